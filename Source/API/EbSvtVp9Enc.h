@@ -32,6 +32,9 @@ extern "C" {
 
 #define EB_BUFFERFLAG_EOS 0x00000001 // signals the last packet of the stream
 #define EB_BUFFERFLAG_SHOW_EXT 0x00000002 // signals that the packet contains a show existing frame at the end
+#define EB_BUFFERFLAG_PARTIAL 0x00000004 // signals a chunk of the tile data of a frame whose final packet follows
+
+#define EB_USER_METADATA_SIZE 16 // bytes of user_metadata carried from an input picture to its packet
 
 #ifdef _WIN32
 #define EB_API __declspec(dllexport)
@@ -80,6 +83,9 @@ typedef struct EbBufferHeaderType {
     uint32_t n_alloc_len;
 
     // pic private data
+    // p_app_private and user_metadata of an input picture are returned with the packet coding that picture: each
+    // picture is coded in exactly one packet, in decode order. A picture coded with show_frame = 0 keeps its
+    // packet; the show existing frame displaying it later (EB_BUFFERFLAG_SHOW_EXT) carries no metadata of its own
     void *p_app_private;
     void *wrapper_ptr;
 
@@ -92,9 +98,26 @@ typedef struct EbBufferHeaderType {
     uint32_t qp;
     uint32_t pic_type;
 
+    // pic quality statistics, sum of the squared errors per plane (stat_report)
+    uint64_t luma_sse;
+    uint64_t cb_sse;
+    uint64_t cr_sse;
+
+    // pic quality statistics, SSIM per plane, 8x8 windows every 4 samples as in libvpx (stat_report)
+    double luma_ssim;
+    double cb_ssim;
+    double cr_ssim;
+
     // pic n_flags
     uint32_t flags;
 
+    // opaque application data, ignored when size does not cover it
+    uint8_t user_metadata[EB_USER_METADATA_SIZE];
+
+    // partial packet output: offset of an EB_BUFFERFLAG_PARTIAL chunk in the tile data of its frame. In the final
+    // packet of the frame, offset at which the chunks received before it are inserted (0 when there were none)
+    uint32_t n_offset;
+
 } EbBufferHeaderType;
 
 typedef enum EbErrorType {
@@ -116,6 +139,7 @@ typedef enum EbErrorType {
     EB_ErrorMutexUnresponsive      = (int32_t)0x80002031,
     EB_ErrorDestroyMutexFailed     = (int32_t)0x80002032,
     EB_NoErrorEmptyQueue           = (int32_t)0x80002033,
+    EB_NoErrorFullQueue            = (int32_t)0x80002034,
     EB_ErrorMax                    = 0x7FFFFFFF
 } EbErrorType;
 
@@ -172,6 +196,11 @@ typedef struct EbSvtVp9EncConfiguration {
     * Default is 0. */
     uint32_t base_layer_switch_mode;
 
+    /* Flag to enable the scene change detection. The first picture of a new
+    * scene is coded as a key frame. Has no effect when intra_period is -1.
+    * Default is 0. */
+    uint32_t scene_change_detection;
+
     // Input Info
     /* The width of input source in units of picture luma pixels.
     * [64 - 8192]
@@ -228,8 +257,17 @@ typedef struct EbSvtVp9EncConfiguration {
     * Default is null.*/
     uint32_t enable_qp_scaling_flag;
 
+    /* Adaptive quantization mode, assigns the superblocks to segments with
+    * their own quantizer.
+    * 0 = OFF.
+    * 1 = Variance based, flat superblocks are given a finer quantizer.
+    * 2 = Motion based, static superblocks of the base layer pictures are given a finer quantizer.
+    * Default is 0. */
+    uint32_t aq_mode;
+
     // Deblock Filter
-    /* Flag to enable the Deblocking Loop Filtering.
+    /* Flag to enable the Deblocking Loop Filtering. In enc modes 0 and 1 with
+    * 8-bit input the filter level is searched, otherwise it is derived from the qindex.
     * Default is 1. */
     EbBool loop_filter;
 
@@ -258,7 +296,9 @@ typedef struct EbSvtVp9EncConfiguration {
     * 0 = Constant QP.
     * 1 = Variable BitRate.
     * 2 = Constant BitRate.
-    [0 - 2]
+    * 3 = Constant Rate Factor, qp sets the quality level and the picture qp
+    *     follows the picture complexity.
+    [0 - 3]
     * Default is 0. */
     uint32_t rate_control_mode;
 
@@ -313,6 +353,16 @@ typedef struct EbSvtVp9EncConfiguration {
     * Default is 60. */
     int32_t injector_frame_rate;
 
+    /* Output the tile data of a frame as soon as its superblock rows are entropy
+    * coded. Each chunk is returned in its own packet flagged EB_BUFFERFLAG_PARTIAL,
+    * then the final packet of the frame brings the frame headers and the rest of
+    * the tile data. The frame is the final packet with the chunks inserted in order
+    * at its n_offset. Chunks are only output for the frame that is next in decode
+    * order, and only when an output buffer is free.
+    *
+    * Default is 0. */
+    uint32_t partial_packet_output;
+
     /* The number of logical processor which encoder threads run on. If
     * LogicalProcessorNumber and TargetSocket are not set, threads are managed by
     * OS thread scheduler. */
@@ -328,6 +378,16 @@ typedef struct EbSvtVp9EncConfiguration {
      * Default is -1. */
     int32_t target_socket;
 
+    /* Backing of the picture buffers of at least one huge page, e.g. the input,
+    * reference and decimated HME pictures.
+    *
+    * 0 = Regular pages.
+    * 1 = Transparent huge pages, the buffers are huge page aligned and advised to the kernel.
+    * 2 = Explicit huge pages from the reserved pool, falling back to 1 when the pool is exhausted.
+    *
+    * Default is 0. */
+    uint32_t huge_pages;
+
     // Debug tools
 
     /* Output reconstructed yuv used for debug purposes. The value is set through
@@ -336,11 +396,29 @@ typedef struct EbSvtVp9EncConfiguration {
     * Default is 0. */
     uint32_t recon_file;
 
+    /* Output the reconstructed pictures as read-only views on the encoder picture
+    * buffers, returned by eb_vp9_svt_get_recon_view(). Nothing is copied: the library
+    * keeps the picture until the view is released, and stalls once its picture pools
+    * are held by views, so views have to be released promptly. Cannot be combined
+    * with recon_file.
+    *
+    * Default is 0. */
+    uint32_t recon_view;
+
+    /* Compute the PSNR and SSIM statistics of every picture in the library. The per
+    * plane SSE and SSIM between the source and the reconstructed picture are returned
+    * with each output packet, the reconstructed yuv output does not need to be enabled.
+    * As with the recon output, every picture is then reconstructed and loop filtered.
+    *
+    * Default is 0. */
+    uint32_t stat_report;
+
     // Input stride
     uint32_t input_picture_stride; // Includes padding
 
     // VBV Parameters
-    /* Sets the maximum rate the VBV buffer should be assumed to refill at
+    /* Sets the maximum rate the VBV buffer should be assumed to refill at, it
+    * caps the rate of the constant rate factor mode when set with vbv_buf_size.
     *
     *  Default is 0. */
     uint32_t vbv_max_rate;
@@ -404,6 +482,46 @@ EB_API EbErrorType eb_vp9_svt_enc_eos_nal(EbComponentType *svt_enc_component, Eb
 * @ *p_buffer           Header pointer, picture buffer. */
 EB_API EbErrorType eb_vp9_svt_enc_send_picture(EbComponentType *svt_enc_component, EbBufferHeaderType *p_buffer);
 
+/* STEP 4-1 (optional): Send the picture without waiting for a free input slot.
+*
+* Parameter:
+* @ *svt_enc_component  Encoder handler.
+* @ *p_buffer           Header pointer, picture buffer.
+* Non-locking call, returns EB_NoErrorFullQueue (would block) when every input slot is in use, the picture
+* is not consumed in that case and has to be sent again. */
+EB_API EbErrorType eb_vp9_svt_enc_send_picture_non_blocking(EbComponentType    *svt_enc_component,
+                                                            EbBufferHeaderType *p_buffer);
+
+/* STEP 4-2 (optional): Query the number of input slots that are free.
+*
+* Parameter:
+* @ *svt_enc_component  Encoder handler.
+* @ *free_count         Number of pictures that can be sent without blocking. */
+EB_API EbErrorType eb_vp9_svt_enc_get_free_input_count(EbComponentType *svt_enc_component, uint32_t *free_count);
+
+/* OPTIONAL: Be notified each time the library is done with an input slot.
+* Must be called after eb_vp9_init_encoder() and before the first picture is sent. The callback runs on an
+* encoder thread and must return quickly; it may call eb_vp9_svt_enc_send_picture_non_blocking().
+*
+* Parameter:
+* @ *svt_enc_component  Encoder handler.
+* @ callback            Function to call, NULL to disable the notification.
+* @ *context            Passed back to the callback. */
+EB_API EbErrorType eb_vp9_svt_enc_set_input_release_callback(EbComponentType *svt_enc_component,
+                                                             void (*callback)(void *context), void *context);
+
+/* OPTIONAL: Change the rate control targets while encoding.
+* Only target_bit_rate, vbv_max_rate, vbv_buf_size, max_qp_allowed, min_qp_allowed, qp, frame_rate,
+* frame_rate_numerator and frame_rate_denominator are read from the configuration, the other fields are ignored.
+* The new values are applied from the next mini-GOP boundary, or from the next picture sent with
+* pic_type = EB_IDR_PICTURE, whichever comes first. Pictures already sent keep the previous values.
+*
+* Parameter:
+* @ *svt_enc_component  Encoder handler.
+* @ *config_ptr         Configuration holding the new values. */
+EB_API EbErrorType eb_vp9_svt_enc_update_parameter(EbComponentType *svt_enc_component,
+                                                   EbSvtVp9EncConfiguration *config_ptr);
+
 /* STEP 5: Receive packet.
 * Parameter:
 * @ *svt_enc_component  Encoder handler.
@@ -426,7 +544,36 @@ EB_API void eb_vp9_svt_release_out_buffer(EbBufferHeaderType **p_buffer);
 * @ *p_buffer           Output buffer. */
 EB_API EbErrorType eb_vp9_svt_get_recon(EbComponentType *svt_enc_component, EbBufferHeaderType *p_buffer);
 
+/* OPTIONAL: Get a view on the next reconstructed picture, in encode order (recon_view).
+* p_buffer of the returned header points to an EbSvtEncInput holding the luma, cb and cr plane pointers and
+* strides, in samples of the encoder bit depth; the picture has the source width and height. pts is the
+* picture number and the last picture carries EB_BUFFERFLAG_EOS. The planes must not be written.
+* Non-locking call, returns EB_NoErrorEmptyQueue when no picture is ready.
+*
+* Parameter:
+* @ *svt_enc_component  Encoder handler.
+* @ **p_buffer          Header pointer to return the view with. */
+EB_API EbErrorType eb_vp9_svt_get_recon_view(EbComponentType *svt_enc_component, EbBufferHeaderType **p_buffer);
+
+/* OPTIONAL: Release a view returned by eb_vp9_svt_get_recon_view(), the library can then reuse the picture.
+* Every view has to be released before eb_vp9_deinit_encoder().
+*
+* Parameter:
+* @ **p_buffer          Header pointer that contains the view to be released. */
+EB_API void eb_vp9_svt_release_recon_view(EbBufferHeaderType **p_buffer);
+
+/* OPTIONAL: Start a new sequence with the same configuration.
+* The encoder threads are stopped and restarted, every buffer pool is kept allocated and the sequence state
+* (picture numbers, GOP position, rate control) goes back to its initial value. The next picture sent is
+* coded as the first picture of a new stream. Call it once the EOS packet of the current sequence was
+* received and every output buffer released; pictures still in flight are dropped.
+*
+* Parameter:
+* @ *svt_enc_component  Encoder handler. */
+EB_API EbErrorType eb_vp9_svt_enc_reset(EbComponentType *svt_enc_component);
+
 /* STEP 6: Deinitialize encoder library.
+* The encoder threads are signaled to quit and joined before the resources are released.
 *
 * Parameter:
 * @ *svt_enc_component  Encoder handler. */
@@ -53,6 +53,12 @@ typedef enum EncoderErrorCodes {
     EB_ENC_PD_ERROR6 = 0x0306,
     EB_ENC_PD_ERROR7 = 0x0307,
 
+    //EB_ENC_EC_ERRORS                  = 0x0400,
+    EB_ENC_EC_ERROR0 = 0x0400,
+
+    //EB_ENC_PK_ERRORS                  = 0x0500,
+    EB_ENC_PK_ERROR0 = 0x0500,
+
 } EncoderErrorCodes;
 
 #ifdef __cplusplus
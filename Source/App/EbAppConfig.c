@@ -8,6 +8,7 @@
 #include <string.h>
 #include "EbApiVersion.h"
 #include "EbAppConfig.h"
+#include "EbAppInputStream.h"
 
 #ifdef _WIN32
 #else
@@ -25,14 +26,18 @@
 #define INPUT_FILE_TOKEN "-i"
 #define OUTPUT_BITSTREAM_TOKEN "-b"
 #define OUTPUT_RECON_TOKEN "-o"
+#define DIRECT_IO_TOKEN "-direct-io"
 #define ERROR_FILE_TOKEN "-errlog"
 #define QP_FILE_TOKEN "-qp-file"
+#define STAT_REPORT_TOKEN "-stat-report"
 #define WIDTH_TOKEN "-w"
 #define HEIGHT_TOKEN "-h"
 #define NUMBER_OF_PICTURES_TOKEN "-n"
 #define BUFFERED_INPUT_TOKEN "-nb"
+#define READ_AHEAD_FRAMES_TOKEN "-read-ahead"
 #define BASE_LAYER_SWITCH_MODE_TOKEN "-base-layer-switch-mode" // no Eval
 #define QP_TOKEN "-q"
+#define AQ_MODE_TOKEN "-aq-mode"
 #define USE_QP_FILE_TOKEN "-use-q-file"
 #define TUNE_TOKEN "-tune"
 #define FRAME_RATE_TOKEN "-fps"
@@ -43,6 +48,7 @@
 #define ENCMODE_TOKEN "-enc-mode"
 #define PRED_STRUCT_TOKEN "-pred-struct"
 #define INTRA_PERIOD_TOKEN "-intra-period"
+#define SCENE_CHANGE_DETECTION_TOKEN "-scd"
 #define PROFILE_TOKEN "-profile"
 #define LEVEL_TOKEN "-level"
 #define INTERLACED_VIDEO_TOKEN "-interlaced-video"
@@ -65,9 +71,11 @@
 #define INJECTOR_TOKEN "-inj" // no Eval
 #define INJECTOR_FRAMERATE_TOKEN "-inj-frm-rt" // no Eval
 #define SPEED_CONTROL_TOKEN "-speed-ctrl"
+#define PARTIAL_PACKET_OUTPUT_TOKEN "-partial-packets"
 #define ASM_TYPE_TOKEN "-asm" // no Eval
 #define THREAD_MGMNT "-lp"
 #define TARGET_SOCKET "-ss"
+#define HUGE_PAGES_TOKEN "-huge-pages"
 #define CONFIG_FILE_COMMENT_CHAR '#'
 #define CONFIG_FILE_NEWLINE_CHAR '\n'
 #define CONFIG_FILE_RETURN_CHAR '\r'
@@ -102,12 +110,16 @@ static void set_cfg_stream_file(const char *value, EbConfig *cfg) {
     }
     FOPEN(cfg->bitstream_file, value, "wb");
 };
+static void set_direct_io(const char *value, EbConfig *cfg) { cfg->direct_io = (uint8_t)strtoul(value, NULL, 0); };
 static void set_cfg_recon_file(const char *value, EbConfig *cfg) {
     if (cfg->recon_file) {
         fclose(cfg->recon_file);
     }
     FOPEN(cfg->recon_file, value, "wb");
 };
+static void set_cfg_stat_report(const char *value, EbConfig *cfg) {
+    cfg->stat_report = (uint32_t)strtoul(value, NULL, 0);
+};
 static void set_cfg_error_file(const char *value, EbConfig *cfg) {
     if (cfg->error_log_file) {
         fclose(cfg->error_log_file);
@@ -129,6 +141,9 @@ static void set_cfg_frames_to_be_encoded(const char *value, EbConfig *cfg) {
     cfg->frames_to_be_encoded = strtoll(value, NULL, 0) << 0;
 };
 static void set_buffered_input(const char *value, EbConfig *cfg) { cfg->buffered_input = strtol(value, NULL, 0); };
+static void set_read_ahead_frames(const char *value, EbConfig *cfg) {
+    cfg->read_ahead_frames = strtoul(value, NULL, 0);
+};
 
 static void set_frame_rate(const char *value, EbConfig *cfg) {
     cfg->frame_rate = strtoul(value, NULL, 0);
@@ -150,11 +165,15 @@ static void set_base_layer_switch_mode(const char *value, EbConfig *cfg) {
 };
 static void set_enc_mode(const char *value, EbConfig *cfg) { cfg->enc_mode = (uint8_t)strtoul(value, NULL, 0); };
 static void set_cfg_intra_period(const char *value, EbConfig *cfg) { cfg->intra_period = strtol(value, NULL, 0); };
+static void set_scene_change_detection(const char *value, EbConfig *cfg) {
+    cfg->scene_change_detection = strtoul(value, NULL, 0);
+};
 static void set_cfg_pred_structure(const char *value, EbConfig *cfg) { cfg->pred_structure = strtol(value, NULL, 0); };
 static void set_cfg_qp(const char *value, EbConfig *cfg) { cfg->qp = strtoul(value, NULL, 0); };
 static void set_cfg_use_qp_file(const char *value, EbConfig *cfg) {
     cfg->use_qp_file = (uint8_t)strtol(value, NULL, 0);
 };
+static void set_cfg_aq_mode(const char *value, EbConfig *cfg) { cfg->aq_mode = strtoul(value, NULL, 0); };
 static void set_loop_filter(const char *value, EbConfig *cfg) { cfg->loop_filter = (uint8_t)strtoul(value, NULL, 0); };
 static void set_enable_hme_flag(const char *value, EbConfig *cfg) {
     cfg->enable_hme_flag = (uint8_t)strtoul(value, NULL, 0);
@@ -190,6 +209,10 @@ static void set_injector(const char *value, EbConfig *cfg) { cfg->injector = str
 
 static void speed_control_flag(const char *value, EbConfig *cfg) { cfg->speed_control_flag = strtol(value, NULL, 0); };
 
+static void set_partial_packet_output(const char *value, EbConfig *cfg) {
+    cfg->partial_packet_output = (uint32_t)strtoul(value, NULL, 0);
+};
+
 static void set_injector_frame_rate(const char *value, EbConfig *cfg) {
     cfg->injector_frame_rate = strtoul(value, NULL, 0);
     if (cfg->injector_frame_rate <= 1000) {
@@ -204,6 +227,7 @@ static void set_target_socket(const char *value, EbConfig *cfg) {
 static void set_logical_processors(const char *value, EbConfig *cfg) {
     cfg->logical_processors = (uint32_t)strtoul(value, NULL, 0);
 };
+static void set_huge_pages(const char *value, EbConfig *cfg) { cfg->huge_pages = (uint32_t)strtoul(value, NULL, 0); };
 enum CfgType {
     SINGLE_INPUT, // Configuration parameters that have only 1 value input
     ARRAY_INPUT // Configuration parameters that have multiple values as input
@@ -227,7 +251,9 @@ ConfigEntry config_entry[] = {
     // File I/O
     {SINGLE_INPUT, INPUT_FILE_TOKEN, "InputFile", set_cfg_input_file},
     {SINGLE_INPUT, OUTPUT_BITSTREAM_TOKEN, "StreamFile", set_cfg_stream_file},
+    {SINGLE_INPUT, DIRECT_IO_TOKEN, "DirectIo", set_direct_io},
     {SINGLE_INPUT, OUTPUT_RECON_TOKEN, "ReconFile", set_cfg_recon_file},
+    {SINGLE_INPUT, STAT_REPORT_TOKEN, "StatReport", set_cfg_stat_report},
     {SINGLE_INPUT, ERROR_FILE_TOKEN, "ErrorFile", set_cfg_error_file},
     {SINGLE_INPUT, QP_FILE_TOKEN, "QpFile", set_cfg_qp_file},
 
@@ -238,9 +264,11 @@ ConfigEntry config_entry[] = {
     // Prediction Structure
     {SINGLE_INPUT, NUMBER_OF_PICTURES_TOKEN, "FrameToBeEncoded", set_cfg_frames_to_be_encoded},
     {SINGLE_INPUT, BUFFERED_INPUT_TOKEN, "BufferedInput", set_buffered_input},
+    {SINGLE_INPUT, READ_AHEAD_FRAMES_TOKEN, "ReadAheadFrames", set_read_ahead_frames},
     {SINGLE_INPUT, BASE_LAYER_SWITCH_MODE_TOKEN, "BaseLayerSwitchMode", set_base_layer_switch_mode},
     {SINGLE_INPUT, ENCMODE_TOKEN, "EncoderMode", set_enc_mode},
     {SINGLE_INPUT, INTRA_PERIOD_TOKEN, "IntraPeriod", set_cfg_intra_period},
+    {SINGLE_INPUT, SCENE_CHANGE_DETECTION_TOKEN, "SceneChangeDetection", set_scene_change_detection},
     {SINGLE_INPUT, FRAME_RATE_TOKEN, "FrameRate", set_frame_rate},
     {SINGLE_INPUT, FRAME_RATE_NUMERATOR_TOKEN, "FrameRateNumerator", set_frame_rate_numerator},
     {SINGLE_INPUT, FRAME_RATE_DENOMINATOR_TOKEN, "FrameRateDenominator", set_frame_rate_denominator},
@@ -251,6 +279,7 @@ ConfigEntry config_entry[] = {
     {SINGLE_INPUT, QP_TOKEN, "QP", set_cfg_qp},
 
     {SINGLE_INPUT, USE_QP_FILE_TOKEN, "UseQpFile", set_cfg_use_qp_file},
+    {SINGLE_INPUT, AQ_MODE_TOKEN, "AqMode", set_cfg_aq_mode},
 
     {SINGLE_INPUT, RATE_CONTROL_ENABLE_TOKEN, "RateControlMode", set_rate_control_mode},
     {SINGLE_INPUT, TARGET_BIT_RATE_TOKEN, "TargetBitRate", set_target_bit_rate},
@@ -276,11 +305,13 @@ ConfigEntry config_entry[] = {
     // Thread Management
     {SINGLE_INPUT, TARGET_SOCKET, "TargetSocket", set_target_socket},
     {SINGLE_INPUT, THREAD_MGMNT, "LogicalProcessors", set_logical_processors},
+    {SINGLE_INPUT, HUGE_PAGES_TOKEN, "HugePages", set_huge_pages},
 
     // Latency
     {SINGLE_INPUT, INJECTOR_TOKEN, "Injector", set_injector},
     {SINGLE_INPUT, INJECTOR_FRAMERATE_TOKEN, "InjectorFrameRate", set_injector_frame_rate},
     {SINGLE_INPUT, SPEED_CONTROL_TOKEN, "SpeedControlFlag", speed_control_flag},
+    {SINGLE_INPUT, PARTIAL_PACKET_OUTPUT_TOKEN, "PartialPacketOutput", set_partial_packet_output},
 
     // Annex A parameters
     {SINGLE_INPUT, PROFILE_TOKEN, "Profile", set_profile},
@@ -303,6 +334,7 @@ void eb_config_ctor(EbConfig *config_ptr) {
     config_ptr->recon_file     = NULL;
     config_ptr->error_log_file = stderr;
     config_ptr->qp_file        = NULL;
+    config_ptr->stat_report    = 0;
 
     config_ptr->frame_rate             = 60;
     config_ptr->frame_rate_numerator   = 0;
@@ -315,8 +347,24 @@ void eb_config_ctor(EbConfig *config_ptr) {
     config_ptr->buffered_input       = -1;
     config_ptr->sequence_buffer      = 0;
 
+    config_ptr->y4m_input         = EB_FALSE;
+    config_ptr->input_streaming   = EB_FALSE;
+    config_ptr->read_ahead_frames = READ_AHEAD_FRAMES_DEFAULT;
+    config_ptr->input_prefix_size = 0;
+    config_ptr->input_stream      = NULL;
+
+    config_ptr->direct_io       = EB_FALSE;
+    config_ptr->ivf_frame_count = 0;
+    config_ptr->output_stream   = NULL;
+
+    config_ptr->partial_packet_output = 0;
+    config_ptr->partial_frame         = NULL;
+    config_ptr->partial_frame_size    = 0;
+    config_ptr->partial_frame_alloc   = 0;
+
     config_ptr->qp          = 45;
     config_ptr->use_qp_file = EB_FALSE;
+    config_ptr->aq_mode     = 0;
 
     config_ptr->rate_control_mode      = 0;
     config_ptr->target_bit_rate        = 7000000;
@@ -326,8 +374,9 @@ void eb_config_ctor(EbConfig *config_ptr) {
     config_ptr->min_qp_allowed         = 10;
     config_ptr->base_layer_switch_mode = 0;
 
-    config_ptr->enc_mode     = 9;
-    config_ptr->intra_period = -2;
+    config_ptr->enc_mode               = 9;
+    config_ptr->intra_period           = -2;
+    config_ptr->scene_change_detection = 0;
 
     config_ptr->pred_structure = 2;
 
@@ -345,7 +394,7 @@ void eb_config_ctor(EbConfig *config_ptr) {
 
     // Latency
     config_ptr->injector            = 0;
-    config_ptr->injector_frame_rate = 60;
+    config_ptr->injector_frame_rate = 60 << 16;
     config_ptr->speed_control_flag  = 0;
 
     // Testing
@@ -359,6 +408,18 @@ void eb_config_ctor(EbConfig *config_ptr) {
     config_ptr->performance_context.max_latency   = 0;
     config_ptr->performance_context.total_latency = 0;
     config_ptr->performance_context.byte_count    = 0;
+    config_ptr->performance_context.luma_sse      = 0;
+    config_ptr->performance_context.cb_sse        = 0;
+    config_ptr->performance_context.cr_sse        = 0;
+    config_ptr->performance_context.luma_psnr     = 0;
+    config_ptr->performance_context.cb_psnr       = 0;
+    config_ptr->performance_context.cr_psnr       = 0;
+    config_ptr->performance_context.luma_ssim     = 0;
+    config_ptr->performance_context.cb_ssim       = 0;
+    config_ptr->performance_context.cr_ssim       = 0;
+
+    config_ptr->performance_context.total_first_byte_latency = 0;
+    config_ptr->performance_context.max_first_byte_latency   = 0;
 
     // ASM Type
     config_ptr->asm_type = 1;
@@ -366,6 +427,7 @@ void eb_config_ctor(EbConfig *config_ptr) {
     config_ptr->stop_encoder       = EB_FALSE;
     config_ptr->target_socket      = -1;
     config_ptr->logical_processors = 0;
+    config_ptr->huge_pages         = 0;
 
     config_ptr->processed_frame_count = 0;
     config_ptr->processed_byte_count  = 0;
@@ -409,6 +471,9 @@ void eb_config_dtor(EbConfig *config_ptr) {
         config_ptr->qp_file = (FILE *)NULL;
     }
 
+    free(config_ptr->partial_frame);
+    config_ptr->partial_frame = NULL;
+
     return;
 }
 
@@ -630,6 +695,26 @@ static EbErrorType verify_settings(EbConfig *config, uint32_t channel_number) {
         return_error = EB_ErrorBadParameter;
     }
 
+    if (config->input_streaming && config->buffered_input != -1) {
+        fprintf(config->error_log_file,
+                "Error instance %u: BufferedInput is not supported with Y4M or piped input\n",
+                channel_number + 1);
+        return_error = EB_ErrorBadParameter;
+    }
+
+    if (config->read_ahead_frames == 0 || config->read_ahead_frames > READ_AHEAD_FRAMES_MAX) {
+        fprintf(config->error_log_file,
+                "Error instance %u: Invalid ReadAheadFrames [1 - %u]\n",
+                channel_number + 1,
+                READ_AHEAD_FRAMES_MAX);
+        return_error = EB_ErrorBadParameter;
+    }
+
+    if (config->direct_io > 1) {
+        fprintf(config->error_log_file, "Error instance %u: Invalid DirectIo [0 - 1]\n", channel_number + 1);
+        return_error = EB_ErrorBadParameter;
+    }
+
     if (config->use_qp_file == EB_TRUE && config->qp_file == NULL) {
         fprintf(config->error_log_file,
                 "Error instance %u: Could not find QP file, use_qp_file is set to 1\n",
@@ -887,13 +972,20 @@ EbErrorType read_command_line(int argc, char *const argv[], EbConfig **configs,
         return_error = EB_ErrorBadParameter;
         for (index = 0; index < num_channels; ++index) {
             if (return_errors[index] == EB_ErrorNone) {
-                return_errors[index] = verify_settings(configs[index], index);
+                // Y4M streams carry the picture geometry, probe before verifying it
+                return_errors[index] = app_input_stream_probe(configs[index], index);
+
+                if (return_errors[index] == EB_ErrorNone)
+                    return_errors[index] = verify_settings(configs[index], index);
 
-                // Assuming no errors, set the frames to be encoded to the number of frames in the input yuv
+                // Assuming no errors, set the frames to be encoded to the number of frames in the input yuv,
+                // streamed input is encoded until its end
                 if (return_errors[index] == EB_ErrorNone && configs[index]->frames_to_be_encoded == 0)
-                    configs[index]->frames_to_be_encoded = compute_frames_to_be_encoded(configs[index]);
+                    configs[index]->frames_to_be_encoded = configs[index]->input_streaming
+                        ? -1
+                        : compute_frames_to_be_encoded(configs[index]);
 
-                if (configs[index]->frames_to_be_encoded == -1) {
+                if (configs[index]->frames_to_be_encoded == -1 && !configs[index]->input_streaming) {
                     fprintf(configs[index]->error_log_file,
                             "Error instance %u: Input yuv does not contain enough frames \n",
                             index + 1);
@@ -902,7 +994,10 @@ EbErrorType read_command_line(int argc, char *const argv[], EbConfig **configs,
 
                 // Force the injector latency mode, and injector frame rate when speed control is on
                 if (return_errors[index] == EB_ErrorNone && configs[index]->speed_control_flag == 1) {
-                    configs[index]->injector = 1;
+                    configs[index]->injector            = 1;
+                    configs[index]->injector_frame_rate = (configs[index]->frame_rate > 1000)
+                        ? configs[index]->frame_rate
+                        : configs[index]->frame_rate << 16;
                 }
             }
             return_error = (EbErrorType)(return_error & return_errors[index]);
@@ -158,6 +158,10 @@ typedef struct EbPerformanceContext {
     uint64_t total_latency;
     uint32_t max_latency;
 
+    // Time to the first byte of each frame, the first partial packet when partial_packet_output is on
+    uint64_t total_first_byte_latency;
+    uint32_t max_first_byte_latency;
+
     uint64_t starts_time;
     uint64_t start_utime;
 
@@ -168,6 +172,17 @@ typedef struct EbPerformanceContext {
 
     uint64_t byte_count;
 
+    // Quality statistics (stat_report), overall sums of the squared errors and of the picture PSNRs and SSIMs
+    uint64_t luma_sse;
+    uint64_t cb_sse;
+    uint64_t cr_sse;
+    double   luma_psnr;
+    double   cb_psnr;
+    double   cr_psnr;
+    double   luma_ssim;
+    double   cb_ssim;
+    double   cr_ssim;
+
 } EbPerformanceContext;
 
 typedef struct EbConfig {
@@ -181,6 +196,7 @@ typedef struct EbConfig {
     FILE *error_log_file;
     FILE *qp_file;
 
+    uint32_t stat_report;
     uint8_t  use_qp_file;
     int32_t  frame_rate;
     int32_t  frame_rate_numerator;
@@ -196,18 +212,43 @@ typedef struct EbConfig {
     int32_t         buffered_input;
     unsigned char **sequence_buffer;
 
+    /****************************************
+     * Streaming Input (Y4M / pipes)
+     ****************************************/
+    uint8_t  y4m_input;
+    uint8_t  input_streaming; // the input is read sequentially and never seeked
+    uint32_t read_ahead_frames;
+    uint8_t  input_prefix[16]; // bytes consumed from a pipe while probing the input
+    uint32_t input_prefix_size;
+    void    *input_stream;
+
+    /****************************************
+     * Buffered Output
+     ****************************************/
+    uint8_t  direct_io; // bypass the page cache for the bitstream file (O_DIRECT)
+    uint32_t ivf_frame_count;
+    void    *output_stream;
+
+    // Reassembly of the frames output in partial packets
+    uint32_t partial_packet_output;
+    uint8_t *partial_frame;
+    uint32_t partial_frame_size;
+    uint32_t partial_frame_alloc;
+
     /*****************************************
      * Coding Structure
      *****************************************/
     uint32_t base_layer_switch_mode;
     uint8_t  enc_mode;
     int32_t  intra_period;
+    uint32_t scene_change_detection;
     uint32_t pred_structure;
 
     /****************************************
      * Quantization
      ****************************************/
     uint32_t qp;
+    uint32_t aq_mode;
 
     /****************************************
      * Loop Filter
@@ -268,6 +309,7 @@ typedef struct EbConfig {
     uint32_t active_channel_count;
     int32_t  target_socket;
     uint32_t logical_processors;
+    uint32_t huge_pages;
     uint8_t  stop_encoder; // to signal CTRL+C Event, need to stop encoding.
 
     uint64_t processed_frame_count;
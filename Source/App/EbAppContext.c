@@ -11,6 +11,8 @@
 
 #include "EbAppContext.h"
 #include "EbAppConfig.h"
+#include "EbAppInputStream.h"
+#include "EbAppOutputStream.h"
 
 #define INPUT_SIZE_576p_TH 0x90000 // 0.58 Million
 #define INPUT_SIZE_1080i_TH 0xB71B0 // 0.75 Million
@@ -146,6 +148,7 @@ EbErrorType copy_configuration_parameters(EbConfig *config, EbAppContext *callba
     callback_data->eb_enc_parameters.source_width           = config->source_width;
     callback_data->eb_enc_parameters.source_height          = config->source_height;
     callback_data->eb_enc_parameters.intra_period           = config->intra_period;
+    callback_data->eb_enc_parameters.scene_change_detection = config->scene_change_detection;
     callback_data->eb_enc_parameters.base_layer_switch_mode = config->base_layer_switch_mode;
     callback_data->eb_enc_parameters.enc_mode               = (uint8_t)config->enc_mode;
     callback_data->eb_enc_parameters.frame_rate             = config->frame_rate;
@@ -161,6 +164,7 @@ EbErrorType copy_configuration_parameters(EbConfig *config, EbAppContext *callba
     callback_data->eb_enc_parameters.vbv_buf_size           = config->vbv_buf_size;
     callback_data->eb_enc_parameters.frames_to_be_encoded   = config->frames_to_be_encoded;
     callback_data->eb_enc_parameters.use_qp_file            = (uint8_t)config->use_qp_file;
+    callback_data->eb_enc_parameters.aq_mode                = config->aq_mode;
     callback_data->eb_enc_parameters.loop_filter            = (uint8_t)config->loop_filter;
     callback_data->eb_enc_parameters.use_default_me_hme     = (uint8_t)config->use_default_me_hme;
     callback_data->eb_enc_parameters.enable_hme_flag        = (uint8_t)config->enable_hme_flag;
@@ -168,6 +172,7 @@ EbErrorType copy_configuration_parameters(EbConfig *config, EbAppContext *callba
     callback_data->eb_enc_parameters.search_area_height     = config->search_area_height;
     callback_data->eb_enc_parameters.tune                   = config->tune;
     callback_data->eb_enc_parameters.recon_file = (config->recon_file) ? (uint32_t)EB_TRUE : (uint32_t)EB_FALSE;
+    callback_data->eb_enc_parameters.stat_report = config->stat_report;
     callback_data->eb_enc_parameters.channel_id = config->channel_id;
     callback_data->eb_enc_parameters.active_channel_count = config->active_channel_count;
     callback_data->eb_enc_parameters.encoder_bit_depth    = config->encoder_bit_depth;
@@ -178,6 +183,9 @@ EbErrorType copy_configuration_parameters(EbConfig *config, EbAppContext *callba
     callback_data->eb_enc_parameters.asm_type             = config->asm_type;
     callback_data->eb_enc_parameters.logical_processors   = config->logical_processors;
     callback_data->eb_enc_parameters.target_socket        = config->target_socket;
+    callback_data->eb_enc_parameters.huge_pages           = config->huge_pages;
+
+    callback_data->eb_enc_parameters.partial_packet_output = config->partial_packet_output;
 
     return return_error;
 }
@@ -262,7 +270,7 @@ EbErrorType AllocateInputBuffers(EbConfig *config, EbAppContext *callback_data)
                       EB_N_PTR,
                       EB_ErrorInsufficientResources);
 
-        if (config->buffered_input == -1) {
+        if (config->buffered_input == -1 && !config->input_streaming) {
             // Allocate frame buffer for the p_buffer
             allocate_frame_buffer(config, callback_data->input_buffer_pool->p_buffer);
         }
@@ -414,6 +422,18 @@ EbErrorType init_encoder(EbConfig *config, EbAppContext *callback_data, uint32_t
         config->sequence_buffer = 0;
     }
 
+    // Y4M and piped input are read ahead by a dedicated thread
+    if (config->input_streaming)
+        return_error = app_input_stream_start(config);
+
+    if (return_error != EB_ErrorNone) {
+        return return_error;
+    }
+
+    // The bitstream is written by a dedicated thread
+    if (config->bitstream_file)
+        return_error = app_output_stream_start(config);
+
     if (return_error != EB_ErrorNone) {
         return return_error;
     }
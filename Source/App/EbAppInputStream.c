@@ -0,0 +1,307 @@
+/*
+* Copyright(c) 2019 Intel Corporation
+* SPDX - License - Identifier: BSD - 2 - Clause - Patent
+*/
+
+/***************************************
+ * Includes
+ ***************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "EbAppInputStream.h"
+#include "EbAppThreads.h"
+
+/***************************************
+ * Macros
+ ***************************************/
+#define SIZE_OF_ONE_FRAME_IN_BYTES(width, height, is16bit) ((((width) * (height) * 3) >> 1) << is16bit)
+#define Y4M_FRAME_TAG "FRAME"
+#define Y4M_FRAME_TAG_SIZE 5
+
+/***************************************
+ * Read-ahead ring
+ *  The reader thread fills the slots in
+ *  order, the encode loop consumes them
+ *  in order. The input is never seeked.
+ ***************************************/
+typedef struct EbAppInputStream {
+    EbConfig *config;
+
+    uint8_t **frame_buffer;
+    uint32_t  frame_buffer_count;
+    size_t    frame_size;
+
+    uint32_t read_index;
+    uint32_t write_index;
+    uint32_t filled_count;
+    int64_t  frames_left; // -1: until end of file
+    uint8_t  end_of_stream;
+    uint8_t  stop;
+
+    AppMutex  mutex;
+    AppCond   not_full;
+    AppCond   not_empty;
+    AppThread reader_thread;
+} EbAppInputStream;
+
+/******************************************************
+ * Reads one '\n' terminated line, returns its length
+ * without the terminator or -1 at the end of file.
+ ******************************************************/
+static int32_t read_line(FILE *input_file, char *line, int32_t max_size) {
+    int32_t length = 0;
+    int     c;
+
+    while ((c = fgetc(input_file)) != EOF && c != '\n') {
+        if (length < max_size - 1)
+            line[length++] = (char)c;
+    }
+    line[length] = '\0';
+
+    return (c == EOF && length == 0) ? -1 : length;
+}
+
+/******************************************************
+ * Y4M stream header
+ *  YUV4MPEG2 W<w> H<h> F<num>:<den> [I<i>] [A<n>:<d>] [C<cs>] [X<..>]
+ ******************************************************/
+static EbErrorType parse_y4m_header(EbConfig *config, uint32_t channel_number) {
+    char     header[Y4M_MAX_HEADER_SIZE];
+    char    *token;
+    uint32_t width = 0, height = 0, fps_num = 0, fps_den = 0;
+    uint32_t bit_depth = 8;
+
+    if (read_line(config->input_file, header, Y4M_MAX_HEADER_SIZE) < 0) {
+        fprintf(config->error_log_file, "Error instance %u: Truncated Y4M header\n", channel_number + 1);
+        return EB_ErrorBadParameter;
+    }
+
+    for (token = strtok(header, " "); token != NULL; token = strtok(NULL, " ")) {
+        switch (token[0]) {
+        case 'W': width = strtoul(token + 1, NULL, 10); break;
+        case 'H': height = strtoul(token + 1, NULL, 10); break;
+        case 'F':
+            fps_num = strtoul(token + 1, &token, 10);
+            fps_den = (*token == ':') ? strtoul(token + 1, NULL, 10) : 1;
+            break;
+        case 'C':
+            if (!strcmp(token + 1, "420p10")) {
+                bit_depth = 10;
+            } else if (strcmp(token + 1, "420") && strcmp(token + 1, "420jpeg") && strcmp(token + 1, "420paldv") &&
+                       strcmp(token + 1, "420mpeg2")) {
+                fprintf(config->error_log_file,
+                        "Error instance %u: Unsupported Y4M color space %s, only 4:2:0 8/10-bit is supported\n",
+                        channel_number + 1,
+                        token + 1);
+                return EB_ErrorBadParameter;
+            }
+            break;
+        default: // interlacing, aspect ratio and extensions do not change the frame layout
+            break;
+        }
+    }
+
+    if (width == 0 || height == 0) {
+        fprintf(config->error_log_file, "Error instance %u: Y4M header is missing the frame size\n", channel_number + 1);
+        return EB_ErrorBadParameter;
+    }
+
+    config->source_width      = width;
+    config->source_height     = height;
+    config->encoder_bit_depth = bit_depth;
+
+    // An explicit frame rate on the command line takes precedence
+    if (fps_num && fps_den && config->frame_rate_numerator == 0 && config->frame_rate_denominator == 0) {
+        config->frame_rate_numerator   = fps_num;
+        config->frame_rate_denominator = fps_den;
+    }
+
+    return EB_ErrorNone;
+}
+
+/******************************************************
+ * Input probing
+ ******************************************************/
+EbErrorType app_input_stream_probe(EbConfig *config, uint32_t channel_number) {
+    FILE  *input_file = config->input_file;
+    size_t read_size;
+    int    seekable;
+
+    if (input_file == NULL)
+        return EB_ErrorNone;
+
+    seekable  = (fseeko64(input_file, 0, SEEK_CUR) == 0);
+    read_size = fread(config->input_prefix, 1, Y4M_SIGNATURE_SIZE, input_file);
+
+    if (read_size == Y4M_SIGNATURE_SIZE && !memcmp(config->input_prefix, Y4M_SIGNATURE, Y4M_SIGNATURE_SIZE)) {
+        config->y4m_input         = EB_TRUE;
+        config->input_prefix_size = 0;
+        if (parse_y4m_header(config, channel_number) != EB_ErrorNone)
+            return EB_ErrorBadParameter;
+    } else if (seekable) {
+        fseeko64(input_file, 0, SEEK_SET);
+        config->input_prefix_size = 0;
+    } else {
+        // Raw data already taken out of a pipe, handed to the reader thread first
+        config->input_prefix_size = (uint32_t)read_size;
+    }
+
+    config->input_streaming = (uint8_t)(config->y4m_input || !seekable);
+
+    return EB_ErrorNone;
+}
+
+/******************************************************
+ * Reads one full frame, returns 0 at the end of file
+ ******************************************************/
+static int read_stream_frame(EbConfig *config, uint8_t *frame, size_t frame_size) {
+    FILE  *input_file  = config->input_file;
+    size_t filled_size = 0;
+
+    if (config->y4m_input) {
+        char frame_header[Y4M_MAX_HEADER_SIZE];
+        if (read_line(input_file, frame_header, Y4M_MAX_HEADER_SIZE) < 0)
+            return 0;
+        if (strncmp(frame_header, Y4M_FRAME_TAG, Y4M_FRAME_TAG_SIZE)) {
+            fprintf(config->error_log_file, "Error: Corrupted Y4M frame header\n");
+            return 0;
+        }
+    } else if (config->input_prefix_size) {
+        memcpy(frame, config->input_prefix, config->input_prefix_size);
+        filled_size               = config->input_prefix_size;
+        config->input_prefix_size = 0;
+    }
+
+    filled_size += fread(frame + filled_size, 1, frame_size - filled_size, input_file);
+
+    if (filled_size != frame_size) {
+        if (filled_size)
+            fprintf(config->error_log_file, "Warning: Dropping incomplete frame at the end of the input\n");
+        return 0;
+    }
+
+    return 1;
+}
+
+static APP_THREAD_RETURN_TYPE input_stream_reader(APP_THREAD_ARG_TYPE arg) {
+    EbAppInputStream *stream = (EbAppInputStream *)arg;
+
+    for (;;) {
+        uint8_t *frame;
+        uint8_t  stop;
+        int      frame_read;
+
+        APP_MUTEX_LOCK(stream->mutex);
+        while (stream->filled_count == stream->frame_buffer_count && !stream->stop)
+            APP_COND_WAIT(stream->not_full, stream->mutex);
+        frame = stream->frame_buffer[stream->write_index];
+        stop  = stream->stop;
+        APP_MUTEX_UNLOCK(stream->mutex);
+
+        // The slot at write_index is owned by the reader until it is published
+        frame_read = !stop && stream->frames_left != 0 &&
+            read_stream_frame(stream->config, frame, stream->frame_size);
+
+        APP_MUTEX_LOCK(stream->mutex);
+        if (frame_read) {
+            stream->write_index = (stream->write_index + 1) % stream->frame_buffer_count;
+            ++stream->filled_count;
+            if (stream->frames_left > 0)
+                --stream->frames_left;
+        } else {
+            stream->end_of_stream = EB_TRUE;
+        }
+        APP_COND_SIGNAL(stream->not_empty);
+        APP_MUTEX_UNLOCK(stream->mutex);
+
+        if (!frame_read)
+            break;
+    }
+
+    return 0;
+}
+
+EbErrorType app_input_stream_start(EbConfig *config) {
+    EbAppInputStream *stream;
+    uint32_t          buffer_index;
+
+    EB_APP_MALLOC(EbAppInputStream *, stream, sizeof(EbAppInputStream), EB_N_PTR, EB_ErrorInsufficientResources);
+    memset(stream, 0, sizeof(EbAppInputStream));
+
+    stream->config             = config;
+    stream->frame_buffer_count = config->read_ahead_frames;
+    stream->frame_size         = SIZE_OF_ONE_FRAME_IN_BYTES(
+        (size_t)config->source_width, (size_t)config->source_height, (config->encoder_bit_depth > 8 ? 1 : 0));
+    stream->frames_left = config->frames_to_be_encoded > 0 ? config->frames_to_be_encoded : -1;
+
+    EB_APP_MALLOC(uint8_t **,
+                  stream->frame_buffer,
+                  sizeof(uint8_t *) * stream->frame_buffer_count,
+                  EB_N_PTR,
+                  EB_ErrorInsufficientResources);
+    for (buffer_index = 0; buffer_index < stream->frame_buffer_count; ++buffer_index) {
+        EB_APP_MALLOC(uint8_t *,
+                      stream->frame_buffer[buffer_index],
+                      stream->frame_size,
+                      EB_N_PTR,
+                      EB_ErrorInsufficientResources);
+    }
+
+    APP_MUTEX_INIT(stream->mutex);
+    APP_COND_INIT(stream->not_full);
+    APP_COND_INIT(stream->not_empty);
+
+    if (APP_THREAD_CREATE(stream->reader_thread, input_stream_reader, stream))
+        return EB_ErrorInsufficientResources;
+
+    config->input_stream = stream;
+
+    return EB_ErrorNone;
+}
+
+uint8_t *app_input_stream_get_frame(EbConfig *config) {
+    EbAppInputStream *stream = (EbAppInputStream *)config->input_stream;
+    uint8_t          *frame  = NULL;
+
+    APP_MUTEX_LOCK(stream->mutex);
+    while (stream->filled_count == 0 && !stream->end_of_stream)
+        APP_COND_WAIT(stream->not_empty, stream->mutex);
+    if (stream->filled_count)
+        frame = stream->frame_buffer[stream->read_index];
+    APP_MUTEX_UNLOCK(stream->mutex);
+
+    return frame;
+}
+
+void app_input_stream_release_frame(EbConfig *config) {
+    EbAppInputStream *stream = (EbAppInputStream *)config->input_stream;
+
+    APP_MUTEX_LOCK(stream->mutex);
+    stream->read_index = (stream->read_index + 1) % stream->frame_buffer_count;
+    --stream->filled_count;
+    APP_COND_SIGNAL(stream->not_full);
+    APP_MUTEX_UNLOCK(stream->mutex);
+}
+
+void app_input_stream_stop(EbConfig *config) {
+    EbAppInputStream *stream = (EbAppInputStream *)config->input_stream;
+
+    if (stream == NULL)
+        return;
+
+    APP_MUTEX_LOCK(stream->mutex);
+    stream->stop = EB_TRUE;
+    APP_COND_SIGNAL(stream->not_full);
+    APP_MUTEX_UNLOCK(stream->mutex);
+
+    APP_THREAD_JOIN(stream->reader_thread);
+
+    APP_COND_DESTROY(stream->not_empty);
+    APP_COND_DESTROY(stream->not_full);
+    APP_MUTEX_DESTROY(stream->mutex);
+
+    // The ring memory itself is released with the app memory table
+    config->input_stream = NULL;
+}
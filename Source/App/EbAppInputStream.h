@@ -0,0 +1,38 @@
+/*
+* Copyright(c) 2019 Intel Corporation
+* SPDX - License - Identifier: BSD - 2 - Clause - Patent
+*/
+
+#ifndef EbAppInputStream_h
+#define EbAppInputStream_h
+
+#include "EbAppConfig.h"
+
+#define Y4M_SIGNATURE "YUV4MPEG2"
+#define Y4M_SIGNATURE_SIZE 9
+#define Y4M_MAX_HEADER_SIZE 256
+#define READ_AHEAD_FRAMES_DEFAULT 8
+#define READ_AHEAD_FRAMES_MAX 64
+
+/********************************
+ * External Function
+ ********************************/
+// Detects Y4M / non-seekable input and parses the Y4M stream header. Must be
+// called once after the command line is parsed and before the settings are
+// verified, as it fills the picture geometry, frame rate and bit depth.
+extern EbErrorType app_input_stream_probe(EbConfig *config, uint32_t channel_number);
+
+// Allocates the read-ahead ring and starts the reader thread
+extern EbErrorType app_input_stream_start(EbConfig *config);
+
+// Blocks until the next frame is available. Returns NULL at the end of the
+// stream, otherwise a pointer to one packed planar frame that stays valid
+// until app_input_stream_release_frame() is called.
+extern uint8_t *app_input_stream_get_frame(EbConfig *config);
+
+extern void app_input_stream_release_frame(EbConfig *config);
+
+// Stops and joins the reader thread
+extern void app_input_stream_stop(EbConfig *config);
+
+#endif // EbAppInputStream_h
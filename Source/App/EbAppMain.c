@@ -23,6 +23,8 @@
 #include "EbAppConfig.h"
 #include "EbAppContext.h"
 #include "EbAppTime.h"
+#include "EbAppInputStream.h"
+#include "EbAppOutputStream.h"
 #ifdef _WIN32
 #include <windows.h>
 #include <fcntl.h> /* _O_BINARY */
@@ -43,6 +45,8 @@ extern AppExitConditionType process_output_recon_buffer(EbConfig *config, EbAppC
 extern AppExitConditionType process_output_stream_buffer(EbConfig *config, EbAppContext *app_call_back,
                                                          uint8_t pic_send_done);
 
+extern double app_sse_to_psnr(double samples, double sse);
+
 volatile int32_t keep_running = 1;
 
 void EventHandler(int32_t dummy) {
@@ -258,6 +262,43 @@ int32_t main(int32_t argc, char *argv[]) {
                                (double)configs[instance_count]->performance_context.byte_count,
                                (double)(configs[instance_count]->performance_context.byte_count << 3) * frame_rate /
                                    (configs[instance_count]->processed_frame_count * 1000));
+
+                        if (configs[instance_count]->stat_report) {
+                            EbPerformanceContext *performance_context =
+                                &configs[instance_count]->performance_context;
+                            const double frame_count    = (double)performance_context->frame_count;
+                            const double luma_samples   = frame_count * configs[instance_count]->source_width *
+                                configs[instance_count]->source_height;
+                            const double chroma_samples = frame_count *
+                                (configs[instance_count]->source_width >> 1) *
+                                (configs[instance_count]->source_height >> 1);
+
+                            printf("\n\t\tY-PSNR\t\tU-PSNR\t\tV-PSNR\t\tYUV-PSNR\n");
+                            printf("Average\t\t%.4f dB\t%.4f dB\t%.4f dB\t%.4f dB\n",
+                                   performance_context->luma_psnr / frame_count,
+                                   performance_context->cb_psnr / frame_count,
+                                   performance_context->cr_psnr / frame_count,
+                                   (4 * performance_context->luma_psnr + performance_context->cb_psnr +
+                                    performance_context->cr_psnr) /
+                                       (6 * frame_count));
+                            printf("Overall\t\t%.4f dB\t%.4f dB\t%.4f dB\t%.4f dB\n",
+                                   app_sse_to_psnr(luma_samples, (double)performance_context->luma_sse),
+                                   app_sse_to_psnr(chroma_samples, (double)performance_context->cb_sse),
+                                   app_sse_to_psnr(chroma_samples, (double)performance_context->cr_sse),
+                                   app_sse_to_psnr(luma_samples + 2 * chroma_samples,
+                                                   (double)(performance_context->luma_sse +
+                                                            performance_context->cb_sse +
+                                                            performance_context->cr_sse)));
+                            // The YUV SSIM weights the planes as libvpx does
+                            printf("\n\t\tY-SSIM\t\tU-SSIM\t\tV-SSIM\t\tYUV-SSIM\n");
+                            printf("Average\t\t%.6f\t%.6f\t%.6f\t%.6f\n",
+                                   performance_context->luma_ssim / frame_count,
+                                   performance_context->cb_ssim / frame_count,
+                                   performance_context->cr_ssim / frame_count,
+                                   (0.8 * performance_context->luma_ssim + 0.1 * performance_context->cb_ssim +
+                                    0.1 * performance_context->cr_ssim) /
+                                       frame_count);
+                        }
                         fflush(stdout);
                     }
                 }
@@ -278,6 +319,11 @@ int32_t main(int32_t argc, char *argv[]) {
                         configs[instance_count]->performance_context.total_execution_time * 1000,
                         configs[instance_count]->performance_context.average_latency,
                         (uint32_t)(configs[instance_count]->performance_context.max_latency));
+                    if (configs[instance_count]->performance_context.frame_count)
+                        printf("Average Time to First Byte:\t%.0f ms\nMax Time to First Byte:\t%u ms\n",
+                               (double)configs[instance_count]->performance_context.total_first_byte_latency /
+                                   configs[instance_count]->performance_context.frame_count,
+                               configs[instance_count]->performance_context.max_first_byte_latency);
 
                 } else {
                     printf("\nChannel %u Encoding Interrupted\n", (uint32_t)(instance_count + 1));
@@ -292,6 +338,10 @@ int32_t main(int32_t argc, char *argv[]) {
 
         // DeInit Encoder
         for (instance_count = num_channels; instance_count > 0; --instance_count) {
+            // The read-ahead thread has to be joined before its ring is freed
+            app_input_stream_stop(configs[instance_count - 1]);
+            // Only left running when the encode stopped before the end of the stream
+            app_output_stream_stop(configs[instance_count - 1]);
             if (return_errors[instance_count - 1] == EB_ErrorNone)
                 return_errors[instance_count - 1] = de_init_encoder(app_callbacks[instance_count - 1],
                                                                     instance_count - 1);
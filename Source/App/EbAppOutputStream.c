@@ -0,0 +1,312 @@
+/*
+* Copyright(c) 2019 Intel Corporation
+* SPDX - License - Identifier: BSD - 2 - Clause - Patent
+*/
+
+/***************************************
+ * Includes
+ ***************************************/
+#if !defined(_WIN32) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE // O_DIRECT
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "EbAppOutputStream.h"
+#include "EbAppThreads.h"
+
+#ifndef _WIN32
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/uio.h>
+#endif
+
+/***************************************
+ * Write buffers
+ *  The encode loop fills the buffer at
+ *  current_index; the pending_count
+ *  buffers before it are in flight and
+ *  written in order by the writer thread,
+ *  several at a time when it falls behind.
+ ***************************************/
+typedef struct EbAppOutputStream {
+    FILE *file;
+#ifndef _WIN32
+    int fd;
+#endif
+    uint8_t *buffer[OUTPUT_WRITE_BUFFER_COUNT];
+    size_t   filled_size[OUTPUT_WRITE_BUFFER_COUNT];
+
+    uint32_t current_index;
+    uint32_t pending_count;
+    uint64_t file_offset;
+    uint8_t  seekable;
+    uint8_t  direct_io;
+    uint8_t  stop;
+    uint8_t  write_error;
+
+    AppMutex  mutex;
+    AppCond   not_full;
+    AppCond   not_empty;
+    AppThread writer_thread;
+} EbAppOutputStream;
+
+static void *aligned_buffer_alloc(size_t size) {
+#ifdef _WIN32
+    return _aligned_malloc(size, OUTPUT_WRITE_ALIGNMENT);
+#else
+    void *ptr;
+    return posix_memalign(&ptr, OUTPUT_WRITE_ALIGNMENT, size) ? NULL : ptr;
+#endif
+}
+
+static void aligned_buffer_free(void *ptr) {
+#ifdef _WIN32
+    _aligned_free(ptr);
+#else
+    free(ptr);
+#endif
+}
+
+static void free_output_stream(EbAppOutputStream *stream) {
+    uint32_t buffer_index;
+    for (buffer_index = 0; buffer_index < OUTPUT_WRITE_BUFFER_COUNT; ++buffer_index)
+        aligned_buffer_free(stream->buffer[buffer_index]);
+    free(stream);
+}
+
+#if !defined(_WIN32) && defined(O_DIRECT)
+static void set_direct_io(EbAppOutputStream *stream, int enable) {
+    const int flags = fcntl(stream->fd, F_GETFL);
+    if (flags == -1 || fcntl(stream->fd, F_SETFL, enable ? (flags | O_DIRECT) : (flags & ~O_DIRECT)) == -1)
+        enable = 0;
+    stream->direct_io = (uint8_t)enable;
+}
+#endif
+
+/******************************************************
+ * Writes buffer_count consecutive buffers starting at
+ * first_index, with a single vectored call when possible
+ ******************************************************/
+static int write_buffers(EbAppOutputStream *stream, uint32_t first_index, uint32_t buffer_count) {
+#ifdef _WIN32
+    uint32_t i;
+    for (i = 0; i < buffer_count; ++i) {
+        const uint32_t index = (first_index + i) % OUTPUT_WRITE_BUFFER_COUNT;
+        if (fwrite(stream->buffer[index], 1, stream->filled_size[index], stream->file) != stream->filled_size[index])
+            return -1;
+    }
+    return 0;
+#else
+    struct iovec iov[OUTPUT_WRITE_BUFFER_COUNT];
+    uint32_t     iov_index = 0;
+    uint32_t     i;
+
+    for (i = 0; i < buffer_count; ++i) {
+        const uint32_t index = (first_index + i) % OUTPUT_WRITE_BUFFER_COUNT;
+        iov[i].iov_base      = stream->buffer[index];
+        iov[i].iov_len       = stream->filled_size[index];
+#ifdef O_DIRECT
+        // Only the last buffer of the stream can have an unaligned size
+        if (stream->direct_io && (stream->filled_size[index] % OUTPUT_WRITE_ALIGNMENT))
+            set_direct_io(stream, 0);
+#endif
+    }
+
+    while (iov_index < buffer_count) {
+        const ssize_t written = stream->seekable
+            ? pwritev(stream->fd, &iov[iov_index], (int)(buffer_count - iov_index), (off_t)stream->file_offset)
+            : writev(stream->fd, &iov[iov_index], (int)(buffer_count - iov_index));
+        size_t remaining;
+
+        if (written < 0) {
+            if (errno == EINTR)
+                continue;
+            return -1;
+        }
+        stream->file_offset += (uint64_t)written;
+
+        // Skip what was written, a short write can stop in the middle of a buffer
+        remaining = (size_t)written;
+        while (iov_index < buffer_count && remaining >= iov[iov_index].iov_len)
+            remaining -= iov[iov_index++].iov_len;
+        if (iov_index < buffer_count) {
+            iov[iov_index].iov_base = (uint8_t *)iov[iov_index].iov_base + remaining;
+            iov[iov_index].iov_len -= remaining;
+#ifdef O_DIRECT
+            if (stream->direct_io && remaining)
+                set_direct_io(stream, 0);
+#endif
+        }
+    }
+    return 0;
+#endif
+}
+
+static APP_THREAD_RETURN_TYPE output_stream_writer(APP_THREAD_ARG_TYPE arg) {
+    EbAppOutputStream *stream = (EbAppOutputStream *)arg;
+
+    for (;;) {
+        uint32_t first_index, buffer_count;
+
+        APP_MUTEX_LOCK(stream->mutex);
+        while (stream->pending_count == 0 && !stream->stop)
+            APP_COND_WAIT(stream->not_empty, stream->mutex);
+        buffer_count = stream->pending_count;
+        first_index  = (stream->current_index + OUTPUT_WRITE_BUFFER_COUNT - buffer_count) % OUTPUT_WRITE_BUFFER_COUNT;
+        APP_MUTEX_UNLOCK(stream->mutex);
+
+        if (buffer_count == 0)
+            break;
+
+        if (write_buffers(stream, first_index, buffer_count))
+            stream->write_error = EB_TRUE;
+
+        APP_MUTEX_LOCK(stream->mutex);
+        stream->pending_count -= buffer_count;
+        APP_COND_SIGNAL(stream->not_full);
+        APP_MUTEX_UNLOCK(stream->mutex);
+    }
+
+    return 0;
+}
+
+// Hands the current buffer to the writer and waits until the next one is free
+static void submit_current_buffer(EbAppOutputStream *stream) {
+    APP_MUTEX_LOCK(stream->mutex);
+    ++stream->pending_count;
+    stream->current_index = (stream->current_index + 1) % OUTPUT_WRITE_BUFFER_COUNT;
+    APP_COND_SIGNAL(stream->not_empty);
+    while (stream->pending_count == OUTPUT_WRITE_BUFFER_COUNT)
+        APP_COND_WAIT(stream->not_full, stream->mutex);
+    stream->filled_size[stream->current_index] = 0;
+    APP_MUTEX_UNLOCK(stream->mutex);
+}
+
+EbErrorType app_output_stream_start(EbConfig *config) {
+    EbAppOutputStream *stream = (EbAppOutputStream *)calloc(1, sizeof(EbAppOutputStream));
+    uint32_t           buffer_index;
+
+    if (stream == NULL)
+        return EB_ErrorInsufficientResources;
+
+    stream->file = config->bitstream_file;
+    fflush(stream->file);
+
+    for (buffer_index = 0; buffer_index < OUTPUT_WRITE_BUFFER_COUNT; ++buffer_index) {
+        stream->buffer[buffer_index] = (uint8_t *)aligned_buffer_alloc(OUTPUT_WRITE_BUFFER_SIZE);
+        if (stream->buffer[buffer_index] == NULL) {
+            free_output_stream(stream);
+            return EB_ErrorInsufficientResources;
+        }
+    }
+
+#ifndef _WIN32
+    stream->fd          = fileno(stream->file);
+    stream->file_offset = (uint64_t)lseek(stream->fd, 0, SEEK_CUR);
+    stream->seekable    = (stream->file_offset != (uint64_t)-1);
+    if (!stream->seekable)
+        stream->file_offset = 0;
+#ifdef O_DIRECT
+    // Direct writes need an aligned file offset; the file is freshly truncated
+    if (config->direct_io && stream->seekable && stream->file_offset == 0) {
+        set_direct_io(stream, 1);
+        if (!stream->direct_io)
+            fprintf(config->error_log_file, "Warning: DirectIo is not supported by the output file system\n");
+    }
+#endif
+#else
+    stream->seekable = EB_TRUE;
+#endif
+
+    APP_MUTEX_INIT(stream->mutex);
+    APP_COND_INIT(stream->not_full);
+    APP_COND_INIT(stream->not_empty);
+
+    if (APP_THREAD_CREATE(stream->writer_thread, output_stream_writer, stream)) {
+        APP_COND_DESTROY(stream->not_empty);
+        APP_COND_DESTROY(stream->not_full);
+        APP_MUTEX_DESTROY(stream->mutex);
+        free_output_stream(stream);
+        return EB_ErrorInsufficientResources;
+    }
+
+    config->output_stream = stream;
+
+    return EB_ErrorNone;
+}
+
+void app_output_stream_write(EbConfig *config, const void *data, size_t size) {
+    EbAppOutputStream *stream = (EbAppOutputStream *)config->output_stream;
+    const uint8_t     *src    = (const uint8_t *)data;
+
+    while (size) {
+        const uint32_t index      = stream->current_index;
+        size_t         chunk_size = OUTPUT_WRITE_BUFFER_SIZE - stream->filled_size[index];
+
+        chunk_size = chunk_size < size ? chunk_size : size;
+        memcpy(stream->buffer[index] + stream->filled_size[index], src, chunk_size);
+        stream->filled_size[index] += chunk_size;
+        src += chunk_size;
+        size -= chunk_size;
+
+        if (stream->filled_size[index] == OUTPUT_WRITE_BUFFER_SIZE)
+            submit_current_buffer(stream);
+    }
+}
+
+void app_output_stream_flush(EbConfig *config) {
+    EbAppOutputStream *stream = (EbAppOutputStream *)config->output_stream;
+
+    // Files are only written in full buffers
+    if (!stream->seekable && stream->filled_size[stream->current_index])
+        submit_current_buffer(stream);
+}
+
+void app_output_stream_stop(EbConfig *config) {
+    EbAppOutputStream *stream = (EbAppOutputStream *)config->output_stream;
+
+    if (stream == NULL)
+        return;
+
+    if (stream->filled_size[stream->current_index])
+        submit_current_buffer(stream);
+
+    APP_MUTEX_LOCK(stream->mutex);
+    stream->stop = EB_TRUE;
+    APP_COND_SIGNAL(stream->not_empty);
+    APP_MUTEX_UNLOCK(stream->mutex);
+
+    APP_THREAD_JOIN(stream->writer_thread);
+
+#if !defined(_WIN32) && defined(O_DIRECT)
+    if (stream->direct_io)
+        set_direct_io(stream, 0);
+#endif
+
+    if (stream->write_error)
+        fprintf(config->error_log_file, "Error: Failed to write the output bitstream\n");
+
+    APP_COND_DESTROY(stream->not_empty);
+    APP_COND_DESTROY(stream->not_full);
+    APP_MUTEX_DESTROY(stream->mutex);
+    free_output_stream(stream);
+    config->output_stream = NULL;
+}
+
+void app_output_stream_patch(EbConfig *config, uint64_t offset, const void *data, size_t size) {
+    FILE *file = config->bitstream_file;
+#ifdef _WIN32
+    if (_fseeki64(file, (__int64)offset, SEEK_SET) == 0) {
+        fwrite(data, 1, size, file);
+        _fseeki64(file, 0, SEEK_END);
+    }
+#else
+    // Not seekable outputs (FIFOs) keep the value written originally
+    if (pwrite(fileno(file), data, size, (off_t)offset) != (ssize_t)size && errno != ESPIPE)
+        fprintf(config->error_log_file, "Warning: Could not update the output file header\n");
+#endif
+}
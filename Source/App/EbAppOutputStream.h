@@ -0,0 +1,36 @@
+/*
+* Copyright(c) 2019 Intel Corporation
+* SPDX - License - Identifier: BSD - 2 - Clause - Patent
+*/
+
+#ifndef EbAppOutputStream_h
+#define EbAppOutputStream_h
+
+#include "EbAppConfig.h"
+
+#define OUTPUT_WRITE_BUFFER_SIZE (4 << 20) // multiple of OUTPUT_WRITE_ALIGNMENT
+#define OUTPUT_WRITE_BUFFER_COUNT 4
+#define OUTPUT_WRITE_ALIGNMENT 4096
+
+/********************************
+ * External Function
+ ********************************/
+// Allocates the write buffers and starts the writer thread on the bitstream file
+extern EbErrorType app_output_stream_start(EbConfig *config);
+
+// Appends data to the bitstream. Full buffers are handed to the writer thread,
+// the call only blocks when every buffer is still in flight.
+extern void app_output_stream_write(EbConfig *config, const void *data, size_t size);
+
+// Called after each packet: outputs that cannot be seeked (FIFOs) hand the
+// partially filled buffer to the writer thread so that the reader sees every
+// packet as it is produced, files keep filling the current buffer.
+extern void app_output_stream_flush(EbConfig *config);
+
+// Writes the remaining data and joins the writer thread
+extern void app_output_stream_stop(EbConfig *config);
+
+// Overwrites already written bytes, only valid after app_output_stream_stop()
+extern void app_output_stream_patch(EbConfig *config, uint64_t offset, const void *data, size_t size);
+
+#endif // EbAppOutputStream_h
@@ -9,11 +9,14 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <math.h>
 
 #include "EbAppContext.h"
 #include "EbAppConfig.h"
 #include "EbSvtVp9ErrorCodes.h"
 #include "EbAppTime.h"
+#include "EbAppInputStream.h"
+#include "EbAppOutputStream.h"
 
 /***************************************
  * Macros
@@ -22,8 +25,21 @@
 #define CLIP3(min_val, max_val, a) (((a) < (min_val)) ? (min_val) : (((a) > (max_val)) ? (max_val) : (a)))
 #define FUTURE_WINDOW_WIDTH 4
 #define SIZE_OF_ONE_FRAME_IN_BYTES(width, height, is16bit) ((((width) * (height) * 3) >> 1) << is16bit)
+#define MAX_PSNR 100.0
 extern volatile int keep_running;
 
+/***************************************
+* Convert a sum of squared errors to PSNR
+***************************************/
+double app_sse_to_psnr(double samples, double sse) {
+    if (sse > 0.0) {
+        const double psnr = 10.0 * log10(samples * 255.0 * 255.0 / sse);
+        return psnr > MAX_PSNR ? MAX_PSNR : psnr;
+    } else {
+        return MAX_PSNR;
+    }
+}
+
 /***************************************
 * Process Error Log
 ***************************************/
@@ -79,6 +95,16 @@ static void log_error_output(FILE *error_log_file, uint32_t error_code) {
         fprintf(error_log_file, "Error: PictureDecisionProcess: Picture Decision Reorder Queue overflow\n");
         break;
 
+        // EB_ENC_EC_ERRORS:
+    case EB_ENC_EC_ERROR0:
+        fprintf(error_log_file, "Error: EntropyCodingProcess: The picture does not fit in the entropy coding buffer!\n");
+        break;
+
+        // EB_ENC_PK_ERRORS:
+    case EB_ENC_PK_ERROR0:
+        fprintf(error_log_file, "Error: PacketizationProcess: The frame does not fit in the packetization buffer!\n");
+        break;
+
     default: fprintf(error_log_file, "Error: Others!\n"); break;
     }
 
@@ -370,6 +396,32 @@ void read_input_frames(EbConfig *config, unsigned char is16bit, EbBufferHeaderTy
     return;
 }
 
+//************************************/
+// read_input_stream_frame
+// Points the input buffer to the next
+// frame of the read-ahead ring
+// Output : 0 at the end of the stream
+/************************************/
+static int read_input_stream_frame(EbConfig *config, unsigned char is16bit, EbBufferHeaderType *header_ptr) {
+    EbSvtEncInput *input_ptr = (EbSvtEncInput *)header_ptr->p_buffer;
+    const size_t   luma_size = ((size_t)config->source_width * config->source_height) << is16bit;
+    uint8_t       *frame_ptr = app_input_stream_get_frame(config);
+
+    if (frame_ptr == NULL)
+        return 0;
+
+    input_ptr->y_stride  = config->source_width;
+    input_ptr->cr_stride = config->source_width >> 1;
+    input_ptr->cb_stride = config->source_width >> 1;
+    input_ptr->luma      = frame_ptr;
+    input_ptr->cb        = frame_ptr + luma_size;
+    input_ptr->cr        = frame_ptr + luma_size + (luma_size >> 2);
+
+    header_ptr->n_filled_len = (uint32_t)(luma_size + (luma_size >> 1));
+
+    return 1;
+}
+
 void send_qp_on_the_fly(EbConfig *config, EbBufferHeaderType *header_ptr) {
     {
         uint32_t qp_ptr;
@@ -429,6 +481,18 @@ static void app_svt_vp9_injector(uint64_t processed_frame_count, uint32_t inject
     }
 }
 
+static void send_eos(EbComponentType *component_handle, EbBufferHeaderType *header_ptr) {
+    header_ptr->n_alloc_len   = 0;
+    header_ptr->n_filled_len  = 0;
+    header_ptr->n_tick_count  = 0;
+    header_ptr->p_app_private = NULL;
+    header_ptr->flags         = EB_BUFFERFLAG_EOS;
+    header_ptr->p_buffer      = NULL;
+    header_ptr->pic_type      = EB_INVALID_PICTURE;
+
+    eb_vp9_svt_enc_send_picture(component_handle, header_ptr);
+}
+
 //************************************/
 // process_input_buffer
 // Reads yuv frames from file and copy
@@ -460,7 +524,15 @@ AppExitConditionType process_input_buffer(EbConfig *config, EbAppContext *app_ca
 
     // If there are bytes left to encode, configure the header
     if (remaining_byte_count != 0 && config->stop_encoder == EB_FALSE) {
-        read_input_frames(config, is16bit, header_ptr);
+        if (config->input_stream) {
+            // End of the pipe / Y4M file: only the EOS is left to send
+            if (!read_input_stream_frame(config, is16bit, header_ptr)) {
+                app_input_stream_stop(config);
+                send_eos(component_handle, header_ptr);
+                return APP_ExitConditionFinished;
+            }
+        } else
+            read_input_frames(config, is16bit, header_ptr);
 
         // Update the context parameters
         config->processed_byte_count += header_ptr->n_filled_len;
@@ -484,16 +556,13 @@ AppExitConditionType process_input_buffer(EbConfig *config, EbAppContext *app_ca
         // Send the picture
         eb_vp9_svt_enc_send_picture(component_handle, header_ptr);
 
+        // The library holds its own copy of the picture, the ring slot can be refilled
+        if (config->input_stream)
+            app_input_stream_release_frame(config);
+
         if ((config->processed_frame_count == (uint64_t)config->frames_to_be_encoded) || config->stop_encoder) {
-            header_ptr->n_alloc_len   = 0;
-            header_ptr->n_filled_len  = 0;
-            header_ptr->n_tick_count  = 0;
-            header_ptr->p_app_private = NULL;
-            header_ptr->flags         = EB_BUFFERFLAG_EOS;
-            header_ptr->p_buffer      = NULL;
-            header_ptr->pic_type      = EB_INVALID_PICTURE;
-
-            eb_vp9_svt_enc_send_picture(component_handle, header_ptr);
+            app_input_stream_stop(config);
+            send_eos(component_handle, header_ptr);
         }
 
         return_value = (header_ptr->flags == EB_BUFFERFLAG_EOS) ? APP_ExitConditionFinished : return_value;
@@ -531,11 +600,11 @@ static void write_ivf_stream_header(EbConfig *config) {
         mem_put_le32(header + 20, 1000); // scale
     }
 
-    mem_put_le32(header + 24, 0); // length
+    mem_put_le32(header + 24, 0); // length, patched at the end of the stream
     mem_put_le32(header + 28, 0); // unused
     //config->performance_context.byte_count += 32;
     if (config->bitstream_file)
-        fwrite(header, 1, 32, config->bitstream_file);
+        app_output_stream_write(config, header, 32);
 
     return;
 }
@@ -555,8 +624,52 @@ static void write_ivf_frame_header(EbConfig *config, uint32_t byte_count, uint64
     write_location = write_location + 4;
     //config->performance_context.byte_count += write_location;
 
-    if (config->bitstream_file)
-        fwrite(header, 1, 12, config->bitstream_file);
+    if (config->bitstream_file) {
+        app_output_stream_write(config, header, 12);
+        ++config->ivf_frame_count;
+    }
+}
+
+// Writes the number of frames into the stream header once everything is on disk
+static void finish_ivf_stream(EbConfig *config) {
+    char length[4];
+
+    app_output_stream_stop(config);
+    mem_put_le32(length, (int32_t)config->ivf_frame_count);
+    app_output_stream_patch(config, 24, length, 4);
+}
+
+// Grows the reassembly buffer of the partial packets, returns 0 when it cannot
+static int32_t reserve_partial_frame(EbConfig *config, uint32_t size) {
+    if (size > config->partial_frame_alloc) {
+        uint8_t *partial_frame = (uint8_t *)realloc(config->partial_frame, size);
+
+        if (partial_frame == NULL)
+            return 0;
+        config->partial_frame       = partial_frame;
+        config->partial_frame_alloc = size;
+    }
+    return 1;
+}
+
+/***************************************************
+* Reassemble the frame of the partial packets
+*   the tile data received in partial packets goes
+*   between the headers and the rest of the tile
+*   data of the final packet, at its n_offset
+***************************************************/
+static int32_t assemble_partial_frame(EbConfig *config, const EbBufferHeaderType *header_ptr) {
+    const uint32_t frame_size = config->partial_frame_size + header_ptr->n_filled_len;
+
+    if (!reserve_partial_frame(config, frame_size))
+        return 0;
+    memmove(config->partial_frame + header_ptr->n_offset, config->partial_frame, config->partial_frame_size);
+    memcpy(config->partial_frame, header_ptr->p_buffer, header_ptr->n_offset);
+    memcpy(config->partial_frame + header_ptr->n_offset + config->partial_frame_size,
+           header_ptr->p_buffer + header_ptr->n_offset,
+           header_ptr->n_filled_len - header_ptr->n_offset);
+    config->partial_frame_size = frame_size;
+    return 1;
 }
 
 #define OBU_FRAME_HEADER_SIZE 1
@@ -591,7 +704,45 @@ AppExitConditionType process_output_stream_buffer(EbConfig *config, EbAppContext
         printf("\n");
         log_error_output(config->error_log_file, header_ptr->flags);
         return APP_ExitConditionError;
+    } else if (stream_status != EB_NoErrorEmptyQueue && (header_ptr->flags & EB_BUFFERFLAG_PARTIAL)) {
+        // Keep the tile data until the final packet of the frame
+        if (config->partial_frame_size == 0) {
+            config->performance_context.total_first_byte_latency += header_ptr->n_tick_count;
+            config->performance_context.max_first_byte_latency =
+                (header_ptr->n_tick_count > config->performance_context.max_first_byte_latency)
+                ? header_ptr->n_tick_count
+                : config->performance_context.max_first_byte_latency;
+        }
+        if (!reserve_partial_frame(config, config->partial_frame_size + header_ptr->n_filled_len)) {
+            printf("\nError: cannot allocate the partial packet reassembly buffer\n");
+            eb_vp9_svt_release_out_buffer(&header_ptr);
+            return APP_ExitConditionError;
+        }
+        memcpy(config->partial_frame + config->partial_frame_size, header_ptr->p_buffer, header_ptr->n_filled_len);
+        config->partial_frame_size += header_ptr->n_filled_len;
+
+        eb_vp9_svt_release_out_buffer(&header_ptr);
     } else if (stream_status != EB_NoErrorEmptyQueue) {
+        uint8_t *frame_buffer = header_ptr->p_buffer;
+        uint32_t frame_size   = header_ptr->n_filled_len;
+
+        if (config->partial_frame_size) {
+            if (!assemble_partial_frame(config, header_ptr)) {
+                printf("\nError: cannot allocate the partial packet reassembly buffer\n");
+                eb_vp9_svt_release_out_buffer(&header_ptr);
+                return APP_ExitConditionError;
+            }
+            frame_buffer               = config->partial_frame;
+            frame_size                 = config->partial_frame_size;
+            config->partial_frame_size = 0;
+        } else {
+            config->performance_context.total_first_byte_latency += header_ptr->n_tick_count;
+            config->performance_context.max_first_byte_latency =
+                (header_ptr->n_tick_count > config->performance_context.max_first_byte_latency)
+                ? header_ptr->n_tick_count
+                : config->performance_context.max_first_byte_latency;
+        }
+
         ++(config->performance_context.frame_count);
         *total_latency += header_ptr->n_tick_count;
         *max_latency = (header_ptr->n_tick_count > *max_latency) ? header_ptr->n_tick_count : *max_latency;
@@ -619,35 +770,51 @@ AppExitConditionType process_output_stream_buffer(EbConfig *config, EbAppContext
             }
 
             if (header_ptr->flags & EB_BUFFERFLAG_SHOW_EXT) {
-                write_ivf_frame_header(config, header_ptr->n_filled_len - (OBU_FRAME_HEADER_SIZE * 4), header_ptr->pts);
-                fwrite(header_ptr->p_buffer, 1, header_ptr->n_filled_len - (OBU_FRAME_HEADER_SIZE * 4), stream_file);
+                write_ivf_frame_header(config, frame_size - (OBU_FRAME_HEADER_SIZE * 4), header_ptr->pts);
+                app_output_stream_write(config, frame_buffer, frame_size - (OBU_FRAME_HEADER_SIZE * 4));
                 // 4 frame headers with an IVF frame header for each
                 write_ivf_frame_header(config, OBU_FRAME_HEADER_SIZE, header_ptr->pts - 2);
-                fwrite(header_ptr->p_buffer + header_ptr->n_filled_len - (OBU_FRAME_HEADER_SIZE * 4),
-                       1,
-                       OBU_FRAME_HEADER_SIZE,
-                       stream_file);
+                app_output_stream_write(config,
+                                        frame_buffer + frame_size - (OBU_FRAME_HEADER_SIZE * 4),
+                                        OBU_FRAME_HEADER_SIZE);
                 write_ivf_frame_header(config, OBU_FRAME_HEADER_SIZE, header_ptr->pts - 1);
-                fwrite(header_ptr->p_buffer + header_ptr->n_filled_len - (OBU_FRAME_HEADER_SIZE * 3),
-                       1,
-                       OBU_FRAME_HEADER_SIZE,
-                       stream_file);
+                app_output_stream_write(config,
+                                        frame_buffer + frame_size - (OBU_FRAME_HEADER_SIZE * 3),
+                                        OBU_FRAME_HEADER_SIZE);
                 write_ivf_frame_header(config, OBU_FRAME_HEADER_SIZE, header_ptr->pts);
-                fwrite(header_ptr->p_buffer + header_ptr->n_filled_len - (OBU_FRAME_HEADER_SIZE * 2),
-                       1,
-                       OBU_FRAME_HEADER_SIZE,
-                       stream_file);
+                app_output_stream_write(config,
+                                        frame_buffer + frame_size - (OBU_FRAME_HEADER_SIZE * 2),
+                                        OBU_FRAME_HEADER_SIZE);
                 write_ivf_frame_header(config, OBU_FRAME_HEADER_SIZE, header_ptr->pts + 1);
-                fwrite(header_ptr->p_buffer + header_ptr->n_filled_len - OBU_FRAME_HEADER_SIZE,
-                       1,
-                       OBU_FRAME_HEADER_SIZE,
-                       stream_file);
+                app_output_stream_write(
+                    config, frame_buffer + frame_size - OBU_FRAME_HEADER_SIZE, OBU_FRAME_HEADER_SIZE);
             } else {
-                write_ivf_frame_header(config, header_ptr->n_filled_len, header_ptr->pts);
-                fwrite(header_ptr->p_buffer, 1, header_ptr->n_filled_len, stream_file);
+                write_ivf_frame_header(config, frame_size, header_ptr->pts);
+                app_output_stream_write(config, frame_buffer, frame_size);
             }
+
+            if (header_ptr->flags & EB_BUFFERFLAG_EOS)
+                finish_ivf_stream(config);
+            else
+                app_output_stream_flush(config);
+        }
+        config->performance_context.byte_count += frame_size;
+
+        // Quality statistics
+        if (config->stat_report) {
+            const double luma_samples   = (double)config->source_width * config->source_height;
+            const double chroma_samples = (double)(config->source_width >> 1) * (config->source_height >> 1);
+
+            config->performance_context.luma_sse += header_ptr->luma_sse;
+            config->performance_context.cb_sse += header_ptr->cb_sse;
+            config->performance_context.cr_sse += header_ptr->cr_sse;
+            config->performance_context.luma_psnr += app_sse_to_psnr(luma_samples, (double)header_ptr->luma_sse);
+            config->performance_context.cb_psnr += app_sse_to_psnr(chroma_samples, (double)header_ptr->cb_sse);
+            config->performance_context.cr_psnr += app_sse_to_psnr(chroma_samples, (double)header_ptr->cr_sse);
+            config->performance_context.luma_ssim += header_ptr->luma_ssim;
+            config->performance_context.cb_ssim += header_ptr->cb_ssim;
+            config->performance_context.cr_ssim += header_ptr->cr_ssim;
         }
-        config->performance_context.byte_count += header_ptr->n_filled_len;
 
         // Update Output Port Activity State
         *port_state  = (header_ptr->flags & EB_BUFFERFLAG_EOS) ? APP_PortInactive : *port_state;
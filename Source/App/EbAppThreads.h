@@ -0,0 +1,51 @@
+/*
+* Copyright(c) 2019 Intel Corporation
+* SPDX - License - Identifier: BSD - 2 - Clause - Patent
+*/
+
+#ifndef EbAppThreads_h
+#define EbAppThreads_h
+
+// Minimal portable mutex / condition variable / thread wrappers used by the
+// App helper threads (input read-ahead, bitstream writer)
+#ifdef _WIN32
+#include <windows.h>
+typedef CRITICAL_SECTION   AppMutex;
+typedef CONDITION_VARIABLE AppCond;
+typedef HANDLE             AppThread;
+#define APP_THREAD_RETURN_TYPE DWORD WINAPI
+#define APP_THREAD_ARG_TYPE LPVOID
+#define APP_MUTEX_INIT(m) InitializeCriticalSection(&(m))
+#define APP_MUTEX_DESTROY(m) DeleteCriticalSection(&(m))
+#define APP_MUTEX_LOCK(m) EnterCriticalSection(&(m))
+#define APP_MUTEX_UNLOCK(m) LeaveCriticalSection(&(m))
+#define APP_COND_INIT(c) InitializeConditionVariable(&(c))
+#define APP_COND_DESTROY(c)
+#define APP_COND_WAIT(c, m) SleepConditionVariableCS(&(c), &(m), INFINITE)
+#define APP_COND_SIGNAL(c) WakeConditionVariable(&(c))
+#define APP_THREAD_CREATE(t, f, a) (((t) = CreateThread(NULL, 0, f, a, 0, NULL)) == NULL)
+#define APP_THREAD_JOIN(t)                \
+    do {                                  \
+        WaitForSingleObject(t, INFINITE); \
+        CloseHandle(t);                   \
+    } while (0)
+#else
+#include <pthread.h>
+typedef pthread_mutex_t AppMutex;
+typedef pthread_cond_t  AppCond;
+typedef pthread_t       AppThread;
+#define APP_THREAD_RETURN_TYPE void *
+#define APP_THREAD_ARG_TYPE void *
+#define APP_MUTEX_INIT(m) pthread_mutex_init(&(m), NULL)
+#define APP_MUTEX_DESTROY(m) pthread_mutex_destroy(&(m))
+#define APP_MUTEX_LOCK(m) pthread_mutex_lock(&(m))
+#define APP_MUTEX_UNLOCK(m) pthread_mutex_unlock(&(m))
+#define APP_COND_INIT(c) pthread_cond_init(&(c), NULL)
+#define APP_COND_DESTROY(c) pthread_cond_destroy(&(c))
+#define APP_COND_WAIT(c, m) pthread_cond_wait(&(c), &(m))
+#define APP_COND_SIGNAL(c) pthread_cond_signal(&(c))
+#define APP_THREAD_CREATE(t, f, a) (pthread_create(&(t), NULL, f, a) != 0)
+#define APP_THREAD_JOIN(t) pthread_join(t, NULL)
+#endif
+
+#endif // EbAppThreads_h
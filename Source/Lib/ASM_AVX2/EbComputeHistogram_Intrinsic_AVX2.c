@@ -0,0 +1,84 @@
+/*
+* Copyright(c) 2019 Intel Corporation
+* SPDX - License - Identifier: BSD - 2 - Clause - Patent
+*/
+
+#include <string.h>
+
+#include "immintrin.h"
+#include "EbComputeHistogram_AVX2.h"
+
+#define HISTOGRAM_SUB_COUNT 4 // interleaved sub-histograms, so that runs of equal samples do not serialize on one bin
+
+/*******************************************
+* eb_vp9_calculate_histogram_avx2_intrin
+*  every sample of the input area, 32 samples
+*  per iteration; consecutive samples are
+*  counted in different sub-histograms which
+*  are added to the output histogram at the end
+*******************************************/
+void eb_vp9_calculate_histogram_avx2_intrin(uint8_t *input_samples, uint32_t input_area_width,
+                                            uint32_t input_area_height, uint32_t stride, uint8_t decim_step,
+                                            uint32_t *histogram, uint64_t *sum) {
+    EB_ALIGN(32) uint32_t sub_histogram[HISTOGRAM_SUB_COUNT][256];
+    EB_ALIGN(32) uint8_t  samples[32];
+    const __m256i         zero     = _mm256_setzero_si256();
+    __m256i               sum_256  = _mm256_setzero_si256();
+    uint64_t              sum_tail = 0;
+    uint64_t              sum_simd[4];
+    uint32_t              horizontal_index;
+    uint32_t              vertical_index;
+    uint32_t              sample_index;
+    uint32_t              bin;
+
+    (void)decim_step;
+
+    memset(sub_histogram, 0, sizeof(sub_histogram));
+
+    for (vertical_index = 0; vertical_index < input_area_height; vertical_index++) {
+        for (horizontal_index = 0; horizontal_index + 32 <= input_area_width; horizontal_index += 32) {
+            const __m256i s = _mm256_loadu_si256((const __m256i *)(input_samples + horizontal_index));
+
+            sum_256 = _mm256_add_epi64(sum_256, _mm256_sad_epu8(s, zero));
+            _mm256_store_si256((__m256i *)samples, s);
+
+            for (sample_index = 0; sample_index < 32; sample_index += HISTOGRAM_SUB_COUNT) {
+                ++sub_histogram[0][samples[sample_index + 0]];
+                ++sub_histogram[1][samples[sample_index + 1]];
+                ++sub_histogram[2][samples[sample_index + 2]];
+                ++sub_histogram[3][samples[sample_index + 3]];
+            }
+        }
+        if (horizontal_index + 16 <= input_area_width) {
+            const __m128i s = _mm_loadu_si128((const __m128i *)(input_samples + horizontal_index));
+
+            sum_256 = _mm256_add_epi64(sum_256, _mm256_castsi128_si256(_mm_sad_epu8(s, _mm_setzero_si128())));
+            _mm_store_si128((__m128i *)samples, s);
+
+            for (sample_index = 0; sample_index < 16; sample_index += HISTOGRAM_SUB_COUNT) {
+                ++sub_histogram[0][samples[sample_index + 0]];
+                ++sub_histogram[1][samples[sample_index + 1]];
+                ++sub_histogram[2][samples[sample_index + 2]];
+                ++sub_histogram[3][samples[sample_index + 3]];
+            }
+            horizontal_index += 16;
+        }
+        for (; horizontal_index < input_area_width; horizontal_index++) {
+            ++sub_histogram[horizontal_index & (HISTOGRAM_SUB_COUNT - 1)][input_samples[horizontal_index]];
+            sum_tail += input_samples[horizontal_index];
+        }
+        input_samples += stride;
+    }
+
+    for (bin = 0; bin < 256; bin += 8) {
+        __m256i h = _mm256_loadu_si256((const __m256i *)(histogram + bin));
+        h         = _mm256_add_epi32(h, _mm256_load_si256((const __m256i *)(sub_histogram[0] + bin)));
+        h         = _mm256_add_epi32(h, _mm256_load_si256((const __m256i *)(sub_histogram[1] + bin)));
+        h         = _mm256_add_epi32(h, _mm256_load_si256((const __m256i *)(sub_histogram[2] + bin)));
+        h         = _mm256_add_epi32(h, _mm256_load_si256((const __m256i *)(sub_histogram[3] + bin)));
+        _mm256_storeu_si256((__m256i *)(histogram + bin), h);
+    }
+
+    _mm256_storeu_si256((__m256i *)sum_simd, sum_256);
+    *sum = sum_simd[0] + sum_simd[1] + sum_simd[2] + sum_simd[3] + sum_tail;
+}
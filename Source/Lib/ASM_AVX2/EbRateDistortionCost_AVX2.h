@@ -0,0 +1,20 @@
+/*
+* Copyright(c) 2019 Intel Corporation
+* SPDX - License - Identifier: BSD - 2 - Clause - Patent
+*/
+
+#ifndef EbRateDistortionCost_AVX2_h
+#define EbRateDistortionCost_AVX2_h
+
+#include "EbDefinitions.h"
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+int eb_vp9_coeff_tokenize_avx2_intrin(const int16_t *qcoeff, const int16_t *scan, int eob,
+                                      const uint16_t *cat6_high_cost, uint8_t *tokens);
+
+#ifdef __cplusplus
+}
+#endif
+#endif // EbRateDistortionCost_AVX2_h
@@ -0,0 +1,84 @@
+/*
+* Copyright(c) 2019 Intel Corporation
+* SPDX - License - Identifier: BSD - 2 - Clause - Patent
+*/
+
+#include "immintrin.h"
+#include "EbRateDistortionCost_AVX2.h"
+#include "vp9_tokenize.h"
+
+/*******************************************
+* eb_vp9_coeff_tokenize_avx2_intrin
+*  8 coeffs per iteration: gather in scan order,
+*  token classification on the magnitude and
+*  value cost lookup, CATEGORY6 coeffs (rare)
+*  are costed in C
+*******************************************/
+int eb_vp9_coeff_tokenize_avx2_intrin(const int16_t *qcoeff, const int16_t *scan, int eob,
+                                      const uint16_t *cat6_high_cost, uint8_t *tokens) {
+    // Largest magnitude of FOUR_TOKEN .. CATEGORY5_TOKEN
+    const __m256i four_max  = _mm256_set1_epi32(4);
+    const __m256i cat1_max  = _mm256_set1_epi32(6);
+    const __m256i cat2_max  = _mm256_set1_epi32(10);
+    const __m256i cat3_max  = _mm256_set1_epi32(18);
+    const __m256i cat4_max  = _mm256_set1_epi32(34);
+    const __m256i cat5_max  = _mm256_set1_epi32(CAT6_MIN_VAL - 1);
+    const __m128i pack_shuf = _mm_setr_epi8(0, 4, 8, 12, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1);
+    __m256i       cost_sum  = _mm256_setzero_si256();
+    int16_t       token;
+    int           cost;
+    int           c;
+
+    // DC (scan[0] is 0 for every scan order)
+    cost      = vp9_get_token_cost(qcoeff[0], &token, cat6_high_cost);
+    tokens[0] = (uint8_t)token;
+
+    for (c = 1; c + 8 <= eob; c += 8) {
+        const __m256i rc = _mm256_cvtepi16_epi32(_mm_loadu_si128((const __m128i *)(scan + c)));
+
+        // rc >= 1 past the DC: the 32-bit gather @ rc - 1 stays within the block and holds qcoeff[rc] in its high half
+        __m256i v = _mm256_i32gather_epi32((const int *)(qcoeff - 1), rc, 2);
+        v         = _mm256_abs_epi32(_mm256_srai_epi32(v, 16));
+
+        const __m256i cat6 = _mm256_cmpgt_epi32(v, cat5_max);
+
+        // ZERO_TOKEN .. FOUR_TOKEN are the magnitude, each category above adds one (compares give -1)
+        __m256i tok = _mm256_min_epi32(v, four_max);
+        tok         = _mm256_sub_epi32(tok, _mm256_cmpgt_epi32(v, four_max));
+        tok         = _mm256_sub_epi32(tok, _mm256_cmpgt_epi32(v, cat1_max));
+        tok         = _mm256_sub_epi32(tok, _mm256_cmpgt_epi32(v, cat2_max));
+        tok         = _mm256_sub_epi32(tok, _mm256_cmpgt_epi32(v, cat3_max));
+        tok         = _mm256_sub_epi32(tok, _mm256_cmpgt_epi32(v, cat4_max));
+        tok         = _mm256_sub_epi32(tok, cat6);
+
+        // The value costs are symmetric
+        const __m256i val_cost = _mm256_i32gather_epi32(
+            eb_vp9_dct_cat_lt_10_value_cost, _mm256_min_epi32(v, cat5_max), 4);
+        cost_sum = _mm256_add_epi32(cost_sum, _mm256_andnot_si256(cat6, val_cost));
+
+        // 8 tokens as bytes
+        const __m128i tok_lo = _mm_shuffle_epi8(_mm256_castsi256_si128(tok), pack_shuf);
+        const __m128i tok_hi = _mm_shuffle_epi8(_mm256_extracti128_si256(tok, 1), pack_shuf);
+        _mm_storel_epi64((__m128i *)(tokens + c), _mm_unpacklo_epi32(tok_lo, tok_hi));
+
+        const int cat6_mask = _mm256_movemask_ps(_mm256_castsi256_ps(cat6));
+        if (cat6_mask) {
+            for (int lane = 0; lane < 8; lane++) {
+                if (cat6_mask & (1 << lane))
+                    cost += vp9_get_token_cost(qcoeff[scan[c + lane]], &token, cat6_high_cost);
+            }
+        }
+    }
+
+    for (; c < eob; c++) {
+        cost += vp9_get_token_cost(qcoeff[scan[c]], &token, cat6_high_cost);
+        tokens[c] = (uint8_t)token;
+    }
+
+    // Horizontal sum
+    __m128i sum = _mm_add_epi32(_mm256_castsi256_si128(cost_sum), _mm256_extracti128_si256(cost_sum, 1));
+    sum         = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, 0x4E));
+    sum         = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, 0xB1));
+
+    return cost + _mm_cvtsi128_si32(sum);
+}
@@ -0,0 +1,22 @@
+/*
+* Copyright(c) 2019 Intel Corporation
+* SPDX - License - Identifier: BSD - 2 - Clause - Patent
+*/
+
+#ifndef EbTemporalFiltering_AVX2_h
+#define EbTemporalFiltering_AVX2_h
+
+#include "EbDefinitions.h"
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void eb_vp9_temporal_filter_apply_avx2_intrin(const uint8_t *src, uint32_t src_stride, const uint8_t *pred,
+                                              uint32_t pred_stride, uint32_t block_width, uint32_t block_height,
+                                              int32_t strength, int32_t filter_weight, uint32_t *accumulator,
+                                              uint16_t *count);
+
+#ifdef __cplusplus
+}
+#endif
+#endif // EbTemporalFiltering_AVX2_h
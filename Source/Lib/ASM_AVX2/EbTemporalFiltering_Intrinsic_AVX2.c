@@ -0,0 +1,55 @@
+/*
+* Copyright(c) 2019 Intel Corporation
+* SPDX - License - Identifier: BSD - 2 - Clause - Patent
+*/
+
+#include "immintrin.h"
+#include "EbTemporalFiltering_AVX2.h"
+#include "EbTemporalFiltering_SSE2.h"
+
+/*******************************************
+* eb_vp9_temporal_filter_apply_avx2_intrin
+*  16 samples per iteration, block_width has
+*  to be a multiple of 16
+*******************************************/
+void eb_vp9_temporal_filter_apply_avx2_intrin(const uint8_t *src, uint32_t src_stride, const uint8_t *pred,
+                                              uint32_t pred_stride, uint32_t block_width, uint32_t block_height,
+                                              int32_t strength, int32_t filter_weight, uint32_t *accumulator,
+                                              uint16_t *count) {
+    const __m128i diff_max = _mm_set1_epi8((char)TEMPORAL_FILTER_DIFF_MAX);
+    const __m256i sixteen  = _mm256_set1_epi16(16);
+    const __m256i rounding = _mm256_set1_epi16(strength > 0 ? (int16_t)(1 << (strength - 1)) : 0);
+    const __m128i shift    = _mm_cvtsi32_si128(strength);
+    const __m256i weight   = _mm256_set1_epi16((int16_t)filter_weight);
+
+    for (uint32_t i = 0; i < block_height; i++) {
+        for (uint32_t j = 0; j < block_width; j += 16) {
+            const __m128i s = _mm_loadu_si128((const __m128i *)(src + j));
+            const __m128i p = _mm_loadu_si128((const __m128i *)(pred + j));
+            __m256i       diff, modifier, weighted;
+
+            diff = _mm256_cvtepu8_epi16(_mm_min_epu8(_mm_or_si128(_mm_subs_epu8(s, p), _mm_subs_epu8(p, s)), diff_max));
+
+            modifier = _mm256_mullo_epi16(diff, diff);
+            modifier = _mm256_add_epi16(_mm256_add_epi16(modifier, modifier), modifier);
+            modifier = _mm256_srl_epi16(_mm256_add_epi16(modifier, rounding), shift);
+            modifier = _mm256_min_epu16(modifier, sixteen);
+            modifier = _mm256_mullo_epi16(_mm256_sub_epi16(sixteen, modifier), weight);
+
+            _mm256_storeu_si256((__m256i *)(count + j),
+                                _mm256_add_epi16(_mm256_loadu_si256((const __m256i *)(count + j)), modifier));
+
+            weighted = _mm256_mullo_epi16(modifier, _mm256_cvtepu8_epi16(p));
+            _mm256_storeu_si256((__m256i *)(accumulator + j),
+                                _mm256_add_epi32(_mm256_loadu_si256((const __m256i *)(accumulator + j)),
+                                                 _mm256_cvtepu16_epi32(_mm256_castsi256_si128(weighted))));
+            _mm256_storeu_si256((__m256i *)(accumulator + j + 8),
+                                _mm256_add_epi32(_mm256_loadu_si256((const __m256i *)(accumulator + j + 8)),
+                                                 _mm256_cvtepu16_epi32(_mm256_extracti128_si256(weighted, 1))));
+        }
+        src += src_stride;
+        pred += pred_stride;
+        count += block_width;
+        accumulator += block_width;
+    }
+}
@@ -0,0 +1,51 @@
+/*
+* Copyright(c) 2019 Intel Corporation
+* SPDX - License - Identifier: BSD - 2 - Clause - Patent
+*/
+
+#include "emmintrin.h"
+#include "EbComputeHistogram_SSE2.h"
+
+/*******************************************
+* eb_vp9_calculate_histogram_decim4_sse2_intrin
+*  one sample every 4 in both directions, the
+*  4 samples of a 16-byte load are isolated
+*  with a dword mask so that a single SAD
+*  gives their sum
+*******************************************/
+void eb_vp9_calculate_histogram_decim4_sse2_intrin(uint8_t *input_samples, uint32_t input_area_width,
+                                                   uint32_t input_area_height, uint32_t stride, uint8_t decim_step,
+                                                   uint32_t *histogram, uint64_t *sum) {
+    const __m128i zero        = _mm_setzero_si128();
+    const __m128i sample_mask = _mm_set1_epi32(0xFF);
+    __m128i       sum_128     = _mm_setzero_si128();
+    uint64_t      sum_tail    = 0;
+    uint64_t      sum_simd;
+    uint32_t      horizontal_index;
+    uint32_t      vertical_index;
+
+    (void)decim_step;
+
+    for (vertical_index = 0; vertical_index < input_area_height; vertical_index += 4) {
+        for (horizontal_index = 0; horizontal_index + 16 <= input_area_width; horizontal_index += 16) {
+            const __m128i samples = _mm_and_si128(
+                _mm_loadu_si128((const __m128i *)(input_samples + horizontal_index)), sample_mask);
+
+            sum_128 = _mm_add_epi64(sum_128, _mm_sad_epu8(samples, zero));
+
+            ++histogram[_mm_cvtsi128_si32(samples)];
+            ++histogram[_mm_cvtsi128_si32(_mm_srli_si128(samples, 4))];
+            ++histogram[_mm_cvtsi128_si32(_mm_srli_si128(samples, 8))];
+            ++histogram[_mm_cvtsi128_si32(_mm_srli_si128(samples, 12))];
+        }
+        for (; horizontal_index < input_area_width; horizontal_index += 4) {
+            ++histogram[input_samples[horizontal_index]];
+            sum_tail += input_samples[horizontal_index];
+        }
+        input_samples += (stride << 2);
+    }
+
+    sum_128 = _mm_add_epi64(sum_128, _mm_srli_si128(sum_128, 8));
+    _mm_storel_epi64((__m128i *)&sum_simd, sum_128);
+    *sum = sum_simd + sum_tail;
+}
@@ -0,0 +1,21 @@
+/*
+* Copyright(c) 2019 Intel Corporation
+* SPDX - License - Identifier: BSD - 2 - Clause - Patent
+*/
+
+#ifndef EbComputeHistogram_SSE2_h
+#define EbComputeHistogram_SSE2_h
+
+#include "EbDefinitions.h"
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void eb_vp9_calculate_histogram_decim4_sse2_intrin(uint8_t *input_samples, uint32_t input_area_width,
+                                                   uint32_t input_area_height, uint32_t stride, uint8_t decim_step,
+                                                   uint32_t *histogram, uint64_t *sum);
+
+#ifdef __cplusplus
+}
+#endif
+#endif // EbComputeHistogram_SSE2_h
@@ -0,0 +1,62 @@
+/*
+* Copyright(c) 2019 Intel Corporation
+* SPDX - License - Identifier: BSD - 2 - Clause - Patent
+*/
+
+#include "emmintrin.h"
+#include "EbComputeSsim_SSE2.h"
+
+/*******************************************
+* eb_vp9_ssim_parms_8x8_sse2_intrin
+*  two rows per iteration, the source and
+*  recon sums are taken with a SAD against
+*  zero, the squares and the products with
+*  a multiply-add of the widened samples
+*******************************************/
+void eb_vp9_ssim_parms_8x8_sse2_intrin(const uint8_t *source, uint32_t source_stride, const uint8_t *recon,
+                                       uint32_t recon_stride, uint32_t *sum_s, uint32_t *sum_r, uint32_t *sum_sq_s,
+                                       uint32_t *sum_sq_r, uint32_t *sum_sxr) {
+    const __m128i zero      = _mm_setzero_si128();
+    __m128i       sum_s_128 = _mm_setzero_si128();
+    __m128i       sum_r_128 = _mm_setzero_si128();
+    __m128i       sq_s_128  = _mm_setzero_si128();
+    __m128i       sq_r_128  = _mm_setzero_si128();
+    __m128i       sxr_128   = _mm_setzero_si128();
+    uint32_t      vertical_index;
+
+    for (vertical_index = 0; vertical_index < 8; vertical_index += 2) {
+        const __m128i s = _mm_unpacklo_epi64(_mm_loadl_epi64((const __m128i *)source),
+                                             _mm_loadl_epi64((const __m128i *)(source + source_stride)));
+        const __m128i r = _mm_unpacklo_epi64(_mm_loadl_epi64((const __m128i *)recon),
+                                             _mm_loadl_epi64((const __m128i *)(recon + recon_stride)));
+        const __m128i s_lo = _mm_unpacklo_epi8(s, zero);
+        const __m128i s_hi = _mm_unpackhi_epi8(s, zero);
+        const __m128i r_lo = _mm_unpacklo_epi8(r, zero);
+        const __m128i r_hi = _mm_unpackhi_epi8(r, zero);
+
+        sum_s_128 = _mm_add_epi32(sum_s_128, _mm_sad_epu8(s, zero));
+        sum_r_128 = _mm_add_epi32(sum_r_128, _mm_sad_epu8(r, zero));
+        sq_s_128  = _mm_add_epi32(sq_s_128, _mm_add_epi32(_mm_madd_epi16(s_lo, s_lo), _mm_madd_epi16(s_hi, s_hi)));
+        sq_r_128  = _mm_add_epi32(sq_r_128, _mm_add_epi32(_mm_madd_epi16(r_lo, r_lo), _mm_madd_epi16(r_hi, r_hi)));
+        sxr_128   = _mm_add_epi32(sxr_128, _mm_add_epi32(_mm_madd_epi16(s_lo, r_lo), _mm_madd_epi16(s_hi, r_hi)));
+
+        source += source_stride << 1;
+        recon += recon_stride << 1;
+    }
+
+    // The SAD sums are in the low dword of each qword, the others in the 4 dwords
+    sum_s_128 = _mm_add_epi32(sum_s_128, _mm_srli_si128(sum_s_128, 8));
+    sum_r_128 = _mm_add_epi32(sum_r_128, _mm_srli_si128(sum_r_128, 8));
+    sq_s_128  = _mm_add_epi32(sq_s_128, _mm_srli_si128(sq_s_128, 8));
+    sq_s_128  = _mm_add_epi32(sq_s_128, _mm_srli_si128(sq_s_128, 4));
+    sq_r_128  = _mm_add_epi32(sq_r_128, _mm_srli_si128(sq_r_128, 8));
+    sq_r_128  = _mm_add_epi32(sq_r_128, _mm_srli_si128(sq_r_128, 4));
+    sxr_128   = _mm_add_epi32(sxr_128, _mm_srli_si128(sxr_128, 8));
+    sxr_128   = _mm_add_epi32(sxr_128, _mm_srli_si128(sxr_128, 4));
+
+    *sum_s    = (uint32_t)_mm_cvtsi128_si32(sum_s_128);
+    *sum_r    = (uint32_t)_mm_cvtsi128_si32(sum_r_128);
+    *sum_sq_s = (uint32_t)_mm_cvtsi128_si32(sq_s_128);
+    *sum_sq_r = (uint32_t)_mm_cvtsi128_si32(sq_r_128);
+    *sum_sxr  = (uint32_t)_mm_cvtsi128_si32(sxr_128);
+}
@@ -0,0 +1,21 @@
+/*
+* Copyright(c) 2019 Intel Corporation
+* SPDX - License - Identifier: BSD - 2 - Clause - Patent
+*/
+
+#ifndef EbComputeSsim_SSE2_h
+#define EbComputeSsim_SSE2_h
+
+#include "EbDefinitions.h"
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void eb_vp9_ssim_parms_8x8_sse2_intrin(const uint8_t *source, uint32_t source_stride, const uint8_t *recon,
+                                       uint32_t recon_stride, uint32_t *sum_s, uint32_t *sum_r, uint32_t *sum_sq_s,
+                                       uint32_t *sum_sq_r, uint32_t *sum_sxr);
+
+#ifdef __cplusplus
+}
+#endif
+#endif // EbComputeSsim_SSE2_h
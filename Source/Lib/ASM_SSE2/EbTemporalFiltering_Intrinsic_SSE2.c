@@ -0,0 +1,56 @@
+/*
+* Copyright(c) 2019 Intel Corporation
+* SPDX - License - Identifier: BSD - 2 - Clause - Patent
+*/
+
+#include "emmintrin.h"
+#include "EbTemporalFiltering_SSE2.h"
+
+/*******************************************
+* eb_vp9_temporal_filter_apply_sse2_intrin
+*  8 samples per iteration, block_width has
+*  to be a multiple of 8
+*******************************************/
+void eb_vp9_temporal_filter_apply_sse2_intrin(const uint8_t *src, uint32_t src_stride, const uint8_t *pred,
+                                              uint32_t pred_stride, uint32_t block_width, uint32_t block_height,
+                                              int32_t strength, int32_t filter_weight, uint32_t *accumulator,
+                                              uint16_t *count) {
+    const __m128i zero     = _mm_setzero_si128();
+    const __m128i diff_max = _mm_set1_epi8((char)TEMPORAL_FILTER_DIFF_MAX);
+    const __m128i sixteen  = _mm_set1_epi16(16);
+    const __m128i rounding = _mm_set1_epi16(strength > 0 ? (int16_t)(1 << (strength - 1)) : 0);
+    const __m128i shift    = _mm_cvtsi32_si128(strength);
+    const __m128i weight   = _mm_set1_epi16((int16_t)filter_weight);
+
+    for (uint32_t i = 0; i < block_height; i++) {
+        for (uint32_t j = 0; j < block_width; j += 8) {
+            const __m128i s = _mm_loadl_epi64((const __m128i *)(src + j));
+            const __m128i p = _mm_loadl_epi64((const __m128i *)(pred + j));
+            __m128i       diff, modifier, weighted;
+
+            diff = _mm_or_si128(_mm_subs_epu8(s, p), _mm_subs_epu8(p, s));
+            diff = _mm_unpacklo_epi8(_mm_min_epu8(diff, diff_max), zero);
+
+            modifier = _mm_mullo_epi16(diff, diff);
+            modifier = _mm_add_epi16(_mm_add_epi16(modifier, modifier), modifier);
+            modifier = _mm_srl_epi16(_mm_add_epi16(modifier, rounding), shift);
+            modifier = _mm_sub_epi16(modifier, _mm_subs_epu16(modifier, sixteen)); // min(modifier, 16)
+            modifier = _mm_mullo_epi16(_mm_sub_epi16(sixteen, modifier), weight);
+
+            _mm_storeu_si128((__m128i *)(count + j),
+                             _mm_add_epi16(_mm_loadu_si128((const __m128i *)(count + j)), modifier));
+
+            weighted = _mm_mullo_epi16(modifier, _mm_unpacklo_epi8(p, zero));
+            _mm_storeu_si128(
+                (__m128i *)(accumulator + j),
+                _mm_add_epi32(_mm_loadu_si128((const __m128i *)(accumulator + j)), _mm_unpacklo_epi16(weighted, zero)));
+            _mm_storeu_si128((__m128i *)(accumulator + j + 4),
+                             _mm_add_epi32(_mm_loadu_si128((const __m128i *)(accumulator + j + 4)),
+                                           _mm_unpackhi_epi16(weighted, zero)));
+        }
+        src += src_stride;
+        pred += pred_stride;
+        count += block_width;
+        accumulator += block_width;
+    }
+}
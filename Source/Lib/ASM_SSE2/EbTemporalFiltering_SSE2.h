@@ -0,0 +1,26 @@
+/*
+* Copyright(c) 2019 Intel Corporation
+* SPDX - License - Identifier: BSD - 2 - Clause - Patent
+*/
+
+#ifndef EbTemporalFiltering_SSE2_h
+#define EbTemporalFiltering_SSE2_h
+
+#include "EbDefinitions.h"
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Differences above this value saturate the modifier for any strength in [0, 6], clipping them keeps
+// 3 * diff^2 + rounding within 16 bits
+#define TEMPORAL_FILTER_DIFF_MAX 147
+
+void eb_vp9_temporal_filter_apply_sse2_intrin(const uint8_t *src, uint32_t src_stride, const uint8_t *pred,
+                                              uint32_t pred_stride, uint32_t block_width, uint32_t block_height,
+                                              int32_t strength, int32_t filter_weight, uint32_t *accumulator,
+                                              uint16_t *count);
+
+#ifdef __cplusplus
+}
+#endif
+#endif // EbTemporalFiltering_SSE2_h
@@ -0,0 +1,23 @@
+/*
+* Copyright(c) 2019 Intel Corporation
+* SPDX - License - Identifier: BSD - 2 - Clause - Patent
+*/
+
+#include "EbComputeHistogram_C.h"
+
+void eb_vp9_calculate_histogram(uint8_t *input_samples, uint32_t input_area_width, uint32_t input_area_height,
+                                uint32_t stride, uint8_t decim_step, uint32_t *histogram, uint64_t *sum) {
+    uint32_t horizontal_index;
+    uint32_t vertical_index;
+    *sum = 0;
+
+    for (vertical_index = 0; vertical_index < input_area_height; vertical_index += decim_step) {
+        for (horizontal_index = 0; horizontal_index < input_area_width; horizontal_index += decim_step) {
+            ++(histogram[input_samples[horizontal_index]]);
+            *sum += input_samples[horizontal_index];
+        }
+        input_samples += (stride << (decim_step >> 1));
+    }
+
+    return;
+}
@@ -0,0 +1,33 @@
+/*
+* Copyright(c) 2019 Intel Corporation
+* SPDX - License - Identifier: BSD - 2 - Clause - Patent
+*/
+
+#ifndef EbComputeHistogram_C_h
+#define EbComputeHistogram_C_h
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "EbDefinitions.h"
+
+/********************************************
+* eb_vp9_calculate_histogram
+*      adds the samples of the input area to
+*      a 256-bin histogram, only one sample
+*      every decim_step in both directions is
+*      taken
+********************************************/
+void eb_vp9_calculate_histogram(uint8_t  *input_samples, // input parameter, input samples Ptr
+                                uint32_t  input_area_width, // input parameter, input area width
+                                uint32_t  input_area_height, // input parameter, input area height
+                                uint32_t  stride, // input parameter, input stride
+                                uint8_t   decim_step, // input parameter, decimation step (1 or 4)
+                                uint32_t *histogram, // output parameter, output histogram
+                                uint64_t *sum); // output parameter, sum of the taken samples
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,28 @@
+/*
+* Copyright(c) 2019 Intel Corporation
+* SPDX - License - Identifier: BSD - 2 - Clause - Patent
+*/
+
+#include "EbComputeSsim_C.h"
+
+void eb_vp9_ssim_parms_8x8(const uint8_t *source, uint32_t source_stride, const uint8_t *recon, uint32_t recon_stride,
+                           uint32_t *sum_s, uint32_t *sum_r, uint32_t *sum_sq_s, uint32_t *sum_sq_r,
+                           uint32_t *sum_sxr) {
+    uint32_t horizontal_index;
+    uint32_t vertical_index;
+
+    *sum_s = *sum_r = *sum_sq_s = *sum_sq_r = *sum_sxr = 0;
+    for (vertical_index = 0; vertical_index < 8; ++vertical_index) {
+        for (horizontal_index = 0; horizontal_index < 8; ++horizontal_index) {
+            *sum_s += source[horizontal_index];
+            *sum_r += recon[horizontal_index];
+            *sum_sq_s += source[horizontal_index] * source[horizontal_index];
+            *sum_sq_r += recon[horizontal_index] * recon[horizontal_index];
+            *sum_sxr += source[horizontal_index] * recon[horizontal_index];
+        }
+        source += source_stride;
+        recon += recon_stride;
+    }
+
+    return;
+}
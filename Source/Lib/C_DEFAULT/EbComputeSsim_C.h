@@ -0,0 +1,35 @@
+/*
+* Copyright(c) 2019 Intel Corporation
+* SPDX - License - Identifier: BSD - 2 - Clause - Patent
+*/
+
+#ifndef EbComputeSsim_C_h
+#define EbComputeSsim_C_h
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "EbDefinitions.h"
+
+/********************************************
+* eb_vp9_ssim_parms_8x8
+*      sums of the samples, of their squares
+*      and of the products of the source and
+*      recon samples of an 8x8 window, the
+*      SSIM window of libvpx (vpx_ssim2)
+********************************************/
+void eb_vp9_ssim_parms_8x8(const uint8_t *source, // input parameter, source samples Ptr
+                           uint32_t       source_stride, // input parameter, source stride
+                           const uint8_t *recon, // input parameter, recon samples Ptr
+                           uint32_t       recon_stride, // input parameter, recon stride
+                           uint32_t      *sum_s, // output parameter, sum of the source samples
+                           uint32_t      *sum_r, // output parameter, sum of the recon samples
+                           uint32_t      *sum_sq_s, // output parameter, sum of the squared source samples
+                           uint32_t      *sum_sq_r, // output parameter, sum of the squared recon samples
+                           uint32_t      *sum_sxr); // output parameter, sum of the source x recon products
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,20 @@
+/*
+* Copyright(c) 2019 Intel Corporation
+* SPDX - License - Identifier: BSD - 2 - Clause - Patent
+*/
+
+#include "EbRateDistortionCost_C.h"
+#include "vp9_tokenize.h"
+
+int eb_vp9_coeff_tokenize(const int16_t *qcoeff, const int16_t *scan, int eob, const uint16_t *cat6_high_cost,
+                          uint8_t *tokens) {
+    int cost = 0;
+
+    for (int c = 0; c < eob; c++) {
+        int16_t token;
+        cost += vp9_get_token_cost(qcoeff[scan[c]], &token, cat6_high_cost);
+        tokens[c] = (uint8_t)token;
+    }
+
+    return cost;
+}
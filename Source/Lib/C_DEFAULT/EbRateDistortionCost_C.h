@@ -0,0 +1,30 @@
+/*
+* Copyright(c) 2019 Intel Corporation
+* SPDX - License - Identifier: BSD - 2 - Clause - Patent
+*/
+
+#ifndef EbRateDistortionCost_C_h
+#define EbRateDistortionCost_C_h
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "EbDefinitions.h"
+
+/*******************************************
+* eb_vp9_coeff_tokenize
+*  tokens of the first eob coeffs in scan
+*  order, returns the sum of their value
+*  (i.e. sign and extra bits) costs
+*******************************************/
+int eb_vp9_coeff_tokenize(const int16_t *qcoeff, // input parameter, quantized coeffs Ptr
+                          const int16_t *scan, // input parameter, scan order
+                          int            eob, // input parameter, end of block
+                          const uint16_t *cat6_high_cost, // input parameter, CATEGORY6 high extra bits costs
+                          uint8_t        *tokens); // output parameter, tokens in scan order
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,33 @@
+/*
+* Copyright(c) 2019 Intel Corporation
+* SPDX - License - Identifier: BSD - 2 - Clause - Patent
+*/
+
+#include "EbTemporalFiltering_C.h"
+
+void eb_vp9_temporal_filter_apply_kernel(const uint8_t *src, uint32_t src_stride, const uint8_t *pred,
+                                         uint32_t pred_stride, uint32_t block_width, uint32_t block_height,
+                                         int32_t strength, int32_t filter_weight, uint32_t *accumulator,
+                                         uint16_t *count) {
+    const int32_t rounding = strength > 0 ? 1 << (strength - 1) : 0;
+
+    for (uint32_t i = 0; i < block_height; i++) {
+        for (uint32_t j = 0; j < block_width; j++) {
+            const int32_t pixel_value = pred[j];
+            int32_t       modifier    = src[j] - pixel_value;
+
+            // Integer approximation of 16 - min(3 * diff^2 / 2^strength, 16)
+            modifier = (modifier * modifier * 3 + rounding) >> strength;
+            if (modifier > 16)
+                modifier = 16;
+            modifier = (16 - modifier) * filter_weight;
+
+            count[j] += (uint16_t)modifier;
+            accumulator[j] += (uint32_t)(modifier * pixel_value);
+        }
+        src += src_stride;
+        pred += pred_stride;
+        count += block_width;
+        accumulator += block_width;
+    }
+}
@@ -0,0 +1,35 @@
+/*
+* Copyright(c) 2019 Intel Corporation
+* SPDX - License - Identifier: BSD - 2 - Clause - Patent
+*/
+
+#ifndef EbTemporalFiltering_C_h
+#define EbTemporalFiltering_C_h
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "EbDefinitions.h"
+
+/*******************************************
+* eb_vp9_temporal_filter_apply_kernel
+*  accumulates the motion compensated block
+*  of one past picture, weighted by its
+*  per sample distance to the source block
+*******************************************/
+void eb_vp9_temporal_filter_apply_kernel(const uint8_t *src, // input parameter, source block Ptr
+                                         uint32_t       src_stride, // input parameter, source stride
+                                         const uint8_t *pred, // input parameter, motion compensated block Ptr
+                                         uint32_t       pred_stride, // input parameter, motion compensated block stride
+                                         uint32_t       block_width, // input parameter, block width
+                                         uint32_t       block_height, // input parameter, block height
+                                         int32_t        strength, // input parameter, filter strength [0, 6]
+                                         int32_t        filter_weight, // input parameter, block weight [0, 2]
+                                         uint32_t      *accumulator, // output parameter, weighted sample sums
+                                         uint16_t      *count); // output parameter, weight sums
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
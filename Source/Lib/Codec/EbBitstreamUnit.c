@@ -16,7 +16,8 @@ EbErrorType eb_vp9_output_bitstream_unit_ctor(OutputBitstreamUnit *bitstream_ptr
 
     if (buffer_size) {
         bitstream_ptr->size = buffer_size / sizeof(unsigned int);
-        EB_MALLOC(unsigned char *, bitstream_ptr->buffer_begin, sizeof(unsigned char) * bitstream_ptr->size, EB_N_PTR);
+        EB_REALLOCABLE_MALLOC(
+            unsigned char *, bitstream_ptr->buffer_begin, sizeof(unsigned char) * bitstream_ptr->size);
         bitstream_ptr->buffer = bitstream_ptr->buffer_begin;
     } else {
         bitstream_ptr->size         = 0;
@@ -36,6 +37,30 @@ EbErrorType eb_vp9_output_bitstream_unit_ctor(OutputBitstreamUnit *bitstream_ptr
     return EB_ErrorNone;
 }
 
+/**********************************
+ * Grow Bitstream
+ *   reallocates the buffer to buffer_size bytes
+ *   when it is smaller, the bytes are kept and the
+ *   write position is reset as the units that grow
+ *   are written through a VpxWriter
+ **********************************/
+EbErrorType eb_vp9_output_bitstream_unit_grow(OutputBitstreamUnit *bitstream_ptr, uint32_t buffer_size) {
+    uint8_t *buffer_begin;
+
+    if (buffer_size <= bitstream_ptr->size)
+        return EB_ErrorNone;
+
+    buffer_begin = (uint8_t *)realloc(bitstream_ptr->buffer_begin, buffer_size);
+    if (buffer_begin == (uint8_t *)EB_NULL)
+        return EB_ErrorInsufficientResources;
+
+    bitstream_ptr->buffer_begin = buffer_begin;
+    bitstream_ptr->buffer       = buffer_begin;
+    bitstream_ptr->size         = buffer_size;
+
+    return EB_ErrorNone;
+}
+
 /**********************************
  * Reset Bitstream
  **********************************/
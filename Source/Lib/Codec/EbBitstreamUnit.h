@@ -35,6 +35,10 @@ typedef struct OutputBitstreamUnit {
  **********************************/
 extern EbErrorType eb_vp9_output_bitstream_unit_ctor(OutputBitstreamUnit *bitstream_ptr, uint32_t buffer_size);
 
+// Grows the buffer allocated by the constructor and resets the write position, the unit is unchanged when the
+// allocation fails
+extern EbErrorType eb_vp9_output_bitstream_unit_grow(OutputBitstreamUnit *bitstream_ptr, uint32_t buffer_size);
+
 extern EbErrorType eb_vp9_output_bitstream_reset(OutputBitstreamUnit *bitstream_ptr);
 
 extern EbErrorType output_bitstream_write(OutputBitstreamUnit *bitstream_ptr, uint32_t bits, uint32_t number_of_bits);
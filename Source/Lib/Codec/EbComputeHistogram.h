@@ -0,0 +1,41 @@
+/*
+* Copyright(c) 2019 Intel Corporation
+* SPDX - License - Identifier: BSD - 2 - Clause - Patent
+*/
+
+#ifndef EbComputeHistogram_h
+#define EbComputeHistogram_h
+
+#include "EbDefinitions.h"
+
+#include "EbComputeHistogram_C.h"
+#include "EbComputeHistogram_SSE2.h"
+#include "EbComputeHistogram_AVX2.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/***************************************
+ * Function Ptr Types
+ ***************************************/
+typedef void (*EbCalculateHistogramType)(uint8_t *input_samples, uint32_t input_area_width,
+                                         uint32_t input_area_height, uint32_t stride, uint8_t decim_step,
+                                         uint32_t *histogram, uint64_t *sum);
+
+/***************************************
+ * Function Tables
+ ***************************************/
+static EbCalculateHistogramType FUNC_TABLE calculate_histogram_func_ptr_array[ASM_TYPE_TOTAL][2] = {
+    // C_DEFAULT
+    {/*0 decim_step 1 */ eb_vp9_calculate_histogram,
+     /*1 decim_step 4 */ eb_vp9_calculate_histogram},
+    // AVX2
+    {/*0 decim_step 1 */ eb_vp9_calculate_histogram_avx2_intrin,
+     /*1 decim_step 4 */ eb_vp9_calculate_histogram_decim4_sse2_intrin},
+};
+
+#ifdef __cplusplus
+}
+#endif
+#endif // EbComputeHistogram_h
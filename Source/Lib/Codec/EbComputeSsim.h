@@ -0,0 +1,38 @@
+/*
+* Copyright(c) 2019 Intel Corporation
+* SPDX - License - Identifier: BSD - 2 - Clause - Patent
+*/
+
+#ifndef EbComputeSsim_h
+#define EbComputeSsim_h
+
+#include "EbDefinitions.h"
+
+#include "EbComputeSsim_C.h"
+#include "EbComputeSsim_SSE2.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/***************************************
+ * Function Ptr Types
+ ***************************************/
+typedef void (*EbSsimParmsType)(const uint8_t *source, uint32_t source_stride, const uint8_t *recon,
+                                uint32_t recon_stride, uint32_t *sum_s, uint32_t *sum_r, uint32_t *sum_sq_s,
+                                uint32_t *sum_sq_r, uint32_t *sum_sxr);
+
+/***************************************
+ * Function Tables
+ ***************************************/
+static EbSsimParmsType FUNC_TABLE ssim_parms_8x8_func_ptr_array[ASM_TYPE_TOTAL] = {
+    // C_DEFAULT
+    eb_vp9_ssim_parms_8x8,
+    // AVX2
+    eb_vp9_ssim_parms_8x8_sse2_intrin,
+};
+
+#ifdef __cplusplus
+}
+#endif
+#endif // EbComputeSsim_h
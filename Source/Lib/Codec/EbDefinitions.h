@@ -125,7 +125,7 @@ typedef __int64 Off64;
 #define USE_SRC_REF 0
 #define INTER_INTRA_BIAS 0
 
-#define SEG_SUPPORT 0
+#define SEG_SUPPORT 1
 
 #define RC_FEEDBACK 1
 
@@ -247,7 +247,7 @@ static const uint32_t me2_nx2_n_offset[4] = {0, 1, 5, 21};
 #define MAX_SUPPORTED_MODES_4K_OQ 11
 #define MAX_SUPPORTED_MODES_4K_SQ 13
 
-#define SPEED_CONTROL_INIT_MOD ENC_MODE_5;
+#define SPEED_CONTROL_INIT_MOD ENC_MODE_5
 
 /** The EB_TUID type is used to identify a TU within a CU.
 */
@@ -359,12 +359,15 @@ typedef enum EbPtrType {
     EB_A_PTR     = 1, // malloc'd pointer aligned
     EB_MUTEX     = 2, // mutex
     EB_SEMAPHORE = 3, // semaphore
-    EB_THREAD    = 4 // thread handle
+    EB_THREAD    = 4, // thread handle
+    EB_H_PTR     = 5, // huge page mapped pointer
+    EB_R_PTR     = 6 // address of a malloc'd pointer that may be reallocated
 } EbPtrType;
 
 typedef struct EbMemoryMapEntry {
     EbPtr     ptr; // points to a memory pointer
     EbPtrType ptr_type; // pointer type
+    size_t    size; // allocated size, used to unmap an EB_H_PTR
 } EbMemoryMapEntry;
 
 // Display Total Memory at the end of the memory allocations
@@ -470,6 +473,14 @@ extern uint32_t lib_thread_count;
 extern uint32_t lib_semaphore_count;
 extern uint32_t lib_mutex_count;
 
+#define HUGE_PAGES_OFF 0
+#define HUGE_PAGES_TRANSPARENT 1
+#define HUGE_PAGES_EXPLICIT 2
+#define HUGE_PAGE_SIZE (2 * 1024 * 1024)
+
+extern uint8_t   eb_vp9_huge_pages; // HugePages mode of the encoder being initialized
+extern uint64_t* total_lib_huge_page_memory; // library Memory mapped or advised as huge pages
+
 #ifdef _WIN32
 #define EB_ALLIGN_MALLOC(type, pointer, n_elements, pointer_class)          \
     pointer = (type)_aligned_malloc(n_elements, ALVALUE);                   \
@@ -509,12 +520,13 @@ extern uint32_t lib_mutex_count;
     lib_malloc_count++;
 #endif
 
-#define EB_MEMORY()                                                             \
-    SVT_LOG("Total Number of Mallocs in Library: %d\n", lib_malloc_count);      \
-    SVT_LOG("Total Number of Threads in Library: %d\n", lib_thread_count);      \
-    SVT_LOG("Total Number of Semaphore in Library: %d\n", lib_semaphore_count); \
-    SVT_LOG("Total Number of Mutex in Library: %d\n", lib_mutex_count);         \
-    SVT_LOG("Total Library Memory: %.2lf KB\n\n", *total_lib_memory / (double)1024);
+#define EB_MEMORY()                                                                \
+    SVT_LOG("Total Number of Mallocs in Library: %d\n", lib_malloc_count);         \
+    SVT_LOG("Total Number of Threads in Library: %d\n", lib_thread_count);         \
+    SVT_LOG("Total Number of Semaphore in Library: %d\n", lib_semaphore_count);    \
+    SVT_LOG("Total Number of Mutex in Library: %d\n", lib_mutex_count);            \
+    SVT_LOG("Total Library Memory: %.2lf KB\n", *total_lib_memory / (double)1024); \
+    SVT_LOG("Total Huge Page Memory: %.2lf KB\n\n", *total_lib_huge_page_memory / (double)1024);
 
 #define EB_MALLOC(type, pointer, n_elements, pointer_class)                 \
     pointer = (type)malloc(n_elements);                                     \
@@ -552,6 +564,42 @@ extern uint32_t lib_mutex_count;
     }                                                             \
     lib_malloc_count++;
 
+// Allocation of a buffer that may be reallocated, the memory map holds the address of the pointer so the
+// pointer has to live in an object registered before it
+#define EB_REALLOCABLE_MALLOC(type, pointer, n_elements)                     \
+    pointer = (type)malloc(n_elements);                                     \
+    if (pointer == (type)EB_NULL) {                                         \
+        return EB_ErrorInsufficientResources;                               \
+    } else {                                                                \
+        memory_map[*(memory_map_index)].ptr_type = EB_R_PTR;                \
+        memory_map[(*(memory_map_index))++].ptr  = &(pointer);              \
+        if (n_elements % 8 == 0) {                                          \
+            *total_lib_memory += (n_elements);                              \
+        } else {                                                            \
+            *total_lib_memory += ((n_elements) + (8 - ((n_elements) % 8))); \
+        }                                                                   \
+    }                                                                       \
+    if (*(memory_map_index) >= MAX_NUM_PTR) {                               \
+        return EB_ErrorInsufficientResources;                               \
+    }                                                                       \
+    lib_malloc_count++;
+
+// Huge page backed allocation of the large picture buffers, regular aligned allocation otherwise
+#define EB_HUGE_PAGE_MALLOC(type, pointer, n_elements, pointer_class)                                  \
+    if (eb_vp9_huge_pages != HUGE_PAGES_OFF && (n_elements) >= HUGE_PAGE_SIZE) {                       \
+        pointer = (type)eb_vp9_huge_page_malloc(n_elements, &memory_map[*(memory_map_index)]);         \
+        if (pointer == (type)EB_NULL) {                                                                \
+            return EB_ErrorInsufficientResources;                                                      \
+        }                                                                                              \
+        *total_lib_memory += memory_map[(*(memory_map_index))++].size;                                 \
+        if (*(memory_map_index) >= MAX_NUM_PTR) {                                                      \
+            return EB_ErrorInsufficientResources;                                                      \
+        }                                                                                              \
+        lib_malloc_count++;                                                                            \
+    } else {                                                                                           \
+        EB_ALLIGN_MALLOC(type, pointer, n_elements, pointer_class)                                     \
+    }
+
 #define EB_CREATESEMAPHORE(type, pointer, n_elements, pointer_class, initial_count, max_count) \
     pointer = eb_vp9_create_semaphore(initial_count, max_count);                               \
     if (pointer == (type)EB_NULL) {                                                            \
@@ -659,6 +707,10 @@ Groups of Pictures (GOP) units.
 #define TUNE_OQ 1
 #define TUNE_VMAF 2
 
+#define AQ_MODE_OFF 0
+#define AQ_MODE_VARIANCE 1
+#define AQ_MODE_MOTION 2
+
 #define ME_FILTER_TAP 4
 
 #define SUB_SAD_SEARCH 0
@@ -688,10 +740,15 @@ Groups of Pictures (GOP) units.
 #define VAR_DIFF_THRSHOLD 10
 
 #define SC_FRAMES_TO_IGNORE 100 // The speed control algorith starts after SC_FRAMES_TO_IGNORE number frames.
-#define SC_FRAMES_INTERVAL_SPEED 60 // The speed control Interval To Check the speed
-#define SC_FRAMES_INTERVAL_T1 60 // The speed control Interval Threshold1
-#define SC_FRAMES_INTERVAL_T2 180 // The speed control Interval Threshold2
-#define SC_FRAMES_INTERVAL_T3 120 // The speed control Interval Threshold3
+#define SC_FRAMES_INTERVAL 60 // The speed control Interval To Check the stage loads and the output rate
+#define SC_LOAD_HIGH 95 // Stage load (% of the frame deadline) above which the speed control goes faster
+#define SC_LOAD_LOW 80 // Stage load (% of the frame deadline) below which the speed control goes slower
+
+// Speed control knobs, each one moves its tool to the settings of the next faster encoder mode
+#define SC_KNOB_SEARCH_AREA 0x01 // ME search area
+#define SC_KNOB_NFL 0x02 // MD NFL size
+#define SC_KNOB_DEPTH_MODE 0x04 // MDC depth mode
+#define SC_KNOB_ALL (SC_KNOB_SEARCH_AREA | SC_KNOB_NFL | SC_KNOB_DEPTH_MODE)
 
 #define CMPLX_LOW 0
 #define CMPLX_MEDIUM 1
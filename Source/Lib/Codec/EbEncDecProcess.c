@@ -16,10 +16,12 @@
 #include "EbPictureOperators.h"
 #include "EbSvtVp9ErrorCodes.h"
 #include "EbComputeSAD.h"
+#include "EbComputeSsim.h"
 #include "EbPictureControlSet.h"
 #include "EbCodingUnit.h"
 #include "EbModeDecision.h"
 #include "EbMcp.h"
+#include "EbTime.h"
 
 #include "vp9_rd.h"
 #include "vp9_picklpf.h"
@@ -697,6 +699,22 @@ void perform_inverse_transform_recon(EncDecContext *context_ptr, ModeDecisionCan
                               2);
     }
 }
+static INLINE int get_tu_coeff_ctx(const EncDecContext *context_ptr, int plane, int tu_index, TX_SIZE tx_size) {
+    int blk_col = (tu_index % 2) * (1 << tx_size);
+    int blk_row = (tu_index >> 1) * (1 << tx_size);
+
+    return combine_entropy_contexts(context_ptr->t_left[plane][blk_row], context_ptr->t_above[plane][blk_col]);
+}
+
+// Keeps the full loop results of a transform block for the encode pass
+static INLINE void set_tu_results(const EncDecContext *context_ptr, TuResults *tu_results, int plane, int tu_index,
+                                  TX_SIZE tx_size, const int distortion[DIST_CALC_TOTAL], int coeff_bits) {
+    tu_results->coeff_ctx                        = get_tu_coeff_ctx(context_ptr, plane, tu_index, tx_size);
+    tu_results->coeff_bits                       = coeff_bits;
+    tu_results->distortion[DIST_CALC_RESIDUAL]   = distortion[DIST_CALC_RESIDUAL];
+    tu_results->distortion[DIST_CALC_PREDICTION] = distortion[DIST_CALC_PREDICTION];
+}
+
 static void perform_dist_rate_calc(EncDecContext *context_ptr, PictureControlSet *picture_control_set_ptr,
                                    int16_t *residual_quant_coeff_buffer, EbByte input_buffer, uint16_t input_stride,
                                    EbByte pred_buffer, uint16_t pred_stride, int16_t *trans_coeff_buffer,
@@ -727,11 +745,9 @@ static void perform_dist_rate_calc(EncDecContext *context_ptr, PictureControlSet
         tufull_distortion[DIST_CALC_PREDICTION] = (int)(tufull_distortionTemp[DIST_CALC_PREDICTION] >> shift);
     }
 
-    int blk_col    = (tu_index % 2) * (1 << tx_size);
-    int blk_row    = (tu_index >> 1) * (1 << tx_size);
     *tu_coeff_bits = 0;
 
-    coeff_ctx = combine_entropy_contexts(context_ptr->t_left[plane][blk_row], context_ptr->t_above[plane][blk_col]);
+    coeff_ctx = get_tu_coeff_ctx(context_ptr, plane, tu_index, tx_size);
 
     *tu_coeff_bits = coeff_rate_estimate( //cost_coeffs
         context_ptr,
@@ -899,6 +915,14 @@ void perform_full_loop(PictureControlSet *picture_control_set_ptr, EncDecContext
                 tufull_distortion[0],
                 &tu_coeff_bits);
 
+            set_tu_results(context_ptr,
+                           &candidate_buffer->tu_results[0][tu_index],
+                           0,
+                           tu_index,
+                           context_ptr->ep_block_stats_ptr->tx_size,
+                           tufull_distortion[0],
+                           tu_coeff_bits);
+
             yfull_distortion[DIST_CALC_RESIDUAL] += tufull_distortion[0][DIST_CALC_RESIDUAL];
             yfull_distortion[DIST_CALC_PREDICTION] += tufull_distortion[0][DIST_CALC_PREDICTION];
             y_coeff_bits += tu_coeff_bits;
@@ -1004,6 +1028,21 @@ void perform_full_loop(PictureControlSet *picture_control_set_ptr, EncDecContext
                 &crfull_distortion[0],
                 &cr_coeff_bits);
 
+            set_tu_results(context_ptr,
+                           &candidate_buffer->tu_results[1][0],
+                           1,
+                           0,
+                           context_ptr->ep_block_stats_ptr->tx_size_uv,
+                           cbfull_distortion,
+                           cb_coeff_bits);
+            set_tu_results(context_ptr,
+                           &candidate_buffer->tu_results[2][0],
+                           2,
+                           0,
+                           context_ptr->ep_block_stats_ptr->tx_size_uv,
+                           crfull_distortion,
+                           cr_coeff_bits);
+
             // SKIP decision making
             if (context_ptr->eob_zero_mode) {
                 if (candidate_buffer->candidate_ptr->mode_info->mode > TM_PRED) {
@@ -1718,6 +1757,139 @@ void update_scratch_recon_buffer(EncDecContext *context_ptr, EbPictureBufferDesc
     }
 }
 
+static void copy_block_coeffs(int16_t *src_ptr, uint32_t src_stride, int16_t *dst_ptr, uint32_t dst_stride,
+                              uint32_t size) {
+    for (uint32_t j = 0; j < size; j++) {
+        EB_MEMCPY(dst_ptr, src_ptr, size * sizeof(int16_t));
+        src_ptr = src_ptr + src_stride;
+        dst_ptr = dst_ptr + dst_stride;
+    }
+}
+
+/***************************************************
+* Keeps the results of a committed block (i.e. coeffs,
+* recon samples, eobs and full loop results) so that
+* the encode pass does not need to encode the block
+* again when the mode and the neighbor contexts match
+***************************************************/
+static void store_md_block_results(PictureControlSet *picture_control_set_ptr, EncDecContext *context_ptr,
+                                   ModeDecisionCandidateBuffer *candidate_buffer, SbUnit *sb_ptr,
+                                   uint32_t block_index) {
+    const EpBlockStats *ep_block_stats_ptr = context_ptr->ep_block_stats_ptr;
+    const ModeInfo     *mode_info          = &context_ptr->enc_dec_local_block_array[block_index]->mode_info;
+    uint32_t            cell_x             = ep_block_stats_ptr->origin_x >> 3;
+    uint32_t            cell_y             = ep_block_stats_ptr->origin_y >> 3;
+    uint32_t            cell_count         = MAX(ep_block_stats_ptr->sq_size >> 3, 1);
+    uint16_t            owner              = 0;
+
+    // Only inter blocks with the final interpolation, full transforms and a valid recon are kept
+    EB_BOOL reusable = (EB_BOOL)(!context_ptr->is16bit && mode_info->mode > TM_PRED &&
+                                 ep_block_stats_ptr->bsize >= BLOCK_8X8 && context_ptr->use_subpel_flag &&
+                                 context_ptr->intra_md_open_loop_flag == EB_FALSE &&
+                                 context_ptr->spatial_sse_full_loop == EB_FALSE &&
+                                 !(context_ptr->pf_md_level && ep_block_stats_ptr->tx_size == TX_32X32));
+#if USE_SRC_REF
+    if (picture_control_set_ptr->parent_pcs_ptr->use_src_ref)
+        reusable = EB_FALSE;
+#else
+    (void)picture_control_set_ptr;
+#endif
+
+    if (reusable) {
+        MdReuseBlock *md_block     = &context_ptr->md_reuse_block[cell_y * MD_REUSE_BLOCK_STRIDE + cell_x];
+        uint32_t      origin_index = ep_block_stats_ptr->origin_x +
+            ep_block_stats_ptr->origin_y * context_ptr->md_reuse_coeff_buffer->stride_y;
+        uint32_t chroma_origin_index = (ep_block_stats_ptr->origin_x >> 1) +
+            (ep_block_stats_ptr->origin_y >> 1) * context_ptr->md_reuse_coeff_buffer->stride_cb;
+
+        md_block->mode_info    = *mode_info;
+        md_block->chroma_valid = (EB_BOOL)((context_ptr->chroma_level == CHROMA_LEVEL_0 ||
+                                            context_ptr->chroma_level == CHROMA_LEVEL_1) &&
+                                           ep_block_stats_ptr->has_uv &&
+                                           !(context_ptr->pf_md_level && ep_block_stats_ptr->tx_size_uv == TX_32X32));
+        EB_MEMCPY(md_block->eob, context_ptr->block_ptr->eob, sizeof(md_block->eob));
+        EB_MEMCPY(md_block->tu_results, candidate_buffer->tu_results, sizeof(md_block->tu_results));
+
+        // Recon samples
+        update_scratch_recon_buffer(
+            context_ptr, candidate_buffer->recon_ptr, context_ptr->md_reuse_recon_buffer, sb_ptr);
+
+        // Coeffs
+        copy_block_coeffs((int16_t *)candidate_buffer->residual_quant_coeff_ptr->buffer_y,
+                          ep_block_stats_ptr->sq_size,
+                          &((int16_t *)context_ptr->md_reuse_coeff_buffer->buffer_y)[origin_index],
+                          context_ptr->md_reuse_coeff_buffer->stride_y,
+                          ep_block_stats_ptr->sq_size);
+
+        if (md_block->chroma_valid) {
+            copy_block_coeffs((int16_t *)candidate_buffer->residual_quant_coeff_ptr->buffer_cb,
+                              ep_block_stats_ptr->sq_size_uv,
+                              &((int16_t *)context_ptr->md_reuse_coeff_buffer->buffer_cb)[chroma_origin_index],
+                              context_ptr->md_reuse_coeff_buffer->stride_cb,
+                              ep_block_stats_ptr->sq_size_uv);
+            copy_block_coeffs((int16_t *)candidate_buffer->residual_quant_coeff_ptr->buffer_cr,
+                              ep_block_stats_ptr->sq_size_uv,
+                              &((int16_t *)context_ptr->md_reuse_coeff_buffer->buffer_cr)[chroma_origin_index],
+                              context_ptr->md_reuse_coeff_buffer->stride_cr,
+                              ep_block_stats_ptr->sq_size_uv);
+        }
+
+        owner = (uint16_t)(block_index + 1);
+    }
+
+    // A committed block always takes over the 8x8s it covers
+    for (uint32_t y = cell_y; y < cell_y + cell_count; y++) {
+        for (uint32_t x = cell_x; x < cell_x + cell_count; x++) {
+            context_ptr->md_reuse_block_owner[y * MD_REUSE_BLOCK_STRIDE + x] = owner;
+        }
+    }
+}
+
+/***************************************************
+* Returns the number of planes (0, 1 or MAX_MB_PLANE)
+* for which the encode pass would get the results
+* kept @ mode decision
+***************************************************/
+static int get_md_reuse_plane_count(EncDecContext *context_ptr, uint16_t ep_block_index) {
+    const EpBlockStats *ep_block_stats_ptr = context_ptr->ep_block_stats_ptr;
+    uint32_t            cell_x             = ep_block_stats_ptr->origin_x >> 3;
+    uint32_t            cell_y             = ep_block_stats_ptr->origin_y >> 3;
+    uint32_t            cell_count         = MAX(ep_block_stats_ptr->sq_size >> 3, 1);
+    MdReuseBlock       *md_block           = &context_ptr->md_reuse_block[cell_y * MD_REUSE_BLOCK_STRIDE + cell_x];
+    uint16_t           *eob                = &context_ptr->block_ptr->eob[0][0];
+
+    if (context_ptr->md_results_reuse == EB_FALSE || ep_block_stats_ptr->bsize < BLOCK_8X8)
+        return 0;
+
+    for (uint32_t y = cell_y; y < cell_y + cell_count; y++) {
+        for (uint32_t x = cell_x; x < cell_x + cell_count; x++) {
+            if (context_ptr->md_reuse_block_owner[y * MD_REUSE_BLOCK_STRIDE + x] != ep_block_index + 1)
+                return 0;
+        }
+    }
+
+    if (memcmp(&md_block->mode_info, context_ptr->e_mbd->mi[0], sizeof(ModeInfo)) ||
+        memcmp(md_block->eob, eob, sizeof(md_block->eob)))
+        return 0;
+
+    // The rate of the coeffs depends on the neighbor contexts
+    for (int tu_index = 0; tu_index < ((ep_block_stats_ptr->sq_size == MAX_SB_SIZE) ? 4 : 1); tu_index++) {
+        if (md_block->tu_results[0][tu_index].coeff_ctx !=
+            get_tu_coeff_ctx(context_ptr, 0, tu_index, ep_block_stats_ptr->tx_size))
+            return 0;
+    }
+
+    if (!ep_block_stats_ptr->has_uv)
+        return MAX_MB_PLANE;
+
+    if (md_block->chroma_valid &&
+        md_block->tu_results[1][0].coeff_ctx == get_tu_coeff_ctx(context_ptr, 1, 0, ep_block_stats_ptr->tx_size_uv) &&
+        md_block->tu_results[2][0].coeff_ctx == get_tu_coeff_ctx(context_ptr, 2, 0, ep_block_stats_ptr->tx_size_uv))
+        return MAX_MB_PLANE;
+
+    return 1;
+}
+
 EB_BOOL check_skip_sub_blocks(SequenceControlSet *sequence_control_set_ptr, PictureControlSet *picture_control_set_ptr,
                               EncDecContext *context_ptr, SbUnit *sb_ptr) {
     SbParams *sb_params_ptr = &sequence_control_set_ptr->sb_params_array[sb_ptr->sb_index];
@@ -1771,10 +1943,9 @@ void search_uv_mode(PictureControlSet *picture_control_set_ptr, EbPictureBufferD
                     EncDecContext *context_ptr) {
     QUANTS *quants = &picture_control_set_ptr->parent_pcs_ptr->cpi->quants;
 #if SEG_SUPPORT
-    VP9_COMMON *const          cm     = &cpi->common;
+    VP9_COMMON *const          cm     = &picture_control_set_ptr->parent_pcs_ptr->cpi->common;
     struct segmentation *const seg    = &cm->seg;
-    const int                  qindex = eb_vp9_get_qindex(
-        seg, candidate_ptr->mode_info->segment_id, picture_control_set_ptr->base_qindex);
+    const int qindex = eb_vp9_get_qindex(seg, context_ptr->segment_id, picture_control_set_ptr->base_qindex);
 
 #else
     const int qindex = picture_control_set_ptr->base_qindex;
@@ -2078,13 +2249,6 @@ void eb_vp9_mode_decision_sb(SequenceControlSet *sequence_control_set_ptr, Pictu
                     candidate_buffer_ptr_array_base
                         [context_ptr->buffer_depth_index_start[context_ptr->ep_block_stats_ptr->depth]]);
 
-#if SEG_SUPPORT
-                VP9_COMMON *const          cm     = &cpi->common;
-                struct segmentation *const seg    = &cm->seg;
-                const int                  qindex = eb_vp9_get_qindex(
-                    seg, context_ptr->segment_id, picture_control_set_ptr->base_qindex);
-#endif
-
                 // Initialize Fast Loop
                 coding_loop_init_fast_loop(context_ptr);
 
@@ -2255,6 +2419,11 @@ void eb_vp9_mode_decision_sb(SequenceControlSet *sequence_control_set_ptr, Pictu
                         // Update neighbor sample arrays
                         update_recon_neighbor_arrays(input_picture_ptr, context_ptr, sb_ptr, candidate_buffer, 0);
 
+                        // Keep the block results for the encode pass
+                        if (context_ptr->md_results_reuse)
+                            store_md_block_results(
+                                picture_control_set_ptr, context_ptr, candidate_buffer, sb_ptr, last_block_index);
+
                         // Hsan: check the lossless optimization that consists of copying the recon samples to an SB sized scratch buffer here, then copy from the scratch buffer to the bdp pillar neighbor sample arrays outside
                         // Update bdp neighbor sample arrays
                         if (picture_control_set_ptr->parent_pcs_ptr->pic_depth_mode == PIC_SB_SWITCH_DEPTH_MODE &&
@@ -3605,6 +3774,98 @@ EB_BOOL is_intra_present(EncDecContext *context_ptr, SbUnit *sb_ptr) {
 }
 
 #if VP9_PERFORM_EP
+static void encode_pass_prediction(SequenceControlSet *sequence_control_set_ptr, EncDecContext *context_ptr,
+                                   uint16_t ep_block_index, int plane) {
+    EbByte pred_buffer = (plane == 0)
+        ? (context_ptr->prediction_buffer->buffer_y + context_ptr->block_origin_index)
+        : (plane == 1) ? context_ptr->prediction_buffer->buffer_cb + context_ptr->block_chroma_origin_index
+                       : context_ptr->prediction_buffer->buffer_cr + context_ptr->block_chroma_origin_index;
+
+    uint16_t pred_stride = (plane == 0) ? context_ptr->prediction_buffer->stride_y
+        : (plane == 1)                  ? context_ptr->prediction_buffer->stride_cb
+                                        : context_ptr->prediction_buffer->stride_cr;
+
+    // Generate intra reference samples if intra present
+    generate_intra_reference_samples(sequence_control_set_ptr, context_ptr, plane);
+
+    prediction_fun_table[context_ptr->enc_dec_local_block_array[ep_block_index]->mode_info.mode <= TM_PRED](
+        context_ptr, pred_buffer, pred_stride, plane);
+}
+
+static INLINE void get_tu_results(const TuResults *tu_results, int distortion[DIST_CALC_TOTAL], int *coeff_bits) {
+    distortion[DIST_CALC_RESIDUAL]   = tu_results->distortion[DIST_CALC_RESIDUAL];
+    distortion[DIST_CALC_PREDICTION] = tu_results->distortion[DIST_CALC_PREDICTION];
+    *coeff_bits                      = tu_results->coeff_bits;
+}
+
+/*******************************************
+* Copies the coeffs and the recon samples kept
+* @ mode decision to the encode pass buffers
+*******************************************/
+static void copy_md_block_results(EncDecContext *context_ptr, SbUnit *sb_ptr, uint32_t recon_origin_index,
+                                  uint32_t recon_chroma_origin_index, int plane_count, EB_BOOL do_recon) {
+    const EpBlockStats  *ep_block_stats_ptr = context_ptr->ep_block_stats_ptr;
+    EbPictureBufferDesc *coeff_buffer       = context_ptr->md_reuse_coeff_buffer;
+    EbPictureBufferDesc *md_recon_buffer    = context_ptr->md_reuse_recon_buffer;
+    uint32_t             origin_index       = ep_block_stats_ptr->origin_x +
+        ep_block_stats_ptr->origin_y * coeff_buffer->stride_y;
+    uint32_t chroma_origin_index = (ep_block_stats_ptr->origin_x >> 1) +
+        (ep_block_stats_ptr->origin_y >> 1) * coeff_buffer->stride_cb;
+
+    copy_block_coeffs(
+        &((int16_t *)coeff_buffer->buffer_y)[origin_index],
+        coeff_buffer->stride_y,
+        &((int16_t *)sb_ptr->quantized_coeff_buffer[0])[sb_ptr->quantized_coeff_buffer_block_offset[0]],
+        ep_block_stats_ptr->sq_size,
+        ep_block_stats_ptr->sq_size);
+
+    if (do_recon)
+        pic_copy_kernel_func_ptr_array[(eb_vp9_ASM_TYPES & PREAVX2_MASK) && 1][ep_block_stats_ptr->sq_size >> 3](
+            &(md_recon_buffer->buffer_y[ep_block_stats_ptr->origin_x +
+                                        ep_block_stats_ptr->origin_y * md_recon_buffer->stride_y]),
+            md_recon_buffer->stride_y,
+            &(context_ptr->recon_buffer->buffer_y[recon_origin_index]),
+            context_ptr->recon_buffer->stride_y,
+            ep_block_stats_ptr->sq_size,
+            ep_block_stats_ptr->sq_size);
+
+    if (plane_count == MAX_MB_PLANE && ep_block_stats_ptr->has_uv) {
+        copy_block_coeffs(
+            &((int16_t *)coeff_buffer->buffer_cb)[chroma_origin_index],
+            coeff_buffer->stride_cb,
+            &((int16_t *)sb_ptr->quantized_coeff_buffer[1])[sb_ptr->quantized_coeff_buffer_block_offset[1]],
+            ep_block_stats_ptr->sq_size_uv,
+            ep_block_stats_ptr->sq_size_uv);
+        copy_block_coeffs(
+            &((int16_t *)coeff_buffer->buffer_cr)[chroma_origin_index],
+            coeff_buffer->stride_cr,
+            &((int16_t *)sb_ptr->quantized_coeff_buffer[2])[sb_ptr->quantized_coeff_buffer_block_offset[2]],
+            ep_block_stats_ptr->sq_size_uv,
+            ep_block_stats_ptr->sq_size_uv);
+
+        if (do_recon) {
+            uint32_t md_recon_chroma_origin_index = (ep_block_stats_ptr->origin_x >> 1) +
+                (ep_block_stats_ptr->origin_y >> 1) * md_recon_buffer->stride_cb;
+
+            pic_copy_kernel_func_ptr_array[(eb_vp9_ASM_TYPES & PREAVX2_MASK) && 1][ep_block_stats_ptr->sq_size_uv >> 3](
+                &(md_recon_buffer->buffer_cb[md_recon_chroma_origin_index]),
+                md_recon_buffer->stride_cb,
+                &(context_ptr->recon_buffer->buffer_cb[recon_chroma_origin_index]),
+                context_ptr->recon_buffer->stride_cb,
+                ep_block_stats_ptr->sq_size_uv,
+                ep_block_stats_ptr->sq_size_uv);
+
+            pic_copy_kernel_func_ptr_array[(eb_vp9_ASM_TYPES & PREAVX2_MASK) && 1][ep_block_stats_ptr->sq_size_uv >> 3](
+                &(md_recon_buffer->buffer_cr[md_recon_chroma_origin_index]),
+                md_recon_buffer->stride_cr,
+                &(context_ptr->recon_buffer->buffer_cr[recon_chroma_origin_index]),
+                context_ptr->recon_buffer->stride_cr,
+                ep_block_stats_ptr->sq_size_uv,
+                ep_block_stats_ptr->sq_size_uv);
+        }
+    }
+}
+
 /*******************************************
         * Encode Pass
         *
@@ -3654,7 +3915,9 @@ EB_EXTERN EbErrorType encode_pass_sb(SequenceControlSet *sequence_control_set_pt
 
     EB_BOOL do_recon = (EB_BOOL)((context_ptr->limit_intra == 0 || is_intra_sb == 1) ||
                                  picture_control_set_ptr->parent_pcs_ptr->is_used_as_reference_flag ||
-                                 sequence_control_set_ptr->static_config.recon_file);
+                                 sequence_control_set_ptr->static_config.recon_file ||
+                                 sequence_control_set_ptr->static_config.recon_view ||
+                                 sequence_control_set_ptr->static_config.stat_report);
 
     // Reset above context @ the 1st SB
     if (sb_ptr->sb_index == 0) {
@@ -3783,22 +4046,20 @@ EB_EXTERN EbErrorType encode_pass_sb(SequenceControlSet *sequence_control_set_pt
             int crfull_distortion[DIST_CALC_TOTAL]    = {0, 0};
             int tufull_distortion[3][DIST_CALC_TOTAL] = {{0, 0}, {0, 0}, {0, 0}};
 
-            // Prediction
-            for (int plane = 0; plane < (int)(context_ptr->ep_block_stats_ptr->has_uv ? MAX_MB_PLANE : 1); ++plane) {
-                EbByte pred_buffer = (plane == 0)
-                    ? (context_ptr->prediction_buffer->buffer_y + context_ptr->block_origin_index)
-                    : (plane == 1) ? context_ptr->prediction_buffer->buffer_cb + context_ptr->block_chroma_origin_index
-                                   : context_ptr->prediction_buffer->buffer_cr + context_ptr->block_chroma_origin_index;
+            // Planes for which the MD results are used as is
+            const MdReuseBlock *md_reuse_block =
+                &context_ptr->md_reuse_block[(context_ptr->ep_block_stats_ptr->origin_y >> 3) * MD_REUSE_BLOCK_STRIDE +
+                                             (context_ptr->ep_block_stats_ptr->origin_x >> 3)];
+            const int md_reuse_plane_count = get_md_reuse_plane_count(context_ptr, ep_block_index);
+            if (md_reuse_plane_count)
+                copy_md_block_results(
+                    context_ptr, sb_ptr, cuOriginReconIndex, cuChromaOriginReconIndex, md_reuse_plane_count, do_recon);
 
-                uint16_t pred_stride = (plane == 0) ? context_ptr->prediction_buffer->stride_y
-                    : (plane == 1)                  ? context_ptr->prediction_buffer->stride_cb
-                                                    : context_ptr->prediction_buffer->stride_cr;
-
-                // Generate intra reference samples if intra present
-                generate_intra_reference_samples(sequence_control_set_ptr, context_ptr, plane);
-
-                prediction_fun_table[context_ptr->enc_dec_local_block_array[ep_block_index]->mode_info.mode <= TM_PRED](
-                    context_ptr, pred_buffer, pred_stride, plane);
+            // Prediction
+            for (int plane = md_reuse_plane_count;
+                 plane < (int)(context_ptr->ep_block_stats_ptr->has_uv ? MAX_MB_PLANE : 1);
+                 ++plane) {
+                encode_pass_prediction(sequence_control_set_ptr, context_ptr, ep_block_index, plane);
             }
 
             QUANTS *quants = &picture_control_set_ptr->parent_pcs_ptr->cpi->quants;
@@ -3826,58 +4087,67 @@ EB_EXTERN EbErrorType encode_pass_sb(SequenceControlSet *sequence_control_set_pt
                      context_ptr->prediction_buffer->stride_y);
                 int tu_coeff_bits = 0;
 
-                // Luma Coding Loop
-                perform_coding_loop(
-                    context_ptr,
-                    &(((int16_t *)sb_ptr->quantized_coeff_buffer[0])[sb_ptr->quantized_coeff_buffer_block_offset[0] +
-                                                                     residual_quant_tu_origin_index]),
-                    context_ptr->ep_block_stats_ptr->sq_size,
-                    &(input_picture_ptr->buffer_y[context_ptr->input_origin_index + input_tu_origin_index]),
-                    input_picture_ptr->stride_y,
-                    &((context_ptr->prediction_buffer
-                           ->buffer_y)[context_ptr->block_origin_index + pred_tu_origin_index]),
-                    context_ptr->prediction_buffer->stride_y,
-                    &(((int16_t *)context_ptr->residual_buffer->buffer_y)
-                          [0]), // Hsan - does not match block location (i.e. stride not used) - kept as is to do not change WebM kernels
-                    &(((int16_t *)context_ptr->transform_buffer->buffer_y)
-                          [0]), // Hsan - does not match block location (i.e. stride not used) - kept as is to do not change WebM kernels
-                    &(context_ptr->recon_buffer->buffer_y[cuOriginReconIndex + pred_recon_tu_origin_index]),
-                    context_ptr->recon_buffer->stride_y,
-                    quants->y_zbin[qindex],
-                    quants->y_round[qindex],
-                    quants->y_quant[qindex],
-                    quants->y_quant_shift[qindex],
-                    &picture_control_set_ptr->parent_pcs_ptr->cpi->y_dequant[qindex][0],
-                    &context_ptr->block_ptr->eob[0][tu_index],
-                    context_ptr->ep_block_stats_ptr->tx_size,
-                    0,
-                    1,
-                    do_recon);
-
-                // Luma Distortion and Rate Calculation
-                if (!(context_ptr->skip_eob_zero_mode_ep && context_ptr->block_ptr->eob[0][tu_index] == 0)) {
-                    perform_dist_rate_calc(
+                if (md_reuse_plane_count) {
+                    // Luma Distortion and Rate from MD
+                    if (!(context_ptr->skip_eob_zero_mode_ep && context_ptr->block_ptr->eob[0][tu_index] == 0))
+                        get_tu_results(&md_reuse_block->tu_results[0][tu_index],
+                                       tufull_distortion[0],
+                                       &tu_coeff_bits);
+                } else {
+                    // Luma Coding Loop
+                    perform_coding_loop(
                         context_ptr,
-                        picture_control_set_ptr,
                         &(((int16_t *)
                                sb_ptr->quantized_coeff_buffer[0])[sb_ptr->quantized_coeff_buffer_block_offset[0] +
                                                                   residual_quant_tu_origin_index]),
+                        context_ptr->ep_block_stats_ptr->sq_size,
                         &(input_picture_ptr->buffer_y[context_ptr->input_origin_index + input_tu_origin_index]),
                         input_picture_ptr->stride_y,
                         &((context_ptr->prediction_buffer
                                ->buffer_y)[context_ptr->block_origin_index + pred_tu_origin_index]),
                         context_ptr->prediction_buffer->stride_y,
-                        &(((int16_t *)context_ptr->residual_buffer->buffer_y)[0]),
-                        &(((int16_t *)context_ptr->transform_buffer->buffer_y)[0]),
+                        &(((int16_t *)context_ptr->residual_buffer->buffer_y)
+                              [0]), // Hsan - does not match block location (i.e. stride not used) - kept as is to do not change WebM kernels
+                        &(((int16_t *)context_ptr->transform_buffer->buffer_y)
+                              [0]), // Hsan - does not match block location (i.e. stride not used) - kept as is to do not change WebM kernels
                         &(context_ptr->recon_buffer->buffer_y[cuOriginReconIndex + pred_recon_tu_origin_index]),
                         context_ptr->recon_buffer->stride_y,
+                        quants->y_zbin[qindex],
+                        quants->y_round[qindex],
+                        quants->y_quant[qindex],
+                        quants->y_quant_shift[qindex],
+                        &picture_control_set_ptr->parent_pcs_ptr->cpi->y_dequant[qindex][0],
                         &context_ptr->block_ptr->eob[0][tu_index],
                         context_ptr->ep_block_stats_ptr->tx_size,
                         0,
-                        tu_index,
-                        context_ptr->enc_dec_local_block_array[ep_block_index]->mode_info.mode,
-                        tufull_distortion[0],
-                        &tu_coeff_bits);
+                        1,
+                        do_recon);
+
+                    // Luma Distortion and Rate Calculation
+                    if (!(context_ptr->skip_eob_zero_mode_ep && context_ptr->block_ptr->eob[0][tu_index] == 0)) {
+                        perform_dist_rate_calc(
+                            context_ptr,
+                            picture_control_set_ptr,
+                            &(((int16_t *)
+                                   sb_ptr->quantized_coeff_buffer[0])[sb_ptr->quantized_coeff_buffer_block_offset[0] +
+                                                                      residual_quant_tu_origin_index]),
+                            &(input_picture_ptr->buffer_y[context_ptr->input_origin_index + input_tu_origin_index]),
+                            input_picture_ptr->stride_y,
+                            &((context_ptr->prediction_buffer
+                                   ->buffer_y)[context_ptr->block_origin_index + pred_tu_origin_index]),
+                            context_ptr->prediction_buffer->stride_y,
+                            &(((int16_t *)context_ptr->residual_buffer->buffer_y)[0]),
+                            &(((int16_t *)context_ptr->transform_buffer->buffer_y)[0]),
+                            &(context_ptr->recon_buffer->buffer_y[cuOriginReconIndex + pred_recon_tu_origin_index]),
+                            context_ptr->recon_buffer->stride_y,
+                            &context_ptr->block_ptr->eob[0][tu_index],
+                            context_ptr->ep_block_stats_ptr->tx_size,
+                            0,
+                            tu_index,
+                            context_ptr->enc_dec_local_block_array[ep_block_index]->mode_info.mode,
+                            tufull_distortion[0],
+                            &tu_coeff_bits);
+                    }
                 }
 
                 yfull_distortion[DIST_CALC_RESIDUAL] += tufull_distortion[0][DIST_CALC_RESIDUAL];
@@ -3885,8 +4155,18 @@ EB_EXTERN EbErrorType encode_pass_sb(SequenceControlSet *sequence_control_set_pt
                 y_coeff_bits += tu_coeff_bits;
             }
 
-            // Cb Coding Loop
-            if (context_ptr->ep_block_stats_ptr->has_uv) {
+            if (context_ptr->ep_block_stats_ptr->has_uv && md_reuse_plane_count == MAX_MB_PLANE) {
+                // Cb and Cr Distortion and Rate from MD
+                if (!(context_ptr->skip_eob_zero_mode_ep && context_ptr->block_ptr->eob[1][0] == 0))
+                    get_tu_results(&md_reuse_block->tu_results[1][0],
+                                   cbfull_distortion,
+                                   &cb_coeff_bits);
+                if (!(context_ptr->skip_eob_zero_mode_ep && context_ptr->block_ptr->eob[2][0] == 0))
+                    get_tu_results(&md_reuse_block->tu_results[2][0],
+                                   crfull_distortion,
+                                   &cr_coeff_bits);
+            } else if (context_ptr->ep_block_stats_ptr->has_uv) {
+                // Cb Coding Loop
                 perform_coding_loop(
                     context_ptr,
                     &(((int16_t *)sb_ptr->quantized_coeff_buffer[1])[sb_ptr->quantized_coeff_buffer_block_offset[1]]),
@@ -4002,6 +4282,13 @@ EB_EXTERN EbErrorType encode_pass_sb(SequenceControlSet *sequence_control_set_pt
                     uint64_t rd1 = (uint64_t)RDCOST(context_ptr->RDMULT, rd->RDDIV, rate1, (uint64_t)distortion1);
                     uint64_t rd2 = (uint64_t)RDCOST(context_ptr->RDMULT, rd->RDDIV, rate2, (uint64_t)distortion2);
                     if (rd1 >= rd2) {
+                        // The planes taken from MD have not been predicted yet
+                        if (do_recon) {
+                            for (int plane = 0; plane < md_reuse_plane_count; ++plane) {
+                                encode_pass_prediction(sequence_control_set_ptr, context_ptr, ep_block_index, plane);
+                            }
+                        }
+
                         for (uint8_t tu_index = 0;
                              tu_index < ((context_ptr->ep_block_stats_ptr->sq_size == MAX_SB_SIZE) ? 4 : 1);
                              tu_index++) {
@@ -4247,7 +4534,7 @@ EB_EXTERN EbErrorType encode_pass_sb(SequenceControlSet *sequence_control_set_pt
 EbErrorType eb_vp9_enc_dec_context_ctor(EncDecContext **context_dbl_ptr,
                                         EbFifo         *mode_decision_configuration_input_fifo_ptr,
                                         EbFifo *packetization_output_fifo_ptr, EbFifo *feedback_fifo_ptr,
-                                        EbFifo *picture_demux_fifo_ptr) {
+                                        EbFifo *picture_demux_fifo_ptr, uint32_t max_picture_width) {
     EbErrorType    return_error = EB_ErrorNone;
     EncDecContext *context_ptr;
     EB_MALLOC(EncDecContext *, context_ptr, sizeof(EncDecContext), EB_N_PTR);
@@ -4327,6 +4614,37 @@ EbErrorType eb_vp9_enc_dec_context_ctor(EncDecContext **context_dbl_ptr,
         }
     }
 
+    // MD results reuse scratch buffers
+    {
+        EbPictureBufferDescInitData init_data;
+
+        init_data.buffer_enable_mask = PICTURE_BUFFER_DESC_FULL_MASK;
+        init_data.max_width          = MAX_SB_SIZE;
+        init_data.max_height         = MAX_SB_SIZE;
+        init_data.bit_depth          = EB_8BIT;
+        init_data.left_padding       = 0;
+        init_data.right_padding      = 0;
+        init_data.top_padding        = 0;
+        init_data.bot_padding        = 0;
+        init_data.split_mode         = EB_FALSE;
+
+        return_error = eb_vp9_picture_buffer_desc_ctor((EbPtr *)&context_ptr->md_reuse_recon_buffer,
+                                                       (EbPtr)&init_data);
+
+        if (return_error == EB_ErrorInsufficientResources) {
+            return EB_ErrorInsufficientResources;
+        }
+
+        init_data.bit_depth = EB_16BIT;
+
+        return_error = eb_vp9_picture_buffer_desc_ctor((EbPtr *)&context_ptr->md_reuse_coeff_buffer,
+                                                       (EbPtr)&init_data);
+
+        if (return_error == EB_ErrorInsufficientResources) {
+            return EB_ErrorInsufficientResources;
+        }
+    }
+
     // uv_mode search scratch buffers
     {
         EbPictureBufferDescInitData init_data;
@@ -4413,6 +4731,24 @@ EbErrorType eb_vp9_enc_dec_context_ctor(EncDecContext **context_dbl_ptr,
     }
     EB_MALLOC(ModeInfo *, context_ptr->uv_mode_search_mode_info, sizeof(ModeInfo), EB_N_PTR);
 
+    // SB partitioning scratch
+    return_error = eb_vp9_mode_decision_configuration_context_ctor(&context_ptr->mdc_context_ptr, EB_NULL, EB_NULL, 0);
+    if (return_error == EB_ErrorInsufficientResources) {
+        return EB_ErrorInsufficientResources;
+    }
+
+    // Loop filter level search scratch
+    context_ptr->lf_search_buffer_stride = ((max_picture_width + MAX_SB_SIZE_MINUS_1) >> LOG2F_MAX_SB_SIZE)
+        << LOG2F_MAX_SB_SIZE;
+    EB_MALLOC(uint8_t *,
+              context_ptr->lf_search_buffer,
+              sizeof(uint8_t) * context_ptr->lf_search_buffer_stride * (LF_SEARCH_TOP_ROWS + MAX_SB_SIZE),
+              EB_N_PTR);
+    EB_MALLOC(LOOP_FILTER_MASK *,
+              context_ptr->lf_search_mask_array,
+              sizeof(LOOP_FILTER_MASK) * (context_ptr->lf_search_buffer_stride >> LOG2F_MAX_SB_SIZE),
+              EB_N_PTR);
+
     // Fast Candidate Array
     EB_MALLOC(ModeDecisionCandidate *,
               context_ptr->fast_candidate_array,
@@ -4589,7 +4925,8 @@ static EB_BOOL assign_enc_dec_segments(EncDecSegments *segment_ptr, uint16_t *se
     switch (task_ptr->input_type) {
     case ENCDEC_TASKS_MDC_INPUT:
 
-        // The entire picture is provided by the MDC process, so
+        // The MDC process only provides the picture level decisions,
+        //   each SB is configured by the thread that codes it, so
         //   no logic is necessary to clear input dependencies.
 
         // Start on Segment 0 immediately
@@ -4676,6 +5013,8 @@ static EB_BOOL assign_enc_dec_segments(EncDecSegments *segment_ptr, uint16_t *se
 
         if (feedback_row_index > 0) {
             eb_vp9_get_empty_object(srm_fifo_ptr, &wrapper_ptr);
+            if (wrapper_ptr == EB_NULL)
+                return EB_FALSE;
             feedback_task_ptr                                  = (EncDecTasks *)wrapper_ptr->object_ptr;
             feedback_task_ptr->input_type                      = ENCDEC_TASKS_ENCDEC_INPUT;
             feedback_task_ptr->enc_dec_segment_row             = feedback_row_index;
@@ -4690,7 +5029,46 @@ static EB_BOOL assign_enc_dec_segments(EncDecSegments *segment_ptr, uint16_t *se
 
     return continue_processing_flag;
 }
-static void recon_output(PictureControlSet *picture_control_set_ptr, SequenceControlSet *sequence_control_set_ptr) {
+/******************************************************
+ * Recon View
+ *   Points the view at the reconstructed picture and holds
+ *   the object owning it until the application releases it
+ ******************************************************/
+static void recon_view(EbReconView *view_ptr, EbObjectWrapper *picture_control_set_wrapper_ptr,
+                       SequenceControlSet *sequence_control_set_ptr) {
+    PictureControlSet   *picture_control_set_ptr = (PictureControlSet *)picture_control_set_wrapper_ptr->object_ptr;
+    EbBool               is16bit = (sequence_control_set_ptr->static_config.encoder_bit_depth > EB_8BIT);
+    EbPictureBufferDesc *reconPtr;
+
+    if (picture_control_set_ptr->parent_pcs_ptr->is_used_as_reference_flag == EB_TRUE) {
+        EbObjectWrapper   *reference_wrapper_ptr = picture_control_set_ptr->parent_pcs_ptr->reference_picture_wrapper_ptr;
+        EbReferenceObject *reference_object_ptr  = (EbReferenceObject *)reference_wrapper_ptr->object_ptr;
+        reconPtr = is16bit ? reference_object_ptr->reference_picture16bit : reference_object_ptr->reference_picture;
+        view_ptr->picture_wrapper_ptr = reference_wrapper_ptr;
+    } else {
+        reconPtr = is16bit ? picture_control_set_ptr->recon_picture_16bit_ptr
+                           : picture_control_set_ptr->recon_picture_ptr;
+        view_ptr->picture_wrapper_ptr = picture_control_set_wrapper_ptr;
+    }
+    eb_vp9_object_inc_live_count(view_ptr->picture_wrapper_ptr, 1);
+
+    view_ptr->planes.luma = reconPtr->buffer_y +
+        ((reconPtr->origin_y * reconPtr->stride_y + reconPtr->origin_x) << is16bit);
+    view_ptr->planes.cb = reconPtr->buffer_cb +
+        (((reconPtr->origin_y >> 1) * reconPtr->stride_cb + (reconPtr->origin_x >> 1)) << is16bit);
+    view_ptr->planes.cr = reconPtr->buffer_cr +
+        (((reconPtr->origin_y >> 1) * reconPtr->stride_cr + (reconPtr->origin_x >> 1)) << is16bit);
+    view_ptr->planes.y_stride  = reconPtr->stride_y;
+    view_ptr->planes.cb_stride = reconPtr->stride_cb;
+    view_ptr->planes.cr_stride = reconPtr->stride_cr;
+
+    view_ptr->header.n_filled_len = 0;
+    view_ptr->header.pts          = picture_control_set_ptr->picture_number;
+}
+
+static void recon_output(EbObjectWrapper    *picture_control_set_wrapper_ptr,
+                         SequenceControlSet *sequence_control_set_ptr) {
+    PictureControlSet  *picture_control_set_ptr = (PictureControlSet *)picture_control_set_wrapper_ptr->object_ptr;
     EbObjectWrapper    *outputReconWrapperPtr;
     EbBufferHeaderType *outputReconPtr;
     EncodeContext      *encode_context_ptr = sequence_control_set_ptr->encode_context_ptr;
@@ -4703,6 +5081,10 @@ static void recon_output(PictureControlSet *picture_control_set_ptr, SequenceCon
     // Get Recon Buffer
     eb_vp9_get_empty_object(sequence_control_set_ptr->encode_context_ptr->recon_output_fifo_ptr,
                             &outputReconWrapperPtr);
+    if (outputReconWrapperPtr == EB_NULL) {
+        eb_vp9_release_mutex(encode_context_ptr->total_number_of_recon_frame_mutex);
+        return;
+    }
     outputReconPtr        = (EbBufferHeaderType *)outputReconWrapperPtr->object_ptr;
     outputReconPtr->flags = 0;
 
@@ -4717,8 +5099,11 @@ static void recon_output(PictureControlSet *picture_control_set_ptr, SequenceCon
     // STOP READ/WRITE PROTECTED SECTION
     outputReconPtr->n_filled_len = 0;
 
-    // Copy the Reconstructed Picture to the Output Recon Buffer
-    {
+    if (sequence_control_set_ptr->static_config.recon_view) {
+        recon_view(
+            (EbReconView *)outputReconWrapperPtr->object_ptr, picture_control_set_wrapper_ptr, sequence_control_set_ptr);
+    } else {
+        // Copy the Reconstructed Picture to the Output Recon Buffer
         uint32_t sampleTotalCount;
         uint8_t *reconReadPtr;
         uint8_t *reconWritePtr;
@@ -4819,6 +5204,386 @@ static void recon_output(PictureControlSet *picture_control_set_ptr, SequenceCon
     eb_vp9_release_mutex(encode_context_ptr->total_number_of_recon_frame_mutex);
 }
 
+/******************************************************
+ * Compute the SSE of a plane, block by block so that
+ * the 32 bit accumulators of the kernel do not overflow
+ ******************************************************/
+static uint64_t compute_plane_sse(uint8_t *source, uint32_t source_stride, uint8_t *recon, uint32_t recon_stride,
+                                  uint32_t width, uint32_t height, uint32_t block_size) {
+    const EbAsm asm_type = (EbAsm)((eb_vp9_ASM_TYPES & PREAVX2_MASK) && 1);
+    uint64_t    sse      = 0;
+    uint32_t    block_x;
+    uint32_t    block_y;
+
+    for (block_y = 0; block_y < height; block_y += block_size) {
+        const uint32_t block_height = MIN(block_size, height - block_y);
+        for (block_x = 0; block_x < width; block_x += block_size) {
+            const uint32_t block_width = MIN(block_size, width - block_x);
+            const uint32_t simd_width  = block_width & ~15;
+            uint8_t       *source_ptr  = source + block_x + block_y * source_stride;
+            uint8_t       *recon_ptr   = recon + block_x + block_y * recon_stride;
+
+            if (simd_width)
+                sse += spatialfull_distortion_kernel_func_ptr_array[asm_type][2](
+                    source_ptr, source_stride, recon_ptr, recon_stride, simd_width, block_height);
+            if (block_width > simd_width)
+                sse += eb_vp9_spatial_full_distortion_kernel(source_ptr + simd_width,
+                                                             source_stride,
+                                                             recon_ptr + simd_width,
+                                                             recon_stride,
+                                                             block_width - simd_width,
+                                                             block_height);
+        }
+    }
+
+    return sse;
+}
+
+/******************************************************
+ * Compute the SSIM of a plane as libvpx does it
+ * (vpx_ssim2): the mean of the similarities of the 8x8
+ * windows taken every 4 samples in both directions
+ ******************************************************/
+#define SSIM_C1 ((26634 * 64 * 64) >> 12) // (k1 * 255)^2 * 64^2, k1 = 0.01
+#define SSIM_C2 ((239708 * 64 * 64) >> 12) // (k2 * 255)^2 * 64^2, k2 = 0.03
+static double compute_plane_ssim(uint8_t *source, uint32_t source_stride, uint8_t *recon, uint32_t recon_stride,
+                                 uint32_t width, uint32_t height) {
+    const EbAsm asm_type   = (EbAsm)((eb_vp9_ASM_TYPES & PREAVX2_MASK) && 1);
+    double      ssim_total = 0;
+    uint32_t    samples    = 0;
+    uint32_t    window_x;
+    uint32_t    window_y;
+
+    for (window_y = 0; window_y + 8 <= height; window_y += 4) {
+        for (window_x = 0; window_x + 8 <= width; window_x += 4) {
+            uint32_t sum_s, sum_r, sum_sq_s, sum_sq_r, sum_sxr;
+            int64_t  ssim_n, ssim_d;
+
+            ssim_parms_8x8_func_ptr_array[asm_type](source + window_x + window_y * source_stride,
+                                                    source_stride,
+                                                    recon + window_x + window_y * recon_stride,
+                                                    recon_stride,
+                                                    &sum_s,
+                                                    &sum_r,
+                                                    &sum_sq_s,
+                                                    &sum_sq_r,
+                                                    &sum_sxr);
+
+            ssim_n = (2 * (int64_t)sum_s * sum_r + SSIM_C1) *
+                (2 * 64 * (int64_t)sum_sxr - 2 * (int64_t)sum_s * sum_r + SSIM_C2);
+            ssim_d = ((int64_t)sum_s * sum_s + (int64_t)sum_r * sum_r + SSIM_C1) *
+                (64 * (int64_t)sum_sq_s - (int64_t)sum_s * sum_s + 64 * (int64_t)sum_sq_r -
+                 (int64_t)sum_r * sum_r + SSIM_C2);
+            ssim_total += (double)ssim_n / (double)ssim_d;
+            ++samples;
+        }
+    }
+
+    return samples ? ssim_total / samples : 1.0;
+}
+
+/******************************************************
+ * Compute the per plane SSE and SSIM of the
+ * reconstructed picture against the saved source
+ * (stat_report)
+ ******************************************************/
+static void compute_picture_quality(SequenceControlSet *sequence_control_set_ptr,
+                                    PictureControlSet *picture_control_set_ptr,
+                                    EbPictureBufferDesc *recon_picture_ptr) {
+    PictureParentControlSet *parent_pcs_ptr     = picture_control_set_ptr->parent_pcs_ptr;
+    EbPictureBufferDesc     *source_picture_ptr = parent_pcs_ptr->save_source_picture_ptr;
+    const uint32_t           luma_width         = recon_picture_ptr->width - sequence_control_set_ptr->pad_right;
+    const uint32_t           luma_height        = recon_picture_ptr->height - sequence_control_set_ptr->pad_bottom;
+    uint8_t                 *recon_y            = recon_picture_ptr->buffer_y + recon_picture_ptr->origin_x +
+        recon_picture_ptr->origin_y * recon_picture_ptr->stride_y;
+    uint8_t                 *recon_cb           = recon_picture_ptr->buffer_cb + (recon_picture_ptr->origin_x >> 1) +
+        (recon_picture_ptr->origin_y >> 1) * recon_picture_ptr->stride_cb;
+    uint8_t                 *recon_cr           = recon_picture_ptr->buffer_cr + (recon_picture_ptr->origin_x >> 1) +
+        (recon_picture_ptr->origin_y >> 1) * recon_picture_ptr->stride_cr;
+
+    parent_pcs_ptr->luma_sse = compute_plane_sse(source_picture_ptr->buffer_y,
+                                                 source_picture_ptr->stride_y,
+                                                 recon_y,
+                                                 recon_picture_ptr->stride_y,
+                                                 luma_width,
+                                                 luma_height,
+                                                 MAX_SB_SIZE);
+    parent_pcs_ptr->cb_sse   = compute_plane_sse(source_picture_ptr->buffer_cb,
+                                               source_picture_ptr->stride_cb,
+                                               recon_cb,
+                                               recon_picture_ptr->stride_cb,
+                                               luma_width >> 1,
+                                               luma_height >> 1,
+                                               MAX_SB_SIZE >> 1);
+    parent_pcs_ptr->cr_sse   = compute_plane_sse(source_picture_ptr->buffer_cr,
+                                               source_picture_ptr->stride_cr,
+                                               recon_cr,
+                                               recon_picture_ptr->stride_cr,
+                                               luma_width >> 1,
+                                               luma_height >> 1,
+                                               MAX_SB_SIZE >> 1);
+
+    parent_pcs_ptr->luma_ssim = compute_plane_ssim(source_picture_ptr->buffer_y,
+                                                   source_picture_ptr->stride_y,
+                                                   recon_y,
+                                                   recon_picture_ptr->stride_y,
+                                                   luma_width,
+                                                   luma_height);
+    parent_pcs_ptr->cb_ssim   = compute_plane_ssim(source_picture_ptr->buffer_cb,
+                                                 source_picture_ptr->stride_cb,
+                                                 recon_cb,
+                                                 recon_picture_ptr->stride_cb,
+                                                 luma_width >> 1,
+                                                 luma_height >> 1);
+    parent_pcs_ptr->cr_ssim   = compute_plane_ssim(source_picture_ptr->buffer_cr,
+                                                 source_picture_ptr->stride_cr,
+                                                 recon_cr,
+                                                 recon_picture_ptr->stride_cr,
+                                                 luma_width >> 1,
+                                                 luma_height >> 1);
+}
+
+/******************************************************
+ * Loop Filter Level Search: reset @ the MDC task, the
+ * candidate levels are spread coarse to fine around the
+ * level derived from the qindex
+ ******************************************************/
+static void lf_search_init(PictureControlSet *picture_control_set_ptr) {
+    static const int8_t lf_search_offset[] = {0, -1, 1, -2, 2, -4, 4, -8, 8};
+    VP9_COMP *const     cpi                = picture_control_set_ptr->parent_pcs_ptr->cpi;
+    VP9_COMMON *const   cm                 = &cpi->common;
+    uint32_t            offset_index;
+    uint32_t            level_index;
+    int                 level;
+
+    eb_vp9_pick_filter_level(cpi, LPF_PICK_FROM_Q);
+
+    picture_control_set_ptr->lf_search_level_count = 0;
+    for (offset_index = 0; offset_index <= sizeof(lf_search_offset) / sizeof(lf_search_offset[0]); ++offset_index) {
+        // OFF ends the list
+        level = (offset_index < sizeof(lf_search_offset) / sizeof(lf_search_offset[0]))
+            ? clamp(cm->lf.filter_level + lf_search_offset[offset_index], 0, MAX_LOOP_FILTER)
+            : 0;
+
+        for (level_index = 0; level_index < picture_control_set_ptr->lf_search_level_count; ++level_index) {
+            if (picture_control_set_ptr->lf_search_level_array[level_index] == level)
+                break;
+        }
+        if (level_index == picture_control_set_ptr->lf_search_level_count) {
+            picture_control_set_ptr->lf_search_level_array[picture_control_set_ptr->lf_search_level_count++] =
+                (uint8_t)level;
+        }
+    }
+    memset(picture_control_set_ptr->lf_search_sse_array, 0, sizeof(picture_control_set_ptr->lf_search_sse_array));
+    picture_control_set_ptr->lf_search_pending_row_count = (cm->mi_rows + MI_MASK) >> MI_BLOCK_SIZE_LOG2;
+    picture_control_set_ptr->lf_search_waiting           = EB_FALSE;
+
+    // The masks are built with a non zero level on every block, the candidate level goes in lfl_y
+    eb_vp9_loop_filter_init(cm);
+    memset(cm->lf_info.lvl, 1, sizeof(cm->lf_info.lvl));
+
+    // Set mi_grid_visible
+    cm->mi_grid_visible = picture_control_set_ptr->mode_info_array;
+}
+
+/******************************************************
+ * Loop Filter Level Search: luma SSE of an SB row for
+ * each level, filtered in the thread scratch. The last
+ * rows of the SB row are measured with the next SB row
+ * since its top edge filters them again
+ ******************************************************/
+static void lf_search_sb_row(SequenceControlSet *sequence_control_set_ptr, PictureControlSet *picture_control_set_ptr,
+                             EncDecContext *context_ptr, uint32_t sb_row_index, const uint8_t *level_array,
+                             uint32_t level_count, uint64_t *sse_array) {
+    VP9_COMMON *const          cm                 = &picture_control_set_ptr->parent_pcs_ptr->cpi->common;
+    EbPictureBufferDesc *const recon_picture_ptr  = context_ptr->recon_buffer;
+    EbPictureBufferDesc *const source_picture_ptr = picture_control_set_ptr->parent_pcs_ptr->enhanced_picture_ptr;
+    const int                  mi_row             = sb_row_index << MI_BLOCK_SIZE_LOG2;
+    const uint32_t             stride             = context_ptr->lf_search_buffer_stride;
+    const uint32_t             luma_width  = recon_picture_ptr->width - sequence_control_set_ptr->pad_right;
+    const uint32_t             luma_height = recon_picture_ptr->height - sequence_control_set_ptr->pad_bottom;
+    const uint32_t             row_y       = sb_row_index << LOG2F_MAX_SB_SIZE;
+    const uint32_t             top_rows    = sb_row_index ? LF_SEARCH_TOP_ROWS : 0;
+    const uint32_t             copy_width  = cm->mi_cols << MI_SIZE_LOG2;
+    const uint32_t copy_height = MIN(MAX_SB_SIZE, (uint32_t)(cm->mi_rows << MI_SIZE_LOG2) - row_y) + top_rows;
+    const uint32_t sse_y       = row_y - top_rows;
+    const uint32_t sse_height  = ((mi_row + MI_BLOCK_SIZE >= cm->mi_rows) ? luma_height
+                                                                          : row_y + MAX_SB_SIZE - LF_SEARCH_TOP_ROWS) -
+        sse_y;
+    uint8_t *const recon_ptr = recon_picture_ptr->buffer_y + recon_picture_ptr->origin_x +
+        (recon_picture_ptr->origin_y + sse_y) * recon_picture_ptr->stride_y;
+    uint8_t *const source_ptr = source_picture_ptr->buffer_y + source_picture_ptr->origin_x +
+        (source_picture_ptr->origin_y + sse_y) * source_picture_ptr->stride_y;
+    ModeInfo **const         mi = cm->mi_grid_visible + mi_row * cm->mi_stride;
+    struct macroblockd_plane plane;
+    uint32_t                 level_index;
+    uint32_t                 y;
+    int                      mi_col;
+
+    // The masks do not depend on the level
+    for (mi_col = 0; mi_col < cm->mi_cols; mi_col += MI_BLOCK_SIZE) {
+        LOOP_FILTER_MASK *lfm = &context_ptr->lf_search_mask_array[mi_col >> MI_BLOCK_SIZE_LOG2];
+        eb_vp9_setup_mask(cm, mi_row, mi_col, mi + mi_col, cm->mi_stride, lfm);
+        eb_vp9_adjust_mask(cm, mi_row, mi_col, lfm);
+    }
+
+    memset(&plane, 0, sizeof(plane));
+    plane.dst.stride = stride;
+
+    for (level_index = 0; level_index < level_count; ++level_index) {
+        const uint8_t level = level_array[level_index];
+
+        if (level == 0) {
+            sse_array[level_index] = compute_plane_sse(source_ptr,
+                                                       source_picture_ptr->stride_y,
+                                                       recon_ptr,
+                                                       recon_picture_ptr->stride_y,
+                                                       luma_width,
+                                                       sse_height,
+                                                       MAX_SB_SIZE);
+            continue;
+        }
+
+        for (y = 0; y < copy_height; ++y) {
+            EB_MEMCPY(context_ptr->lf_search_buffer + y * stride,
+                      recon_ptr + y * recon_picture_ptr->stride_y,
+                      copy_width);
+        }
+
+        for (mi_col = 0; mi_col < cm->mi_cols; mi_col += MI_BLOCK_SIZE) {
+            LOOP_FILTER_MASK *lfm = &context_ptr->lf_search_mask_array[mi_col >> MI_BLOCK_SIZE_LOG2];
+            memset(lfm->lfl_y, level, sizeof(lfm->lfl_y));
+            plane.dst.buf = context_ptr->lf_search_buffer + top_rows * stride + (mi_col << MI_SIZE_LOG2);
+            eb_vp9_filter_block_plane_ss00(cm, &plane, mi_row, lfm);
+        }
+
+        sse_array[level_index] = compute_plane_sse(source_ptr,
+                                                   source_picture_ptr->stride_y,
+                                                   context_ptr->lf_search_buffer,
+                                                   stride,
+                                                   luma_width,
+                                                   sse_height,
+                                                   MAX_SB_SIZE);
+    }
+}
+
+/******************************************************
+ * Loop Filter Level Search: add the SSE of an SB row,
+ * the last pending row wakes up the last SB thread
+ ******************************************************/
+static void lf_search_sb_row_done(PictureControlSet *picture_control_set_ptr, const uint64_t *sse_array) {
+    uint32_t level_index;
+
+    eb_vp9_block_on_mutex(picture_control_set_ptr->lf_search_mutex);
+    for (level_index = 0; level_index < picture_control_set_ptr->lf_search_level_count; ++level_index)
+        picture_control_set_ptr->lf_search_sse_array[level_index] += sse_array[level_index];
+    if (--picture_control_set_ptr->lf_search_pending_row_count == 0 && picture_control_set_ptr->lf_search_waiting)
+        eb_vp9_post_semaphore(picture_control_set_ptr->lf_search_done_semaphore);
+    eb_vp9_release_mutex(picture_control_set_ptr->lf_search_mutex);
+}
+
+/******************************************************
+ * Loop Filter Level Search: evaluate completed SB rows
+ ******************************************************/
+static void lf_search_sb_rows(SequenceControlSet *sequence_control_set_ptr, PictureControlSet *picture_control_set_ptr,
+                              EncDecContext *context_ptr, uint32_t sb_row_index_start, uint32_t sb_row_count) {
+    uint64_t sse_array[LF_SEARCH_MAX_LEVELS];
+    uint32_t sb_row_index;
+
+    for (sb_row_index = sb_row_index_start; sb_row_index < sb_row_index_start + sb_row_count; ++sb_row_index) {
+        lf_search_sb_row(sequence_control_set_ptr,
+                         picture_control_set_ptr,
+                         context_ptr,
+                         sb_row_index,
+                         picture_control_set_ptr->lf_search_level_array,
+                         picture_control_set_ptr->lf_search_level_count,
+                         sse_array);
+        lf_search_sb_row_done(picture_control_set_ptr, sse_array);
+    }
+}
+
+/******************************************************
+ * Loop Filter Level Search: @ the last SB, once all the
+ * SB rows are evaluated, the levels between the best one
+ * and its neighbours in the coarse steps are evaluated
+ * on the whole picture, the lowest SSE wins
+ ******************************************************/
+static void lf_search_pick_level(SequenceControlSet *sequence_control_set_ptr,
+                                 PictureControlSet *picture_control_set_ptr, EncDecContext *context_ptr) {
+    struct loop_filter *const lf = &picture_control_set_ptr->parent_pcs_ptr->cpi->common.lf;
+    const uint32_t            sb_row_count =
+        (picture_control_set_ptr->parent_pcs_ptr->cpi->common.mi_rows + MI_MASK) >> MI_BLOCK_SIZE_LOG2;
+    uint8_t  fine_level_array[4];
+    uint64_t fine_sse_array[4];
+    uint64_t row_sse_array[4];
+    uint32_t fine_level_count = 0;
+    uint32_t level_index;
+    uint32_t sb_row_index;
+    uint8_t  best_level;
+    uint64_t best_sse;
+    int      step;
+
+    eb_vp9_block_on_mutex(picture_control_set_ptr->lf_search_mutex);
+    if (picture_control_set_ptr->lf_search_pending_row_count) {
+        picture_control_set_ptr->lf_search_waiting = EB_TRUE;
+        eb_vp9_release_mutex(picture_control_set_ptr->lf_search_mutex);
+        eb_vp9_block_on_semaphore(picture_control_set_ptr->lf_search_done_semaphore);
+    } else {
+        eb_vp9_release_mutex(picture_control_set_ptr->lf_search_mutex);
+    }
+
+    best_level = picture_control_set_ptr->lf_search_level_array[0];
+    best_sse   = picture_control_set_ptr->lf_search_sse_array[0];
+    for (level_index = 1; level_index < picture_control_set_ptr->lf_search_level_count; ++level_index) {
+        const uint8_t  level = picture_control_set_ptr->lf_search_level_array[level_index];
+        const uint64_t sse   = picture_control_set_ptr->lf_search_sse_array[level_index];
+        if (sse < best_sse || (sse == best_sse && level < best_level)) {
+            best_level = level;
+            best_sse   = sse;
+        }
+    }
+
+    // Fine steps: the levels within 2 of the best one that the coarse steps skipped
+    for (step = -2; step <= 2; ++step) {
+        const int level = best_level + step;
+        if (step == 0 || level < 0 || level > MAX_LOOP_FILTER)
+            continue;
+        for (level_index = 0; level_index < picture_control_set_ptr->lf_search_level_count; ++level_index) {
+            if (picture_control_set_ptr->lf_search_level_array[level_index] == level)
+                break;
+        }
+        if (level_index == picture_control_set_ptr->lf_search_level_count) {
+            fine_level_array[fine_level_count++] = (uint8_t)level;
+        }
+    }
+
+    if (fine_level_count) {
+        memset(fine_sse_array, 0, sizeof(fine_sse_array));
+        for (sb_row_index = 0; sb_row_index < sb_row_count; ++sb_row_index) {
+            lf_search_sb_row(sequence_control_set_ptr,
+                             picture_control_set_ptr,
+                             context_ptr,
+                             sb_row_index,
+                             fine_level_array,
+                             fine_level_count,
+                             row_sse_array);
+            for (level_index = 0; level_index < fine_level_count; ++level_index)
+                fine_sse_array[level_index] += row_sse_array[level_index];
+        }
+        for (level_index = 0; level_index < fine_level_count; ++level_index) {
+            const uint8_t  level = fine_level_array[level_index];
+            const uint64_t sse   = fine_sse_array[level_index];
+            if (sse < best_sse || (sse == best_sse && level < best_level)) {
+                best_level = level;
+                best_sse   = sse;
+            }
+        }
+    }
+
+    lf->sharpness_level = 0;
+    lf->filter_level    = best_level;
+}
+
 static void pad_ref_and_set_flags(PictureControlSet  *picture_control_set_ptr,
                                   SequenceControlSet *sequence_control_set_ptr) {
     EbReferenceObject *reference_object =
@@ -4904,6 +5669,28 @@ void copy_statistics_to_ref_object(PictureControlSet *picture_control_set_ptr) {
         ->is_scene_change = picture_control_set_ptr->parent_pcs_ptr->scene_change_flag;
 }
 
+/******************************************************
+        * Derive EncDec Settings common to all tunes
+        Input   : encoder mode and the tune settings
+        Output  : EncDec Kernel signal(s)
+        ******************************************************/
+static void signal_derivation_enc_dec_kernel_common(SequenceControlSet *sequence_control_set_ptr,
+                                                    PictureControlSet  *picture_control_set_ptr,
+                                                    EncDecContext      *context_ptr) {
+    // Set Loop Filter Level Search
+    // The SB rows are filtered from the unfiltered recon, so every SB has to be reconstructed
+    if (sequence_control_set_ptr->static_config.loop_filter && picture_control_set_ptr->enc_mode <= ENC_MODE_1 &&
+        context_ptr->limit_intra == EB_FALSE && context_ptr->is16bit == EB_FALSE) {
+        context_ptr->lf_level_search = EB_TRUE;
+    } else {
+        context_ptr->lf_level_search = EB_FALSE;
+    }
+
+    // Set MD results reuse @ EP
+    // Bit-exact: the EP only takes the MD results when it would derive the same ones
+    context_ptr->md_results_reuse = EB_TRUE;
+}
+
 /******************************************************
         * Derive EncDec Settings for SQ
         Input   : encoder mode and tune
@@ -5023,9 +5810,9 @@ EbErrorType eb_vp9_signal_derivation_enc_dec_kernel_sq(SequenceControlSet *seque
     // 2                    3
     // 3                    2
     // 4                    1
-    if (picture_control_set_ptr->enc_mode <= ENC_MODE_2) {
+    if (picture_control_set_ptr->parent_pcs_ptr->nfl_enc_mode <= ENC_MODE_2) {
         context_ptr->nfl_level = 0;
-    } else if (picture_control_set_ptr->enc_mode <= ENC_MODE_4) {
+    } else if (picture_control_set_ptr->parent_pcs_ptr->nfl_enc_mode <= ENC_MODE_4) {
         context_ptr->nfl_level = 1;
     } else {
         context_ptr->nfl_level = 2;
@@ -5162,9 +5949,9 @@ EbErrorType eb_vp9_signal_derivation_enc_dec_kernel_oq(SequenceControlSet *seque
     // 2                    3
     // 3                    2
     // 4                    1
-    if (picture_control_set_ptr->enc_mode <= ENC_MODE_2) {
+    if (picture_control_set_ptr->parent_pcs_ptr->nfl_enc_mode <= ENC_MODE_2) {
         context_ptr->nfl_level = 0;
-    } else if (picture_control_set_ptr->enc_mode <= ENC_MODE_4) {
+    } else if (picture_control_set_ptr->parent_pcs_ptr->nfl_enc_mode <= ENC_MODE_4) {
         context_ptr->nfl_level = 1;
     } else {
         context_ptr->nfl_level = 2;
@@ -5289,9 +6076,9 @@ EbErrorType eb_vp9_signal_derivation_enc_dec_kernel_vmaf(SequenceControlSet *seq
     // 2                    3
     // 3                    2
     // 4                    1
-    if (picture_control_set_ptr->enc_mode <= ENC_MODE_2) {
+    if (picture_control_set_ptr->parent_pcs_ptr->nfl_enc_mode <= ENC_MODE_2) {
         context_ptr->nfl_level = 0;
-    } else if (picture_control_set_ptr->enc_mode <= ENC_MODE_4) {
+    } else if (picture_control_set_ptr->parent_pcs_ptr->nfl_enc_mode <= ENC_MODE_4) {
         context_ptr->nfl_level = 1;
     } else {
         context_ptr->nfl_level = 2;
@@ -5329,6 +6116,8 @@ void *eb_vp9_enc_dec_kernel(void *input_ptr) {
     EB_BOOL  end_of_row_flag;
     uint32_t sb_row_index_start;
     uint32_t sb_row_index_count;
+    uint32_t lf_search_row_index_start;
+    uint32_t lf_search_row_count;
     uint32_t picture_width_in_sb;
 
     // Segments
@@ -5343,9 +6132,18 @@ void *eb_vp9_enc_dec_kernel(void *input_ptr) {
     uint32_t        segment_band_size;
     EncDecSegments *segments_ptr;
 
+    // Speed Control
+    uint64_t start_seconds;
+    uint64_t start_useconds;
+    uint64_t finish_seconds;
+    uint64_t finish_useconds;
+
     for (;;) {
         // Get Mode Decision Results
         eb_vp9_get_full_object(context_ptr->mode_decision_input_fifo_ptr, &enc_dec_tasks_wrapper_ptr);
+        if (enc_dec_tasks_wrapper_ptr == EB_NULL)
+            return EB_NULL;
+        svt_vp9_get_time(&start_seconds, &start_useconds);
 
         enc_dec_tasks_ptr        = (EncDecTasks *)enc_dec_tasks_wrapper_ptr->object_ptr;
         picture_control_set_ptr  = (PictureControlSet *)enc_dec_tasks_ptr->picture_control_set_wrapper_ptr->object_ptr;
@@ -5361,6 +6159,7 @@ void *eb_vp9_enc_dec_kernel(void *input_ptr) {
         picture_width_in_sb = (sequence_control_set_ptr->luma_width + MAX_SB_SIZE_MINUS_1) >> LOG2F_MAX_SB_SIZE;
         end_of_row_flag     = EB_FALSE;
         sb_row_index_start = sb_row_index_count = 0;
+        lf_search_row_index_start = lf_search_row_count = 0;
 
         // EncDec Kernel Signal(s) derivation
         if (sequence_control_set_ptr->static_config.tune == TUNE_SQ) {
@@ -5371,6 +6170,7 @@ void *eb_vp9_enc_dec_kernel(void *input_ptr) {
         } else {
             eb_vp9_signal_derivation_enc_dec_kernel_oq(sequence_control_set_ptr, picture_control_set_ptr, context_ptr);
         }
+        signal_derivation_enc_dec_kernel_common(sequence_control_set_ptr, picture_control_set_ptr, context_ptr);
 
         // Set valid ref_frame
         if (picture_control_set_ptr->slice_type != I_SLICE) {
@@ -5427,6 +6227,11 @@ void *eb_vp9_enc_dec_kernel(void *input_ptr) {
         context_ptr->eob_zero_mode = (sequence_control_set_ptr->static_config.tune != TUNE_SQ ||
                                       picture_control_set_ptr->temporal_layer_index > 0);
 
+        // Loop Filter Level Search state, the MDC task precedes the coding of any SB of the picture
+        if (context_ptr->lf_level_search && enc_dec_tasks_ptr->input_type == ENCDEC_TASKS_MDC_INPUT) {
+            lf_search_init(picture_control_set_ptr);
+        }
+
         // Hsan: could be simplified
         eb_vp9_setup_scale_factors_for_frame(
             context_ptr->sf,
@@ -5448,6 +6253,17 @@ void *eb_vp9_enc_dec_kernel(void *input_ptr) {
         while (assign_enc_dec_segments(
                    segments_ptr, &segment_index, enc_dec_tasks_ptr, context_ptr->enc_dec_feedback_fifo_ptr) ==
                EB_TRUE) {
+            // Loop Filter Level Search of the SB rows completed by the previous segment, off the wavefront
+            //   now that the segments that depend on it are released
+            if (lf_search_row_count) {
+                lf_search_sb_rows(sequence_control_set_ptr,
+                                  picture_control_set_ptr,
+                                  context_ptr,
+                                  lf_search_row_index_start,
+                                  lf_search_row_count);
+                lf_search_row_count = 0;
+            }
+
             x_sb_start_index = segments_ptr->x_start_array[segment_index];
             y_sb_start_index = segments_ptr->y_start_array[segment_index];
             sb_start_index   = y_sb_start_index * picture_width_in_sb + x_sb_start_index;
@@ -5510,6 +6326,8 @@ void *eb_vp9_enc_dec_kernel(void *input_ptr) {
                         : EB_TRUE;
 
 #if SEG_SUPPORT
+                    context_ptr->segment_id = sb_ptr->segment_id;
+
                     VP9_COMMON *const          cm     = &picture_control_set_ptr->parent_pcs_ptr->cpi->common;
                     struct segmentation *const seg    = &cm->seg;
                     const int                  qindex = eb_vp9_get_qindex(
@@ -5520,9 +6338,9 @@ void *eb_vp9_enc_dec_kernel(void *input_ptr) {
                     context_ptr->RDMULT = eb_vp9_compute_rd_mult(picture_control_set_ptr->parent_pcs_ptr->cpi, qindex);
                     context_ptr->rd_mult_sad = (int)MAX(round(sqrtf((float)context_ptr->RDMULT / 128) * 128), 1);
 
-#if SEG_SUPPORT
-                    context_ptr->segment_id = sb_ptr->segment_id;
-#endif
+                    // Reset the MD results kept for the encode pass
+                    memset(context_ptr->md_reuse_block_owner, 0, sizeof(context_ptr->md_reuse_block_owner));
+
                     if (picture_control_set_ptr->parent_pcs_ptr->pic_depth_mode == PIC_FULL85_DEPTH_MODE ||
                         picture_control_set_ptr->parent_pcs_ptr->pic_depth_mode == PIC_FULL84_DEPTH_MODE ||
                         picture_control_set_ptr->parent_pcs_ptr->pic_depth_mode == PIC_OPEN_LOOP_DEPTH_MODE ||
@@ -5543,6 +6361,8 @@ void *eb_vp9_enc_dec_kernel(void *input_ptr) {
                           picture_control_set_ptr->parent_pcs_ptr->sb_depth_mode_array[sb_index] ==
                               SB_PRED_OPEN_LOOP_1_NFL_DEPTH_MODE))) {
                         // MDC depth partitioning
+                        eb_vp9_mode_decision_configuration_sb(
+                            context_ptr->mdc_context_ptr, sequence_control_set_ptr, picture_control_set_ptr, sb_index);
                         context_ptr->depth_part_stage = 0;
                         eb_vp9_mode_decision_sb(sequence_control_set_ptr, picture_control_set_ptr, context_ptr, sb_ptr);
 
@@ -5616,12 +6436,26 @@ void *eb_vp9_enc_dec_kernel(void *input_ptr) {
 
                     // Encode Pass
                     encode_pass_sb(sequence_control_set_ptr, picture_control_set_ptr, context_ptr, sb_ptr);
+
+                    // Loop Filter Level Search, the SB row is complete
+                    if (context_ptr->lf_level_search && end_of_row_flag) {
+                        lf_search_row_index_start = lf_search_row_count ? lf_search_row_index_start : ysb_index;
+                        ++lf_search_row_count;
+                    }
 #endif
                 }
                 x_sb_start_index = (x_sb_start_index > 0) ? x_sb_start_index - 1 : 0;
             }
         }
 
+        if (lf_search_row_count) {
+            lf_search_sb_rows(sequence_control_set_ptr,
+                              picture_control_set_ptr,
+                              context_ptr,
+                              lf_search_row_index_start,
+                              lf_search_row_count);
+        }
+
         if (last_sb_flag) {
             struct loop_filter *lf = &picture_control_set_ptr->parent_pcs_ptr->cpi->common.lf;
             // Initialize Loop Filter Parameters
@@ -5631,17 +6465,23 @@ void *eb_vp9_enc_dec_kernel(void *input_ptr) {
             lf->mode_ref_delta_enabled = 0;
 
             if (sequence_control_set_ptr->static_config.loop_filter) {
-                eb_vp9_pick_filter_level(
+                if (context_ptr->lf_level_search) {
+                    lf_search_pick_level(sequence_control_set_ptr, picture_control_set_ptr, context_ptr);
+                } else {
+                    eb_vp9_pick_filter_level(
 #if 0
-                            picture_control_set_ptr->parent_pcs_ptr->cpi->Source,
+                                picture_control_set_ptr->parent_pcs_ptr->cpi->Source,
 #endif
-                    picture_control_set_ptr->parent_pcs_ptr->cpi, LPF_PICK_FROM_Q);
+                        picture_control_set_ptr->parent_pcs_ptr->cpi, LPF_PICK_FROM_Q);
+                }
 
                 EB_BOOL lf_application_enable_flag;
 
                 if ((context_ptr->allow_enc_dec_mismatch == EB_TRUE ||
                      picture_control_set_ptr->parent_pcs_ptr->is_used_as_reference_flag == EB_FALSE) &&
-                    sequence_control_set_ptr->static_config.recon_file == EB_FALSE) {
+                    sequence_control_set_ptr->static_config.recon_file == EB_FALSE &&
+                    sequence_control_set_ptr->static_config.recon_view == EB_FALSE &&
+                    sequence_control_set_ptr->static_config.stat_report == EB_FALSE) {
                     lf_application_enable_flag = EB_FALSE;
                 } else {
                     lf_application_enable_flag = EB_TRUE;
@@ -5687,6 +6527,18 @@ void *eb_vp9_enc_dec_kernel(void *input_ptr) {
                 }
             }
 
+            // Quality statistics, on the loop filtered recon
+            if (picture_control_set_ptr->parent_pcs_ptr->save_source_picture_ptr && !context_ptr->is16bit) {
+                compute_picture_quality(sequence_control_set_ptr, picture_control_set_ptr, context_ptr->recon_buffer);
+            } else {
+                picture_control_set_ptr->parent_pcs_ptr->luma_sse  = 0;
+                picture_control_set_ptr->parent_pcs_ptr->cb_sse    = 0;
+                picture_control_set_ptr->parent_pcs_ptr->cr_sse    = 0;
+                picture_control_set_ptr->parent_pcs_ptr->luma_ssim = 0;
+                picture_control_set_ptr->parent_pcs_ptr->cb_ssim   = 0;
+                picture_control_set_ptr->parent_pcs_ptr->cr_ssim   = 0;
+            }
+
             if (picture_control_set_ptr->parent_pcs_ptr->reference_picture_wrapper_ptr != NULL) {
                 copy_statistics_to_ref_object(picture_control_set_ptr);
             }
@@ -5760,12 +6612,14 @@ void *eb_vp9_enc_dec_kernel(void *input_ptr) {
             }
 
             if (encode_context_ptr->recon_port_active) {
-                recon_output(picture_control_set_ptr, sequence_control_set_ptr);
+                recon_output(enc_dec_tasks_ptr->picture_control_set_wrapper_ptr, sequence_control_set_ptr);
             }
 
             if (picture_control_set_ptr->parent_pcs_ptr->is_used_as_reference_flag) {
                 // Get Empty EntropyCoding Results
                 eb_vp9_get_empty_object(context_ptr->picture_demux_output_fifo_ptr, &picture_demux_results_wrapper_ptr);
+                if (picture_demux_results_wrapper_ptr == EB_NULL)
+                    return EB_NULL;
 
                 picture_demux_results_ptr = (PictureDemuxResults *)picture_demux_results_wrapper_ptr->object_ptr;
                 picture_demux_results_ptr->reference_picture_wrapper_ptr =
@@ -5786,10 +6640,21 @@ void *eb_vp9_enc_dec_kernel(void *input_ptr) {
             // we are trying to avoid making a such change in the APP (ideally an input buffer live count should be set in the APP (under EbBufferHeaderType data structure))
         }
 
+        // Account the segment processing time to the EncDec stage load
+        if (sequence_control_set_ptr->static_config.speed_control_flag) {
+            svt_vp9_get_time(&finish_seconds, &finish_useconds);
+            eb_vp9_block_on_mutex(encode_context_ptr->sc_buffer_mutex);
+            encode_context_ptr->sc_enc_dec_busy_time += svt_vp9_compute_overall_elapsed_time_ms(
+                start_seconds, start_useconds, finish_seconds, finish_useconds);
+            eb_vp9_release_mutex(encode_context_ptr->sc_buffer_mutex);
+        }
+
         // Send the Entropy Coder incremental updates as each LCU row becomes available
         if (end_of_row_flag == EB_TRUE) {
             // Get Empty EncDec Results
             eb_vp9_get_empty_object(context_ptr->enc_dec_output_fifo_ptr, &enc_dec_results_wrapper_ptr);
+            if (enc_dec_results_wrapper_ptr == EB_NULL)
+                return EB_NULL;
             enc_dec_results_ptr = (EncDecResults *)enc_dec_results_wrapper_ptr->object_ptr;
             enc_dec_results_ptr->picture_control_set_wrapper_ptr = enc_dec_tasks_ptr->picture_control_set_wrapper_ptr;
             enc_dec_results_ptr->completed_sb_row_index_start    = sb_row_index_start;
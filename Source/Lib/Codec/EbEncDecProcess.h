@@ -18,6 +18,7 @@
 #include "EbReferenceObject.h"
 #include "EbNeighborArrays.h"
 #include "EbCodingUnit.h"
+#include "EbModeDecisionConfigurationProcess.h"
 
 #include "vpx_convolve.h"
 
@@ -34,6 +35,11 @@ extern "C" {
 #define MODE_DECISION_CANDIDATE_BUFFER_MAX_COUNT (MAX_NFL + 1) * 5
 #define MAX_FULL_LOOP_CANIDATES_PER_DEPTH MAX_NFL
 
+#define MD_REUSE_BLOCK_STRIDE (MAX_SB_SIZE >> 3)
+#define MD_REUSE_BLOCK_COUNT (MD_REUSE_BLOCK_STRIDE * MD_REUSE_BLOCK_STRIDE)
+
+#define LF_SEARCH_TOP_ROWS 8 // rows above an SB row that the loop filter reads and writes
+
 /**************************************
 * Macros
 **************************************/
@@ -44,6 +50,17 @@ extern "C" {
 #define GROUP_OF_4_32x32_BLOCKS(origin_x, origin_y) \
     (((((origin_x >> 3) & 0x4) == 0x4) && (((origin_y >> 3) & 0x4) == 0x4)) ? EB_TRUE : EB_FALSE)
 
+/**************************************
+ * Recon View (recon_view)
+ **************************************/
+typedef struct EbReconView {
+    // Returned to the application, header.p_buffer points to planes
+    EbBufferHeaderType header;
+    EbSvtEncInput      planes;
+    // Reference object, or picture control set of a non reference picture, held until the view is released
+    EbObjectWrapper *picture_wrapper_ptr;
+} EbReconView;
+
 /**************************************
  * Coding Loop Context
  **************************************/
@@ -53,6 +70,17 @@ typedef struct EncDecBlockUnit {
 
 } EncDecBlockUnit;
 
+/**************************************
+ * Mode decision results of a committed
+ * block, reused by the encode pass
+ **************************************/
+typedef struct MdReuseBlock {
+    ModeInfo  mode_info;
+    EB_BOOL   chroma_valid;
+    uint16_t  eob[MAX_MB_PLANE][4]; // after the block skip decision
+    TuResults tu_results[MAX_MB_PLANE][4];
+} MdReuseBlock;
+
 /**************************************
 * Enc Dec Context
 **************************************/
@@ -142,6 +170,7 @@ typedef struct EncDecContext {
 
     uint8_t pf_md_level;
     uint8_t nfl_level;
+    EB_BOOL lf_level_search;
 
     // Hsan: how to avoid intra_above_ref and intra_left_ref (lossless optimization toward faster generate_intra_reference_samples).
     uint8_t *intra_above_ref;
@@ -198,6 +227,22 @@ typedef struct EncDecContext {
     int RDMULT;
     int rd_mult_sad;
 
+    // Mode decision results reuse @ encode pass
+    EB_BOOL              md_results_reuse;
+    EbPictureBufferDesc *md_reuse_recon_buffer;
+    EbPictureBufferDesc *md_reuse_coeff_buffer;
+    uint16_t     md_reuse_block_owner[MD_REUSE_BLOCK_COUNT]; // per 8x8: ep_block_index + 1 of the kept block, 0: none
+    MdReuseBlock md_reuse_block[MD_REUSE_BLOCK_COUNT];       // @ the 8x8 of the block origin
+
+    // SB partitioning scratch of the MDC, the SBs are configured by the thread that codes them
+    ModeDecisionConfigurationContext *mdc_context_ptr;
+
+    // Loop filter level search scratch: the luma of one SB row plus the rows above it that the filter reads,
+    // and the masks of the SBs of the row
+    uint8_t          *lf_search_buffer;
+    uint32_t          lf_search_buffer_stride;
+    LOOP_FILTER_MASK *lf_search_mask_array;
+
 } EncDecContext;
 
 /**************************************
@@ -209,7 +254,7 @@ extern void eb_vp9_reset_mode_decision(EncDecContext *context_ptr, PictureContro
 extern EbErrorType eb_vp9_enc_dec_context_ctor(EncDecContext **context_dbl_ptr,
                                                EbFifo         *mode_decision_configuration_input_fifo_ptr,
                                                EbFifo *packetization_output_fifo_ptr, EbFifo *feedback_fifo_ptr,
-                                               EbFifo *picture_demux_fifo_ptr);
+                                               EbFifo *picture_demux_fifo_ptr, uint32_t max_picture_width);
 
 extern void *eb_vp9_enc_dec_kernel(void *input_ptr);
 
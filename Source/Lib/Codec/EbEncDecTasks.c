@@ -18,3 +18,13 @@ EbErrorType eb_vp9_enc_dec_tasks_ctor(EbPtr *object_dbl_ptr, EbPtr object_init_d
 
     return EB_ErrorNone;
 }
+
+/**************************************
+ * eb_vp9_enc_dec_tasks_node
+ *   the node of the picture control set the task
+ *   is for, the EncDec processes of that node
+ *   take the task first
+ **************************************/
+uint32_t eb_vp9_enc_dec_tasks_node(EbObjectWrapper *wrapper_ptr) {
+    return ((EncDecTasks *)wrapper_ptr->object_ptr)->picture_control_set_wrapper_ptr->node_index;
+}
@@ -33,6 +33,7 @@ typedef struct EncDecTasksInitData {
  * Extern Function Declarations
  **************************************/
 extern EbErrorType eb_vp9_enc_dec_tasks_ctor(EbPtr *object_dbl_ptr, EbPtr object_init_data_ptr);
+extern uint32_t    eb_vp9_enc_dec_tasks_node(EbObjectWrapper *wrapper_ptr);
 
 #ifdef __cplusplus
 }
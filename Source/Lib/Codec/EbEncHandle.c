@@ -17,6 +17,7 @@
 
 #include <stdlib.h>
 #include <stdio.h>
+#include <stddef.h>
 
 #include "EbDefinitions.h"
 #include "EbSvtVp9Enc.h"
@@ -68,6 +69,7 @@
 #include <pthread.h>
 #include <errno.h>
 #include <sys/stat.h>
+#include <sys/syscall.h>
 #include <fcntl.h>
 #endif
 
@@ -96,15 +98,10 @@
 // Buffer Transfer Parameters
 #define EB_INPUTVIDEOBUFFERSIZE \
     0x10000 //   832*480*3//      // Input Slice Size , must me a multiple of 2 in case of 10 bit video.
-#define EB_OUTPUTSTREAMBUFFERSIZE 0x2DC6C0 //0x7D00        // match MTU Size
+#define EB_OUTPUTSTREAMBUFFERMINSIZE 0x4000 // smallest output stream buffer
+#define EB_OUTPUTSTREAMBUFFERRCFACTOR 16 // output stream buffer size in average coded pictures when the rate is controlled
 #define EB_OUTPUTRECONBUFFERSIZE (MAX_PICTURE_WIDTH_SIZE * MAX_PICTURE_HEIGHT_SIZE * 2) // Recon Slice Size
-#define EB_OUTPUTSTREAMQUANT 27
 #define EB_OUTPUTSTATISTICSBUFFERSIZE 0x30 // 6X8 (8 Bytes for Y, U, V, number of bits, picture number, QP)
-#define EB_OUTPUTSTREAMBUFFERSIZE_MACRO(ResolutionSize)        \
-    ((ResolutionSize) < (INPUT_SIZE_1080i_TH)       ? 0x1E8480 \
-         : (ResolutionSize) < (INPUT_SIZE_1080p_TH) ? 0x2DC6C0 \
-         : (ResolutionSize) < (INPUT_SIZE_4K_TH)    ? 0x2DC6C0 \
-                                                    : 0x2DC6C0)
 
 static uint64_t max_luma_picture_size[TOTAL_LEVEL_COUNT] = {36864U,
                                                             122880U,
@@ -152,6 +149,8 @@ uint32_t lib_malloc_count    = 0;
 uint32_t lib_thread_count    = 0;
 uint32_t lib_semaphore_count = 0;
 uint32_t lib_mutex_count     = 0;
+uint64_t *total_lib_huge_page_memory;
+uint8_t   eb_vp9_huge_pages = HUGE_PAGES_OFF;
 
 uint8_t eb_vp9_num_groups = 0;
 #ifdef _WIN32
@@ -283,7 +282,7 @@ static int32_t can_use_intel_avx512() {
 
 // Returns ASM Type based on system configuration. AVX512 - 111, AVX2 - 011, NONAVX2 - 001, C - 000
 // Using bit-fields, the fastest function will always be selected based on the available functions in the function arrays
-uint32_t get_cpu_asm_type() {
+uint32_t get_cpu_asm_type(void) {
     uint32_t asm_type = 0;
 
     if (can_use_intel_avx512() == 1)
@@ -441,6 +440,8 @@ void lib_svt_vp9_encoder_send_error_exit(EbPtr h_component, uint32_t error_code)
     EbBufferHeaderType *output_packet;
 
     eb_vp9_get_empty_object((p_enc_comp_data->output_stream_buffer_producer_fifo_ptr_dbl_array[0])[0], &eb_wrapper_ptr);
+    if (eb_wrapper_ptr == EB_NULL)
+        return;
 
     output_packet = (EbBufferHeaderType *)eb_wrapper_ptr->object_ptr;
 
@@ -465,9 +466,11 @@ static EbErrorType eb_enc_handle_ctor(EbEncHandle **enc_handle_dbl_ptr, EbHandle
     enc_handle_ptr->memory_map       = (EbMemoryMapEntry *)malloc(sizeof(EbMemoryMapEntry) * MAX_NUM_PTR);
     enc_handle_ptr->memory_map_index = 0;
     enc_handle_ptr->total_lib_memory = sizeof(EbEncHandle) + sizeof(EbMemoryMapEntry) * MAX_NUM_PTR;
+    enc_handle_ptr->total_lib_huge_page_memory = 0;
 
     // Save Memory Map Pointers
-    total_lib_memory    = &enc_handle_ptr->total_lib_memory;
+    total_lib_memory           = &enc_handle_ptr->total_lib_memory;
+    total_lib_huge_page_memory = &enc_handle_ptr->total_lib_huge_page_memory;
     memory_map          = enc_handle_ptr->memory_map;
     memory_map_index    = &enc_handle_ptr->memory_map_index;
     lib_malloc_count    = 0;
@@ -682,6 +685,198 @@ static void eb_set_thread_management_parameters(EbSvtVp9EncConfiguration *config
 #endif
 }
 
+/**********************************
+* Memory Placement
+**********************************/
+#define MAX_NUMA_NODES 64
+// set_mempolicy() modes, see linux/mempolicy.h
+#define EB_MPOL_DEFAULT 0
+#define EB_MPOL_PREFERRED 1
+#define EB_MPOL_INTERLEAVE 3
+
+// Cleared to keep every allocation on the node of the thread calling eb_vp9_init_encoder(), as a baseline
+EbBool eb_vp9_numa_placement = EB_TRUE;
+// Number of memory nodes the encoder threads span, the per-node placement is only done above 1
+uint32_t eb_vp9_numa_node_count = 1;
+#if defined(__linux__)
+static unsigned long numa_node_id[MAX_NUMA_NODES];
+static cpu_set_t     numa_node_cpus[MAX_NUMA_NODES];
+#endif
+
+typedef struct InitThreadPlacement {
+#ifdef _WIN32
+    GROUP_AFFINITY group_affinity;
+#elif defined(__linux__)
+    cpu_set_t     affinity;
+    unsigned long node_mask;
+    EbBool        interleaved;
+#endif
+} InitThreadPlacement;
+
+#if defined(__linux__)
+/*
+* Groups the encoder processors by memory node, in numa_node_cpus[], and returns the mask of these nodes
+*/
+static unsigned long derive_encoder_nodes(const cpu_set_t *encoder_cpus) {
+    unsigned long node_mask = 0;
+
+    eb_vp9_numa_node_count = 0;
+    for (int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+        if (!CPU_ISSET(cpu, encoder_cpus))
+            continue;
+        for (unsigned long node = 0; node < MAX_NUMA_NODES; node++) {
+            char path[64];
+            snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%d/node%lu", cpu, node);
+            if (access(path, F_OK) != 0)
+                continue;
+            uint32_t node_index = 0;
+            while (node_index < eb_vp9_numa_node_count && numa_node_id[node_index] != node) node_index++;
+            if (node_index == eb_vp9_numa_node_count) {
+                numa_node_id[eb_vp9_numa_node_count++] = node;
+                CPU_ZERO(&numa_node_cpus[node_index]);
+            }
+            CPU_SET(cpu, &numa_node_cpus[node_index]);
+            node_mask |= 1UL << node;
+            break;
+        }
+    }
+    if (eb_vp9_numa_node_count == 0)
+        eb_vp9_numa_node_count = 1;
+
+    return node_mask;
+}
+#endif
+
+/*
+* The pools and the process contexts are allocated, and mostly first touched, by the thread calling
+* eb_vp9_init_encoder(). On a multi-socket system that thread is moved to the processors of the encoder
+* threads for the initialization so that their memory is placed on the node(s) the encoder runs on, and
+* interleaved across the nodes when the encoder spans several of them. In that case the per-node objects
+* (see place_init_thread_on_node) are then placed on one node each.
+*/
+static void bind_init_thread_to_encoder(InitThreadPlacement *placement) {
+    eb_vp9_numa_node_count = 1;
+    if (eb_vp9_num_groups <= 1 || !eb_vp9_numa_placement)
+        return;
+#ifdef _WIN32
+    if (!eb_vp9_alternate_groups)
+        SetThreadGroupAffinity(GetCurrentThread(), &eb_vp9_group_affinity, &placement->group_affinity);
+#elif defined(__linux__)
+    pthread_getaffinity_np(pthread_self(), sizeof(cpu_set_t), &placement->affinity);
+    placement->interleaved = EB_FALSE;
+
+    // An empty set leaves the encoder threads on all the processors of the caller
+    const cpu_set_t *encoder_cpus = CPU_COUNT(&eb_vp9_group_affinity) ? &eb_vp9_group_affinity
+                                                                      : &placement->affinity;
+    if (CPU_COUNT(&eb_vp9_group_affinity))
+        pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &eb_vp9_group_affinity);
+    placement->node_mask = derive_encoder_nodes(encoder_cpus);
+
+#ifdef SYS_set_mempolicy
+    // Keep any policy the application has set, e.g. with numactl
+    int mode = EB_MPOL_DEFAULT;
+    if (syscall(SYS_get_mempolicy, &mode, NULL, 0, NULL, 0) || mode != EB_MPOL_DEFAULT)
+        return;
+
+    if (eb_vp9_numa_node_count > 1 &&
+        syscall(SYS_set_mempolicy, EB_MPOL_INTERLEAVE, &placement->node_mask, MAX_NUMA_NODES + 1) == 0)
+        placement->interleaved = EB_TRUE;
+#endif
+#endif
+}
+
+/*
+* Per-node objects: the contexts of the processes pinned to a node (see pin_thread_to_node) and the child
+* picture control sets are constructed on that node only, the init thread is moved to its processors and,
+* unless the application set its own policy, prefers its memory
+*/
+static void place_init_thread_on_node(const InitThreadPlacement *placement, uint32_t node_index) {
+    if (eb_vp9_numa_node_count <= 1)
+        return;
+#if defined(__linux__)
+    pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &numa_node_cpus[node_index]);
+#ifdef SYS_set_mempolicy
+    if (placement->interleaved) {
+        unsigned long node_mask = 1UL << numa_node_id[node_index];
+        syscall(SYS_set_mempolicy, EB_MPOL_PREFERRED, &node_mask, MAX_NUMA_NODES + 1);
+    }
+#endif
+#else
+    (void)placement;
+    (void)node_index;
+#endif
+}
+
+// Back to the placement of the shared objects, on all the encoder nodes
+static void place_init_thread_on_encoder(const InitThreadPlacement *placement) {
+    if (eb_vp9_numa_node_count <= 1)
+        return;
+#if defined(__linux__)
+    if (CPU_COUNT(&eb_vp9_group_affinity))
+        pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &eb_vp9_group_affinity);
+    else
+        pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &placement->affinity);
+#ifdef SYS_set_mempolicy
+    if (placement->interleaved)
+        syscall(SYS_set_mempolicy, EB_MPOL_INTERLEAVE, &placement->node_mask, MAX_NUMA_NODES + 1);
+#endif
+#else
+    (void)placement;
+#endif
+}
+
+static void restore_init_thread(InitThreadPlacement *placement) {
+    if (eb_vp9_num_groups <= 1 || !eb_vp9_numa_placement)
+        return;
+#ifdef _WIN32
+    if (!eb_vp9_alternate_groups)
+        SetThreadGroupAffinity(GetCurrentThread(), &placement->group_affinity, NULL);
+#elif defined(__linux__)
+#ifdef SYS_set_mempolicy
+    if (placement->interleaved)
+        syscall(SYS_set_mempolicy, EB_MPOL_DEFAULT, NULL, 0);
+#endif
+    pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &placement->affinity);
+#endif
+}
+
+/*
+* The processes of the multi-instance stages are spread over the encoder nodes, process n runs on the
+* processors of node n % eb_vp9_numa_node_count, next to its context
+*/
+static void pin_thread_to_node(EbHandle thread_handle, uint32_t process_index) {
+    if (eb_vp9_numa_node_count <= 1)
+        return;
+#if defined(__linux__)
+    pthread_setaffinity_np(
+        *((pthread_t *)thread_handle), sizeof(cpu_set_t), &numa_node_cpus[process_index % eb_vp9_numa_node_count]);
+#else
+    (void)thread_handle;
+#endif
+}
+
+/*
+* Constructs the objects of a SystemResource in per-node sub-pools, object n on node n % eb_vp9_numa_node_count
+* (see eb_vp9_system_resource_set_object_nodes)
+*/
+typedef struct NodeObjectInitData {
+    EB_CTOR                    object_ctor;
+    EbPtr                      object_init_data_ptr;
+    const InitThreadPlacement *placement;
+    uint32_t                   object_index;
+} NodeObjectInitData;
+
+static EbErrorType node_object_ctor(EbPtr *object_dbl_ptr, EbPtr object_init_data_ptr) {
+    NodeObjectInitData *init_data_ptr = (NodeObjectInitData *)object_init_data_ptr;
+    EbErrorType         return_error;
+
+    place_init_thread_on_node(init_data_ptr->placement, init_data_ptr->object_index++ % eb_vp9_numa_node_count);
+    return_error = init_data_ptr->object_ctor(object_dbl_ptr, init_data_ptr->object_init_data_ptr);
+    place_init_thread_on_encoder(init_data_ptr->placement);
+
+    return return_error;
+}
+
 EbErrorType lib_allocate_frame_buffer(SequenceControlSet *sequence_control_set_ptr, EbBufferHeaderType *input_buffer) {
     EbErrorType                 return_error = EB_ErrorNone;
     EbPictureBufferDescInitData input_picture_buffer_desc_init_data;
@@ -754,13 +949,240 @@ EbErrorType eb_output_recon_buffer_header_ctor(EbPtr *object_dbl_ptr, EbPtr obje
 
     return EB_ErrorNone;
 }
+EbErrorType eb_output_recon_view_ctor(EbPtr *object_dbl_ptr, EbPtr object_init_data_ptr) {
+    EbReconView *view_ptr;
+    (void)object_init_data_ptr;
+
+    EB_MALLOC(EbReconView *, view_ptr, sizeof(EbReconView), EB_N_PTR);
+    *object_dbl_ptr = (EbPtr)view_ptr;
+
+    // The planes are set per picture, no picture memory is allocated
+    EB_MEMSET(view_ptr, 0, sizeof(EbReconView));
+    view_ptr->header.size     = sizeof(EbBufferHeaderType);
+    view_ptr->header.p_buffer = (uint8_t *)&view_ptr->planes;
+
+    return EB_ErrorNone;
+}
+/**********************************
+ * Apply a function to every System Resource of the encoder pipeline
+ **********************************/
+static void for_each_system_resource(EbEncHandle *enc_handle_ptr, void (*resource_function)(EbSystemResource *)) {
+    resource_function(enc_handle_ptr->sequence_control_set_pool_ptr);
+    resource_function(enc_handle_ptr->picture_parent_control_set_pool_ptr_array[0]);
+    resource_function(enc_handle_ptr->picture_control_set_pool_ptr_array[0]);
+    resource_function(enc_handle_ptr->reference_picture_pool_ptr_array[0]);
+    resource_function(enc_handle_ptr->pa_reference_picture_pool_ptr_array[0]);
+    resource_function(enc_handle_ptr->input_buffer_resource_ptr);
+    resource_function(enc_handle_ptr->output_stream_buffer_resource_ptr_array[0]);
+    if (enc_handle_ptr->output_recon_buffer_resource_ptr_array)
+        resource_function(enc_handle_ptr->output_recon_buffer_resource_ptr_array[0]);
+    resource_function(enc_handle_ptr->resource_coordination_results_resource_ptr);
+    resource_function(enc_handle_ptr->picture_analysis_results_resource_ptr);
+    resource_function(enc_handle_ptr->picture_decision_results_resource_ptr);
+    resource_function(enc_handle_ptr->motion_estimation_results_resource_ptr);
+    resource_function(enc_handle_ptr->initial_rate_control_results_resource_ptr);
+    resource_function(enc_handle_ptr->picture_demux_results_resource_ptr);
+    resource_function(enc_handle_ptr->rate_control_tasks_resource_ptr);
+    resource_function(enc_handle_ptr->rate_control_results_resource_ptr);
+    resource_function(enc_handle_ptr->enc_dec_tasks_resource_ptr);
+    resource_function(enc_handle_ptr->enc_dec_results_resource_ptr);
+    resource_function(enc_handle_ptr->entropy_coding_results_resource_ptr);
+}
+
+/**********************************
+ * Wake up the Picture Analysis processes waiting on the histograms of a picture
+ *   that no process will analyze anymore, the encoder is shutting down
+ **********************************/
+static void wake_histogram_waiters(EbEncHandle *enc_handle_ptr) {
+    EbSystemResource *pool_ptr = enc_handle_ptr->picture_parent_control_set_pool_ptr_array[0];
+    uint32_t          object_index;
+
+    for (object_index = 0; object_index < pool_ptr->object_total_count; ++object_index)
+        eb_vp9_post_semaphore(((PictureParentControlSet *)pool_ptr->wrapper_ptr_pool[object_index]->object_ptr)
+                                  ->picture_histogram_done_semaphore);
+}
+
+/**********************************
+ * Stop the encoder kernels
+ *   The kernels are signaled to quit, their threads are
+ *   joined and removed from the memory map so that
+ *   create_encoder_threads can add them again
+ **********************************/
+static void stop_encoder_threads(EbEncHandle *enc_handle_ptr) {
+    uint32_t ptr_index;
+    uint32_t kept_index = 0;
+
+    for_each_system_resource(enc_handle_ptr, eb_vp9_shutdown_process);
+    wake_histogram_waiters(enc_handle_ptr);
+
+    for (ptr_index = 0; ptr_index < enc_handle_ptr->memory_map_index; ++ptr_index) {
+        if (enc_handle_ptr->memory_map[ptr_index].ptr_type == EB_THREAD) {
+            eb_vp9_destroy_thread(enc_handle_ptr->memory_map[ptr_index].ptr);
+            enc_handle_ptr->total_lib_memory -= (sizeof(EbHandle) + 7) & ~(uint64_t)7;
+            lib_thread_count--;
+        } else
+            enc_handle_ptr->memory_map[kept_index++] = enc_handle_ptr->memory_map[ptr_index];
+    }
+    enc_handle_ptr->memory_map_index = kept_index;
+}
+
+/**********************************
+ * Create the encoder kernel threads
+ **********************************/
+static EbErrorType create_encoder_threads(EbEncHandle *enc_handle_ptr) {
+    SequenceControlSet *scs_ptr = enc_handle_ptr->sequence_control_set_instance_array[0]->sequence_control_set_ptr;
+    uint32_t            process_index;
+
+    // Resource Coordination
+    EB_CREATETHREAD(EbHandle,
+                    enc_handle_ptr->resource_coordination_thread_handle,
+                    sizeof(EbHandle),
+                    EB_THREAD,
+                    eb_vp9_resource_coordination_kernel,
+                    enc_handle_ptr->resource_coordination_context_ptr);
+
+    // Picture Analysis
+    for (process_index = 0; process_index < scs_ptr->picture_analysis_process_init_count; ++process_index) {
+        EB_CREATETHREAD(EbHandle,
+                        enc_handle_ptr->picture_analysis_thread_handle_array[process_index],
+                        sizeof(EbHandle),
+                        EB_THREAD,
+                        eb_vp9_picture_analysis_kernel,
+                        enc_handle_ptr->picture_analysis_context_ptr_array[process_index]);
+        pin_thread_to_node(enc_handle_ptr->picture_analysis_thread_handle_array[process_index], process_index);
+    }
+
+    // Picture Decision
+    EB_CREATETHREAD(EbHandle,
+                    enc_handle_ptr->picture_decision_thread_handle,
+                    sizeof(EbHandle),
+                    EB_THREAD,
+                    eb_vp9_picture_decision_kernel,
+                    enc_handle_ptr->picture_decision_context_ptr);
+
+    // Motion Estimation
+    for (process_index = 0; process_index < scs_ptr->motion_estimation_process_init_count; ++process_index) {
+        EB_CREATETHREAD(EbHandle,
+                        enc_handle_ptr->motion_estimation_thread_handle_array[process_index],
+                        sizeof(EbHandle),
+                        EB_THREAD,
+                        eb_vp9_motion_estimation_kernel,
+                        enc_handle_ptr->motion_estimation_context_ptr_array[process_index]);
+        pin_thread_to_node(enc_handle_ptr->motion_estimation_thread_handle_array[process_index], process_index);
+    }
+
+    // Initial Rate Control
+    EB_CREATETHREAD(EbHandle,
+                    enc_handle_ptr->initial_rate_control_thread_handle,
+                    sizeof(EbHandle),
+                    EB_THREAD,
+                    eb_vp9_initial_eb_vp9_rate_control_kernel,
+                    enc_handle_ptr->initial_rate_control_context_ptr);
+
+    // Source Based Oprations
+    for (process_index = 0; process_index < scs_ptr->source_based_operations_process_init_count; ++process_index) {
+        EB_CREATETHREAD(EbHandle,
+                        enc_handle_ptr->source_based_operations_thread_handle_array[process_index],
+                        sizeof(EbHandle),
+                        EB_THREAD,
+                        eb_vp9_source_based_operations_kernel,
+                        enc_handle_ptr->source_based_operations_context_ptr_array[process_index]);
+        pin_thread_to_node(enc_handle_ptr->source_based_operations_thread_handle_array[process_index], process_index);
+    }
+
+    // Picture Manager
+    EB_CREATETHREAD(EbHandle,
+                    enc_handle_ptr->picture_manager_thread_handle,
+                    sizeof(EbHandle),
+                    EB_THREAD,
+                    eb_vp9_PictureManagerKernel,
+                    enc_handle_ptr->picture_manager_context_ptr);
+
+    // Rate Control
+    EB_CREATETHREAD(EbHandle,
+                    enc_handle_ptr->rate_control_thread_handle,
+                    sizeof(EbHandle),
+                    EB_THREAD,
+                    eb_vp9_rate_control_kernel,
+                    enc_handle_ptr->rate_control_context_ptr);
+
+    // Mode Decision Configuration Process
+    for (process_index = 0; process_index < scs_ptr->mode_decision_configuration_process_init_count; ++process_index) {
+        EB_CREATETHREAD(EbHandle,
+                        enc_handle_ptr->mode_decision_configuration_thread_handle_array[process_index],
+                        sizeof(EbHandle),
+                        EB_THREAD,
+                        eb_vp9_mode_decision_configuration_kernel,
+                        enc_handle_ptr->mode_decision_configuration_context_ptr_array[process_index]);
+        pin_thread_to_node(enc_handle_ptr->mode_decision_configuration_thread_handle_array[process_index],
+                           process_index);
+    }
+
+    // EncDec Process
+    for (process_index = 0; process_index < scs_ptr->enc_dec_process_init_count; ++process_index) {
+        EB_CREATETHREAD(EbHandle,
+                        enc_handle_ptr->enc_dec_thread_handle_array[process_index],
+                        sizeof(EbHandle),
+                        EB_THREAD,
+                        eb_vp9_enc_dec_kernel,
+                        enc_handle_ptr->enc_dec_context_ptr_array[process_index]);
+        pin_thread_to_node(enc_handle_ptr->enc_dec_thread_handle_array[process_index], process_index);
+    }
+
+    // Entropy Coding Process
+    for (process_index = 0; process_index < scs_ptr->entropy_coding_process_init_count; ++process_index) {
+        EB_CREATETHREAD(EbHandle,
+                        enc_handle_ptr->entropy_coding_thread_handle_array[process_index],
+                        sizeof(EbHandle),
+                        EB_THREAD,
+                        eb_vp9_entropy_coding_kernel,
+                        enc_handle_ptr->entropy_coding_context_ptr_array[process_index]);
+        pin_thread_to_node(enc_handle_ptr->entropy_coding_thread_handle_array[process_index], process_index);
+    }
+
+    // Packetization
+    EB_CREATETHREAD(EbHandle,
+                    enc_handle_ptr->packetization_thread_handle,
+                    sizeof(EbHandle),
+                    EB_THREAD,
+                    eb_vp9_packetization_kernel,
+                    enc_handle_ptr->packetization_context_ptr);
+
+    return EB_ErrorNone;
+}
+
+/**************************************
+* Output Stream Buffer Size
+*   the raw picture size scaled by the expected
+*   compression: from the QP in CQP mode, from the
+*   target rate with room for the intra pictures
+*   otherwise. The packetization grows the buffers
+*   of the pictures that do not fit
+**************************************/
+static uint32_t output_stream_buffer_size(const EbSvtVp9EncConfiguration *config) {
+    const uint64_t raw_size = (((uint64_t)config->source_width * config->source_height * 3) >> 1)
+        << (config->encoder_bit_depth > EB_8BIT);
+    uint64_t size;
+
+    if (config->rate_control_mode == 1 || config->rate_control_mode == 2) {
+        const uint32_t fps = (uint32_t)((config->frame_rate > 1000) ? config->frame_rate >> 16 : config->frame_rate);
+
+        size = (uint64_t)config->target_bit_rate / (8 * MAX(fps, 1)) * EB_OUTPUTSTREAMBUFFERRCFACTOR;
+    } else
+        size = raw_size >> (config->qp >> 4);
+
+    return (uint32_t)CLIP3(EB_OUTPUTSTREAMBUFFERMINSIZE, MAX(raw_size, EB_OUTPUTSTREAMBUFFERMINSIZE), size);
+}
+
 /**************************************
 * EbBufferHeaderType Constructor
+*   p_buffer is reallocable as the packetization
+*   grows it
 **************************************/
 static EbErrorType eb_output_buffer_header_ctor(EbPtr *object_dbl_ptr, EbPtr object_init_data_ptr) {
     EbSvtVp9EncConfiguration *config = (EbSvtVp9EncConfiguration *)object_init_data_ptr;
-    uint32_t size = (uint32_t)(EB_OUTPUTSTREAMBUFFERSIZE_MACRO(config->source_width * config->source_height)); //TBC
-    EbBufferHeaderType *out_buf_ptr;
+    uint32_t                  size   = output_stream_buffer_size(config);
+    EbBufferHeaderType       *out_buf_ptr;
 
     EB_MALLOC(EbBufferHeaderType *, out_buf_ptr, sizeof(EbBufferHeaderType), EB_N_PTR);
     *object_dbl_ptr = (EbPtr)out_buf_ptr;
@@ -768,7 +1190,7 @@ static EbErrorType eb_output_buffer_header_ctor(EbPtr *object_dbl_ptr, EbPtr obj
     // Initialize Header
     out_buf_ptr->size = sizeof(EbBufferHeaderType);
 
-    EB_MALLOC(uint8_t *, out_buf_ptr->p_buffer, size, EB_N_PTR);
+    EB_REALLOCABLE_MALLOC(uint8_t *, out_buf_ptr->p_buffer, size);
 
     out_buf_ptr->n_alloc_len   = size;
     out_buf_ptr->p_app_private = NULL;
@@ -776,14 +1198,7 @@ static EbErrorType eb_output_buffer_header_ctor(EbPtr *object_dbl_ptr, EbPtr obj
     return EB_ErrorNone;
 }
 
-/**********************************
- * Initialize Encoder Library
- **********************************/
-#if __linux
-__attribute__((visibility("default")))
-#endif
-EB_API EbErrorType eb_vp9_init_encoder(EbComponentType *svt_enc_component) {
-
+static EbErrorType init_encoder_resources(EbComponentType *svt_enc_component, const InitThreadPlacement *placement) {
     EbEncHandle        *enc_handle_ptr = (EbEncHandle *)svt_enc_component->p_component_private;
     EbErrorType         return_error   = EB_ErrorNone;
     uint32_t            process_index;
@@ -810,6 +1225,10 @@ EB_API EbErrorType eb_vp9_init_encoder(EbComponentType *svt_enc_component) {
     /************************************
      * Sequence Control Set
      ************************************/
+    // One SequenceControlSet per mini-GOP in flight, runtime updates then never wait for a free one
+    enc_handle_ptr->sequence_control_set_pool_total_count = MAX(
+        EB_SequenceControlSetPoolInitCount,
+        (scs_ptr->picture_control_set_pool_init_count >> scs_ptr->hierarchical_levels) + 2);
     return_error = eb_vp9_system_resource_ctor(&enc_handle_ptr->sequence_control_set_pool_ptr,
                                                enc_handle_ptr->sequence_control_set_pool_total_count,
                                                1,
@@ -853,6 +1272,7 @@ EB_API EbErrorType eb_vp9_init_encoder(EbComponentType *svt_enc_component) {
     input_data.enc_mode      = scs_ptr->static_config.enc_mode;
     input_data.speed_control = (uint8_t)scs_ptr->static_config.speed_control_flag;
     input_data.tune          = scs_ptr->static_config.tune;
+    input_data.stat_report   = (uint8_t)scs_ptr->static_config.stat_report;
     return_error             = eb_vp9_system_resource_ctor(
         &(enc_handle_ptr->picture_parent_control_set_pool_ptr_array[0]),
         scs_ptr->picture_control_set_pool_init_count, //enc_handle_ptr->picture_control_set_pool_total_count,
@@ -906,7 +1326,16 @@ EB_API EbErrorType eb_vp9_init_encoder(EbComponentType *svt_enc_component) {
         input_data.bot_padding    = scs_ptr->bot_padding;
         input_data.bit_depth      = EB_8BIT;
         input_data.is16bit        = is16bit;
-        return_error              = eb_vp9_system_resource_ctor(
+
+        // The child picture control sets are split in per-node sub-pools, the EncDec segments of a picture are
+        // then mostly coded by the processes of its node (see eb_vp9_enc_dec_tasks_node)
+        NodeObjectInitData node_init_data;
+        node_init_data.object_ctor          = eb_vp9_picture_control_set_ctor;
+        node_init_data.object_init_data_ptr = &input_data;
+        node_init_data.placement            = placement;
+        node_init_data.object_index         = 0;
+
+        return_error = eb_vp9_system_resource_ctor(
             &(enc_handle_ptr->picture_control_set_pool_ptr_array[0]),
             scs_ptr->picture_control_set_pool_init_count_child, //EB_PictureControlSetPoolInitCountChild,
             1,
@@ -914,11 +1343,13 @@ EB_API EbErrorType eb_vp9_init_encoder(EbComponentType *svt_enc_component) {
             &enc_handle_ptr->picture_control_set_pool_producer_fifo_ptr_dbl_array[0],
             (EbFifo ***)EB_NULL,
             EB_FALSE,
-            eb_vp9_picture_control_set_ctor,
-            &input_data);
+            node_object_ctor,
+            &node_init_data);
         if (return_error == EB_ErrorInsufficientResources) {
             return EB_ErrorInsufficientResources;
         }
+        eb_vp9_system_resource_set_object_nodes(enc_handle_ptr->picture_control_set_pool_ptr_array[0],
+                                                eb_vp9_numa_node_count);
     }
 
     /************************************
@@ -1099,7 +1530,10 @@ EB_API EbErrorType eb_vp9_init_encoder(EbComponentType *svt_enc_component) {
     if (return_error == EB_ErrorInsufficientResources) {
         return EB_ErrorInsufficientResources;
     }
-    if (scs_ptr->static_config.recon_file) {
+    scs_ptr->encode_context_ptr->output_stream_buffer_pool_size =
+        (uint64_t)(scs_ptr->input_output_buffer_fifo_init_count + 6) *
+        output_stream_buffer_size(&scs_ptr->static_config);
+    if (scs_ptr->static_config.recon_file || scs_ptr->static_config.recon_view) {
         // EbBufferHeaderType Output Recon
         EB_MALLOC(EbSystemResource **,
                   enc_handle_ptr->output_recon_buffer_resource_ptr_array,
@@ -1121,7 +1555,9 @@ EB_API EbErrorType eb_vp9_init_encoder(EbComponentType *svt_enc_component) {
                                                    &enc_handle_ptr->output_recon_buffer_producer_fifo_ptr_dbl_array[0],
                                                    &enc_handle_ptr->output_recon_buffer_consumer_fifo_ptr_dbl_array[0],
                                                    EB_TRUE,
-                                                   eb_output_recon_buffer_header_ctor,
+                                                   scs_ptr->static_config.recon_view
+                                                       ? eb_output_recon_view_ctor
+                                                       : eb_output_recon_buffer_header_ctor,
                                                    scs_ptr);
         if (return_error == EB_ErrorInsufficientResources) {
             return EB_ErrorInsufficientResources;
@@ -1301,6 +1737,13 @@ EB_API EbErrorType eb_vp9_init_encoder(EbComponentType *svt_enc_component) {
         if (return_error == EB_ErrorInsufficientResources) {
             return EB_ErrorInsufficientResources;
         }
+
+        // The tasks go to the EncDec processes of the node of their picture control set
+        if (eb_vp9_numa_node_count > 1) {
+            for (i = 0; i < scs_ptr->enc_dec_process_init_count; ++i)
+                enc_handle_ptr->enc_dec_tasks_consumer_fifo_ptr_array[i]->node_index = i % eb_vp9_numa_node_count;
+            enc_handle_ptr->enc_dec_tasks_resource_ptr->object_node_callback = eb_vp9_enc_dec_tasks_node;
+        }
     }
 
     // EncDec Results
@@ -1347,7 +1790,9 @@ EB_API EbErrorType eb_vp9_init_encoder(EbComponentType *svt_enc_component) {
     // Output Buffer Fifo Ptrs
     scs_ptr->encode_context_ptr->stream_output_fifo_ptr =
         (enc_handle_ptr->output_stream_buffer_producer_fifo_ptr_dbl_array[0])[0];
-    if (scs_ptr->static_config.recon_file)
+    scs_ptr->encode_context_ptr->partial_stream_output_fifo_ptr =
+        (enc_handle_ptr->output_stream_buffer_producer_fifo_ptr_dbl_array[0])[1];
+    if (scs_ptr->static_config.recon_file || scs_ptr->static_config.recon_view)
         scs_ptr->encode_context_ptr->recon_output_fifo_ptr =
             (enc_handle_ptr->output_recon_buffer_producer_fifo_ptr_dbl_array[0])[0];
     /************************************
@@ -1388,6 +1833,7 @@ EB_API EbErrorType eb_vp9_init_encoder(EbComponentType *svt_enc_component) {
         picture_buffer_desc_conf.bot_padding        = 0;
         picture_buffer_desc_conf.split_mode         = EB_FALSE;
 
+        place_init_thread_on_node(placement, process_index % eb_vp9_numa_node_count);
         return_error = eb_vp9_picture_analysis_context_ctor(
             &picture_buffer_desc_conf,
             EB_TRUE,
@@ -1396,6 +1842,7 @@ EB_API EbErrorType eb_vp9_init_encoder(EbComponentType *svt_enc_component) {
             enc_handle_ptr->picture_analysis_results_producer_fifo_ptr_array[process_index],
             ((scs_ptr->max_input_luma_width + MAX_SB_SIZE_MINUS_1) / MAX_SB_SIZE) *
                 ((scs_ptr->max_input_luma_height + MAX_SB_SIZE_MINUS_1) / MAX_SB_SIZE));
+        place_init_thread_on_encoder(placement);
 
         if (return_error == EB_ErrorInsufficientResources) {
             return EB_ErrorInsufficientResources;
@@ -1418,10 +1865,12 @@ EB_API EbErrorType eb_vp9_init_encoder(EbComponentType *svt_enc_component) {
               EB_N_PTR);
 
     for (process_index = 0; process_index < scs_ptr->motion_estimation_process_init_count; ++process_index) {
+        place_init_thread_on_node(placement, process_index % eb_vp9_numa_node_count);
         return_error = eb_vp9_motion_estimation_context_ctor(
             (MotionEstimationContext **)&enc_handle_ptr->motion_estimation_context_ptr_array[process_index],
             enc_handle_ptr->picture_decision_results_consumer_fifo_ptr_array[process_index],
             enc_handle_ptr->motion_estimation_results_producer_fifo_ptr_array[process_index]);
+        place_init_thread_on_encoder(placement);
 
         if (return_error == EB_ErrorInsufficientResources) {
             return EB_ErrorInsufficientResources;
@@ -1444,10 +1893,12 @@ EB_API EbErrorType eb_vp9_init_encoder(EbComponentType *svt_enc_component) {
               EB_N_PTR);
 
     for (process_index = 0; process_index < scs_ptr->source_based_operations_process_init_count; ++process_index) {
+        place_init_thread_on_node(placement, process_index % eb_vp9_numa_node_count);
         return_error = eb_vp9_source_based_operations_context_ctor(
             (SourceBasedOperationsContext **)&enc_handle_ptr->source_based_operations_context_ptr_array[process_index],
             enc_handle_ptr->initial_rate_control_results_consumer_fifo_ptr_array[process_index],
             enc_handle_ptr->picture_demux_results_producer_fifo_ptr_array[process_index]);
+        place_init_thread_on_encoder(placement);
         if (return_error == EB_ErrorInsufficientResources) {
             return EB_ErrorInsufficientResources;
         }
@@ -1482,6 +1933,7 @@ EB_API EbErrorType eb_vp9_init_encoder(EbComponentType *svt_enc_component) {
 
         for (process_index = 0; process_index < scs_ptr->mode_decision_configuration_process_init_count;
              ++process_index) {
+            place_init_thread_on_node(placement, process_index % eb_vp9_numa_node_count);
             return_error = eb_vp9_mode_decision_configuration_context_ctor(
                 (ModeDecisionConfigurationContext **)&enc_handle_ptr
                     ->mode_decision_configuration_context_ptr_array[process_index],
@@ -1491,6 +1943,7 @@ EB_API EbErrorType eb_vp9_init_encoder(EbComponentType *svt_enc_component) {
                     ->enc_dec_tasks_producer_fifo_ptr_array[enc_dec_port_lookup(ENCDEC_INPUT_PORT_MDC, process_index)],
                 ((scs_ptr->max_input_luma_width + MAX_SB_SIZE_MINUS_1) / MAX_SB_SIZE) *
                     ((scs_ptr->max_input_luma_height + MAX_SB_SIZE_MINUS_1) / MAX_SB_SIZE));
+            place_init_thread_on_encoder(placement);
 
             if (return_error == EB_ErrorInsufficientResources) {
                 return EB_ErrorInsufficientResources;
@@ -1510,13 +1963,16 @@ EB_API EbErrorType eb_vp9_init_encoder(EbComponentType *svt_enc_component) {
               EB_N_PTR);
 
     for (process_index = 0; process_index < scs_ptr->enc_dec_process_init_count; ++process_index) {
+        place_init_thread_on_node(placement, process_index % eb_vp9_numa_node_count);
         return_error = eb_vp9_enc_dec_context_ctor(
             (EncDecContext **)&enc_handle_ptr->enc_dec_context_ptr_array[process_index],
             enc_handle_ptr->enc_dec_tasks_consumer_fifo_ptr_array[process_index],
             enc_handle_ptr->enc_dec_results_producer_fifo_ptr_array[process_index],
             enc_handle_ptr
                 ->enc_dec_tasks_producer_fifo_ptr_array[enc_dec_port_lookup(ENCDEC_INPUT_PORT_ENCDEC, process_index)],
-            enc_handle_ptr->picture_demux_results_producer_fifo_ptr_array[1 + process_index]);
+            enc_handle_ptr->picture_demux_results_producer_fifo_ptr_array[1 + process_index],
+            maxpicture_width);
+        place_init_thread_on_encoder(placement);
 
         if (return_error == EB_ErrorInsufficientResources) {
             return EB_ErrorInsufficientResources;
@@ -1530,6 +1986,7 @@ EB_API EbErrorType eb_vp9_init_encoder(EbComponentType *svt_enc_component) {
               EB_N_PTR);
 
     for (process_index = 0; process_index < scs_ptr->entropy_coding_process_init_count; ++process_index) {
+        place_init_thread_on_node(placement, process_index % eb_vp9_numa_node_count);
         return_error = eb_vp9_entropy_coding_context_ctor(
             (EntropyCodingContext **)&enc_handle_ptr->entropy_coding_context_ptr_array[process_index],
             enc_handle_ptr->enc_dec_results_consumer_fifo_ptr_array[process_index],
@@ -1537,6 +1994,7 @@ EB_API EbErrorType eb_vp9_init_encoder(EbComponentType *svt_enc_component) {
             enc_handle_ptr->rate_control_tasks_producer_fifo_ptr_array[rate_control_port_lookup(
                 RATE_CONTROL_INPUT_PORT_ENTROPY_CODING, process_index)],
             is16bit);
+        place_init_thread_on_encoder(placement);
         if (return_error == EB_ErrorInsufficientResources) {
             return EB_ErrorInsufficientResources;
         }
@@ -1555,153 +2013,112 @@ EB_API EbErrorType eb_vp9_init_encoder(EbComponentType *svt_enc_component) {
     /************************************
      * Thread Handles
      ************************************/
-    EbSvtVp9EncConfiguration *config_ptr = &scs_ptr->static_config;
-    eb_set_thread_management_parameters(config_ptr);
-
-    // Resource Coordination
-    EB_CREATETHREAD(EbHandle,
-                    enc_handle_ptr->resource_coordination_thread_handle,
-                    sizeof(EbHandle),
-                    EB_THREAD,
-                    eb_vp9_resource_coordination_kernel,
-                    enc_handle_ptr->resource_coordination_context_ptr);
-
     // Picture Analysis
     EB_MALLOC(EbHandle *,
               enc_handle_ptr->picture_analysis_thread_handle_array,
               sizeof(EbHandle) * scs_ptr->picture_analysis_process_init_count,
               EB_N_PTR);
 
-    for (process_index = 0; process_index < scs_ptr->picture_analysis_process_init_count; ++process_index) {
-        EB_CREATETHREAD(EbHandle,
-                        enc_handle_ptr->picture_analysis_thread_handle_array[process_index],
-                        sizeof(EbHandle),
-                        EB_THREAD,
-                        eb_vp9_picture_analysis_kernel,
-                        enc_handle_ptr->picture_analysis_context_ptr_array[process_index]);
-    }
-
-    // Picture Decision
-    EB_CREATETHREAD(EbHandle,
-                    enc_handle_ptr->picture_decision_thread_handle,
-                    sizeof(EbHandle),
-                    EB_THREAD,
-                    eb_vp9_picture_decision_kernel,
-                    enc_handle_ptr->picture_decision_context_ptr);
-
     // Motion Estimation
     EB_MALLOC(EbHandle *,
               enc_handle_ptr->motion_estimation_thread_handle_array,
               sizeof(EbHandle) * scs_ptr->motion_estimation_process_init_count,
               EB_N_PTR);
 
-    for (process_index = 0; process_index < scs_ptr->motion_estimation_process_init_count; ++process_index) {
-        EB_CREATETHREAD(EbHandle,
-                        enc_handle_ptr->motion_estimation_thread_handle_array[process_index],
-                        sizeof(EbHandle),
-                        EB_THREAD,
-                        eb_vp9_motion_estimation_kernel,
-                        enc_handle_ptr->motion_estimation_context_ptr_array[process_index]);
-    }
-
-    // Initial Rate Control
-    EB_CREATETHREAD(EbHandle,
-                    enc_handle_ptr->initial_rate_control_thread_handle,
-                    sizeof(EbHandle),
-                    EB_THREAD,
-                    eb_vp9_initial_eb_vp9_rate_control_kernel,
-                    enc_handle_ptr->initial_rate_control_context_ptr);
-
     // Source Based Oprations
     EB_MALLOC(EbHandle *,
               enc_handle_ptr->source_based_operations_thread_handle_array,
               sizeof(EbHandle) * scs_ptr->source_based_operations_process_init_count,
               EB_N_PTR);
 
-    for (process_index = 0; process_index < scs_ptr->source_based_operations_process_init_count; ++process_index) {
-        EB_CREATETHREAD(EbHandle,
-                        enc_handle_ptr->source_based_operations_thread_handle_array[process_index],
-                        sizeof(EbHandle),
-                        EB_THREAD,
-                        eb_vp9_source_based_operations_kernel,
-                        enc_handle_ptr->source_based_operations_context_ptr_array[process_index]);
-    }
-
-    // Picture Manager
-    EB_CREATETHREAD(EbHandle,
-                    enc_handle_ptr->picture_manager_thread_handle,
-                    sizeof(EbHandle),
-                    EB_THREAD,
-                    eb_vp9_PictureManagerKernel,
-                    enc_handle_ptr->picture_manager_context_ptr);
-
-    // Rate Control
-    EB_CREATETHREAD(EbHandle,
-                    enc_handle_ptr->rate_control_thread_handle,
-                    sizeof(EbHandle),
-                    EB_THREAD,
-                    eb_vp9_rate_control_kernel,
-                    enc_handle_ptr->rate_control_context_ptr);
-
     // Mode Decision Configuration Process
     EB_MALLOC(EbHandle *,
               enc_handle_ptr->mode_decision_configuration_thread_handle_array,
               sizeof(EbHandle) * scs_ptr->mode_decision_configuration_process_init_count,
               EB_N_PTR);
 
-    for (process_index = 0; process_index < scs_ptr->mode_decision_configuration_process_init_count; ++process_index) {
-        EB_CREATETHREAD(EbHandle,
-                        enc_handle_ptr->mode_decision_configuration_thread_handle_array[process_index],
-                        sizeof(EbHandle),
-                        EB_THREAD,
-                        eb_vp9_mode_decision_configuration_kernel,
-                        enc_handle_ptr->mode_decision_configuration_context_ptr_array[process_index]);
-    }
-
     // EncDec Process
     EB_MALLOC(EbHandle *,
               enc_handle_ptr->enc_dec_thread_handle_array,
               sizeof(EbHandle) * scs_ptr->enc_dec_process_init_count,
               EB_N_PTR);
 
-    for (process_index = 0; process_index < scs_ptr->enc_dec_process_init_count; ++process_index) {
-        EB_CREATETHREAD(EbHandle,
-                        enc_handle_ptr->enc_dec_thread_handle_array[process_index],
-                        sizeof(EbHandle),
-                        EB_THREAD,
-                        eb_vp9_enc_dec_kernel,
-                        enc_handle_ptr->enc_dec_context_ptr_array[process_index]);
-    }
-
     // Entropy Coding Process
     EB_MALLOC(EbHandle *,
               enc_handle_ptr->entropy_coding_thread_handle_array,
               sizeof(EbHandle) * scs_ptr->entropy_coding_process_init_count,
               EB_N_PTR);
 
-    for (process_index = 0; process_index < scs_ptr->entropy_coding_process_init_count; ++process_index) {
-        EB_CREATETHREAD(EbHandle,
-                        enc_handle_ptr->entropy_coding_thread_handle_array[process_index],
-                        sizeof(EbHandle),
-                        EB_THREAD,
-                        eb_vp9_entropy_coding_kernel,
-                        enc_handle_ptr->entropy_coding_context_ptr_array[process_index]);
+    return_error = create_encoder_threads(enc_handle_ptr);
+    if (return_error == EB_ErrorInsufficientResources) {
+        return EB_ErrorInsufficientResources;
     }
 
-    // Packetization
-    EB_CREATETHREAD(EbHandle,
-                    enc_handle_ptr->packetization_thread_handle,
-                    sizeof(EbHandle),
-                    EB_THREAD,
-                    eb_vp9_packetization_kernel,
-                    enc_handle_ptr->packetization_context_ptr);
-
 #if DISPLAY_MEMORY
     EB_MEMORY();
 #endif
     return return_error;
 }
 
+/**********************************
+ * Initialize Encoder Library
+ **********************************/
+#if __linux
+__attribute__((visibility("default")))
+#endif
+EB_API EbErrorType eb_vp9_init_encoder(EbComponentType *svt_enc_component) {
+    EbEncHandle        *enc_handle_ptr = (EbEncHandle *)svt_enc_component->p_component_private;
+    SequenceControlSet *scs_ptr = enc_handle_ptr->sequence_control_set_instance_array[0]->sequence_control_set_ptr;
+    InitThreadPlacement placement;
+    EbErrorType         return_error;
+
+    eb_set_thread_management_parameters(&scs_ptr->static_config);
+    eb_vp9_huge_pages = (uint8_t)scs_ptr->static_config.huge_pages;
+
+    bind_init_thread_to_encoder(&placement);
+    return_error = init_encoder_resources(svt_enc_component, &placement);
+    restore_init_thread(&placement);
+
+    return return_error;
+}
+
+/**********************************
+ * Reset the encoder for a new sequence
+ **********************************/
+#if __linux
+__attribute__((visibility("default")))
+#endif
+EB_API EbErrorType eb_vp9_svt_enc_reset(EbComponentType *svt_enc_component) {
+    EbEncHandle                  *enc_handle_ptr = (EbEncHandle *)svt_enc_component->p_component_private;
+    EbSequenceControlSetInstance *scs_instance   = enc_handle_ptr->sequence_control_set_instance_array[0];
+    EbErrorType                   return_error;
+
+    if (enc_handle_ptr->resource_coordination_thread_handle == EB_NULL)
+        return EB_ErrorBadParameter;
+
+    // Stop the pipeline and return every object to its pool
+    stop_encoder_threads(enc_handle_ptr);
+    for_each_system_resource(enc_handle_ptr, eb_vp9_system_resource_reset);
+
+    // Sequence state
+    return_error = eb_vp9_encode_context_reset(scs_instance->encode_context_ptr);
+    if (return_error != EB_ErrorNone)
+        return return_error;
+    eb_vp9_resource_coordination_context_reset(
+        (ResourceCoordinationContext *)enc_handle_ptr->resource_coordination_context_ptr);
+    eb_vp9_picture_decision_context_reset((PictureDecisionContext *)enc_handle_ptr->picture_decision_context_ptr);
+    eb_vp9_rate_control_context_reset((RateControlContext *)enc_handle_ptr->rate_control_context_ptr,
+                                      scs_instance->sequence_control_set_ptr->intra_period);
+
+    // Restart the kernels, the thread handles are added back to this encoder's memory map
+    total_lib_memory = &enc_handle_ptr->total_lib_memory;
+    memory_map       = enc_handle_ptr->memory_map;
+    memory_map_index = &enc_handle_ptr->memory_map_index;
+    eb_set_thread_management_parameters(&scs_instance->sequence_control_set_ptr->static_config);
+
+    return create_encoder_threads(enc_handle_ptr);
+}
+
 /**********************************
  * DeInitialize Encoder Library
  **********************************/
@@ -1714,6 +2131,12 @@ EB_API EbErrorType eb_vp9_deinit_encoder(EbComponentType *svt_enc_component) {
     int32_t           ptr_index      = 0;
     EbMemoryMapEntry *memory_entry   = (EbMemoryMapEntry *)EB_NULL;
     if (enc_handle_ptr) {
+        // Ask the kernels to quit, the threads are joined below
+        if (enc_handle_ptr->resource_coordination_thread_handle) {
+            for_each_system_resource(enc_handle_ptr, eb_vp9_shutdown_process);
+            wake_histogram_waiters(enc_handle_ptr);
+        }
+
         if (enc_handle_ptr->memory_map_index) {
             // Loop through the ptr table and free all malloc'd pointers per channel
             for (ptr_index = (enc_handle_ptr->memory_map_index) - 1; ptr_index >= 0; --ptr_index) {
@@ -1727,6 +2150,8 @@ EB_API EbErrorType eb_vp9_deinit_encoder(EbComponentType *svt_enc_component) {
                     free(memory_entry->ptr);
 #endif
                     break;
+                case EB_H_PTR: eb_vp9_huge_page_free(memory_entry); break;
+                case EB_R_PTR: free(*(EbPtr *)memory_entry->ptr); break;
                 case EB_SEMAPHORE: eb_vp9_destroy_semaphore(memory_entry->ptr); break;
                 case EB_THREAD: eb_vp9_destroy_thread(memory_entry->ptr); break;
                 case EB_MUTEX: eb_vp9_destroy_mutex(memory_entry->ptr); break;
@@ -1776,6 +2201,7 @@ EbErrorType eb_vp9_svt_enc_init_parameter(EbSvtVp9EncConfiguration *config_ptr)
 
     config_ptr->qp                     = 50;
     config_ptr->use_qp_file            = EB_FALSE;
+    config_ptr->aq_mode                = 0;
     config_ptr->rate_control_mode      = 0;
     config_ptr->target_bit_rate        = 7000000;
     config_ptr->max_qp_allowed         = MAX_QP_VALUE;
@@ -1783,6 +2209,7 @@ EbErrorType eb_vp9_svt_enc_init_parameter(EbSvtVp9EncConfiguration *config_ptr)
     config_ptr->base_layer_switch_mode = 0;
     config_ptr->enc_mode               = 3;
     config_ptr->intra_period           = 31;
+    config_ptr->scene_change_detection = 0;
     config_ptr->pred_structure         = EB_PRED_RANDOM_ACCESS;
     config_ptr->loop_filter            = EB_TRUE;
     config_ptr->use_default_me_hme     = EB_TRUE;
@@ -1799,8 +2226,9 @@ EbErrorType eb_vp9_svt_enc_init_parameter(EbSvtVp9EncConfiguration *config_ptr)
     config_ptr->level   = 0;
 
     // Latency
-    config_ptr->injector_frame_rate = 60 << 16;
-    config_ptr->speed_control_flag  = 0;
+    config_ptr->injector_frame_rate   = 60 << 16;
+    config_ptr->speed_control_flag    = 0;
+    config_ptr->partial_packet_output = 0;
 
     // ASM Type
     config_ptr->asm_type = 1;
@@ -1808,11 +2236,14 @@ EbErrorType eb_vp9_svt_enc_init_parameter(EbSvtVp9EncConfiguration *config_ptr)
     // Channel info
     config_ptr->logical_processors   = 0;
     config_ptr->target_socket        = -1;
+    config_ptr->huge_pages           = HUGE_PAGES_OFF;
     config_ptr->channel_id           = 0;
     config_ptr->active_channel_count = 1;
 
     // Debug info
-    config_ptr->recon_file = 0;
+    config_ptr->recon_file  = 0;
+    config_ptr->recon_view  = 0;
+    config_ptr->stat_report = 0;
 
     return return_error;
 }
@@ -2041,7 +2472,7 @@ static void set_default_configuration_parameters(SequenceControlSet *sequence_co
 
 static uint32_t compute_default_look_ahead(EbSvtVp9EncConfiguration *config, SequenceControlSet *scs_ptr) {
     int32_t lad = 0;
-    if (config->rate_control_mode == 0)
+    if (config->rate_control_mode == 0 || config->rate_control_mode == 3)
         lad = (2 << scs_ptr->hierarchical_levels) + 1;
     else
         lad = config->intra_period;
@@ -2069,6 +2500,8 @@ static void copy_api_from_app(SequenceControlSet       *sequence_control_set_ptr
         ((EbSvtVp9EncConfiguration *)p_component_parameter_structure)->pred_structure;
     sequence_control_set_ptr->static_config.base_layer_switch_mode =
         ((EbSvtVp9EncConfiguration *)p_component_parameter_structure)->base_layer_switch_mode;
+    sequence_control_set_ptr->static_config.scene_change_detection =
+        ((EbSvtVp9EncConfiguration *)p_component_parameter_structure)->scene_change_detection;
     sequence_control_set_ptr->static_config.tune = ((EbSvtVp9EncConfiguration *)p_component_parameter_structure)->tune;
     sequence_control_set_ptr->static_config.enc_mode =
         ((EbSvtVp9EncConfiguration *)p_component_parameter_structure)->enc_mode;
@@ -2081,6 +2514,8 @@ static void copy_api_from_app(SequenceControlSet       *sequence_control_set_ptr
         ((EbSvtVp9EncConfiguration *)p_component_parameter_structure)->qp;
     sequence_control_set_ptr->static_config.use_qp_file =
         ((EbSvtVp9EncConfiguration *)p_component_parameter_structure)->use_qp_file;
+    sequence_control_set_ptr->static_config.aq_mode =
+        ((EbSvtVp9EncConfiguration *)p_component_parameter_structure)->aq_mode;
 
     // Loop Filter
     sequence_control_set_ptr->static_config.loop_filter =
@@ -2100,8 +2535,13 @@ static void copy_api_from_app(SequenceControlSet       *sequence_control_set_ptr
 
     sequence_control_set_ptr->static_config.recon_file =
         ((EbSvtVp9EncConfiguration *)p_component_parameter_structure)->recon_file;
+    sequence_control_set_ptr->static_config.recon_view =
+        ((EbSvtVp9EncConfiguration *)p_component_parameter_structure)->recon_view;
     sequence_control_set_ptr->encode_context_ptr->recon_port_active =
-        (EB_BOOL)sequence_control_set_ptr->static_config.recon_file;
+        (EB_BOOL)(sequence_control_set_ptr->static_config.recon_file ||
+                  sequence_control_set_ptr->static_config.recon_view);
+    sequence_control_set_ptr->static_config.stat_report =
+        ((EbSvtVp9EncConfiguration *)p_component_parameter_structure)->stat_report;
 
     // Rate Control
     sequence_control_set_ptr->static_config.rate_control_mode =
@@ -2145,6 +2585,8 @@ static void copy_api_from_app(SequenceControlSet       *sequence_control_set_ptr
         ((EbSvtVp9EncConfiguration *)p_component_parameter_structure)->injector_frame_rate;
     sequence_control_set_ptr->static_config.speed_control_flag =
         ((EbSvtVp9EncConfiguration *)p_component_parameter_structure)->speed_control_flag;
+    sequence_control_set_ptr->static_config.partial_packet_output =
+        ((EbSvtVp9EncConfiguration *)p_component_parameter_structure)->partial_packet_output;
 
     sequence_control_set_ptr->static_config.asm_type =
         ((EbSvtVp9EncConfiguration *)p_component_parameter_structure)->asm_type;
@@ -2158,6 +2600,8 @@ static void copy_api_from_app(SequenceControlSet       *sequence_control_set_ptr
         ((EbSvtVp9EncConfiguration *)p_component_parameter_structure)->logical_processors;
     sequence_control_set_ptr->static_config.target_socket =
         ((EbSvtVp9EncConfiguration *)p_component_parameter_structure)->target_socket;
+    sequence_control_set_ptr->static_config.huge_pages =
+        ((EbSvtVp9EncConfiguration *)p_component_parameter_structure)->huge_pages;
 
     sequence_control_set_ptr->static_config.frame_rate_denominator =
         ((EbSvtVp9EncConfiguration *)p_component_parameter_structure)->frame_rate_denominator;
@@ -2166,7 +2610,8 @@ static void copy_api_from_app(SequenceControlSet       *sequence_control_set_ptr
 
     // Set default hierarchical-levels
     if (sequence_control_set_ptr->static_config.tune != 0 &&
-        sequence_control_set_ptr->static_config.rate_control_mode == 0) {
+        (sequence_control_set_ptr->static_config.rate_control_mode == 0 ||
+         sequence_control_set_ptr->static_config.rate_control_mode == 3)) {
         sequence_control_set_ptr->hierarchical_levels = 4;
         sequence_control_set_ptr->max_temporal_layers = 4;
     } else {
@@ -2417,6 +2862,17 @@ static EbErrorType verify_settings(SequenceControlSet *sequence_control_set_ptr)
         return_error = EB_ErrorBadParameter;
     }
 
+    if (config->scene_change_detection > 1) {
+        SVT_LOG("Error Instance %u: Invalid SceneChangeDetection. SceneChangeDetection must be [0 - 1]\n",
+                channel_number + 1);
+        return_error = EB_ErrorBadParameter;
+    }
+
+    if (config->aq_mode > AQ_MODE_MOTION) {
+        SVT_LOG("Error Instance %u: Invalid AqMode. AqMode must be [0 - 2]\n", channel_number + 1);
+        return_error = EB_ErrorBadParameter;
+    }
+
     if (config->loop_filter > 1) {
         SVT_LOG("Error Instance %u: Invalid LoopFilterDisable. LoopFilterDisable must be [0 - 1]\n",
                 channel_number + 1);
@@ -2488,8 +2944,8 @@ static EbErrorType verify_settings(SequenceControlSet *sequence_control_set_ptr)
         return_error = EB_ErrorBadParameter;
     }
 
-    if (config->rate_control_mode > 2) {
-        SVT_LOG("Error Instance %u: The rate control mode must be [0 - 2] \n", channel_number + 1);
+    if (config->rate_control_mode > 3) {
+        SVT_LOG("Error Instance %u: The rate control mode must be [0 - 3] \n", channel_number + 1);
         return_error = EB_ErrorBadParameter;
     }
 #if !VP9_RC
@@ -2543,6 +2999,12 @@ static EbErrorType verify_settings(SequenceControlSet *sequence_control_set_ptr)
         return_error = EB_ErrorBadParameter;
     }
 
+    if (config->partial_packet_output > 1) {
+        SVT_LOG("Error instance %u: Invalid PartialPacketOutput. PartialPacketOutput must be [0 - 1] \n",
+                channel_number + 1);
+        return_error = EB_ErrorBadParameter;
+    }
+
     if (((int32_t)(config->asm_type) < 0) || ((int32_t)(config->asm_type) > 1)) {
         SVT_LOG("Error Instance %u: Invalid asm type value [0: C Only, 1: Auto] .\n", channel_number + 1);
         return_error = EB_ErrorBadParameter;
@@ -2553,6 +3015,26 @@ static EbErrorType verify_settings(SequenceControlSet *sequence_control_set_ptr)
         return_error = EB_ErrorBadParameter;
     }
 
+    if (config->huge_pages > HUGE_PAGES_EXPLICIT) {
+        SVT_LOG("Error instance %u: Invalid HugePages. HugePages must be [0 - 2] \n", channel_number + 1);
+        return_error = EB_ErrorBadParameter;
+    }
+
+    if (config->stat_report > 1) {
+        SVT_LOG("Error instance %u: Invalid StatReport. StatReport must be [0 - 1] \n", channel_number + 1);
+        return_error = EB_ErrorBadParameter;
+    }
+
+    if (config->recon_view > 1) {
+        SVT_LOG("Error instance %u: Invalid ReconView. ReconView must be [0 - 1] \n", channel_number + 1);
+        return_error = EB_ErrorBadParameter;
+    }
+
+    if (config->recon_view && config->recon_file) {
+        SVT_LOG("Error instance %u: ReconView cannot be used with a recon file \n", channel_number + 1);
+        return_error = EB_ErrorBadParameter;
+    }
+
     return return_error;
 }
 
@@ -2631,6 +3113,8 @@ static void print_lib_params(SequenceControlSet *scs) {
         SVT_LOG("\nSVT [config]: RCMode / TargetBitrate\t\t\t\t\t\t: CBR / %d ", config->target_bit_rate);
     else if (config->rate_control_mode == 1)
         SVT_LOG("\nSVT [config]: RCMode / TargetBitrate\t\t\t\t\t\t: VBR / %d ", config->target_bit_rate);
+    else if (config->rate_control_mode == 3)
+        SVT_LOG("\nSVT [config]: RCMode / QP / MaxRate\t\t\t\t\t\t: CRF / %d / %d ", scs->qp, config->vbv_max_rate);
     else
         SVT_LOG("\nSVT [config]: BRC Mode / QP \t\t\t\t\t\t\t: CQP / %d ", scs->qp);
 #ifdef DEBUG_BUFFERS
@@ -2736,6 +3220,76 @@ EB_API EbErrorType eb_vp9_svt_enc_set_parameter(EbComponentType          *svt_en
     return return_error;
 }
 
+/**********************************
+ * Update the rate control targets
+ *   The new values are written to the instance SequenceControlSet,
+ *   Resource Coordination copies them to a new active SequenceControlSet
+ *   at the next mini-GOP boundary and Rate Control follows from there
+ **********************************/
+#if __linux
+__attribute__((visibility("default")))
+#endif
+EB_API EbErrorType eb_vp9_svt_enc_update_parameter(EbComponentType          *svt_enc_component,
+                                                   EbSvtVp9EncConfiguration *config_ptr) {
+    EbEncHandle                  *enc_handle_ptr;
+    EbSequenceControlSetInstance *scs_instance;
+    SequenceControlSet           *scs_ptr;
+    uint32_t                      frame_rate;
+
+    if (svt_enc_component == (EbComponentType *)EB_NULL || config_ptr == (EbSvtVp9EncConfiguration *)EB_NULL) {
+        return EB_ErrorBadParameter;
+    }
+
+    enc_handle_ptr = (EbEncHandle *)svt_enc_component->p_component_private;
+    scs_instance   = enc_handle_ptr->sequence_control_set_instance_array[0];
+    scs_ptr        = scs_instance->sequence_control_set_ptr;
+
+    // Extract frame rate from Numerator and Denominator if not 0
+    frame_rate = config_ptr->frame_rate;
+    if (config_ptr->frame_rate_numerator != 0 && config_ptr->frame_rate_denominator != 0) {
+        frame_rate = ((config_ptr->frame_rate_numerator << 8) / config_ptr->frame_rate_denominator) << 8;
+    }
+
+    if (frame_rate == 0 || frame_rate > (240 << 16)) {
+        SVT_LOG("Error Instance 1: The frame rate must be (0 - 240] fps\n");
+        return EB_ErrorBadParameter;
+    }
+    if (config_ptr->qp > MAX_QP_VALUE) {
+        SVT_LOG("Error instance 1: QP must be [0 - %d]\n", MAX_QP_VALUE);
+        return EB_ErrorBadParameter;
+    }
+    if (scs_ptr->static_config.rate_control_mode &&
+        (config_ptr->max_qp_allowed > MAX_QP_VALUE || config_ptr->min_qp_allowed > config_ptr->max_qp_allowed)) {
+        SVT_LOG("Error instance 1: min_qp_allowed and max_qp_allowed must satisfy 0 <= min <= max <= %d\n",
+                MAX_QP_VALUE);
+        return EB_ErrorBadParameter;
+    }
+    if ((scs_ptr->static_config.rate_control_mode == 1 || scs_ptr->static_config.rate_control_mode == 2) &&
+        config_ptr->target_bit_rate == 0) {
+        SVT_LOG("Error instance 1: The target bit rate must be greater than 0\n");
+        return EB_ErrorBadParameter;
+    }
+
+    eb_vp9_block_on_mutex(scs_instance->config_mutex);
+
+    scs_ptr->qp = scs_ptr->static_config.qp = config_ptr->qp;
+    scs_ptr->frame_rate = scs_ptr->static_config.frame_rate = frame_rate;
+    scs_ptr->static_config.frame_rate_numerator   = config_ptr->frame_rate_numerator;
+    scs_ptr->static_config.frame_rate_denominator = config_ptr->frame_rate_denominator;
+    scs_ptr->static_config.target_bit_rate        = config_ptr->target_bit_rate;
+    scs_ptr->static_config.vbv_max_rate           = config_ptr->vbv_max_rate;
+    scs_ptr->static_config.vbv_buf_size           = config_ptr->vbv_buf_size;
+    if (scs_ptr->static_config.rate_control_mode) {
+        scs_ptr->static_config.max_qp_allowed = config_ptr->max_qp_allowed;
+        scs_ptr->static_config.min_qp_allowed = config_ptr->min_qp_allowed;
+    }
+    scs_instance->config_update_pending = EB_TRUE;
+
+    eb_vp9_release_mutex(scs_instance->config_mutex);
+
+    return EB_ErrorNone;
+}
+
 /***********************************************
 **** Copy the input buffer from the
 **** sample application to the library buffers
@@ -2807,6 +3361,13 @@ static void copy_input_buffer(SequenceControlSet *sequenceControlSet, EbBufferHe
     dst->qp           = src->qp;
     dst->pic_type     = src->pic_type;
 
+    // Copy the application data returned with the packet
+    dst->p_app_private = src->p_app_private;
+    if (src->size >= offsetof(EbBufferHeaderType, user_metadata) + sizeof(src->user_metadata))
+        EB_MEMCPY(dst->user_metadata, src->user_metadata, sizeof(dst->user_metadata));
+    else
+        EB_MEMSET(dst->user_metadata, 0, sizeof(dst->user_metadata));
+
     // Copy the picture buffer
     if (src->p_buffer != NULL)
         copy_frame_buffer(sequenceControlSet, dst->p_buffer, src->p_buffer);
@@ -2864,6 +3425,48 @@ EB_API EbErrorType eb_vp9_svt_get_recon(EbComponentType *svt_enc_component, EbBu
     return return_error;
 }
 
+/**********************************
+* Recon View
+**********************************/
+#if defined(__linux__) || defined(__APPLE__)
+__attribute__((visibility("default")))
+#endif
+EB_API EbErrorType eb_vp9_svt_get_recon_view(EbComponentType *svt_enc_component, EbBufferHeaderType **p_buffer) {
+    EbEncHandle        *p_enc_comp_data = (EbEncHandle *)svt_enc_component->p_component_private;
+    EbObjectWrapper    *eb_wrapper_ptr  = NULL;
+    SequenceControlSet *scs_ptr = p_enc_comp_data->sequence_control_set_instance_array[0]->sequence_control_set_ptr;
+
+    // recon views are not enabled
+    if (!scs_ptr->static_config.recon_view)
+        return EB_ErrorMax;
+
+    eb_vp9_get_full_object_non_blocking((p_enc_comp_data->output_recon_buffer_consumer_fifo_ptr_dbl_array[0])[0],
+                                        &eb_wrapper_ptr);
+    if (!eb_wrapper_ptr)
+        return EB_NoErrorEmptyQueue;
+
+    // return the view, saving the wrapper pointer for the release
+    *p_buffer                = &((EbReconView *)eb_wrapper_ptr->object_ptr)->header;
+    (*p_buffer)->wrapper_ptr = (void *)eb_wrapper_ptr;
+
+    return EB_ErrorNone;
+}
+
+#if defined(__linux__) || defined(__APPLE__)
+__attribute__((visibility("default")))
+#endif
+EB_API void eb_vp9_svt_release_recon_view(EbBufferHeaderType **p_buffer) {
+    if (p_buffer && *p_buffer && (*p_buffer)->wrapper_ptr) {
+        EbReconView *view_ptr = (EbReconView *)((EbObjectWrapper *)(*p_buffer)->wrapper_ptr)->object_ptr;
+
+        // Give the picture back to the encoder, then the view itself
+        eb_vp9_release_object(view_ptr->picture_wrapper_ptr);
+        view_ptr->picture_wrapper_ptr = NULL;
+        eb_vp9_release_object((EbObjectWrapper *)(*p_buffer)->wrapper_ptr);
+    }
+    return;
+}
+
 /**********************************
 * Empty This Buffer
 **********************************/
@@ -2876,6 +3479,32 @@ EB_API EbErrorType eb_vp9_svt_enc_send_picture(EbComponentType *svt_enc_componen
 
     // Take the buffer and put it into our internal queue structure
     eb_vp9_get_empty_object(enc_handle_ptr->input_buffer_producer_fifo_ptr_array[0], &eb_wrapper_ptr);
+    if (eb_wrapper_ptr == EB_NULL)
+        return EB_ErrorUndefined;
+
+    if (p_buffer != NULL) {
+        copy_input_buffer(enc_handle_ptr->sequence_control_set_instance_array[0]->sequence_control_set_ptr,
+                          (EbBufferHeaderType *)eb_wrapper_ptr->object_ptr,
+                          p_buffer);
+    }
+
+    eb_vp9_post_full_object(eb_wrapper_ptr);
+
+    return EB_ErrorNone;
+}
+
+#if defined(__linux__) || defined(__APPLE__)
+__attribute__((visibility("default")))
+#endif
+EB_API EbErrorType eb_vp9_svt_enc_send_picture_non_blocking(EbComponentType    *svt_enc_component,
+                                                            EbBufferHeaderType *p_buffer) {
+    EbEncHandle     *enc_handle_ptr = (EbEncHandle *)svt_enc_component->p_component_private;
+    EbObjectWrapper *eb_wrapper_ptr;
+
+    // Only take an input slot that is free right now
+    if (eb_vp9_get_empty_object_non_blocking(enc_handle_ptr->input_buffer_producer_fifo_ptr_array[0],
+                                             &eb_wrapper_ptr) == EB_NoErrorFullQueue)
+        return EB_NoErrorFullQueue;
 
     if (p_buffer != NULL) {
         copy_input_buffer(enc_handle_ptr->sequence_control_set_instance_array[0]->sequence_control_set_ptr,
@@ -2888,6 +3517,44 @@ EB_API EbErrorType eb_vp9_svt_enc_send_picture(EbComponentType *svt_enc_componen
     return EB_ErrorNone;
 }
 
+/**********************************
+* Input slot availability
+**********************************/
+#if defined(__linux__) || defined(__APPLE__)
+__attribute__((visibility("default")))
+#endif
+EB_API EbErrorType eb_vp9_svt_enc_get_free_input_count(EbComponentType *svt_enc_component, uint32_t *free_count) {
+    EbEncHandle *enc_handle_ptr;
+
+    if (svt_enc_component == NULL || free_count == NULL)
+        return EB_ErrorBadParameter;
+
+    enc_handle_ptr = (EbEncHandle *)svt_enc_component->p_component_private;
+    *free_count    = eb_vp9_get_empty_object_count(enc_handle_ptr->input_buffer_producer_fifo_ptr_array[0]);
+
+    return EB_ErrorNone;
+}
+
+#if defined(__linux__) || defined(__APPLE__)
+__attribute__((visibility("default")))
+#endif
+EB_API EbErrorType eb_vp9_svt_enc_set_input_release_callback(EbComponentType *svt_enc_component,
+                                                             void (*callback)(void *context), void *context) {
+    EbEncHandle *enc_handle_ptr;
+
+    if (svt_enc_component == NULL)
+        return EB_ErrorBadParameter;
+
+    enc_handle_ptr = (EbEncHandle *)svt_enc_component->p_component_private;
+    if (enc_handle_ptr->input_buffer_resource_ptr == NULL)
+        return EB_ErrorBadParameter;
+
+    enc_handle_ptr->input_buffer_resource_ptr->release_callback_context = context;
+    enc_handle_ptr->input_buffer_resource_ptr->release_callback         = callback;
+
+    return EB_ErrorNone;
+}
+
 /**********************************
 * eb_svt_get_packet sends out packet
 **********************************/
@@ -2912,7 +3579,8 @@ EB_API EbErrorType eb_vp9_svt_get_packet(EbComponentType *svt_enc_component, EbB
         packet = (EbBufferHeaderType *)eb_wrapper_ptr->object_ptr;
 
         if (packet->flags != EB_BUFFERFLAG_EOS && packet->flags != EB_BUFFERFLAG_SHOW_EXT &&
-            packet->flags != (EB_BUFFERFLAG_SHOW_EXT | EB_BUFFERFLAG_EOS) && packet->flags != 0) {
+            packet->flags != (EB_BUFFERFLAG_SHOW_EXT | EB_BUFFERFLAG_EOS) && packet->flags != EB_BUFFERFLAG_PARTIAL &&
+            packet->flags != 0) {
             return_error = EB_ErrorMax;
         }
 
@@ -138,6 +138,7 @@ typedef struct EbEncHandle {
     EbMemoryMapEntry *memory_map;
     uint32_t          memory_map_index;
     uint64_t          total_lib_memory;
+    uint64_t          total_lib_huge_page_memory;
 
 } EbEncHandle;
 
@@ -146,4 +147,15 @@ typedef struct EbEncHandle {
  **************************************/
 extern EbErrorType eb_buffer_header_ctor(EbPtr *object_dbl_ptr, EbPtr object_init_data_ptr);
 
+/**************************************
+ * ASM Type of the system (AVX512 - 111, AVX2 - 011, NONAVX2 - 001, C - 000)
+ **************************************/
+extern uint32_t get_cpu_asm_type(void);
+
+/**************************************
+ * Memory placement across the nodes of the encoder threads, set when the next encoder is initialized
+ **************************************/
+extern EbBool   eb_vp9_numa_placement;
+extern uint32_t eb_vp9_numa_node_count;
+
 #endif // EbEncHandle_h
@@ -27,10 +27,10 @@ EbErrorType eb_vp9_encode_context_ctor(EbPtr *object_dbl_ptr, EbPtr object_init_
     // Port Active State
     EB_CREATEMUTEX(EbHandle, encode_context_ptr->total_number_of_recon_frame_mutex, sizeof(EbHandle), EB_MUTEX);
 
-    encode_context_ptr->total_number_of_recon_frames = 0;
     // Output Buffer Fifos
-    encode_context_ptr->stream_output_fifo_ptr = (EbFifo *)EB_NULL;
-    encode_context_ptr->recon_output_fifo_ptr  = (EbFifo *)EB_NULL;
+    encode_context_ptr->stream_output_fifo_ptr         = (EbFifo *)EB_NULL;
+    encode_context_ptr->partial_stream_output_fifo_ptr = (EbFifo *)EB_NULL;
+    encode_context_ptr->recon_output_fifo_ptr          = (EbFifo *)EB_NULL;
 
     // Picture Buffer Fifos
     encode_context_ptr->input_picture_pool_fifo_ptr        = (EbFifo *)EB_NULL;
@@ -38,7 +38,6 @@ EbErrorType eb_vp9_encode_context_ctor(EbPtr *object_dbl_ptr, EbPtr object_init_
     encode_context_ptr->pa_reference_picture_pool_fifo_ptr = (EbFifo *)EB_NULL;
 
     // Picture Decision Reordering Queue
-    encode_context_ptr->picture_decision_reorder_queue_head_index = 0;
     EB_MALLOC(PictureDecisionReorderEntry **,
               encode_context_ptr->picture_decision_reorder_queue,
               sizeof(PictureDecisionReorderEntry *) * PICTURE_DECISION_REORDER_QUEUE_MAX_DEPTH,
@@ -53,7 +52,6 @@ EbErrorType eb_vp9_encode_context_ctor(EbPtr *object_dbl_ptr, EbPtr object_init_
     }
 
     // Picture Manager Reordering Queue
-    encode_context_ptr->picture_manager_reorder_queue_head_index = 0;
     EB_MALLOC(PictureManagerReorderEntry **,
               encode_context_ptr->picture_manager_reorder_queue,
               sizeof(PictureManagerReorderEntry *) * PICTURE_MANAGER_REORDER_QUEUE_MAX_DEPTH,
@@ -68,28 +66,12 @@ EbErrorType eb_vp9_encode_context_ctor(EbPtr *object_dbl_ptr, EbPtr object_init_
     }
 
     // Picture Manager Pre-Assignment Buffer
-    encode_context_ptr->pre_assignment_buffer_intra_count        = 0;
-    encode_context_ptr->pre_assignment_buffer_idr_count          = 0;
-    encode_context_ptr->pre_assignment_buffer_scene_change_count = 0;
-    encode_context_ptr->pre_assignment_buffer_scene_change_index = 0;
-    encode_context_ptr->pre_assignment_buffer_eos_flag           = EB_FALSE;
-    encode_context_ptr->decode_base_number                       = 0;
-
-    encode_context_ptr->pre_assignment_buffer_count = 0;
-    encode_context_ptr->number_of_active_pictures   = 0;
-
     EB_MALLOC(EbObjectWrapper **,
               encode_context_ptr->pre_assignment_buffer,
               sizeof(EbObjectWrapper *) * PRE_ASSIGNMENT_MAX_DEPTH,
               EB_N_PTR);
 
-    for (picture_index = 0; picture_index < PRE_ASSIGNMENT_MAX_DEPTH; ++picture_index) {
-        encode_context_ptr->pre_assignment_buffer[picture_index] = (EbObjectWrapper *)EB_NULL;
-    }
-
     // Picture Manager Input Queue
-    encode_context_ptr->input_picture_queue_head_index = 0;
-    encode_context_ptr->input_picture_queue_tail_index = 0;
     EB_MALLOC(InputQueueEntry **,
               encode_context_ptr->input_picture_queue,
               sizeof(InputQueueEntry *) * INPUT_QUEUE_MAX_DEPTH,
@@ -103,8 +85,6 @@ EbErrorType eb_vp9_encode_context_ctor(EbPtr *object_dbl_ptr, EbPtr object_init_
     }
 
     // Picture Manager Reference Queue
-    encode_context_ptr->reference_picture_queue_head_index = 0;
-    encode_context_ptr->reference_picture_queue_tail_index = 0;
     EB_MALLOC(ReferenceQueueEntry **,
               encode_context_ptr->reference_picture_queue,
               sizeof(ReferenceQueueEntry *) * REFERENCE_QUEUE_MAX_DEPTH,
@@ -117,9 +97,15 @@ EbErrorType eb_vp9_encode_context_ctor(EbPtr *object_dbl_ptr, EbPtr object_init_
         }
     }
 
+    // Picture Manager Ready and Release Queues
+    EB_MALLOC(uint32_t *, encode_context_ptr->input_ready_queue, sizeof(uint32_t) * INPUT_QUEUE_MAX_DEPTH, EB_N_PTR);
+
+    EB_MALLOC(uint32_t *,
+              encode_context_ptr->reference_release_queue,
+              sizeof(uint32_t) * REFERENCE_QUEUE_MAX_DEPTH,
+              EB_N_PTR);
+
     // Picture Decision PA Reference Queue
-    encode_context_ptr->picture_decision_pa_reference_queue_head_index = 0;
-    encode_context_ptr->picture_decision_pa_reference_queue_tail_index = 0;
     EB_MALLOC(PaReferenceQueueEntry **,
               encode_context_ptr->picture_decision_pa_reference_queue,
               sizeof(PaReferenceQueueEntry *) * PICTURE_DECISION_PA_REFERENCE_QUEUE_MAX_DEPTH,
@@ -134,7 +120,6 @@ EbErrorType eb_vp9_encode_context_ctor(EbPtr *object_dbl_ptr, EbPtr object_init_
     }
 
     // Initial Rate Control Reordering Queue
-    encode_context_ptr->initial_rate_control_reorder_queue_head_index = 0;
     EB_MALLOC(InitialRateControlReorderEntry **,
               encode_context_ptr->initial_rate_control_reorder_queue,
               sizeof(InitialRateControlReorderEntry *) * INITIAL_RATE_CONTROL_REORDER_QUEUE_MAX_DEPTH,
@@ -149,8 +134,6 @@ EbErrorType eb_vp9_encode_context_ctor(EbPtr *object_dbl_ptr, EbPtr object_init_
     }
 
     // High level Rate Control histogram Queue
-    encode_context_ptr->hl_rate_control_historgram_queue_head_index = 0;
-
     EB_MALLOC(HlRateControlHistogramEntry **,
               encode_context_ptr->hl_rate_control_historgram_queue,
               sizeof(HlRateControlHistogramEntry *) * HIGH_LEVEL_RATE_CONTROL_HISTOGRAM_QUEUE_MAX_DEPTH,
@@ -167,7 +150,6 @@ EbErrorType eb_vp9_encode_context_ctor(EbPtr *object_dbl_ptr, EbPtr object_init_
     EB_CREATEMUTEX(EbHandle, encode_context_ptr->hl_rate_control_historgram_queue_mutex, sizeof(EbHandle), EB_MUTEX);
 
     // Packetization Reordering Queue
-    encode_context_ptr->packetization_reorder_queue_head_index = 0;
     EB_MALLOC(PacketizationReorderEntry **,
               encode_context_ptr->packetization_reorder_queue,
               sizeof(PacketizationReorderEntry *) * PACKETIZATION_REORDER_QUEUE_MAX_DEPTH,
@@ -180,18 +162,7 @@ EbErrorType eb_vp9_encode_context_ctor(EbPtr *object_dbl_ptr, EbPtr object_init_
             return EB_ErrorInsufficientResources;
         }
     }
-
-    encode_context_ptr->intra_period_position = 0;
-    encode_context_ptr->pred_struct_position  = 0;
-    encode_context_ptr->current_input_poc     = -1;
-    encode_context_ptr->elapsed_non_idr_count = 0;
-    encode_context_ptr->initial_picture       = EB_TRUE;
-
-    encode_context_ptr->last_idr_picture = 0;
-
-    // Sequence Termination Flags
-    encode_context_ptr->terminating_picture_number         = ~0u;
-    encode_context_ptr->terminating_sequence_flag_received = EB_FALSE;
+    EB_CREATEMUTEX(EbHandle, encode_context_ptr->packetization_reorder_queue_mutex, sizeof(EbHandle), EB_MUTEX);
 
     // Prediction Structure Group
     encode_context_ptr->prediction_structure_group_ptr = (PredictionStructureGroup *)EB_NULL;
@@ -199,33 +170,16 @@ EbErrorType eb_vp9_encode_context_ctor(EbPtr *object_dbl_ptr, EbPtr object_init_
     // Rate Control
     encode_context_ptr->available_target_bitrate         = 10000000;
     encode_context_ptr->available_target_bitrate_changed = EB_FALSE;
-    encode_context_ptr->buffer_fill                      = 0;
-    encode_context_ptr->vbv_buf_size                     = 0;
-    encode_context_ptr->vbv_max_rate                     = 0;
 
     // Rate Control Bit Tables
     EB_MALLOC(RateControlTables *,
               encode_context_ptr->rate_control_tables_array,
               sizeof(RateControlTables) * TOTAL_NUMBER_OF_INITIAL_RC_TABLES_ENTRY,
               EB_N_PTR);
-
-    return_error = rate_control_tables_ctor(encode_context_ptr->rate_control_tables_array);
-    if (return_error == EB_ErrorInsufficientResources) {
-        return EB_ErrorInsufficientResources;
-    }
     // RC Rate Table Update Mutex
     EB_CREATEMUTEX(EbHandle, encode_context_ptr->rate_table_update_mutex, sizeof(EbHandle), EB_MUTEX);
 
-    encode_context_ptr->rate_control_tables_array_updated = EB_FALSE;
-
     EB_CREATEMUTEX(EbHandle, encode_context_ptr->sc_buffer_mutex, sizeof(EbHandle), EB_MUTEX);
-    encode_context_ptr->sc_buffer                     = 0;
-    encode_context_ptr->sc_frame_in                   = 0;
-    encode_context_ptr->sc_frame_out                  = 0;
-    encode_context_ptr->enc_mode                      = SPEED_CONTROL_INIT_MOD;
-    encode_context_ptr->previous_selected_ref_qp      = 32;
-    encode_context_ptr->max_coded_poc                 = 0;
-    encode_context_ptr->max_coded_poc_selected_ref_qp = 32;
 
     encode_context_ptr->shared_reference_mutex = eb_vp9_create_mutex();
     if (encode_context_ptr->shared_reference_mutex == (EbHandle)EB_NULL) {
@@ -236,5 +190,146 @@ EbErrorType eb_vp9_encode_context_ctor(EbPtr *object_dbl_ptr, EbPtr object_init_
         *total_lib_memory += (sizeof(EbHandle));
     }
 
+    return eb_vp9_encode_context_reset(encode_context_ptr);
+}
+
+/**************************************
+ * eb_vp9_encode_context_reset
+ *   Puts the sequence state (queues, GOP
+ *   counters, rate control and speed control
+ *   state) back to the start of a sequence
+ **************************************/
+EbErrorType eb_vp9_encode_context_reset(EncodeContext *encode_context_ptr) {
+    uint32_t    picture_index;
+    EbErrorType return_error;
+
+    encode_context_ptr->total_number_of_recon_frames = 0;
+
+    // Picture Decision Reordering Queue
+    encode_context_ptr->picture_decision_reorder_queue_head_index = 0;
+    for (picture_index = 0; picture_index < PICTURE_DECISION_REORDER_QUEUE_MAX_DEPTH; ++picture_index) {
+        encode_context_ptr->picture_decision_reorder_queue[picture_index]->picture_number         = picture_index;
+        encode_context_ptr->picture_decision_reorder_queue[picture_index]->parent_pcs_wrapper_ptr = EB_NULL;
+    }
+
+    // Picture Manager Reordering Queue
+    encode_context_ptr->picture_manager_reorder_queue_head_index = 0;
+    for (picture_index = 0; picture_index < PICTURE_MANAGER_REORDER_QUEUE_MAX_DEPTH; ++picture_index) {
+        encode_context_ptr->picture_manager_reorder_queue[picture_index]->picture_number         = picture_index;
+        encode_context_ptr->picture_manager_reorder_queue[picture_index]->parent_pcs_wrapper_ptr = EB_NULL;
+    }
+
+    // Picture Manager Pre-Assignment Buffer
+    encode_context_ptr->pre_assignment_buffer_intra_count        = 0;
+    encode_context_ptr->pre_assignment_buffer_idr_count          = 0;
+    encode_context_ptr->pre_assignment_buffer_scene_change_count = 0;
+    encode_context_ptr->pre_assignment_buffer_scene_change_index = 0;
+    encode_context_ptr->pre_assignment_buffer_eos_flag           = EB_FALSE;
+    encode_context_ptr->decode_base_number                       = 0;
+
+    encode_context_ptr->pre_assignment_buffer_count = 0;
+    encode_context_ptr->number_of_active_pictures   = 0;
+
+    for (picture_index = 0; picture_index < PRE_ASSIGNMENT_MAX_DEPTH; ++picture_index) {
+        encode_context_ptr->pre_assignment_buffer[picture_index] = (EbObjectWrapper *)EB_NULL;
+    }
+
+    // Picture Manager Input Queue
+    encode_context_ptr->input_picture_queue_head_index = 0;
+    encode_context_ptr->input_picture_queue_tail_index = 0;
+    for (picture_index = 0; picture_index < INPUT_QUEUE_MAX_DEPTH; ++picture_index) {
+        encode_context_ptr->input_picture_queue[picture_index]->input_object_ptr = (EbObjectWrapper *)EB_NULL;
+        encode_context_ptr->input_picture_queue[picture_index]->dependent_count  = 0;
+    }
+
+    // Picture Manager Reference Queue
+    encode_context_ptr->reference_picture_queue_head_index = 0;
+    encode_context_ptr->reference_picture_queue_tail_index = 0;
+    for (picture_index = 0; picture_index < REFERENCE_QUEUE_MAX_DEPTH; ++picture_index) {
+        ReferenceQueueEntry *entry_ptr = encode_context_ptr->reference_picture_queue[picture_index];
+        entry_ptr->reference_object_ptr = (EbObjectWrapper *)EB_NULL;
+        entry_ptr->picture_number       = ~0u;
+        entry_ptr->dependent_count      = 0;
+        entry_ptr->reference_available  = EB_FALSE;
+        entry_ptr->waiter_head          = WAITER_NULL;
+        entry_ptr->release_pending      = EB_FALSE;
+    }
+    encode_context_ptr->input_ready_count       = 0;
+    encode_context_ptr->reference_release_count = 0;
+
+    // Picture Decision PA Reference Queue
+    encode_context_ptr->picture_decision_pa_reference_queue_head_index = 0;
+    encode_context_ptr->picture_decision_pa_reference_queue_tail_index = 0;
+    for (picture_index = 0; picture_index < PICTURE_DECISION_PA_REFERENCE_QUEUE_MAX_DEPTH; ++picture_index) {
+        PaReferenceQueueEntry *entry_ptr = encode_context_ptr->picture_decision_pa_reference_queue[picture_index];
+        entry_ptr->input_object_ptr = (EbObjectWrapper *)EB_NULL;
+        entry_ptr->picture_number   = 0;
+        entry_ptr->dependent_count  = 0;
+    }
+
+    // Initial Rate Control Reordering Queue
+    encode_context_ptr->initial_rate_control_reorder_queue_head_index = 0;
+    for (picture_index = 0; picture_index < INITIAL_RATE_CONTROL_REORDER_QUEUE_MAX_DEPTH; ++picture_index) {
+        encode_context_ptr->initial_rate_control_reorder_queue[picture_index]->picture_number = picture_index;
+        encode_context_ptr->initial_rate_control_reorder_queue[picture_index]->parent_pcs_wrapper_ptr = EB_NULL;
+    }
+
+    // High level Rate Control histogram Queue
+    encode_context_ptr->hl_rate_control_historgram_queue_head_index = 0;
+    for (picture_index = 0; picture_index < HIGH_LEVEL_RATE_CONTROL_HISTOGRAM_QUEUE_MAX_DEPTH; ++picture_index) {
+        HlRateControlHistogramEntry *entry_ptr = encode_context_ptr->hl_rate_control_historgram_queue[picture_index];
+        entry_ptr->picture_number         = picture_index;
+        entry_ptr->life_count             = 0;
+        entry_ptr->passed_to_hlrc         = EB_FALSE;
+        entry_ptr->is_coded               = EB_FALSE;
+        entry_ptr->parent_pcs_wrapper_ptr = (EbObjectWrapper *)EB_NULL;
+    }
+
+    // Packetization Reordering Queue
+    encode_context_ptr->packetization_reorder_queue_head_index = 0;
+    for (picture_index = 0; picture_index < PACKETIZATION_REORDER_QUEUE_MAX_DEPTH; ++picture_index) {
+        encode_context_ptr->packetization_reorder_queue[picture_index]->picture_number            = picture_index;
+        encode_context_ptr->packetization_reorder_queue[picture_index]->output_stream_wrapper_ptr = EB_NULL;
+    }
+
+    encode_context_ptr->intra_period_position = 0;
+    encode_context_ptr->pred_struct_position  = 0;
+    encode_context_ptr->current_input_poc     = -1;
+    encode_context_ptr->elapsed_non_idr_count = 0;
+    encode_context_ptr->initial_picture       = EB_TRUE;
+
+    encode_context_ptr->last_idr_picture = 0;
+
+    // Sequence Termination Flags
+    encode_context_ptr->terminating_picture_number         = ~0u;
+    encode_context_ptr->terminating_sequence_flag_received = EB_FALSE;
+
+    // Rate Control
+    encode_context_ptr->buffer_fill                   = 0;
+    encode_context_ptr->vbv_buf_size                  = 0;
+    encode_context_ptr->vbv_max_rate                  = 0;
+    encode_context_ptr->previous_selected_ref_qp      = 32;
+    encode_context_ptr->max_coded_poc                 = 0;
+    encode_context_ptr->max_coded_poc_selected_ref_qp = 32;
+
+    // Rate Control Bit Tables, updated by the Packetization feedback
+    return_error = rate_control_tables_ctor(encode_context_ptr->rate_control_tables_array);
+    if (return_error == EB_ErrorInsufficientResources) {
+        return EB_ErrorInsufficientResources;
+    }
+    encode_context_ptr->rate_control_tables_array_updated = EB_FALSE;
+
+    // Speed Control
+    encode_context_ptr->sc_buffer            = 0;
+    encode_context_ptr->sc_frame_in          = 0;
+    encode_context_ptr->sc_frame_out         = 0;
+    encode_context_ptr->sc_me_busy_time      = 0;
+    encode_context_ptr->sc_enc_dec_busy_time = 0;
+    encode_context_ptr->enc_mode             = SPEED_CONTROL_INIT_MOD;
+    encode_context_ptr->sc_knobs             = 0;
+
+    encode_context_ptr->previous_mini_gop_hierarchical_levels    = 0;
+    encode_context_ptr->previous_picture_control_set_wrapper_ptr = (EbObjectWrapper *)EB_NULL;
+
     return EB_ErrorNone;
 }
@@ -51,7 +51,10 @@ typedef struct EncodeContext {
 
     // Output Buffer Fifos
     EbFifo *stream_output_fifo_ptr;
+    EbFifo *partial_stream_output_fifo_ptr;
     EbFifo *recon_output_fifo_ptr;
+    // Bytes held by the output stream buffers, they only grow so this is also the peak
+    uint64_t output_stream_buffer_pool_size;
     // Picture Buffer Fifos
     EbFifo *input_picture_pool_fifo_ptr;
     EbFifo *reference_picture_pool_fifo_ptr;
@@ -91,6 +94,13 @@ typedef struct EncodeContext {
     uint32_t              reference_picture_queue_head_index;
     uint32_t              reference_picture_queue_tail_index;
 
+    // Picture Manager input entries with all their references completed, and reference entries
+    // to check for release in the current event, both kept in queue order
+    uint32_t *input_ready_queue;
+    uint32_t  input_ready_count;
+    uint32_t *reference_release_queue;
+    uint32_t  reference_release_count;
+
     // Initial Rate Control Reorder Queue
     InitialRateControlReorderEntry **initial_rate_control_reorder_queue;
     uint32_t                         initial_rate_control_reorder_queue_head_index;
@@ -103,6 +113,8 @@ typedef struct EncodeContext {
     // Packetization Reorder Queue
     PacketizationReorderEntry **packetization_reorder_queue;
     uint32_t                    packetization_reorder_queue_head_index;
+    // Serializes the partial packets of the head picture with the output of the head (partial_packet_output)
+    EbHandle packetization_reorder_queue_mutex;
 
     // GOP Counters
     uint32_t intra_period_position; // Current position in intra period
@@ -131,8 +143,12 @@ typedef struct EncodeContext {
     int64_t  sc_frame_in;
     int64_t  sc_frame_out;
     EbHandle sc_buffer_mutex;
+    // Time (ms) the ME and the EncDec threads spent on processing, accumulated under sc_buffer_mutex
+    double sc_me_busy_time;
+    double sc_enc_dec_busy_time;
 
     EB_ENC_MODE enc_mode;
+    uint8_t     sc_knobs; // SC_KNOB_* stepped on top of enc_mode
 
     // Rate Control
     uint32_t available_target_bitrate;
@@ -160,5 +176,6 @@ typedef struct EncodeContextInitData {
  * Extern Function Declarations
  **************************************/
 extern EbErrorType eb_vp9_encode_context_ctor(EbPtr *object_dbl_ptr, EbPtr object_init_data_ptr);
+extern EbErrorType eb_vp9_encode_context_reset(EncodeContext *encode_context_ptr);
 
 #endif // EbEncodeContext_h
@@ -9,6 +9,8 @@
 #include "EbEncDecResults.h"
 #include "EbEntropyCodingResults.h"
 #include "EbRateControlTasks.h"
+#include "EbPacketizationProcess.h"
+#include "EbSvtVp9ErrorCodes.h"
 
 #include "vp9_blockd.h"
 #include "vp9_encoder.h"
@@ -20,6 +22,10 @@
 #include "vp9_segmentation.h"
 
 #endif
+
+// Margin kept in the entropy coding buffer before a SB is coded, 4 bytes per sample
+#define EC_SB_MAX_SIZE (MAX_SB_SIZE * MAX_SB_SIZE * 3 / 2 * 4)
+
 /******************************************************
  * Enc Dec Context Constructor
  ******************************************************/
@@ -87,7 +93,7 @@ EbErrorType EntropyCodingSb(PictureControlSet *picture_control_set_ptr, EntropyC
 
     // Reset above context @ the 1st SB
     if (sb_ptr->sb_index == 0) {
-        eb_vp9_start_encode(residual_bc, data + total_size);
+        eb_vp9_start_encode(residual_bc, data + total_size, output_bitstream_ptr->size);
 
         // Note: this memset assumes above_context[0], [1] and [2]
         // are allocated as part of the same buffer.
@@ -96,6 +102,15 @@ EbErrorType EntropyCodingSb(PictureControlSet *picture_control_set_ptr, EntropyC
         memset(cm->above_seg_context, 0, sizeof(*cm->above_seg_context) * mi_cols_aligned_to_sb(cm->mi_cols));
     }
 
+    // Grow the buffer when the SB may not fit, on allocation failure the writer bound reports the overflow
+    if (residual_bc->size - residual_bc->pos < EC_SB_MAX_SIZE &&
+        eb_vp9_output_bitstream_unit_grow(output_bitstream_ptr,
+                                          MAX(output_bitstream_ptr->size + (output_bitstream_ptr->size >> 1),
+                                              residual_bc->pos + EC_SB_MAX_SIZE)) == EB_ErrorNone) {
+        residual_bc->buffer = output_bitstream_ptr->buffer;
+        residual_bc->size   = output_bitstream_ptr->size;
+    }
+
     // Reset left context @ each row of SB
     if (sb_ptr->origin_x == 0) {
         // Initialize the left context for the new SB row
@@ -444,6 +459,8 @@ EbErrorType EntropyCodingSb(PictureControlSet *picture_control_set_ptr, EntropyC
     // Stop writing
     if (sb_ptr->sb_index == (unsigned)picture_control_set_ptr->sb_total_count - 1) {
         eb_vp9_stop_encode(residual_bc);
+        if (residual_bc->error)
+            return_error = EB_ErrorInsufficientResources;
     }
 
     return return_error;
@@ -566,6 +583,8 @@ void *eb_vp9_entropy_coding_kernel(void *input_ptr) {
     for (;;) {
         // Get Mode Decision Results
         eb_vp9_get_full_object(context_ptr->enc_dec_input_fifo_ptr, &enc_dec_results_wrapper_ptr);
+        if (enc_dec_results_wrapper_ptr == EB_NULL)
+            return EB_NULL;
         enc_dec_results_ptr     = (EncDecResults *)enc_dec_results_wrapper_ptr->object_ptr;
         picture_control_set_ptr = (PictureControlSet *)enc_dec_results_ptr->picture_control_set_wrapper_ptr->object_ptr;
         sequence_control_set_ptr = (SequenceControlSet *)
@@ -594,11 +613,11 @@ void *eb_vp9_entropy_coding_kernel(void *input_ptr) {
 
                     sb_ptr->sb_total_bits = 0;
 #if VP9_RC
-                    uint32_t prev_pos = sb_index ? picture_control_set_ptr->entropy_coder_ptr->residual_bc.pos : 0;
+                    uint32_t prev_pos =
+                        sb_index ? vpx_writer_tell(&picture_control_set_ptr->entropy_coder_ptr->residual_bc) : 0;
 #endif
 #if SEG_SUPPORT
                     if (sb_index == 0) {
-                        MACROBLOCKD      *xd = NULL;
                         VP9_COMMON *const cm = &picture_control_set_ptr->parent_pcs_ptr->cpi->common;
 
                         struct segmentation *seg = &cm->seg;
@@ -613,12 +632,17 @@ void *eb_vp9_entropy_coding_kernel(void *input_ptr) {
                         }
                     }
 #endif
-                    // Entropy Coding
-                    EntropyCodingSb(
-                        picture_control_set_ptr, context_ptr, sb_ptr, picture_control_set_ptr->entropy_coder_ptr);
+                    // Entropy Coding, the picture goes on truncated once the error is reported
+                    if (EntropyCodingSb(picture_control_set_ptr,
+                                        context_ptr,
+                                        sb_ptr,
+                                        picture_control_set_ptr->entropy_coder_ptr) != EB_ErrorNone) {
+                        EbCallback *app_callback_ptr = sequence_control_set_ptr->encode_context_ptr->app_callback_ptr;
+                        app_callback_ptr->error_handler(app_callback_ptr->handle, EB_ENC_EC_ERROR0);
+                    }
 #if VP9_RC
-                    sb_ptr->sb_total_bits = (picture_control_set_ptr->entropy_coder_ptr->residual_bc.pos - prev_pos)
-                        << 3;
+                    sb_ptr->sb_total_bits =
+                        (vpx_writer_tell(&picture_control_set_ptr->entropy_coder_ptr->residual_bc) - prev_pos) << 3;
                     picture_control_set_ptr->parent_pcs_ptr->quantized_coeff_num_bits += sb_ptr->sb_total_bits;
 #endif
 
@@ -632,6 +656,8 @@ void *eb_vp9_entropy_coding_kernel(void *input_ptr) {
 
                     // Get Empty EncDec Results
                     eb_vp9_get_empty_object(context_ptr->rate_control_output_fifo_ptr, &rate_control_task_wrapper_ptr);
+                    if (rate_control_task_wrapper_ptr == EB_NULL)
+                        return EB_NULL;
                     rate_control_task_ptr            = (RateControlTasks *)rate_control_task_wrapper_ptr->object_ptr;
                     rate_control_task_ptr->task_type = RC_ENTROPY_CODING_ROW_FEEDBACK_RESULT;
                     rate_control_task_ptr->picture_number = picture_control_set_ptr->picture_number;
@@ -645,6 +671,12 @@ void *eb_vp9_entropy_coding_kernel(void *input_ptr) {
                     eb_vp9_post_full_object(rate_control_task_wrapper_ptr);
                 }
 
+                // Output the tile data of the row before the next row is coded, the last row goes with the headers
+                if (sequence_control_set_ptr->static_config.partial_packet_output &&
+                    ysb_index + 1 < (uint32_t)picture_control_set_ptr->entropy_coding_row_count) {
+                    eb_vp9_packetization_output_partial(picture_control_set_ptr);
+                }
+
                 eb_vp9_block_on_mutex(picture_control_set_ptr->entropy_coding_mutex);
                 if (picture_control_set_ptr->entropy_coding_pic_done == EB_FALSE) {
                     // If the picture is complete, terminate the slice
@@ -673,6 +705,10 @@ void *eb_vp9_entropy_coding_kernel(void *input_ptr) {
                         // Get Empty Entropy Coding Results
                         eb_vp9_get_empty_object(context_ptr->entropy_coding_output_fifo_ptr,
                                                 &entropy_coding_results_wrapper_ptr);
+                        if (entropy_coding_results_wrapper_ptr == EB_NULL) {
+                            eb_vp9_release_mutex(picture_control_set_ptr->entropy_coding_mutex);
+                            return EB_NULL;
+                        }
                         entropy_coding_results_ptr = (EntropyCodingResults *)
                                                          entropy_coding_results_wrapper_ptr->object_ptr;
                         entropy_coding_results_ptr->picture_control_set_wrapper_ptr =
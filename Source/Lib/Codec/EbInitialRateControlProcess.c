@@ -296,6 +296,7 @@ static void eb_vp9_ReleasePaReferenceObjects(PictureParentControlSet *picture_co
     // PA Reference Pictures
     uint32_t num_of_list_to_search;
     uint32_t list_index;
+    uint32_t picture_index;
     if (picture_control_set_ptr->slice_type != I_SLICE) {
         num_of_list_to_search = (picture_control_set_ptr->slice_type == P_SLICE) ? REF_LIST_0 : REF_LIST_1;
 
@@ -316,6 +317,11 @@ static void eb_vp9_ReleasePaReferenceObjects(PictureParentControlSet *picture_co
         eb_vp9_release_object(picture_control_set_ptr->pareference_picture_wrapper_ptr);
     }
 
+    // Past input pictures used by the temporal filter
+    for (picture_index = 0; picture_index < picture_control_set_ptr->temporal_filter_count; ++picture_index)
+        eb_vp9_release_object(picture_control_set_ptr->temporal_filter_wrapper_ptr_array[picture_index]);
+    picture_control_set_ptr->temporal_filter_count = 0;
+
     return;
 }
 
@@ -812,6 +818,8 @@ void *eb_vp9_initial_eb_vp9_rate_control_kernel(void *input_ptr) {
     for (;;) {
         // Get Input Full Object
         eb_vp9_get_full_object(context_ptr->motion_estimation_results_input_fifo_ptr, &input_results_wrapper_ptr);
+        if (input_results_wrapper_ptr == EB_NULL)
+            return EB_NULL;
 
         input_results_ptr       = (MotionEstimationResults *)input_results_wrapper_ptr->object_ptr;
         picture_control_set_ptr = (PictureParentControlSet *)
@@ -844,7 +852,8 @@ void *eb_vp9_initial_eb_vp9_rate_control_kernel(void *input_ptr) {
             queue_entry_ptr = determine_picture_offset_in_queue(
                 encode_context_ptr, picture_control_set_ptr, input_results_ptr);
 
-            if (sequence_control_set_ptr->static_config.rate_control_mode) {
+            if (sequence_control_set_ptr->static_config.rate_control_mode == 1 ||
+                sequence_control_set_ptr->static_config.rate_control_mode == 2) {
                 if (sequence_control_set_ptr->look_ahead_distance != 0) {
                     // Getting the Histogram Queue Data
                     get_histogram_queue_data(sequence_control_set_ptr, encode_context_ptr, picture_control_set_ptr);
@@ -952,7 +961,8 @@ void *eb_vp9_initial_eb_vp9_rate_control_kernel(void *input_ptr) {
                     else
                         picture_control_set_ptr->end_of_sequence_region = EB_FALSE;
 
-                    if (sequence_control_set_ptr->static_config.rate_control_mode) {
+                    if (sequence_control_set_ptr->static_config.rate_control_mode == 1 ||
+                        sequence_control_set_ptr->static_config.rate_control_mode == 2) {
                         // Determine offset from the Head Ptr for HLRC histogram queue and set the life count
                         if (sequence_control_set_ptr->look_ahead_distance != 0) {
                             // Update Histogram Queue Entry Life count
@@ -1006,6 +1016,8 @@ void *eb_vp9_initial_eb_vp9_rate_control_kernel(void *input_ptr) {
                     eb_vp9_get_empty_object(
                         sequence_control_set_ptr->encode_context_ptr->reference_picture_pool_fifo_ptr,
                         &reference_picture_wrapper_ptr);
+                    if (reference_picture_wrapper_ptr == EB_NULL)
+                        return EB_NULL;
                     ((PictureParentControlSet *)(queue_entry_ptr->parent_pcs_wrapper_ptr->object_ptr))
                         ->reference_picture_wrapper_ptr = reference_picture_wrapper_ptr;
 
@@ -1017,11 +1029,15 @@ void *eb_vp9_initial_eb_vp9_rate_control_kernel(void *input_ptr) {
                     //OPTION 1:  get the buffer in resource coordination
                     eb_vp9_get_empty_object(sequence_control_set_ptr->encode_context_ptr->stream_output_fifo_ptr,
                                             &output_stream_wrapper_ptr);
+                    if (output_stream_wrapper_ptr == EB_NULL)
+                        return EB_NULL;
                     picture_control_set_ptr->output_stream_wrapper_ptr = output_stream_wrapper_ptr;
 
                     // Get Empty Results Object
                     eb_vp9_get_empty_object(context_ptr->initialrate_control_results_output_fifo_ptr,
                                             &output_results_wrapper_ptr);
+                    if (output_results_wrapper_ptr == EB_NULL)
+                        return EB_NULL;
 
                     output_results_ptr = (InitialRateControlResults *)output_results_wrapper_ptr->object_ptr;
                     output_results_ptr->picture_control_set_wrapper_ptr = queue_entry_ptr->parent_pcs_wrapper_ptr;
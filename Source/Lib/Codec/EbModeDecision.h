@@ -56,6 +56,18 @@ typedef struct ModeDecisionCandidate {
 
 } ModeDecisionCandidate;
 
+/**************************************
+* Transform Block Results
+*  full loop results of a transform block
+*  before the block skip decision
+**************************************/
+typedef struct TuResults {
+    uint16_t eob;
+    int      coeff_ctx;
+    int      coeff_bits;
+    int      distortion[DIST_CALC_TOTAL];
+} TuResults;
+
 /**************************************
 * Mode Decision Candidate Buffer
 **************************************/
@@ -73,6 +85,9 @@ typedef struct ModeDecisionCandidateBuffer {
     uint64_t *fast_cost_ptr;
     uint64_t *full_cost_ptr;
 
+    // Full loop results, reused by the encode pass
+    TuResults tu_results[MAX_MB_PLANE][4];
+
 } ModeDecisionCandidateBuffer;
 
 /**************************************
@@ -22,6 +22,7 @@
 
 #if SEG_SUPPORT
 #include "vp9_segmentation.h"
+#include "vp9_ratectrl.h"
 #endif
 
 // Shooting states
@@ -125,9 +126,13 @@ EbErrorType eb_vp9_mode_decision_configuration_context_ctor(ModeDecisionConfigur
     context_ptr->rate_control_input_fifo_ptr                 = rate_control_input_fifo_ptr;
     context_ptr->mode_decision_configuration_output_fifo_ptr = mode_decision_configuration_output_fifo_ptr;
 
-    // Budgeting
-    EB_MALLOC(uint32_t *, context_ptr->sb_score_array, sizeof(uint32_t) * sb_total_count, EB_N_PTR);
-    EB_MALLOC(uint8_t *, context_ptr->sb_cost_array, sizeof(uint8_t) * sb_total_count, EB_N_PTR);
+    // Budgeting, not needed by the contexts that only configure SBs (sb_total_count 0)
+    context_ptr->sb_score_array = (uint32_t *)EB_NULL;
+    context_ptr->sb_cost_array  = (uint8_t *)EB_NULL;
+    if (sb_total_count) {
+        EB_MALLOC(uint32_t *, context_ptr->sb_score_array, sizeof(uint32_t) * sb_total_count, EB_N_PTR);
+        EB_MALLOC(uint8_t *, context_ptr->sb_cost_array, sizeof(uint8_t) * sb_total_count, EB_N_PTR);
+    }
 
     // Open Loop Partitioning
     EB_MALLOC(ModeDecisionCandidate *, context_ptr->candidate_ptr, sizeof(ModeDecisionCandidate), EB_N_PTR);
@@ -2403,19 +2408,6 @@ static EbErrorType early_mode_decision_sb(SequenceControlSet               *sequ
     return return_error;
 }
 
-/******************************************************
-* Predict the LCU partitionning
-******************************************************/
-void picture_depth_open_loop(ModeDecisionConfigurationContext *context_ptr,
-                             SequenceControlSet *sequence_control_set_ptr, PictureControlSet *picture_control_set_ptr) {
-    for (int sb_index = 0; sb_index < picture_control_set_ptr->sb_total_count; ++sb_index) {
-        early_mode_decision_sb(sequence_control_set_ptr,
-                               picture_control_set_ptr,
-                               context_ptr,
-                               picture_control_set_ptr->sb_ptr_array[sb_index]);
-    }
-}
-
 void sb_depth_open_loop(ModeDecisionConfigurationContext *context_ptr, SequenceControlSet *sequence_control_set_ptr,
                         PictureControlSet *picture_control_set_ptr, uint32_t sb_index) {
     early_mode_decision_sb(sequence_control_set_ptr,
@@ -2548,132 +2540,6 @@ void sb_depth_84_block(SequenceControlSet *sequence_control_set_ptr, PictureCont
     }
 }
 
-void picture_depth_85_block(SequenceControlSet *sequence_control_set_ptr, PictureControlSet *picture_control_set_ptr) {
-    uint32_t sb_index;
-    EB_BOOL  split_flag;
-
-    for (sb_index = 0; sb_index < picture_control_set_ptr->sb_total_count; ++sb_index) {
-        SbParams  *sb_params   = &sequence_control_set_ptr->sb_params_array[sb_index];
-        MdcSbData *results_ptr = &picture_control_set_ptr->mdc_sb_data_array[sb_index];
-
-        results_ptr->block_count = 0;
-        uint16_t block_index     = 0;
-
-        while (block_index < EP_BLOCK_MAX_COUNT) {
-            split_flag = EB_TRUE;
-
-            const EpBlockStats *ep_block_stats_ptr = ep_get_block_stats(block_index);
-            uint8_t             depth              = ep_block_stats_ptr->depth;
-            if (sb_params->ep_scan_block_validity[block_index] && ep_block_stats_ptr->shape == PART_N) {
-                switch (depth) {
-#if INTRA_4x4_SB_DEPTH_84_85
-                case 0:
-                    results_ptr->block_data_array[results_ptr->block_count].block_index  = block_index;
-                    results_ptr->block_data_array[results_ptr->block_count++].split_flag = split_flag = EB_TRUE;
-                    break;
-                case 1:
-                    results_ptr->block_data_array[results_ptr->block_count].block_index  = block_index;
-                    results_ptr->block_data_array[results_ptr->block_count++].split_flag = split_flag = EB_TRUE;
-                    break;
-                case 2:
-                    results_ptr->block_data_array[results_ptr->block_count].block_index  = block_index;
-                    results_ptr->block_data_array[results_ptr->block_count++].split_flag = split_flag = EB_TRUE;
-                    break;
-                case 3:
-                    results_ptr->block_data_array[results_ptr->block_count].block_index  = block_index;
-                    results_ptr->block_data_array[results_ptr->block_count++].split_flag = split_flag = EB_TRUE;
-                    break;
-                case 4:
-                    results_ptr->block_data_array[results_ptr->block_count].block_index  = block_index;
-                    results_ptr->block_data_array[results_ptr->block_count++].split_flag = split_flag = EB_FALSE;
-                    break;
-#else
-                case 0:
-                    results_ptr->block_data_array[results_ptr->block_count].block_index  = block_index;
-                    results_ptr->block_data_array[results_ptr->block_count++].split_flag = split_flag = EB_TRUE;
-                    break;
-
-                case 1:
-                    results_ptr->block_data_array[results_ptr->block_count].block_index  = block_index;
-                    results_ptr->block_data_array[results_ptr->block_count++].split_flag = split_flag = EB_TRUE;
-                    break;
-
-                case 2:
-                    results_ptr->block_data_array[results_ptr->block_count].block_index  = block_index;
-                    results_ptr->block_data_array[results_ptr->block_count++].split_flag = split_flag = EB_TRUE;
-                    break;
-
-                case 3:
-                    results_ptr->block_data_array[results_ptr->block_count].block_index  = block_index;
-                    results_ptr->block_data_array[results_ptr->block_count++].split_flag = split_flag = EB_FALSE;
-                    break;
-#endif
-                }
-            }
-
-            block_index += (split_flag == EB_FALSE) ? sq_depth_offset[depth] : nsq_depth_offset[depth];
-        }
-    }
-}
-
-void picture_depth_84_block(SequenceControlSet *sequence_control_set_ptr, PictureControlSet *picture_control_set_ptr) {
-    uint32_t sb_index;
-    EB_BOOL  split_flag;
-
-    for (sb_index = 0; sb_index < picture_control_set_ptr->sb_total_count; ++sb_index) {
-        SbParams  *sb_params   = &sequence_control_set_ptr->sb_params_array[sb_index];
-        MdcSbData *results_ptr = &picture_control_set_ptr->mdc_sb_data_array[sb_index];
-
-        results_ptr->block_count = 0;
-        uint16_t block_index     = 0;
-
-        while (block_index < EP_BLOCK_MAX_COUNT) {
-            split_flag = EB_TRUE;
-
-            const EpBlockStats *ep_block_stats_ptr = ep_get_block_stats(block_index);
-            uint8_t             depth              = ep_block_stats_ptr->depth;
-            if (sb_params->ep_scan_block_validity[block_index] && ep_block_stats_ptr->shape == PART_N) {
-                switch (depth) {
-#if INTRA_4x4_I_SLICE
-                case 0: split_flag = EB_TRUE; break;
-                case 1:
-                    results_ptr->block_data_array[results_ptr->block_count].block_index  = block_index;
-                    results_ptr->block_data_array[results_ptr->block_count++].split_flag = split_flag = EB_TRUE;
-                    break;
-                case 2:
-                    results_ptr->block_data_array[results_ptr->block_count].block_index  = block_index;
-                    results_ptr->block_data_array[results_ptr->block_count++].split_flag = split_flag = EB_TRUE;
-                    break;
-                case 3:
-                    results_ptr->block_data_array[results_ptr->block_count].block_index  = block_index;
-                    results_ptr->block_data_array[results_ptr->block_count++].split_flag = split_flag = EB_TRUE;
-                    break;
-                case 4:
-                    results_ptr->block_data_array[results_ptr->block_count].block_index  = block_index;
-                    results_ptr->block_data_array[results_ptr->block_count++].split_flag = split_flag = EB_FALSE;
-                    break;
-#else
-                case 0: split_flag = EB_TRUE; break;
-                case 1:
-                    results_ptr->block_data_array[results_ptr->block_count].block_index  = block_index;
-                    results_ptr->block_data_array[results_ptr->block_count++].split_flag = split_flag = EB_TRUE;
-                    break;
-                case 2:
-                    results_ptr->block_data_array[results_ptr->block_count].block_index  = block_index;
-                    results_ptr->block_data_array[results_ptr->block_count++].split_flag = split_flag = EB_TRUE;
-                    break;
-                case 3:
-                    results_ptr->block_data_array[results_ptr->block_count].block_index  = block_index;
-                    results_ptr->block_data_array[results_ptr->block_count++].split_flag = split_flag = EB_FALSE;
-                    break;
-#endif
-                }
-            }
-            block_index += (split_flag == EB_FALSE) ? sq_depth_offset[depth] : nsq_depth_offset[depth];
-        }
-    }
-}
-
 void sb_depth_8x8_16x16_block(SequenceControlSet *sequence_control_set_ptr, PictureControlSet *picture_control_set_ptr,
                               uint32_t sb_index) {
     EB_BOOL    split_flag;
@@ -2740,11 +2606,50 @@ void sb_depth_16x16_block(SequenceControlSet *sequence_control_set_ptr, PictureC
     }
 }
 
+/******************************************************
+* Mode Decision Configuration SB
+*   derives the partitioning of one SB after the picture
+*   level decisions of the MDC kernel. There is no
+*   dependency between SBs; context_ptr only provides
+*   the SB scratch (candidate, local CU array), so this
+*   is run by the thread that codes the SB
+******************************************************/
+void eb_vp9_mode_decision_configuration_sb(ModeDecisionConfigurationContext *context_ptr,
+                                           SequenceControlSet               *sequence_control_set_ptr,
+                                           PictureControlSet *picture_control_set_ptr, uint32_t sb_index) {
+    if (picture_control_set_ptr->parent_pcs_ptr->pic_depth_mode == PIC_SB_SWITCH_DEPTH_MODE) {
+        if (picture_control_set_ptr->parent_pcs_ptr->sb_depth_mode_array[sb_index] == SB_FULL85_DEPTH_MODE) {
+            sb_depth_85_block(sequence_control_set_ptr, picture_control_set_ptr, sb_index);
+        } else if (picture_control_set_ptr->parent_pcs_ptr->sb_depth_mode_array[sb_index] == SB_FULL84_DEPTH_MODE) {
+            sb_depth_84_block(sequence_control_set_ptr, picture_control_set_ptr, sb_index);
+        } else if (picture_control_set_ptr->parent_pcs_ptr->sb_depth_mode_array[sb_index] == SB_AVC_DEPTH_MODE) {
+            sb_depth_8x8_16x16_block(sequence_control_set_ptr, picture_control_set_ptr, sb_index);
+        } else if (picture_control_set_ptr->parent_pcs_ptr->sb_depth_mode_array[sb_index] ==
+                   SB_LIGHT_AVC_DEPTH_MODE) {
+            sb_depth_16x16_block(sequence_control_set_ptr, picture_control_set_ptr, sb_index);
+        } else if (picture_control_set_ptr->parent_pcs_ptr->sb_depth_mode_array[sb_index] ==
+                       SB_OPEN_LOOP_DEPTH_MODE ||
+                   picture_control_set_ptr->parent_pcs_ptr->sb_depth_mode_array[sb_index] ==
+                       SB_LIGHT_OPEN_LOOP_DEPTH_MODE ||
+                   picture_control_set_ptr->parent_pcs_ptr->sb_depth_mode_array[sb_index] ==
+                       SB_PRED_OPEN_LOOP_DEPTH_MODE ||
+                   picture_control_set_ptr->parent_pcs_ptr->sb_depth_mode_array[sb_index] ==
+                       SB_PRED_OPEN_LOOP_1_NFL_DEPTH_MODE) {
+            sb_depth_open_loop(context_ptr, sequence_control_set_ptr, picture_control_set_ptr, sb_index);
+        }
+    } else if (picture_control_set_ptr->parent_pcs_ptr->pic_depth_mode == PIC_FULL85_DEPTH_MODE) {
+        sb_depth_85_block(sequence_control_set_ptr, picture_control_set_ptr, sb_index);
+    } else if (picture_control_set_ptr->parent_pcs_ptr->pic_depth_mode == PIC_FULL84_DEPTH_MODE) {
+        sb_depth_84_block(sequence_control_set_ptr, picture_control_set_ptr, sb_index);
+    } else if (picture_control_set_ptr->parent_pcs_ptr->pic_depth_mode == PIC_OPEN_LOOP_DEPTH_MODE) {
+        sb_depth_open_loop(context_ptr, sequence_control_set_ptr, picture_control_set_ptr, sb_index);
+    }
+}
+
 #if BEA
 #define MAX_DELTA_QINDEX 80
 #define DELTA_QINDEX_SEGMENTS 8
-EbErrorType qpm_derive_bea(ModeDecisionConfigurationContext *context_ptr, PictureControlSet *picture_control_set_ptr,
-                           SequenceControlSet *sequence_control_set_ptr) {
+EbErrorType qpm_derive_bea(ModeDecisionConfigurationContext *context_ptr, PictureControlSet *picture_control_set_ptr) {
     EbErrorType return_error = EB_ErrorNone;
     SbUnit     *sb_ptr;
     int64_t     non_moving_index_distance;
@@ -2765,23 +2670,8 @@ EbErrorType qpm_derive_bea(ModeDecisionConfigurationContext *context_ptr, Pictur
     //else
     //    non_moving_weight = 1;
 
-    uint32_t distanceRatio = (uint32_t)~0;
-
     for (int sb_index = 0; sb_index < picture_control_set_ptr->sb_total_count; ++sb_index) {
         sb_ptr = picture_control_set_ptr->sb_ptr_array[sb_index];
-        if (picture_control_set_ptr->parent_pcs_ptr->non_moving_index_min_distance != 0 &&
-            picture_control_set_ptr->parent_pcs_ptr->non_moving_index_max_distance != 0) {
-            distanceRatio = (picture_control_set_ptr->parent_pcs_ptr->non_moving_index_max_distance >
-                             picture_control_set_ptr->parent_pcs_ptr->non_moving_index_min_distance)
-                ? abs(picture_control_set_ptr->parent_pcs_ptr->non_moving_index_max_distance * 100 /
-                      picture_control_set_ptr->parent_pcs_ptr->non_moving_index_min_distance)
-                : abs(picture_control_set_ptr->parent_pcs_ptr->non_moving_index_min_distance * 100 /
-                      picture_control_set_ptr->parent_pcs_ptr->non_moving_index_max_distance);
-        }
-
-        //if (distanceRatio >= BEA_DISTANSE_RATIO_T0) {
-        //    non_moving_weight = 1;
-        //}
 
         non_moving_index_distance = (int32_t)picture_control_set_ptr->parent_pcs_ptr->non_moving_index_array[sb_index] -
             (int32_t)picture_control_set_ptr->parent_pcs_ptr->non_moving_average_score;
@@ -2818,6 +2708,69 @@ EbErrorType qpm_derive_bea(ModeDecisionConfigurationContext *context_ptr, Pictur
     }
     return return_error;
 }
+
+#define VARIANCE_AQ_SEGMENTS 5
+#define VARIANCE_AQ_ENERGY_MIN -4
+#define VARIANCE_AQ_ENERGY_MAX 1
+// Rate of each segment relative to the picture, from the flattest to the busiest SBs (libvpx variance AQ)
+static const double variance_aq_rate_ratio[VARIANCE_AQ_SEGMENTS] = {2.5, 2.0, 1.5, 1.0, 0.75};
+static const uint8_t variance_aq_energy_to_segment[VARIANCE_AQ_ENERGY_MAX - VARIANCE_AQ_ENERGY_MIN + 1] = {
+    0, 1, 1, 2, 3, 4};
+
+/******************************************************
+* sb_log_activity
+*   log of the mean 8x8 variance of the SB, scaled as the libvpx block energy
+******************************************************/
+static double sb_log_activity(PictureParentControlSet *picture_control_set_ptr, uint32_t sb_index) {
+    uint32_t variance_sum = 0;
+    for (uint32_t block_index = ME_TIER_ZERO_PU_8x8_0; block_index <= ME_TIER_ZERO_PU_8x8_63; ++block_index)
+        variance_sum += picture_control_set_ptr->variance[sb_index][block_index];
+    return log((256.0 * variance_sum) / 64 + 1.0);
+}
+
+/******************************************************
+* qpm_derive_variance_aq
+*   assigns the SBs to segments by their activity relative to the picture average, and derives the segments
+*   qindex deltas so that the picture keeps the rate of base_qindex
+******************************************************/
+void qpm_derive_variance_aq(ModeDecisionConfigurationContext *context_ptr, PictureControlSet *picture_control_set_ptr,
+                            SequenceControlSet *sequence_control_set_ptr) {
+    PictureParentControlSet *parent_pcs_ptr = picture_control_set_ptr->parent_pcs_ptr;
+    double                   energy_midpoint = 0;
+    double                   average_rate_ratio = 0;
+    int                      sb_index;
+
+    for (sb_index = 0; sb_index < picture_control_set_ptr->sb_total_count; ++sb_index)
+        energy_midpoint += sb_log_activity(parent_pcs_ptr, sb_index);
+    energy_midpoint /= picture_control_set_ptr->sb_total_count;
+
+    for (sb_index = 0; sb_index < picture_control_set_ptr->sb_total_count; ++sb_index) {
+        SbUnit *sb_ptr = picture_control_set_ptr->sb_ptr_array[sb_index];
+        int     energy = (int)round(sb_log_activity(parent_pcs_ptr, sb_index) - energy_midpoint);
+        energy         = CLIP3(VARIANCE_AQ_ENERGY_MIN, VARIANCE_AQ_ENERGY_MAX, energy);
+        sb_ptr->segment_id = variance_aq_energy_to_segment[energy - VARIANCE_AQ_ENERGY_MIN];
+        picture_control_set_ptr->segment_counts[sb_ptr->segment_id]++;
+        average_rate_ratio += variance_aq_rate_ratio[sb_ptr->segment_id];
+    }
+    average_rate_ratio /= picture_control_set_ptr->sb_total_count;
+
+    // Normalise the segments rate to the picture, the rate control bits model of base_qindex stays valid
+    RATE_CONTROL rc;
+    rc.worst_quality = MAXQ;
+    rc.best_quality  = MINQ;
+    for (int segment = 0; segment < VARIANCE_AQ_SEGMENTS; ++segment) {
+        if (picture_control_set_ptr->segment_counts[segment]) {
+            int qindex_delta = eb_vp9_compute_qdelta_by_rate(
+                &rc,
+                picture_control_set_ptr->slice_type == I_SLICE ? KEY_FRAME : INTER_FRAME,
+                picture_control_set_ptr->base_qindex,
+                variance_aq_rate_ratio[segment] / average_rate_ratio,
+                (vpx_bit_depth_t)sequence_control_set_ptr->static_config.encoder_bit_depth);
+            context_ptr->qindex_delta[segment] = CLIP3(
+                1 - picture_control_set_ptr->base_qindex, MAXQ - picture_control_set_ptr->base_qindex, qindex_delta);
+        }
+    }
+}
 #endif
 
 /******************************************************
@@ -2841,6 +2794,8 @@ void *eb_vp9_mode_decision_configuration_kernel(void *input_ptr) {
     for (;;) {
         // Get RateControl Results
         eb_vp9_get_full_object(context_ptr->rate_control_input_fifo_ptr, &rate_control_results_wrapper_ptr);
+        if (rate_control_results_wrapper_ptr == EB_NULL)
+            return EB_NULL;
 
         rate_control_results_ptr = (RateControlResults *)rate_control_results_wrapper_ptr->object_ptr;
         picture_control_set_ptr  = (PictureControlSet *)
@@ -2906,11 +2861,23 @@ void *eb_vp9_mode_decision_configuration_kernel(void *input_ptr) {
         eb_vp9_disable_segmentation(seg);
         eb_vp9_clearall_segfeatures(seg);
 
-        if (sequence_control_set_ptr->static_config.rate_control_mode == 2 &&
-            picture_control_set_ptr->temporal_layer_index < 1 &&
-            picture_control_set_ptr->parent_pcs_ptr->non_moving_average_score > 5) {
-            qpm_derive_bea(context_ptr, picture_control_set_ptr, sequence_control_set_ptr);
+        // The SB array is recycled with the picture, SBs default to segment 0
+        for (int sb_index = 0; sb_index < picture_control_set_ptr->sb_total_count; ++sb_index)
+            picture_control_set_ptr->sb_ptr_array[sb_index]->segment_id = 0;
 
+        EbBool aq_enabled = EB_FALSE;
+        if (sequence_control_set_ptr->static_config.aq_mode == AQ_MODE_VARIANCE &&
+            picture_control_set_ptr->base_qindex > 0) {
+            qpm_derive_variance_aq(context_ptr, picture_control_set_ptr, sequence_control_set_ptr);
+            aq_enabled = EB_TRUE;
+        } else if (sequence_control_set_ptr->static_config.aq_mode == AQ_MODE_MOTION &&
+                   picture_control_set_ptr->temporal_layer_index < 1 &&
+                   picture_control_set_ptr->parent_pcs_ptr->non_moving_average_score > 5) {
+            qpm_derive_bea(context_ptr, picture_control_set_ptr);
+            aq_enabled = EB_TRUE;
+        }
+
+        if (aq_enabled) {
             eb_vp9_enable_segmentation(seg);
             // Select delta coding method.
             seg->abs_delta = SEGMENT_DELTADATA;
@@ -2964,42 +2931,16 @@ void *eb_vp9_mode_decision_configuration_kernel(void *input_ptr) {
         // Detect complex/non-flat/moving LCU in a non-complex area (used to refine MDC depth control)
         complex_non_flat_moving_sb(sequence_control_set_ptr, picture_control_set_ptr, picture_width_in_sb);
 
-        if (picture_control_set_ptr->parent_pcs_ptr->pic_depth_mode == PIC_SB_SWITCH_DEPTH_MODE) {
+        if (picture_control_set_ptr->parent_pcs_ptr->pic_depth_mode == PIC_SB_SWITCH_DEPTH_MODE)
             eb_vp9_derive_sb_md_mode(sequence_control_set_ptr, picture_control_set_ptr, context_ptr);
 
-            for (int sb_index = 0; sb_index < picture_control_set_ptr->sb_total_count; ++sb_index) {
-                if (picture_control_set_ptr->parent_pcs_ptr->sb_depth_mode_array[sb_index] == SB_FULL85_DEPTH_MODE) {
-                    sb_depth_85_block(sequence_control_set_ptr, picture_control_set_ptr, sb_index);
-                } else if (picture_control_set_ptr->parent_pcs_ptr->sb_depth_mode_array[sb_index] ==
-                           SB_FULL84_DEPTH_MODE) {
-                    sb_depth_84_block(sequence_control_set_ptr, picture_control_set_ptr, sb_index);
-                } else if (picture_control_set_ptr->parent_pcs_ptr->sb_depth_mode_array[sb_index] ==
-                           SB_AVC_DEPTH_MODE) {
-                    sb_depth_8x8_16x16_block(sequence_control_set_ptr, picture_control_set_ptr, sb_index);
-                } else if (picture_control_set_ptr->parent_pcs_ptr->sb_depth_mode_array[sb_index] ==
-                           SB_LIGHT_AVC_DEPTH_MODE) {
-                    sb_depth_16x16_block(sequence_control_set_ptr, picture_control_set_ptr, sb_index);
-                } else if (picture_control_set_ptr->parent_pcs_ptr->sb_depth_mode_array[sb_index] ==
-                               SB_OPEN_LOOP_DEPTH_MODE ||
-                           picture_control_set_ptr->parent_pcs_ptr->sb_depth_mode_array[sb_index] ==
-                               SB_LIGHT_OPEN_LOOP_DEPTH_MODE ||
-                           picture_control_set_ptr->parent_pcs_ptr->sb_depth_mode_array[sb_index] ==
-                               SB_PRED_OPEN_LOOP_DEPTH_MODE ||
-                           picture_control_set_ptr->parent_pcs_ptr->sb_depth_mode_array[sb_index] ==
-                               SB_PRED_OPEN_LOOP_1_NFL_DEPTH_MODE) {
-                    sb_depth_open_loop(context_ptr, sequence_control_set_ptr, picture_control_set_ptr, sb_index);
-                }
-            }
-        } else if (picture_control_set_ptr->parent_pcs_ptr->pic_depth_mode == PIC_FULL85_DEPTH_MODE) {
-            picture_depth_85_block(sequence_control_set_ptr, picture_control_set_ptr);
-        } else if (picture_control_set_ptr->parent_pcs_ptr->pic_depth_mode == PIC_FULL84_DEPTH_MODE) {
-            picture_depth_84_block(sequence_control_set_ptr, picture_control_set_ptr);
-        } else if (picture_control_set_ptr->parent_pcs_ptr->pic_depth_mode == PIC_OPEN_LOOP_DEPTH_MODE) {
-            picture_depth_open_loop(context_ptr, sequence_control_set_ptr, picture_control_set_ptr);
-        }
-
+        // The SB partitioning (eb_vp9_mode_decision_configuration_sb()) is left to the EncDec process, each SB
+        // being configured by the EncDec thread that codes it, so the picture is posted as soon as the picture
+        // level decisions are made
         // Post the results to the MD processes
         eb_vp9_get_empty_object(context_ptr->mode_decision_configuration_output_fifo_ptr, &enc_dec_tasks_wrapper_ptr);
+        if (enc_dec_tasks_wrapper_ptr == EB_NULL)
+            return EB_NULL;
 
         enc_dec_tasks_ptr                                  = (EncDecTasks *)enc_dec_tasks_wrapper_ptr->object_ptr;
         enc_dec_tasks_ptr->picture_control_set_wrapper_ptr = rate_control_results_ptr->picture_control_set_wrapper_ptr;
@@ -130,6 +130,10 @@ extern EbErrorType eb_vp9_mode_decision_configuration_context_ctor(ModeDecisionC
                                                                    EbFifo  *mode_decision_configuration_output_fifo_ptr,
                                                                    uint16_t sb_total_count);
 
+extern void eb_vp9_mode_decision_configuration_sb(ModeDecisionConfigurationContext *context_ptr,
+                                                  SequenceControlSet               *sequence_control_set_ptr,
+                                                  PictureControlSet *picture_control_set_ptr, uint32_t sb_index);
+
 extern void *eb_vp9_mode_decision_configuration_kernel(void *input_ptr);
 
 #ifdef __cplusplus
@@ -48,6 +48,11 @@
 
 #define MAX_SAD_VALUE 64 * 64 * 255
 
+// Predictive search center
+#define PREDICTIVE_ME_MAX_CANDIDATES 6
+#define PREDICTIVE_ME_AGREEMENT_DISTANCE 2 // full-pel
+#define PREDICTIVE_ME_MIN_SEARCH_AREA 16
+
 uint32_t eb_vp9_tab32x32[16] = {0, 1, 4, 5, 2, 3, 6, 7, 8, 9, 12, 13, 10, 11, 14, 15};
 uint32_t eb_vp9_tab8x8[64]   = {0,  1,  4,  5,  16, 17, 20, 21, 2,  3,  6,  7,  18, 19, 22, 23, 8,  9,  12, 13, 24, 25,
                                 28, 29, 10, 11, 14, 15, 26, 27, 30, 31, 32, 33, 36, 37, 48, 49, 52, 53, 34, 35, 38, 39,
@@ -4447,8 +4452,8 @@ static void test_search_area_bounds(EbPictureBufferDesc *ref_pic_ptr, MeContext
     uint64_t mv_d_cost = (mv_d_sad << COST_PRECISION) + (MD_OFFSET >> MD_SHIFT);
 #endif
     if (list_index == 1) {
-        x_search_center = list_index ? 0 - (_MVXT(context_ptr->p_sb_best_mv[0][0][0]) >> 2) : 0;
-        y_search_center = list_index ? 0 - (_MVYT(context_ptr->p_sb_best_mv[0][0][0]) >> 2) : 0;
+        x_search_center = list_index ? 0 - (_MVXT(context_ptr->p_sb_best_mv[REFERENCE_PIC_LIST_0][0][0]) >> 2) : 0;
+        y_search_center = list_index ? 0 - (_MVYT(context_ptr->p_sb_best_mv[REFERENCE_PIC_LIST_0][0][0]) >> 2) : 0;
         ///////////////// correct
         // Correct the left edge of the Search Area if it is not on the reference Picture
         x_search_center = ((origin_x + x_search_center) < -pad_width) ? -pad_width - origin_x : x_search_center;
@@ -4502,8 +4507,8 @@ static void test_search_area_bounds(EbPictureBufferDesc *ref_pic_ptr, MeContext
         x_search_center = 0;
         y_search_center = 0 - (context_ptr->hme_level0_total_search_area_height * sparce_scale);
     } else if (best_cost == direct_mv_cost) {
-        x_search_center = list_index ? 0 - (_MVXT(context_ptr->p_sb_best_mv[0][0][0]) >> 2) : 0;
-        y_search_center = list_index ? 0 - (_MVYT(context_ptr->p_sb_best_mv[0][0][0]) >> 2) : 0;
+        x_search_center = list_index ? 0 - (_MVXT(context_ptr->p_sb_best_mv[REFERENCE_PIC_LIST_0][0][0]) >> 2) : 0;
+        y_search_center = list_index ? 0 - (_MVYT(context_ptr->p_sb_best_mv[REFERENCE_PIC_LIST_0][0][0]) >> 2) : 0;
     } else if (best_cost == mv_d_cost) {
         x_search_center = 0;
         y_search_center = (context_ptr->hme_level0_total_search_area_height * sparce_scale);
@@ -4517,6 +4522,126 @@ static void test_search_area_bounds(EbPictureBufferDesc *ref_pic_ptr, MeContext
     *ysc = y_search_center;
 }
 
+/*******************************************
+ * predictive_search_center
+ *   Selects the full-pel search center with the lowest
+ *   SAD among (0,0), the HME center, the 64x64 MVs of the
+ *   left, top and top-right SBs (when already estimated
+ *   in the current ME segment) and, for list 1, the list 0
+ *   MV scaled by the POC distances. Returns EB_TRUE when
+ *   at least two neighbor MVs agree with the selected
+ *   center, i.e. the local motion is well predicted.
+ *******************************************/
+static EB_BOOL predictive_search_center(PictureParentControlSet *picture_control_set_ptr, MeContext *context_ptr,
+                                        EbPictureBufferDesc *ref_pic_ptr, uint32_t sb_index, uint32_t list_index,
+                                        int16_t origin_x, int16_t origin_y, uint32_t sb_width, uint32_t sb_height,
+                                        int16_t *x_search_center, int16_t *y_search_center) {
+    SequenceControlSet *sequence_control_set_ptr =
+        (SequenceControlSet *)picture_control_set_ptr->sequence_control_set_wrapper_ptr->object_ptr;
+    uint32_t picture_width_in_sb = sequence_control_set_ptr->picture_width_in_sb;
+    uint32_t xsb_index           = sb_index % picture_width_in_sb;
+    uint32_t ysb_index           = sb_index / picture_width_in_sb;
+    uint32_t neighbor_sb_index[3];
+    uint32_t neighbor_count = 0;
+    int16_t  x_candidate[PREDICTIVE_ME_MAX_CANDIDATES];
+    int16_t  y_candidate[PREDICTIVE_ME_MAX_CANDIDATES];
+    uint32_t candidate_count = 0;
+    uint32_t candidate_index, i;
+    uint64_t best_cost       = ~0ull;
+    uint32_t subsample_sad   = 1;
+    int16_t  pad_width       = (int16_t)MAX_SB_SIZE - 1;
+    int16_t  pad_height      = (int16_t)MAX_SB_SIZE - 1;
+    uint32_t agreeing_count  = 0;
+
+    // (0,0) first, then HME: ties keep the default choice
+    x_candidate[candidate_count]   = 0;
+    y_candidate[candidate_count++] = 0;
+    x_candidate[candidate_count]   = *x_search_center;
+    y_candidate[candidate_count++] = *y_search_center;
+
+    // Spatial candidates, only SBs processed before the current one by this ME segment
+    if (xsb_index > context_ptr->sb_segment_x_start_index)
+        neighbor_sb_index[neighbor_count++] = sb_index - 1;
+    if (ysb_index > context_ptr->sb_segment_y_start_index) {
+        neighbor_sb_index[neighbor_count++] = sb_index - picture_width_in_sb;
+        if (xsb_index + 1 < context_ptr->sb_segment_x_end_index)
+            neighbor_sb_index[neighbor_count++] = sb_index - picture_width_in_sb + 1;
+    }
+    for (i = 0; i < neighbor_count; ++i) {
+        MeCuResults *neighbor_result = &picture_control_set_ptr->me_results[neighbor_sb_index[i]][0];
+        x_candidate[candidate_count] = (list_index ? neighbor_result->x_mv_l1 : neighbor_result->x_mv_l0) >> 2;
+        y_candidate[candidate_count++] = (list_index ? neighbor_result->y_mv_l1 : neighbor_result->y_mv_l0) >> 2;
+    }
+
+    // Temporal candidate: the list 0 MV of this SB scaled to the list 1 reference
+    if (list_index == 1) {
+        int64_t distance_l0 = (int64_t)picture_control_set_ptr->picture_number -
+            (int64_t)picture_control_set_ptr->ref_pic_poc_array[0];
+        int64_t distance_l1 = (int64_t)picture_control_set_ptr->picture_number -
+            (int64_t)picture_control_set_ptr->ref_pic_poc_array[1];
+        if (distance_l0 != 0) {
+            x_candidate[candidate_count] = (int16_t)(
+                (_MVXT(context_ptr->p_sb_best_mv[REFERENCE_PIC_LIST_0][0][0]) * distance_l1 / distance_l0) >> 2);
+            y_candidate[candidate_count++] = (int16_t)(
+                (_MVYT(context_ptr->p_sb_best_mv[REFERENCE_PIC_LIST_0][0][0]) * distance_l1 / distance_l0) >> 2);
+        }
+    }
+
+    for (candidate_index = 0; candidate_index < candidate_count; ++candidate_index) {
+        int16_t  x_center = x_candidate[candidate_index];
+        int16_t  y_center = y_candidate[candidate_index];
+        uint32_t search_region_index;
+        uint64_t candidate_cost;
+
+        // Correct the candidate if it is not on the reference Picture
+        x_center = ((origin_x + x_center) < -pad_width) ? -pad_width - origin_x : x_center;
+        x_center = ((origin_x + x_center) > (int16_t)ref_pic_ptr->width - 1)
+            ? x_center - ((origin_x + x_center) - ((int16_t)ref_pic_ptr->width - 1))
+            : x_center;
+        y_center = ((origin_y + y_center) < -pad_height) ? -pad_height - origin_y : y_center;
+        y_center = ((origin_y + y_center) > (int16_t)ref_pic_ptr->height - 1)
+            ? y_center - ((origin_y + y_center) - ((int16_t)ref_pic_ptr->height - 1))
+            : y_center;
+        x_candidate[candidate_index] = x_center;
+        y_candidate[candidate_index] = y_center;
+
+        // Skip the candidates already evaluated
+        for (i = 0; i < candidate_index; ++i) {
+            if (x_candidate[i] == x_center && y_candidate[i] == y_center)
+                break;
+        }
+        if (i < candidate_index)
+            continue;
+
+        search_region_index = (int16_t)(ref_pic_ptr->origin_x + origin_x) + x_center +
+            ((int16_t)(ref_pic_ptr->origin_y + origin_y) + y_center) * ref_pic_ptr->stride_y;
+
+        candidate_cost = n_x_m_sad_kernel_func_ptr_array[(eb_vp9_ASM_TYPES & AVX2_MASK) && 1][sb_width >> 3](
+                             context_ptr->sb_src_ptr,
+                             context_ptr->sb_src_stride << subsample_sad,
+                             &(ref_pic_ptr->buffer_y[search_region_index]),
+                             ref_pic_ptr->stride_y << subsample_sad,
+                             sb_height >> subsample_sad,
+                             sb_width)
+            << subsample_sad;
+
+        if (candidate_cost < best_cost) {
+            best_cost        = candidate_cost;
+            *x_search_center = x_center;
+            *y_search_center = y_center;
+        }
+    }
+
+    // Spatial candidates start right after (0,0) and HME
+    for (i = 2; i < 2 + neighbor_count; ++i) {
+        if (ABS(x_candidate[i] - *x_search_center) <= PREDICTIVE_ME_AGREEMENT_DISTANCE &&
+            ABS(y_candidate[i] - *y_search_center) <= PREDICTIVE_ME_AGREEMENT_DISTANCE)
+            agreeing_count++;
+    }
+
+    return (EB_BOOL)(neighbor_count >= 2 && agreeing_count == neighbor_count);
+}
+
 /*******************************************
  * motion_estimate_sb
  *   performs ME (SB)
@@ -5005,7 +5130,25 @@ EbErrorType motion_estimate_sb(
             search_area_width  = (int16_t)MIN(context_ptr->search_area_width, 127);
             search_area_height = (int16_t)MIN(context_ptr->search_area_height, 127);
 
-            if (x_search_center != 0 || y_search_center != 0) {
+            if (context_ptr->predictive_me &&
+                (picture_control_set_ptr->temporal_layer_index > 0 || list_index == 0)) {
+                // Well predicted motion only needs a refinement around the predicted center
+                if (predictive_search_center(picture_control_set_ptr,
+                                             context_ptr,
+                                             ref_pic_ptr,
+                                             lblock_index,
+                                             list_index,
+                                             origin_x,
+                                             origin_y,
+                                             sb_width,
+                                             sb_height,
+                                             &x_search_center,
+                                             &y_search_center)) {
+                    search_area_width  = MIN(search_area_width, MAX(search_area_width >> 1, PREDICTIVE_ME_MIN_SEARCH_AREA));
+                    search_area_height = MIN(search_area_height,
+                                             MAX(search_area_height >> 1, PREDICTIVE_ME_MIN_SEARCH_AREA));
+                }
+            } else if (x_search_center != 0 || y_search_center != 0) {
                 check_zero_zero_center(ref_pic_ptr,
                                        context_ptr,
                                        sb_origin_x,
@@ -5292,7 +5435,8 @@ EbErrorType motion_estimate_sb(
         }
     }
 
-    if (sequence_control_set_ptr->static_config.rate_control_mode) {
+    if (sequence_control_set_ptr->static_config.rate_control_mode == 1 ||
+        sequence_control_set_ptr->static_config.rate_control_mode == 2) {
         // Compute the sum of the distortion of all 16 16x16 (best) blocks in the LCU
         picture_control_set_ptr->rcme_distortion[lblock_index] = 0;
         for (i = 0; i < 16; i++) {
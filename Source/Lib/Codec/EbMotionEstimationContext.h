@@ -381,6 +381,13 @@ typedef struct MeContext { // MV offset (search center)
     uint8_t fractional_search_model;
     EB_BOOL fractional_search64x64;
     EB_BOOL single_hme_quadrant;
+    EB_BOOL predictive_me; // search center from neighbor / scaled MVs, smaller search area when they agree
+
+    // Bounds of the ME segment being processed, the SBs before the current one in
+    // the segment already hold their ME results
+    uint32_t sb_segment_x_start_index;
+    uint32_t sb_segment_x_end_index;
+    uint32_t sb_segment_y_start_index;
 
     // ME
     uint8_t search_area_width;
@@ -15,6 +15,8 @@
 #include "EbMotionEstimation.h"
 #include "EbDefinitions.h"
 #include "EbComputeSAD.h"
+#include "EbTemporalFiltering.h"
+#include "EbTime.h"
 
 #include "emmintrin.h"
 
@@ -54,7 +56,7 @@ EbErrorType check_zero_zero_center(PictureParentControlSet *picture_control_set_
  ************************************************/
 void *set_me_hme_params_sq(MeContext *me_context_ptr, PictureParentControlSet *picture_control_set_ptr,
                            SequenceControlSet *sequence_control_set_ptr, EB_INPUT_RESOLUTION input_resolution) {
-    uint8_t hme_me_level = picture_control_set_ptr->enc_mode;
+    uint8_t hme_me_level = picture_control_set_ptr->search_area_enc_mode;
 
     uint32_t input_ratio = sequence_control_set_ptr->luma_width / sequence_control_set_ptr->luma_height;
 
@@ -161,7 +163,7 @@ void *set_me_hme_params_sq(MeContext *me_context_ptr, PictureParentControlSet *p
  ************************************************/
 void *eb_vp9_set_me_hme_params_oq(MeContext *me_context_ptr, PictureParentControlSet *picture_control_set_ptr,
                                   SequenceControlSet *sequence_control_set_ptr, EB_INPUT_RESOLUTION input_resolution) {
-    uint8_t hme_me_level = picture_control_set_ptr->enc_mode;
+    uint8_t hme_me_level = picture_control_set_ptr->search_area_enc_mode;
 
     uint32_t input_ratio = sequence_control_set_ptr->luma_width / sequence_control_set_ptr->luma_height;
 
@@ -255,7 +257,7 @@ void *eb_vp9_set_me_hme_params_oq(MeContext *me_context_ptr, PictureParentContro
  ************************************************/
 void *set_me_hme_params_vmaf(MeContext *me_context_ptr, PictureParentControlSet *picture_control_set_ptr,
                              SequenceControlSet *sequence_control_set_ptr, EB_INPUT_RESOLUTION input_resolution) {
-    uint8_t hme_me_level = picture_control_set_ptr->enc_mode;
+    uint8_t hme_me_level = picture_control_set_ptr->search_area_enc_mode;
 
     uint32_t input_ratio = sequence_control_set_ptr->luma_width / sequence_control_set_ptr->luma_height;
 
@@ -533,6 +535,21 @@ EbErrorType compute_zz_sad(MotionEstimationContext *context_ptr, SequenceControl
     return return_error;
 }
 #endif
+/******************************************************
+* Derive ME Settings common to all tunes
+  Input   : encoder mode
+  Output  : ME Kernel signal(s)
+******************************************************/
+static void signal_derivation_me_kernel_common(PictureParentControlSet *picture_control_set_ptr,
+                                               MotionEstimationContext *context_ptr) {
+    // Set predictive ME search center
+    if (picture_control_set_ptr->enc_mode >= ENC_MODE_1) {
+        context_ptr->me_context_ptr->predictive_me = EB_TRUE;
+    } else {
+        context_ptr->me_context_ptr->predictive_me = EB_FALSE;
+    }
+}
+
 /******************************************************
 * Derive ME Settings for SQ
   Input   : encoder mode and tune
@@ -920,9 +937,18 @@ void *eb_vp9_motion_estimation_kernel(void *input_ptr) {
 
     uint32_t intra_sad_interval_index;
 
+    // Speed Control
+    uint64_t start_seconds;
+    uint64_t start_useconds;
+    uint64_t finish_seconds;
+    uint64_t finish_useconds;
+
     for (;;) {
         // Get Input Full Object
         eb_vp9_get_full_object(context_ptr->picture_decision_results_input_fifo_ptr, &input_results_wrapper_ptr);
+        if (input_results_wrapper_ptr == EB_NULL)
+            return EB_NULL;
+        svt_vp9_get_time(&start_seconds, &start_useconds);
 
         input_results_ptr       = (PictureDecisionResults *)input_results_wrapper_ptr->object_ptr;
         picture_control_set_ptr = (PictureParentControlSet *)
@@ -959,6 +985,11 @@ void *eb_vp9_motion_estimation_kernel(void *input_ptr) {
         } else {
             eb_vp9_signal_derivation_me_kernel_oq(sequence_control_set_ptr, picture_control_set_ptr, context_ptr);
         }
+        signal_derivation_me_kernel_common(picture_control_set_ptr, context_ptr);
+
+        context_ptr->me_context_ptr->sb_segment_x_start_index = x_sb_start_index;
+        context_ptr->me_context_ptr->sb_segment_x_end_index   = x_sb_end_index;
+        context_ptr->me_context_ptr->sb_segment_y_start_index = y_sb_start_index;
 
         // Motion Estimation
         if (picture_control_set_ptr->slice_type != I_SLICE) {
@@ -1040,6 +1071,10 @@ void *eb_vp9_motion_estimation_kernel(void *input_ptr) {
                                        sb_origin_y,
                                        context_ptr->me_context_ptr,
                                        input_picture_ptr);
+
+                    // Temporal filtering of the source SB, it is not read by the ME of the other SBs
+                    if (picture_control_set_ptr->temporal_filter_count)
+                        eb_vp9_temporal_filter_sb(picture_control_set_ptr, sb_index, sb_origin_x, sb_origin_y);
                 }
             }
         }
@@ -1101,7 +1136,8 @@ void *eb_vp9_motion_estimation_kernel(void *input_ptr) {
 
         // Calculate the ME Distortion and OIS Historgrams
         eb_vp9_block_on_mutex(picture_control_set_ptr->rc_distortion_histogram_mutex);
-        if (sequence_control_set_ptr->static_config.rate_control_mode) {
+        if (sequence_control_set_ptr->static_config.rate_control_mode == 1 ||
+            sequence_control_set_ptr->static_config.rate_control_mode == 2) {
             if (picture_control_set_ptr->slice_type != I_SLICE) {
                 uint16_t sad_interval_index;
                 for (ysb_index = y_sb_start_index; ysb_index < y_sb_end_index; ++ysb_index) {
@@ -1235,8 +1271,20 @@ void *eb_vp9_motion_estimation_kernel(void *input_ptr) {
             }
         }
         eb_vp9_release_mutex(picture_control_set_ptr->rc_distortion_histogram_mutex);
+
+        // Account the segment processing time to the ME stage load
+        if (sequence_control_set_ptr->static_config.speed_control_flag) {
+            svt_vp9_get_time(&finish_seconds, &finish_useconds);
+            eb_vp9_block_on_mutex(sequence_control_set_ptr->encode_context_ptr->sc_buffer_mutex);
+            sequence_control_set_ptr->encode_context_ptr->sc_me_busy_time += svt_vp9_compute_overall_elapsed_time_ms(
+                start_seconds, start_useconds, finish_seconds, finish_useconds);
+            eb_vp9_release_mutex(sequence_control_set_ptr->encode_context_ptr->sc_buffer_mutex);
+        }
+
         // Get Empty Results Object
         eb_vp9_get_empty_object(context_ptr->motion_estimation_results_output_fifo_ptr, &output_results_wrapper_ptr);
+        if (output_results_wrapper_ptr == EB_NULL)
+            return EB_NULL;
 
         output_results_ptr = (MotionEstimationResults *)output_results_wrapper_ptr->object_ptr;
         output_results_ptr->picture_control_set_wrapper_ptr = input_results_ptr->picture_control_set_wrapper_ptr;
@@ -26,6 +26,7 @@
 #include "EbEntropyCoding.h"
 #include "EbRateControlTasks.h"
 #include "EbTime.h"
+#include "EbSvtVp9ErrorCodes.h"
 #include "stdint.h"
 
 //struct vpx_write_bit_buffer *wb; // needs to be here
@@ -57,6 +58,121 @@ void ivf_write_frame_header(EbByte write_byte_ptr, uint32_t *write_location, siz
     *output_buffer_index += 12;
 }
 
+/**************************************
+* write_output_stream
+*   appends a packed frame to the output stream
+*   buffer, which grows when the frame does not
+*   fit; on allocation failure the frame is
+*   truncated. Returns the bytes the buffer grew
+*   by, the caller adds them to the pool size
+*   under the reorder queue lock
+**************************************/
+static uint64_t write_output_stream(EbBufferHeaderType *output_stream_ptr, EbByte read_byte_ptr, uint64_t size) {
+    uint64_t required_size = output_stream_ptr->n_filled_len + size;
+    uint64_t growth        = 0;
+
+    if (required_size > output_stream_ptr->n_alloc_len) {
+        uint64_t alloc_size = MAX(required_size, (uint64_t)output_stream_ptr->n_alloc_len * 3 / 2);
+        uint8_t *p_buffer   = (uint8_t *)realloc(output_stream_ptr->p_buffer, alloc_size);
+
+        if (p_buffer != (uint8_t *)EB_NULL) {
+            growth                         = alloc_size - output_stream_ptr->n_alloc_len;
+            output_stream_ptr->p_buffer    = p_buffer;
+            output_stream_ptr->n_alloc_len = (uint32_t)alloc_size;
+        } else {
+            SVT_LOG("SVT [ERROR]: cannot grow the output stream buffer to %llu bytes, the frame is truncated\n",
+                    (unsigned long long)alloc_size);
+            size = output_stream_ptr->n_alloc_len - output_stream_ptr->n_filled_len;
+        }
+    }
+
+    EB_MEMCPY(&output_stream_ptr->p_buffer[output_stream_ptr->n_filled_len], read_byte_ptr, size);
+    output_stream_ptr->n_filled_len += (uint32_t)size;
+
+    return growth;
+}
+
+/**************************************
+* eb_vp9_packetization_output_partial
+*   outputs the tile data entropy coded so far
+*   in a partial packet when the picture is the
+*   next one to be output in decode order
+*   (partial_packet_output). A carry can still
+*   reach the last byte that is not 0xff, so
+*   only the bytes before it are output
+**************************************/
+void eb_vp9_packetization_output_partial(PictureControlSet *picture_control_set_ptr) {
+    SequenceControlSet *sequence_control_set_ptr = (SequenceControlSet *)
+                                                       picture_control_set_ptr->sequence_control_set_wrapper_ptr->object_ptr;
+    EncodeContext      *encode_context_ptr = (EncodeContext *)sequence_control_set_ptr->encode_context_ptr;
+    const VpxWriter    *residual_bc        = &picture_control_set_ptr->entropy_coder_ptr->residual_bc;
+    uint32_t            final_size         = residual_bc->pos;
+    EbObjectWrapper    *output_stream_wrapper_ptr;
+    EbBufferHeaderType *output_stream_ptr;
+    PacketizationReorderEntry *queue_entry_ptr;
+
+    while (final_size > 0 && residual_bc->buffer[final_size - 1] == 0xff) final_size--;
+    if (final_size > 0)
+        final_size--;
+    if (final_size <= picture_control_set_ptr->entropy_coding_released_size)
+        return;
+
+    eb_vp9_block_on_mutex(encode_context_ptr->packetization_reorder_queue_mutex);
+
+    queue_entry_ptr =
+        encode_context_ptr->packetization_reorder_queue[encode_context_ptr->packetization_reorder_queue_head_index];
+
+    if (queue_entry_ptr->picture_number == picture_control_set_ptr->parent_pcs_ptr->decode_order) {
+        // Never wait for the application, the data is output with the final packet instead
+        eb_vp9_get_empty_object_non_blocking(encode_context_ptr->partial_stream_output_fifo_ptr,
+                                             &output_stream_wrapper_ptr);
+
+        if (output_stream_wrapper_ptr != EB_NULL) {
+            uint64_t finish_time_seconds  = 0;
+            uint64_t finish_timeu_seconds = 0;
+
+            output_stream_ptr               = (EbBufferHeaderType *)output_stream_wrapper_ptr->object_ptr;
+            output_stream_ptr->flags        = EB_BUFFERFLAG_PARTIAL;
+            output_stream_ptr->n_filled_len = 0;
+            output_stream_ptr->n_offset     = picture_control_set_ptr->entropy_coding_released_size;
+            output_stream_ptr->pts          = picture_control_set_ptr->parent_pcs_ptr->eb_input_ptr->pts;
+            output_stream_ptr->dts          = picture_control_set_ptr->parent_pcs_ptr->decode_order -
+                (uint64_t)(1 << sequence_control_set_ptr->hierarchical_levels) + 1;
+            output_stream_ptr->pic_type = picture_control_set_ptr->parent_pcs_ptr->is_used_as_reference_flag
+                ? picture_control_set_ptr->parent_pcs_ptr->idr_flag ? EB_IDR_PICTURE
+                                                                    : picture_control_set_ptr->slice_type
+                : EB_NON_REF_PICTURE;
+            output_stream_ptr->p_app_private = picture_control_set_ptr->parent_pcs_ptr->eb_input_ptr->p_app_private;
+            EB_MEMCPY(output_stream_ptr->user_metadata,
+                      picture_control_set_ptr->parent_pcs_ptr->eb_input_ptr->user_metadata,
+                      sizeof(output_stream_ptr->user_metadata));
+            output_stream_ptr->luma_sse  = 0;
+            output_stream_ptr->cb_sse    = 0;
+            output_stream_ptr->cr_sse    = 0;
+            output_stream_ptr->luma_ssim = 0;
+            output_stream_ptr->cb_ssim   = 0;
+            output_stream_ptr->cr_ssim   = 0;
+
+            svt_vp9_get_time(&finish_time_seconds, &finish_timeu_seconds);
+            output_stream_ptr->n_tick_count = (uint32_t)svt_vp9_compute_overall_elapsed_time_ms(
+                picture_control_set_ptr->parent_pcs_ptr->start_time_seconds,
+                picture_control_set_ptr->parent_pcs_ptr->start_timeu_seconds,
+                finish_time_seconds,
+                finish_timeu_seconds);
+
+            encode_context_ptr->output_stream_buffer_pool_size += write_output_stream(
+                output_stream_ptr,
+                residual_bc->buffer + picture_control_set_ptr->entropy_coding_released_size,
+                final_size - picture_control_set_ptr->entropy_coding_released_size);
+            picture_control_set_ptr->entropy_coding_released_size += output_stream_ptr->n_filled_len;
+
+            eb_vp9_post_full_object(output_stream_wrapper_ptr);
+        }
+    }
+
+    eb_vp9_release_mutex(encode_context_ptr->packetization_reorder_queue_mutex);
+}
+
 #if VP9_RC
 void eb_vp9_update_rc_rate_tables(PictureControlSet  *picture_control_set_ptr,
                                   SequenceControlSet *sequence_control_set_ptr) {
@@ -72,7 +188,8 @@ void eb_vp9_update_rc_rate_tables(PictureControlSet  *picture_control_set_ptr,
     int32_t  qp_index;
 
     // LCU Loop
-    if (sequence_control_set_ptr->static_config.rate_control_mode > 0) {
+    if (sequence_control_set_ptr->static_config.rate_control_mode == 1 ||
+        sequence_control_set_ptr->static_config.rate_control_mode == 2) {
         uint64_t sadBits[NUMBER_OF_SAD_INTERVALS] = {0};
         uint32_t count[NUMBER_OF_SAD_INTERVALS]   = {0};
 
@@ -326,6 +443,8 @@ void *eb_vp9_packetization_kernel(void *input_ptr) {
     for (;;) {
         // Get EntropyCoding Results
         eb_vp9_get_full_object(context_ptr->entropy_coding_input_fifo_ptr, &entropy_coding_results_wrapper_ptr);
+        if (entropy_coding_results_wrapper_ptr == EB_NULL)
+            return EB_NULL;
         entropy_coding_results_ptr = (EntropyCodingResults *)entropy_coding_results_wrapper_ptr->object_ptr;
         picture_control_set_ptr    = (PictureControlSet *)
                                       entropy_coding_results_ptr->picture_control_set_wrapper_ptr->object_ptr;
@@ -356,6 +475,7 @@ void *eb_vp9_packetization_kernel(void *input_ptr) {
             ? EB_BUFFERFLAG_EOS
             : 0;
         output_stream_ptr->n_filled_len = 0;
+        output_stream_ptr->n_offset     = 0;
         output_stream_ptr->pts          = picture_control_set_ptr->parent_pcs_ptr->eb_input_ptr->pts;
         output_stream_ptr->dts          = picture_control_set_ptr->parent_pcs_ptr->decode_order -
             (uint64_t)(1 << sequence_control_set_ptr->hierarchical_levels) + 1;
@@ -363,9 +483,20 @@ void *eb_vp9_packetization_kernel(void *input_ptr) {
                  ? picture_control_set_ptr->parent_pcs_ptr->idr_flag ? EB_IDR_PICTURE : picture_control_set_ptr->slice_type
                  : EB_NON_REF_PICTURE;
         output_stream_ptr->p_app_private = picture_control_set_ptr->parent_pcs_ptr->eb_input_ptr->p_app_private;
+        EB_MEMCPY(output_stream_ptr->user_metadata,
+                  picture_control_set_ptr->parent_pcs_ptr->eb_input_ptr->user_metadata,
+                  sizeof(output_stream_ptr->user_metadata));
+        output_stream_ptr->luma_sse      = picture_control_set_ptr->parent_pcs_ptr->luma_sse;
+        output_stream_ptr->cb_sse        = picture_control_set_ptr->parent_pcs_ptr->cb_sse;
+        output_stream_ptr->cr_sse        = picture_control_set_ptr->parent_pcs_ptr->cr_sse;
+        output_stream_ptr->luma_ssim     = picture_control_set_ptr->parent_pcs_ptr->luma_ssim;
+        output_stream_ptr->cb_ssim       = picture_control_set_ptr->parent_pcs_ptr->cb_ssim;
+        output_stream_ptr->cr_ssim       = picture_control_set_ptr->parent_pcs_ptr->cr_ssim;
 
         // Get Empty Rate Control Input Tasks
         eb_vp9_get_empty_object(context_ptr->rate_control_tasks_output_fifo_ptr, &rate_control_tasks_wrapper_ptr);
+        if (rate_control_tasks_wrapper_ptr == EB_NULL)
+            return EB_NULL;
         rate_control_tasks_ptr = (RateControlTasks *)rate_control_tasks_wrapper_ptr->object_ptr;
         rate_control_tasks_ptr->picture_control_set_wrapper_ptr =
             picture_control_set_ptr->picture_parent_control_set_wrapper_ptr;
@@ -374,28 +505,30 @@ void *eb_vp9_packetization_kernel(void *input_ptr) {
         OutputBitstreamUnit *output_bitstream_ptr = (OutputBitstreamUnit *)
                                                         picture_control_set_ptr->bitstream_ptr->output_bitstream_ptr;
         uint64_t size;
+        uint64_t output_stream_growth;
 
         size = 0;
         eb_vp9_reset_bitstream(picture_control_set_ptr->bitstream_ptr->output_bitstream_ptr);
 
-        eb_vp9_pack_bitstream(picture_control_set_ptr,
-                              picture_control_set_ptr->parent_pcs_ptr->cpi,
-                              output_bitstream_ptr->buffer,
-                              &size,
-                              0,
-                              0);
+        // The buffer holds the headers and the tile data not output yet. The frame goes on truncated once the error
+        // is reported
+        eb_vp9_output_bitstream_unit_grow(output_bitstream_ptr,
+                                          picture_control_set_ptr->entropy_coder_ptr->residual_bc.pos -
+                                              picture_control_set_ptr->entropy_coding_released_size +
+                                              PACKETIZATION_PROCESS_HEADER_SIZE);
+        if (eb_vp9_pack_bitstream(picture_control_set_ptr,
+                                  picture_control_set_ptr->parent_pcs_ptr->cpi,
+                                  output_bitstream_ptr->buffer,
+                                  &size,
+                                  0,
+                                  0) != EB_ErrorNone) {
+            encode_context_ptr->app_callback_ptr->error_handler(encode_context_ptr->app_callback_ptr->handle,
+                                                                EB_ENC_PK_ERROR0);
+        }
 
         // Stream construction
         output_bitstream_ptr->written_bits_count = (uint32_t)size;
         output_bitstream_ptr->buffer             = output_bitstream_ptr->buffer_begin + size;
-        uint32_t  write_location                 = 0;
-        uint32_t  read_location                  = 0;
-        EbByte    read_byte_ptr;
-        EbByte    write_byte_ptr;
-        uint32_t *output_buffer_index = (uint32_t *)&(output_stream_ptr->n_filled_len);
-        uint32_t *output_buffer_size  = (uint32_t *)&(output_stream_ptr->n_alloc_len);
-        read_byte_ptr                 = (EbByte)output_bitstream_ptr->buffer_begin;
-        write_byte_ptr                = &output_stream_ptr->p_buffer[*output_buffer_index];
 
         // IVF data: 12-byte header
         // bytes 0 -  3 :   size of frame in bytes(not including the 12 - byte header)
@@ -403,14 +536,13 @@ void *eb_vp9_packetization_kernel(void *input_ptr) {
         //ivf_write_frame_header(write_byte_ptr, &write_location, size, picture_control_set_ptr->picture_number, output_buffer_index);
 
         // Frame Data: 12+-byte
-        // AMIR to replace by memcopy
-        while (read_location < size) {
-            if ((*output_buffer_index) < (*output_buffer_size)) {
-                write_byte_ptr[write_location++] = read_byte_ptr[read_location];
-                *output_buffer_index += 1;
-            }
-            read_location++;
-        }
+        output_stream_growth = write_output_stream(output_stream_ptr, output_bitstream_ptr->buffer_begin, size);
+
+        // The tile data output in partial packets is inserted after the frame headers
+        if (picture_control_set_ptr->entropy_coding_released_size)
+            output_stream_ptr->n_offset = output_stream_ptr->n_filled_len -
+                (picture_control_set_ptr->entropy_coder_ptr->residual_bc.pos -
+                 picture_control_set_ptr->entropy_coding_released_size);
 
         if (picture_control_set_ptr->parent_pcs_ptr->cpi->common.show_existing_frame) {
             output_stream_ptr->flags |= EB_BUFFERFLAG_SHOW_EXT;
@@ -418,6 +550,7 @@ void *eb_vp9_packetization_kernel(void *input_ptr) {
                 size = 0;
                 eb_vp9_reset_bitstream(picture_control_set_ptr->bitstream_ptr->output_bitstream_ptr);
 
+                // A show existing frame is its uncompressed header only
                 eb_vp9_pack_bitstream(picture_control_set_ptr,
                                       picture_control_set_ptr->parent_pcs_ptr->cpi,
                                       output_bitstream_ptr->buffer,
@@ -428,32 +561,21 @@ void *eb_vp9_packetization_kernel(void *input_ptr) {
                 // Stream construction
                 output_bitstream_ptr->written_bits_count = (uint32_t)size;
                 output_bitstream_ptr->buffer             = output_bitstream_ptr->buffer_begin + size;
-                uint32_t  write_location                 = 0;
-                uint32_t  read_location                  = 0;
-                EbByte    read_byte_ptr;
-                EbByte    write_byte_ptr;
-                uint32_t *output_buffer_index = (uint32_t *)&(output_stream_ptr->n_filled_len);
-                uint32_t *output_buffer_size  = (uint32_t *)&(output_stream_ptr->n_alloc_len);
-                read_byte_ptr                 = (EbByte)output_bitstream_ptr->buffer_begin;
-                write_byte_ptr                = &output_stream_ptr->p_buffer[*output_buffer_index];
 
                 // Frame Data: 12+-byte
-#if COPY_STREAM
-                EB_MEMCPY(write_byte_ptr + write_location, read_byte_ptr, size);
-#else
-                while (read_location < size) {
-                    if ((*output_buffer_index) < (*output_buffer_size)) {
-                        write_byte_ptr[write_location++] = read_byte_ptr[read_location];
-                        *output_buffer_index += 1;
-                    }
-                    read_location++;
-                }
-#endif
+                output_stream_growth += write_output_stream(
+                    output_stream_ptr, output_bitstream_ptr->buffer_begin, size);
             }
         }
 
+        // The partial packets grow the buffers of the other pictures from the EntropyCoding threads
+        eb_vp9_block_on_mutex(encode_context_ptr->packetization_reorder_queue_mutex);
+        encode_context_ptr->output_stream_buffer_pool_size += output_stream_growth;
+        eb_vp9_release_mutex(encode_context_ptr->packetization_reorder_queue_mutex);
+
         // Send the number of bytes per frame to RC
-        picture_control_set_ptr->parent_pcs_ptr->total_num_bits = output_stream_ptr->n_filled_len << 3;
+        picture_control_set_ptr->parent_pcs_ptr->total_num_bits =
+            (uint64_t)(output_stream_ptr->n_filled_len + picture_control_set_ptr->entropy_coding_released_size) << 3;
         queue_entry_ptr->actual_bits    = picture_control_set_ptr->parent_pcs_ptr->total_num_bits;
         queue_entry_ptr->total_num_bits = picture_control_set_ptr->parent_pcs_ptr->total_num_bits;
 
@@ -697,13 +819,22 @@ void *eb_vp9_packetization_kernel(void *input_ptr) {
 
                 buffer_fill_temp -= queue_entry_ptr->actual_bits;
                 buffer_fill_temp                = MAX(buffer_fill_temp, 0);
-                buffer_fill_temp                = (int64_t)(buffer_fill_temp +
-                                             (encode_context_ptr->vbv_max_rate *
-                                              (1.0 / (sequence_control_set_ptr->frame_rate >> RC_PRECISION))));
+                // The frame rate is either in fps or in Q16
+                const double fps = (sequence_control_set_ptr->frame_rate > 1000)
+                    ? (double)sequence_control_set_ptr->frame_rate / (1 << RC_PRECISION)
+                    : (double)sequence_control_set_ptr->frame_rate;
+                buffer_fill_temp                = (int64_t)(buffer_fill_temp + (encode_context_ptr->vbv_max_rate / fps));
                 buffer_fill_temp                = MIN(buffer_fill_temp, encode_context_ptr->vbv_buf_size);
                 encode_context_ptr->buffer_fill = buffer_fill_temp;
                 //printf("totalNumBits = %lld \t bufferFill = %lld \t pictureNumber = %lld \n", queue_entry_ptr->actual_bits, encode_context_ptr->bufferFill, picture_control_set_ptr->picture_number);
             }
+            // The partial packets of the next picture can only be output after this one
+            eb_vp9_block_on_mutex(encode_context_ptr->packetization_reorder_queue_mutex);
+
+            if ((output_stream_ptr->flags & EB_BUFFERFLAG_EOS) && sequence_control_set_ptr->static_config.stat_report)
+                SVT_LOG("SVT [INFO]: output stream buffers peak at %llu KB\n",
+                        (unsigned long long)(encode_context_ptr->output_stream_buffer_pool_size >> 10));
+
             // Release the Bitstream wrapper object
             eb_vp9_post_full_object(output_stream_wrapper_ptr);
             // Reset the Reorder Queue Entry
@@ -717,6 +848,8 @@ void *eb_vp9_packetization_kernel(void *input_ptr) {
                 ? 0
                 : encode_context_ptr->packetization_reorder_queue_head_index + 1;
 
+            eb_vp9_release_mutex(encode_context_ptr->packetization_reorder_queue_mutex);
+
             queue_entry_ptr =
                 encode_context_ptr
                     ->packetization_reorder_queue[encode_context_ptr->packetization_reorder_queue_head_index];
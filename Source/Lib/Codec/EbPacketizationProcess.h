@@ -8,6 +8,7 @@
 
 #include "EbDefinitions.h"
 #include "EbSystemResourceManager.h"
+#include "EbPictureControlSet.h"
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -31,6 +32,8 @@ extern EbErrorType eb_vp9_packetization_context_ctor(PacketizationContext **cont
                                                      EbFifo                *entropy_coding_input_fifo_ptr,
                                                      EbFifo                *rate_control_tasks_output_fifo_ptr);
 
+extern void eb_vp9_packetization_output_partial(PictureControlSet *picture_control_set_ptr);
+
 extern void *eb_vp9_packetization_kernel(void *input_ptr);
 
 #ifdef __cplusplus
@@ -20,6 +20,7 @@
 #include "EbReferenceObject.h"
 
 #include "EbComputeMean.h"
+#include "EbComputeHistogram.h"
 #include "EbMeSadCalculation.h"
 #include "EbComputeMean_SSE2.h"
 #include "EbCombinedAveragingSAD_Intrinsic_AVX2.h"
@@ -121,34 +122,6 @@ void eb_vp9_decimation_2d(uint8_t *input_samples, // input parameter, input samp
     return;
 }
 
-/********************************************
-* calculate_histogram
-*      creates n-bins histogram for the input
-********************************************/
-static void calculate_histogram(uint8_t  *input_samples, // input parameter, input samples Ptr
-                                uint32_t  input_area_width, // input parameter, input area width
-                                uint32_t  input_area_height, // input parameter, input area height
-                                uint32_t  stride, // input parameter, input stride
-                                uint8_t   decim_step, // input parameter, area height
-                                uint32_t *histogram, // output parameter, output histogram
-                                uint64_t *sum)
-
-{
-    uint32_t horizontal_index;
-    uint32_t vertical_index;
-    *sum = 0;
-
-    for (vertical_index = 0; vertical_index < input_area_height; vertical_index += decim_step) {
-        for (horizontal_index = 0; horizontal_index < input_area_width; horizontal_index += decim_step) {
-            ++(histogram[input_samples[horizontal_index]]);
-            *sum += input_samples[horizontal_index];
-        }
-        input_samples += (stride << (decim_step >> 1));
-    }
-
-    return;
-}
-
 static uint64_t compute_variance32x32(
     EbPictureBufferDesc *input_padded_picture_ptr, // input parameter, Input Padded Picture
     uint32_t  input_luma_origin_index, // input parameter, LCU index, used to point to source/reference samples
@@ -4096,9 +4069,11 @@ static EbErrorType quarter_sample_denoise(PictureAnalysisContext  *context_ptr,
         // Turn OFF the de-noiser for Class 2 at QP=29 and lower (for Fixed_QP) and at the target rate of 14Mbps and higher (for RC=ON)
         if ((picture_control_set_ptr->pic_noise_class == PIC_NOISE_CLASS_3_1) ||
             ((picture_control_set_ptr->pic_noise_class == PIC_NOISE_CLASS_2) &&
-             ((sequence_control_set_ptr->static_config.rate_control_mode == 0 &&
+             (((sequence_control_set_ptr->static_config.rate_control_mode == 0 ||
+                sequence_control_set_ptr->static_config.rate_control_mode == 3) &&
                sequence_control_set_ptr->qp > DENOISER_QP_TH) ||
-              (sequence_control_set_ptr->static_config.rate_control_mode != 0 &&
+              ((sequence_control_set_ptr->static_config.rate_control_mode == 1 ||
+                sequence_control_set_ptr->static_config.rate_control_mode == 2) &&
                sequence_control_set_ptr->static_config.target_bit_rate < DENOISER_BITRATE_TH)))) {
             sub_sample_filter_noise(sequence_control_set_ptr,
                                     picture_control_set_ptr,
@@ -4153,9 +4128,11 @@ EbErrorType half_sample_denoise(PictureAnalysisContext *context_ptr, SequenceCon
         // Turn OFF the de-noiser for Class 2 at QP=29 and lower (for Fixed_QP) and at the target rate of 14Mbps and higher (for RC=ON)
         if ((picture_control_set_ptr->pic_noise_class == PIC_NOISE_CLASS_3_1) ||
             ((picture_control_set_ptr->pic_noise_class == PIC_NOISE_CLASS_2) &&
-             ((sequence_control_set_ptr->static_config.rate_control_mode == 0 &&
+             (((sequence_control_set_ptr->static_config.rate_control_mode == 0 ||
+                sequence_control_set_ptr->static_config.rate_control_mode == 3) &&
                sequence_control_set_ptr->qp > DENOISER_QP_TH) ||
-              (sequence_control_set_ptr->static_config.rate_control_mode != 0 &&
+              ((sequence_control_set_ptr->static_config.rate_control_mode == 1 ||
+                sequence_control_set_ptr->static_config.rate_control_mode == 2) &&
                sequence_control_set_ptr->static_config.target_bit_rate < DENOISER_BITRATE_TH)))) {
             sub_sample_filter_noise(sequence_control_set_ptr,
                                     picture_control_set_ptr,
@@ -4278,7 +4255,7 @@ static void sub_sample_luma_generate_pixel_intensity_histogram_bins(
                 : 0;
 
             // Y Histogram
-            calculate_histogram(
+            calculate_histogram_func_ptr_array[(eb_vp9_ASM_TYPES & AVX2_MASK) && 1][0](
                 &input_picture_ptr
                      ->buffer_y[(input_picture_ptr->origin_x + region_in_picture_width_index * region_width) +
                                 ((input_picture_ptr->origin_y + region_in_picture_height_index * region_height) *
@@ -4364,7 +4341,7 @@ static void sub_sample_chroma_generate_pixel_intensity_histogram_bins(
                 : 0;
 
             // U Histogram
-            calculate_histogram(
+            calculate_histogram_func_ptr_array[(eb_vp9_ASM_TYPES & AVX2_MASK) && 1][1](
                 &input_picture_ptr
                      ->buffer_cb[((input_picture_ptr->origin_x + region_in_picture_width_index * region_width) >> 1) +
                                  (((input_picture_ptr->origin_y + region_in_picture_height_index * region_height) >>
@@ -4396,7 +4373,7 @@ static void sub_sample_chroma_generate_pixel_intensity_histogram_bins(
             }
 
             // V Histogram
-            calculate_histogram(
+            calculate_histogram_func_ptr_array[(eb_vp9_ASM_TYPES & AVX2_MASK) && 1][1](
                 &input_picture_ptr
                      ->buffer_cr[((input_picture_ptr->origin_x + region_in_picture_width_index * region_width) >> 1) +
                                  (((input_picture_ptr->origin_y + region_in_picture_height_index * region_height) >>
@@ -4885,6 +4862,62 @@ static void calculate_input_average_intensity(SequenceControlSet      *sequence_
     return;
 }
 
+/************************************************
+ * Histogram differences per region
+ ** Accumulates the absolute differences between the
+ ** histograms of the current and the previous input
+ ** pictures, the SCD @ PictureDecisionProcess() then
+ ** only has to update its running averages
+ ************************************************/
+static void compute_histogram_differences(SequenceControlSet      *sequence_control_set_ptr,
+                                          PictureParentControlSet *picture_control_set_ptr) {
+    PictureParentControlSet *previous_picture_control_set_ptr =
+        (PictureParentControlSet *)picture_control_set_ptr->previous_picture_control_set_wrapper_ptr->object_ptr;
+    uint32_t region_in_picture_width_index;
+    uint32_t region_in_picture_height_index;
+    uint32_t video_component;
+    uint32_t bin;
+
+    if (previous_picture_control_set_ptr == picture_control_set_ptr) {
+        EB_MEMSET(picture_control_set_ptr->ahd_per_region, 0, sizeof(picture_control_set_ptr->ahd_per_region));
+        return;
+    }
+
+    // The previous picture may still be under analysis in another thread. It is ahead of this one in the
+    // picture analysis input FIFO, and posts before it waits on its own previous picture, so this cannot deadlock
+    eb_vp9_block_on_semaphore(previous_picture_control_set_ptr->picture_histogram_done_semaphore);
+
+    // Loop over regions inside the picture
+    for (region_in_picture_width_index = 0;
+         region_in_picture_width_index < sequence_control_set_ptr->picture_analysis_number_of_regions_per_width;
+         region_in_picture_width_index++) { // loop over horizontal regions
+        for (region_in_picture_height_index = 0;
+             region_in_picture_height_index < sequence_control_set_ptr->picture_analysis_number_of_regions_per_height;
+             region_in_picture_height_index++) { // loop over vertical regions
+            for (video_component = 0; video_component < 3; ++video_component) {
+                const uint32_t *current_histogram =
+                    picture_control_set_ptr
+                        ->picture_histogram[region_in_picture_width_index][region_in_picture_height_index]
+                                           [video_component];
+                const uint32_t *previous_histogram =
+                    previous_picture_control_set_ptr
+                        ->picture_histogram[region_in_picture_width_index][region_in_picture_height_index]
+                                           [video_component];
+                uint32_t ahd = 0;
+
+                for (bin = 0; bin < HISTOGRAM_NUMBER_OF_BINS; ++bin) {
+                    ahd += ABS((int32_t)current_histogram[bin] - (int32_t)previous_histogram[bin]);
+                }
+                picture_control_set_ptr
+                    ->ahd_per_region[region_in_picture_width_index][region_in_picture_height_index][video_component] =
+                    ahd;
+            }
+        }
+    }
+
+    return;
+}
+
 /************************************************
  * Gathering statistics per picture
  ** Calculating the pixel intensity histogram bins per picture needed for SCD
@@ -4900,7 +4933,7 @@ static void gathering_picture_statistics(SequenceControlSet      *sequence_contr
     uint64_t sum_average_intensity_total_regions_cb   = 0;
     uint64_t sum_average_intensity_total_regions_cr   = 0;
 
-    // Histogram bins
+    // Histogram bins, also used for the average intensities and the dark area density
     // Use 1/16 Luma for Histogram generation
     // 1/16 input ready
     sub_sample_luma_generate_pixel_intensity_histogram_bins(sequence_control_set_ptr,
@@ -4916,6 +4949,10 @@ static void gathering_picture_statistics(SequenceControlSet      *sequence_contr
                                                               &sum_average_intensity_total_regions_cb,
                                                               &sum_average_intensity_total_regions_cr);
 
+    // Release the next picture, whose SCD compares its histograms to these ones
+    if (sequence_control_set_ptr->scd_mode != SCD_MODE_0)
+        eb_vp9_post_semaphore(picture_control_set_ptr->picture_histogram_done_semaphore);
+
     // Calculate the LUMA average intensity
     calculate_input_average_intensity(sequence_control_set_ptr,
                                       picture_control_set_ptr,
@@ -4931,6 +4968,11 @@ static void gathering_picture_statistics(SequenceControlSet      *sequence_contr
                                        input_padded_picture_ptr,
                                        sb_total_count);
 
+    // Done last, as it may have to wait for the previous picture
+    if (sequence_control_set_ptr->scd_mode != SCD_MODE_0) {
+        compute_histogram_differences(sequence_control_set_ptr, picture_control_set_ptr);
+    }
+
     return;
 }
 /************************************************
@@ -5019,6 +5061,38 @@ static void pad_picture_to_multiple_of_sb_dimensions(EbPictureBufferDesc *input_
     return;
 }
 
+/************************************************
+ * Save the source picture
+ ** Kept for the quality statistics, the input picture is
+ ** then modified in place by the denoising and the temporal filtering
+ ************************************************/
+static void save_source_picture(EbPictureBufferDesc *input_picture_ptr, EbPictureBufferDesc *save_source_picture_ptr) {
+    const uint32_t input_luma_offset = input_picture_ptr->origin_x +
+        input_picture_ptr->origin_y * input_picture_ptr->stride_y;
+    const uint32_t input_cb_offset = (input_picture_ptr->origin_x >> 1) +
+        (input_picture_ptr->origin_y >> 1) * input_picture_ptr->stride_cb;
+    const uint32_t input_cr_offset = (input_picture_ptr->origin_x >> 1) +
+        (input_picture_ptr->origin_y >> 1) * input_picture_ptr->stride_cr;
+    uint32_t vertical_idx;
+
+    for (vertical_idx = 0; vertical_idx < input_picture_ptr->height; ++vertical_idx) {
+        EB_MEMCPY(save_source_picture_ptr->buffer_y + vertical_idx * save_source_picture_ptr->stride_y,
+                  input_picture_ptr->buffer_y + input_luma_offset + vertical_idx * input_picture_ptr->stride_y,
+                  input_picture_ptr->width);
+    }
+
+    for (vertical_idx = 0; vertical_idx < (uint32_t)(input_picture_ptr->height >> 1); ++vertical_idx) {
+        EB_MEMCPY(save_source_picture_ptr->buffer_cb + vertical_idx * save_source_picture_ptr->stride_cb,
+                  input_picture_ptr->buffer_cb + input_cb_offset + vertical_idx * input_picture_ptr->stride_cb,
+                  input_picture_ptr->width >> 1);
+        EB_MEMCPY(save_source_picture_ptr->buffer_cr + vertical_idx * save_source_picture_ptr->stride_cr,
+                  input_picture_ptr->buffer_cr + input_cr_offset + vertical_idx * input_picture_ptr->stride_cr,
+                  input_picture_ptr->width >> 1);
+    }
+
+    return;
+}
+
 /************************************************
 * 1/4 & 1/16 input picture decimation
 ************************************************/
@@ -5116,6 +5190,8 @@ void *eb_vp9_picture_analysis_kernel(void *input_ptr) {
     for (;;) {
         // Get Input Full Object
         eb_vp9_get_full_object(context_ptr->resource_coordination_results_input_fifo_ptr, &input_results_wrapper_ptr);
+        if (input_results_wrapper_ptr == EB_NULL)
+            return EB_NULL;
 
         input_results_ptr       = (ResourceCoordinationResults *)input_results_wrapper_ptr->object_ptr;
         picture_control_set_ptr = (PictureParentControlSet *)
@@ -5141,6 +5217,10 @@ void *eb_vp9_picture_analysis_kernel(void *input_ptr) {
         // Pad pictures to multiple min cu size
         pad_picture_to_multiple_of_min_cu_size_dimensions(sequence_control_set_ptr, input_picture_ptr);
 
+        // Save the source for the quality statistics
+        if (picture_control_set_ptr->save_source_picture_ptr)
+            save_source_picture(input_picture_ptr, picture_control_set_ptr->save_source_picture_ptr);
+
         // Pre processing operations performed on the input picture
         picture_pre_processing_operations(picture_control_set_ptr,
 #if !TURN_OFF_PRE_PROCESSING
@@ -5182,6 +5262,8 @@ void *eb_vp9_picture_analysis_kernel(void *input_ptr) {
 
         // Get Empty Results Object
         eb_vp9_get_empty_object(context_ptr->picture_analysis_results_output_fifo_ptr, &output_results_wrapper_ptr);
+        if (output_results_wrapper_ptr == EB_NULL)
+            return EB_NULL;
 
         output_results_ptr = (PictureAnalysisResults *)output_results_wrapper_ptr->object_ptr;
         output_results_ptr->picture_control_set_wrapper_ptr = input_results_ptr->picture_control_set_wrapper_ptr;
@@ -7,6 +7,7 @@
 
 #include "EbPictureBufferDesc.h"
 #include "EbDefinitions.h"
+#include "EbUtility.h"
 /*****************************************
  * eb_vp9_picture_buffer_desc_ctor
  *  Initializes the Buffer Descriptor's
@@ -57,17 +58,17 @@ EbErrorType eb_vp9_picture_buffer_desc_ctor(EbPtr *object_dbl_ptr, EbPtr object_
 
     // Allocate the Picture Buffers (luma & chroma)
     if (picture_buffer_desc_init_data_ptr->buffer_enable_mask & PICTURE_BUFFER_DESC_Y_FLAG) {
-        EB_ALLIGN_MALLOC(EbByte,
-                         picture_buffer_desc_ptr->buffer_y,
-                         picture_buffer_desc_ptr->luma_size * bytesPerPixel * sizeof(uint8_t),
-                         EB_A_PTR);
+        EB_HUGE_PAGE_MALLOC(EbByte,
+                            picture_buffer_desc_ptr->buffer_y,
+                            picture_buffer_desc_ptr->luma_size * bytesPerPixel * sizeof(uint8_t),
+                            EB_A_PTR);
         //picture_buffer_desc_ptr->buffer_y = (EbByte) EB_aligned_malloc( picture_buffer_desc_ptr->luma_size      * bytesPerPixel * sizeof(uint8_t),ALVALUE);
         picture_buffer_desc_ptr->buffer_bit_inc_y = 0;
         if (picture_buffer_desc_init_data_ptr->split_mode == EB_TRUE) {
-            EB_ALLIGN_MALLOC(EbByte,
-                             picture_buffer_desc_ptr->buffer_bit_inc_y,
-                             picture_buffer_desc_ptr->luma_size * bytesPerPixel * sizeof(uint8_t),
-                             EB_A_PTR);
+            EB_HUGE_PAGE_MALLOC(EbByte,
+                                picture_buffer_desc_ptr->buffer_bit_inc_y,
+                                picture_buffer_desc_ptr->luma_size * bytesPerPixel * sizeof(uint8_t),
+                                EB_A_PTR);
             //picture_buffer_desc_ptr->buffer_bit_inc_y = (EbByte) EB_aligned_malloc( picture_buffer_desc_ptr->luma_size      * bytesPerPixel * sizeof(uint8_t),ALVALUE);
         }
     } else {
@@ -76,17 +77,17 @@ EbErrorType eb_vp9_picture_buffer_desc_ctor(EbPtr *object_dbl_ptr, EbPtr object_
     }
 
     if (picture_buffer_desc_init_data_ptr->buffer_enable_mask & PICTURE_BUFFER_DESC_Cb_FLAG) {
-        EB_ALLIGN_MALLOC(EbByte,
-                         picture_buffer_desc_ptr->buffer_cb,
-                         picture_buffer_desc_ptr->chroma_size * bytesPerPixel * sizeof(uint8_t),
-                         EB_A_PTR);
+        EB_HUGE_PAGE_MALLOC(EbByte,
+                            picture_buffer_desc_ptr->buffer_cb,
+                            picture_buffer_desc_ptr->chroma_size * bytesPerPixel * sizeof(uint8_t),
+                            EB_A_PTR);
         //picture_buffer_desc_ptr->buffer_cb = (EbByte) EB_aligned_malloc(picture_buffer_desc_ptr->chroma_size    * bytesPerPixel * sizeof(uint8_t),ALVALUE);
         picture_buffer_desc_ptr->buffer_bit_inc_cb = 0;
         if (picture_buffer_desc_init_data_ptr->split_mode == EB_TRUE) {
-            EB_ALLIGN_MALLOC(EbByte,
-                             picture_buffer_desc_ptr->buffer_bit_inc_cb,
-                             picture_buffer_desc_ptr->chroma_size * bytesPerPixel * sizeof(uint8_t),
-                             EB_A_PTR);
+            EB_HUGE_PAGE_MALLOC(EbByte,
+                                picture_buffer_desc_ptr->buffer_bit_inc_cb,
+                                picture_buffer_desc_ptr->chroma_size * bytesPerPixel * sizeof(uint8_t),
+                                EB_A_PTR);
             //picture_buffer_desc_ptr->buffer_bit_inc_cb = (EbByte) EB_aligned_malloc(picture_buffer_desc_ptr->chroma_size    * bytesPerPixel * sizeof(uint8_t),ALVALUE);
         }
     } else {
@@ -95,17 +96,17 @@ EbErrorType eb_vp9_picture_buffer_desc_ctor(EbPtr *object_dbl_ptr, EbPtr object_
     }
 
     if (picture_buffer_desc_init_data_ptr->buffer_enable_mask & PICTURE_BUFFER_DESC_Cr_FLAG) {
-        EB_ALLIGN_MALLOC(EbByte,
-                         picture_buffer_desc_ptr->buffer_cr,
-                         picture_buffer_desc_ptr->chroma_size * bytesPerPixel * sizeof(uint8_t),
-                         EB_A_PTR);
+        EB_HUGE_PAGE_MALLOC(EbByte,
+                            picture_buffer_desc_ptr->buffer_cr,
+                            picture_buffer_desc_ptr->chroma_size * bytesPerPixel * sizeof(uint8_t),
+                            EB_A_PTR);
         //picture_buffer_desc_ptr->buffer_cr = (EbByte) EB_aligned_malloc(picture_buffer_desc_ptr->chroma_size    * bytesPerPixel * sizeof(uint8_t),ALVALUE);
         picture_buffer_desc_ptr->buffer_bit_inc_cr = 0;
         if (picture_buffer_desc_init_data_ptr->split_mode == EB_TRUE) {
-            EB_ALLIGN_MALLOC(EbByte,
-                             picture_buffer_desc_ptr->buffer_bit_inc_cr,
-                             picture_buffer_desc_ptr->chroma_size * bytesPerPixel * sizeof(uint8_t),
-                             EB_A_PTR);
+            EB_HUGE_PAGE_MALLOC(EbByte,
+                                picture_buffer_desc_ptr->buffer_bit_inc_cr,
+                                picture_buffer_desc_ptr->chroma_size * bytesPerPixel * sizeof(uint8_t),
+                                EB_A_PTR);
             //picture_buffer_desc_ptr->buffer_bit_inc_cr = (EbByte) EB_aligned_malloc(picture_buffer_desc_ptr->chroma_size    * bytesPerPixel * sizeof(uint8_t),ALVALUE);
         }
     } else {
@@ -83,15 +83,22 @@ EbErrorType eb_vp9_picture_control_set_ctor(EbPtr *object_dbl_ptr, EbPtr object_
     if (return_error == EB_ErrorInsufficientResources) {
         return EB_ErrorInsufficientResources;
     }
-    // Entropy Coder
-    return_error = eb_vp9_entropy_coder_ctor(&object_ptr->entropy_coder_ptr, SEGMENT_ENTROPY_BUFFER_SIZE);
+    // Entropy Coder, the bitstream buffers start at the raw picture size at most and grow with the pictures
+    // that do not fit. The constructor takes the size in 32-bit words
+    const uint32_t raw_picture_size = (uint32_t)(init_data_ptr->picture_width * init_data_ptr->picture_height * 3 / 2)
+        << is16bit;
+    return_error = eb_vp9_entropy_coder_ctor(
+        &object_ptr->entropy_coder_ptr, MIN(SEGMENT_ENTROPY_BUFFER_SIZE, raw_picture_size * sizeof(unsigned int)));
 
     if (return_error == EB_ErrorInsufficientResources) {
         return EB_ErrorInsufficientResources;
     }
 
     // Packetization process Bitstream
-    return_error = eb_vp9_bitstream_ctor(&object_ptr->bitstream_ptr, PACKETIZATION_PROCESS_BUFFER_SIZE);
+    return_error = eb_vp9_bitstream_ctor(
+        &object_ptr->bitstream_ptr,
+        MIN(PACKETIZATION_PROCESS_BUFFER_SIZE,
+            (raw_picture_size + PACKETIZATION_PROCESS_HEADER_SIZE) * sizeof(unsigned int)));
 
     if (return_error == EB_ErrorInsufficientResources) {
         return EB_ErrorInsufficientResources;
@@ -281,6 +288,10 @@ EbErrorType eb_vp9_picture_control_set_ctor(EbPtr *object_dbl_ptr, EbPtr object_
     // Entropy Rows
     EB_CREATEMUTEX(EbHandle, object_ptr->entropy_coding_mutex, sizeof(EbHandle), EB_MUTEX);
 
+    // Loop Filter Level Search
+    EB_CREATEMUTEX(EbHandle, object_ptr->lf_search_mutex, sizeof(EbHandle), EB_MUTEX);
+    EB_CREATESEMAPHORE(EbHandle, object_ptr->lf_search_done_semaphore, sizeof(EbHandle), EB_SEMAPHORE, 0, 1);
+
     return EB_ErrorNone;
 }
 
@@ -422,6 +433,7 @@ EbErrorType eb_vp9_picture_parent_control_set_ctor(EbPtr *object_dbl_ptr, EbPtr
             }
         }
     }
+    EB_CREATESEMAPHORE(EbHandle, object_ptr->picture_histogram_done_semaphore, sizeof(EbHandle), EB_SEMAPHORE, 0, 1);
 #if 0 // Hsan: will be used when adding ois
     uint32_t maxOisCand;
     uint32_t maxOisCand = MAX(MAX_OIS_0, MAX_OIS_2);
@@ -533,5 +545,27 @@ EbErrorType eb_vp9_picture_parent_control_set_ctor(EbPtr *object_dbl_ptr, EbPtr
               sizeof(EB_SB_DEPTH_MODE) * object_ptr->sb_total_count,
               EB_N_PTR);
 
+    // Source copy for the quality statistics
+    object_ptr->save_source_picture_ptr = (EbPictureBufferDesc *)EB_NULL;
+    if (init_data_ptr->stat_report) {
+        EbPictureBufferDescInitData save_source_buffer_desc_init_data;
+
+        save_source_buffer_desc_init_data.max_width          = init_data_ptr->picture_width;
+        save_source_buffer_desc_init_data.max_height         = init_data_ptr->picture_height;
+        save_source_buffer_desc_init_data.bit_depth          = EB_8BIT;
+        save_source_buffer_desc_init_data.buffer_enable_mask = PICTURE_BUFFER_DESC_FULL_MASK;
+        save_source_buffer_desc_init_data.left_padding       = 0;
+        save_source_buffer_desc_init_data.right_padding      = 0;
+        save_source_buffer_desc_init_data.top_padding        = 0;
+        save_source_buffer_desc_init_data.bot_padding        = 0;
+        save_source_buffer_desc_init_data.split_mode         = EB_FALSE;
+
+        return_error = eb_vp9_recon_picture_buffer_desc_ctor((EbPtr *)&(object_ptr->save_source_picture_ptr),
+                                                             (EbPtr)&save_source_buffer_desc_init_data);
+        if (return_error == EB_ErrorInsufficientResources) {
+            return EB_ErrorInsufficientResources;
+        }
+    }
+
     return return_error;
 }
@@ -29,8 +29,9 @@ extern "C" {
 #endif
 
 #define SEGMENT_ENTROPY_BUFFER_SIZE 0x989680 // Entropy Bitstream Buffer Size
+#define PACKETIZATION_PROCESS_HEADER_SIZE 0x001000 // Header(s) Buffer Size
 #define PACKETIZATION_PROCESS_BUFFER_SIZE \
-    SEGMENT_ENTROPY_BUFFER_SIZE + 0x001000 // Entropy Bitstream + Header(s) Buffer Size.
+    SEGMENT_ENTROPY_BUFFER_SIZE + PACKETIZATION_PROCESS_HEADER_SIZE // Entropy Bitstream + Header(s) Buffer Size.
 #define HISTOGRAM_NUMBER_OF_BINS 256
 #define MAX_NUMBER_OF_REGIONS_IN_WIDTH 4
 #define MAX_NUMBER_OF_REGIONS_IN_HEIGHT 4
@@ -53,6 +54,10 @@ extern "C" {
 
 #define NEIGHBOR_ARRAY_TOTAL_COUNT 3
 
+#define TEMPORAL_FILTER_MAX_PAST_PICTURES 2
+
+#define LF_SEARCH_MAX_LEVELS 10 // guess, guess +/- 1, 2, 4, 8 and OFF
+
 /**************************************
  * Segment-based Control Sets
  **************************************/
@@ -124,6 +129,16 @@ typedef struct PictureControlSet {
     EbHandle entropy_coding_mutex;
     EB_BOOL  entropy_coding_in_progress;
     EB_BOOL  entropy_coding_pic_done;
+    uint32_t entropy_coding_released_size; // bytes of the tile data already output in partial packets
+
+    // Loop Filter Level Search, each SB row is evaluated by the EncDec thread that codes its last SB
+    uint8_t  lf_search_level_count;
+    uint8_t  lf_search_level_array[LF_SEARCH_MAX_LEVELS];
+    uint64_t lf_search_sse_array[LF_SEARCH_MAX_LEVELS];
+    uint32_t lf_search_pending_row_count;
+    EB_BOOL  lf_search_waiting;
+    EbHandle lf_search_mutex;
+    EbHandle lf_search_done_semaphore; // posted once the last pending SB row is evaluated
 
     // Mode Decision Config
     MdcSbData *mdc_sb_data_array;
@@ -242,6 +257,9 @@ typedef struct PictureParentControlSet {
 
     EbPictureBufferDesc *enhanced_picture_ptr;
 
+    // Copy of the source taken before the denoising and the temporal filtering of the input picture (stat_report)
+    EbPictureBufferDesc *save_source_picture_ptr;
+
     EB_PICNOISE_CLASS pic_noise_class;
 
     EbBufferHeaderType *eb_input_ptr;
@@ -291,9 +309,14 @@ typedef struct PictureParentControlSet {
 
     uint64_t start_time_seconds;
     uint64_t start_timeu_seconds;
-    uint32_t luma_sse;
-    uint32_t cr_sse;
-    uint32_t cb_sse;
+    // Per plane SSE of the reconstructed picture against the saved source (stat_report)
+    uint64_t luma_sse;
+    uint64_t cr_sse;
+    uint64_t cb_sse;
+    // Per plane SSIM of the reconstructed picture against the saved source (stat_report)
+    double luma_ssim;
+    double cb_ssim;
+    double cr_ssim;
 
     // PA
     uint32_t pre_assignment_buffer_count;
@@ -310,8 +333,11 @@ typedef struct PictureParentControlSet {
 
     // Histograms
     uint32_t ****picture_histogram;
+    EbHandle     picture_histogram_done_semaphore; // posted @ PictureAnalysisProcess() once the histograms are ready
 
     uint64_t average_intensity_per_region[MAX_NUMBER_OF_REGIONS_IN_WIDTH][MAX_NUMBER_OF_REGIONS_IN_HEIGHT][3];
+    // Accumulative histogram (absolute) differences to the previous picture, per region and component
+    uint32_t ahd_per_region[MAX_NUMBER_OF_REGIONS_IN_WIDTH][MAX_NUMBER_OF_REGIONS_IN_HEIGHT][3];
 
     // Segments
     uint16_t me_segments_total_count;
@@ -412,6 +438,11 @@ typedef struct PictureParentControlSet {
 
     // Encoder Mode
     EB_ENC_MODE enc_mode;
+    // Encoder mode of the ME search area, the MD NFL and the MDC depth mode, enc_mode unless the speed control
+    // stepped the tool to the next faster mode
+    EB_ENC_MODE search_area_enc_mode;
+    EB_ENC_MODE nfl_enc_mode;
+    EB_ENC_MODE depth_mode_enc_mode;
 
     // Multi-modes signal(s)
     EbPictureDepthMode   pic_depth_mode;
@@ -426,6 +457,13 @@ typedef struct PictureParentControlSet {
     EB_BOOL              enable_hme_level_1_flag;
     EB_BOOL              enable_hme_level_2_flag;
 
+    // Temporal filtering of the source (base layer pictures), the past pictures are the ones preceding the
+    // picture in display order, their input buffers are held until the ME of the picture is done
+    uint8_t              temporal_filter_count;
+    uint8_t              temporal_filter_strength;
+    EbObjectWrapper     *temporal_filter_wrapper_ptr_array[TEMPORAL_FILTER_MAX_PAST_PICTURES];
+    EbPictureBufferDesc *temporal_filter_picture_ptr_array[TEMPORAL_FILTER_MAX_PAST_PICTURES];
+
 } PictureParentControlSet;
 
 typedef struct PictureControlSetInitData {
@@ -447,6 +485,8 @@ typedef struct PictureControlSetInitData {
 
     uint8_t tune;
 
+    uint8_t stat_report;
+
 } PictureControlSetInitData;
 
 /**************************************
@@ -17,6 +17,7 @@
 #include "EbReferenceObject.h"
 #include "EbComputeSAD.h"
 #include "EbMeSadCalculation.h"
+#include "EbTemporalFiltering.h"
 
 #include "EbSvtVp9ErrorCodes.h"
 #include "vp9_pred_common.h"
@@ -52,7 +53,6 @@ EbErrorType eb_vp9_picture_decision_context_ctor(PictureDecisionContext **contex
                                                  EbFifo                  *picture_decision_results_output_fifo_ptr) {
     PictureDecisionContext *context_ptr;
     uint32_t                array_index;
-    uint32_t                array_row, arrow_column;
     EB_MALLOC(PictureDecisionContext *, context_ptr, sizeof(PictureDecisionContext), EB_N_PTR);
     *context_dbl_ptr = context_ptr;
 
@@ -84,6 +84,18 @@ EbErrorType eb_vp9_picture_decision_context_ctor(PictureDecisionContext **contex
                   EB_N_PTR);
     }
 
+    eb_vp9_picture_decision_context_reset(context_ptr);
+
+    return EB_ErrorNone;
+}
+
+/************************************************
+ * Picture Decision Context Reset
+ *   Clears the scene change running averages
+ ************************************************/
+void eb_vp9_picture_decision_context_reset(PictureDecisionContext *context_ptr) {
+    uint32_t array_row, arrow_column;
+
     for (array_row = 0; array_row < MAX_NUMBER_OF_REGIONS_IN_HEIGHT; array_row++) {
         for (arrow_column = 0; arrow_column < MAX_NUMBER_OF_REGIONS_IN_WIDTH; arrow_column++) {
             context_ptr->ahd_running_avg_cb[arrow_column][array_row] = 0;
@@ -93,8 +105,6 @@ EbErrorType eb_vp9_picture_decision_context_ctor(PictureDecisionContext **contex
     }
 
     context_ptr->reset_running_avg = EB_TRUE;
-
-    return EB_ErrorNone;
 }
 
 EB_BOOL eb_vp9_SceneTransitionDetector(PictureDecisionContext   *context_ptr,
@@ -136,8 +146,6 @@ EB_BOOL eb_vp9_SceneTransitionDetector(PictureDecisionContext   *context_ptr,
     uint8_t aid_future_present = 0;
     uint8_t aid_present_past   = 0;
 
-    uint32_t bin = 0; // variable used to iterate through the bins of the histograms
-
     uint32_t region_in_picture_width_index;
     uint32_t region_in_picture_height_index;
 
@@ -145,6 +153,8 @@ EB_BOOL eb_vp9_SceneTransitionDetector(PictureDecisionContext   *context_ptr,
     uint32_t region_height;
     uint32_t region_width_offset;
     uint32_t region_height_offset;
+    uint32_t region_area_width;
+    uint32_t region_area_height;
 
     uint32_t is_abrupt_change_count = 0;
     uint32_t is_scene_change_count  = 0;
@@ -179,10 +189,13 @@ EB_BOOL eb_vp9_SceneTransitionDetector(PictureDecisionContext   *context_ptr,
             is_flash         = EB_FALSE;
             gradual_change   = EB_FALSE;
 
-            // Reset accumulative histogram (absolute) differences between the past and current frame
-            ahd    = 0;
-            ahd_cb = 0;
-            ahd_cr = 0;
+            // Accumulative histogram (absolute) differences between the past and current frame, computed @ PictureAnalysisProcess()
+            ahd = currentpicture_control_set_ptr
+                      ->ahd_per_region[region_in_picture_width_index][region_in_picture_height_index][0];
+            ahd_cb = currentpicture_control_set_ptr
+                         ->ahd_per_region[region_in_picture_width_index][region_in_picture_height_index][1];
+            ahd_cr = currentpicture_control_set_ptr
+                         ->ahd_per_region[region_in_picture_width_index][region_in_picture_height_index][2];
 
             region_width_offset = (region_in_picture_width_index ==
                                    sequence_control_set_ptr->picture_analysis_number_of_regions_per_width - 1)
@@ -196,8 +209,9 @@ EB_BOOL eb_vp9_SceneTransitionDetector(PictureDecisionContext   *context_ptr,
                     (sequence_control_set_ptr->picture_analysis_number_of_regions_per_height * region_height)
                 : 0;
 
-            region_width += region_width_offset;
-            region_height += region_height_offset;
+            // Size of this region, the last ones also cover the remainder of the picture
+            region_area_width  = region_width + region_width_offset;
+            region_area_height = region_height + region_height_offset;
 
             region_thresh_hold = (
                                      // Noise insertion/removal detection
@@ -206,30 +220,12 @@ EB_BOOL eb_vp9_SceneTransitionDetector(PictureDecisionContext   *context_ptr,
                                       NOISE_VARIANCE_TH) &&
                                      (currentpicture_control_set_ptr->pic_avg_variance > HIGH_PICTURE_VARIANCE_TH ||
                                       previouspicture_control_set_ptr->pic_avg_variance > HIGH_PICTURE_VARIANCE_TH))
-                ? NOISY_SCENE_TH * NUM64x64INPIC(region_width, region_height)
+                ? NOISY_SCENE_TH * NUM64x64INPIC(region_area_width, region_area_height)
                 : // SCD TH function of noise insertion/removal.
-                SCENE_TH * NUM64x64INPIC(region_width, region_height);
+                SCENE_TH * NUM64x64INPIC(region_area_width, region_area_height);
 
             region_thresh_hold_chroma = region_thresh_hold / 4;
 
-            for (bin = 0; bin < HISTOGRAM_NUMBER_OF_BINS; ++bin) {
-                ahd += ABS(
-                    (int32_t)currentpicture_control_set_ptr
-                        ->picture_histogram[region_in_picture_width_index][region_in_picture_height_index][0][bin] -
-                    (int32_t)previouspicture_control_set_ptr
-                        ->picture_histogram[region_in_picture_width_index][region_in_picture_height_index][0][bin]);
-                ahd_cb += ABS(
-                    (int32_t)currentpicture_control_set_ptr
-                        ->picture_histogram[region_in_picture_width_index][region_in_picture_height_index][1][bin] -
-                    (int32_t)previouspicture_control_set_ptr
-                        ->picture_histogram[region_in_picture_width_index][region_in_picture_height_index][1][bin]);
-                ahd_cr += ABS(
-                    (int32_t)currentpicture_control_set_ptr
-                        ->picture_histogram[region_in_picture_width_index][region_in_picture_height_index][2][bin] -
-                    (int32_t)previouspicture_control_set_ptr
-                        ->picture_histogram[region_in_picture_width_index][region_in_picture_height_index][2][bin]);
-            }
-
             if (context_ptr->reset_running_avg) {
                 ahd_running_avg[region_in_picture_width_index][region_in_picture_height_index]    = ahd;
                 ahd_running_avg_cb[region_in_picture_width_index][region_in_picture_height_index] = ahd_cb;
@@ -757,13 +753,13 @@ EbErrorType eb_vp9_signal_derivation_multi_processes_sq(SequenceControlSet
     EbErrorType return_error = EB_ErrorNone;
 
     // Set MD Partitioning Method
-    if (picture_control_set_ptr->enc_mode <= ENC_MODE_3) {
+    if (picture_control_set_ptr->depth_mode_enc_mode <= ENC_MODE_3) {
         if (picture_control_set_ptr->slice_type == I_SLICE) {
             picture_control_set_ptr->pic_depth_mode = PIC_FULL84_DEPTH_MODE;
         } else {
             picture_control_set_ptr->pic_depth_mode = PIC_FULL85_DEPTH_MODE;
         }
-    } else if (picture_control_set_ptr->enc_mode <= ENC_MODE_4) {
+    } else if (picture_control_set_ptr->depth_mode_enc_mode <= ENC_MODE_4) {
         if (sequence_control_set_ptr->input_resolution == INPUT_SIZE_4K_RANGE) {
             if (picture_control_set_ptr->slice_type == I_SLICE) {
                 picture_control_set_ptr->pic_depth_mode = PIC_FULL84_DEPTH_MODE;
@@ -777,7 +773,7 @@ EbErrorType eb_vp9_signal_derivation_multi_processes_sq(SequenceControlSet
                 picture_control_set_ptr->pic_depth_mode = PIC_SB_SWITCH_DEPTH_MODE;
             }
         }
-    } else if (picture_control_set_ptr->enc_mode <= ENC_MODE_9) {
+    } else if (picture_control_set_ptr->depth_mode_enc_mode <= ENC_MODE_9) {
         if (picture_control_set_ptr->slice_type == I_SLICE) {
             picture_control_set_ptr->pic_depth_mode = PIC_FULL84_DEPTH_MODE;
         } else {
@@ -831,7 +827,7 @@ EbErrorType eb_vp9_signal_derivation_multi_processes_oq(SequenceControlSet
     EbErrorType return_error = EB_ErrorNone;
 
     // Set MD Partitioning Method
-    if (picture_control_set_ptr->enc_mode <= ENC_MODE_3) {
+    if (picture_control_set_ptr->depth_mode_enc_mode <= ENC_MODE_3) {
         if (picture_control_set_ptr->slice_type == I_SLICE) {
             picture_control_set_ptr->pic_depth_mode = PIC_FULL84_DEPTH_MODE;
         } else {
@@ -882,7 +878,7 @@ EbErrorType eb_vp9_signal_derivation_multi_processes_vmaf(SequenceControlSet
     EbErrorType return_error = EB_ErrorNone;
 
     // Set MD Partitioning Method
-    if (picture_control_set_ptr->enc_mode <= ENC_MODE_1) {
+    if (picture_control_set_ptr->depth_mode_enc_mode <= ENC_MODE_1) {
         if (picture_control_set_ptr->slice_type == I_SLICE) {
             picture_control_set_ptr->pic_depth_mode = PIC_FULL84_DEPTH_MODE;
         } else {
@@ -1327,6 +1323,55 @@ void generate_rps_info(PictureParentControlSet *picture_control_set_ptr, Picture
     }
 }
 
+/***************************************************************************************************
+ * Temporal Filter Setup
+ *   The base layer picture closing a Random Access mini GOP is filtered @ MotionEstimationProcess()
+ *   with the pictures preceding it in the mini GOP, up to the first scene change. Their input
+ *   buffers are held until the ME of the picture is done.
+ ***************************************************************************************************/
+static void temporal_filter_setup(SequenceControlSet *sequence_control_set_ptr, EncodeContext *encode_context_ptr,
+                                  PictureDecisionContext *context_ptr, PictureParentControlSet *picture_control_set_ptr,
+                                  uint32_t mini_gop_index, uint32_t picture_index) {
+    PictureParentControlSet *next_pcs_ptr = picture_control_set_ptr;
+    PictureParentControlSet *past_pcs_ptr;
+    int32_t                  q;
+
+    picture_control_set_ptr->temporal_filter_count = 0;
+
+    if (picture_index != context_ptr->mini_gop_end_index[mini_gop_index] ||
+        picture_control_set_ptr->slice_type == I_SLICE || picture_control_set_ptr->temporal_layer_index > 0 ||
+        picture_control_set_ptr->pred_struct_ptr->pred_type != EB_PRED_RANDOM_ACCESS ||
+        picture_control_set_ptr->ref_pa_pic_ptr_array[REF_LIST_0] == EB_NULL)
+        return;
+
+    while (picture_control_set_ptr->temporal_filter_count < TEMPORAL_FILTER_MAX_PAST_PICTURES &&
+           picture_index - picture_control_set_ptr->temporal_filter_count >
+               context_ptr->mini_gop_start_index[mini_gop_index]) {
+        past_pcs_ptr = (PictureParentControlSet *)encode_context_ptr
+                           ->pre_assignment_buffer[picture_index - picture_control_set_ptr->temporal_filter_count - 1]
+                           ->object_ptr;
+
+        if (next_pcs_ptr->scene_change_flag || past_pcs_ptr->temporal_layer_index == 0 ||
+            past_pcs_ptr->picture_number + picture_control_set_ptr->temporal_filter_count + 1 !=
+                picture_control_set_ptr->picture_number)
+            break;
+
+        picture_control_set_ptr->temporal_filter_wrapper_ptr_array[picture_control_set_ptr->temporal_filter_count] =
+            past_pcs_ptr->input_picture_wrapper_ptr;
+        picture_control_set_ptr->temporal_filter_picture_ptr_array[picture_control_set_ptr->temporal_filter_count] =
+            past_pcs_ptr->enhanced_picture_ptr;
+        eb_vp9_object_inc_live_count(past_pcs_ptr->input_picture_wrapper_ptr, 1);
+
+        ++picture_control_set_ptr->temporal_filter_count;
+        next_pcs_ptr = past_pcs_ptr;
+    }
+
+    // Lower the strength at high quality, as in the libvpx ARF filter
+    q = (int32_t)eb_vp9_convert_qindex_to_q(eb_vp9_quantizer_to_qindex(sequence_control_set_ptr->qp), VPX_BITS_8);
+    picture_control_set_ptr->temporal_filter_strength = (uint8_t)(
+        q > 16 ? TEMPORAL_FILTER_STRENGTH : MAX(TEMPORAL_FILTER_STRENGTH - (16 - q) / 2, 0));
+}
+
 /***************************************************************************************************
  * Picture Decision Kernel
  *
@@ -1472,6 +1517,8 @@ void *eb_vp9_picture_decision_kernel(void *input_ptr) {
     for (;;) {
         // Get Input Full Object
         eb_vp9_get_full_object(context_ptr->picture_analysis_results_input_fifo_ptr, &input_results_wrapper_ptr);
+        if (input_results_wrapper_ptr == EB_NULL)
+            return EB_NULL;
 
         input_results_ptr       = (PictureAnalysisResults *)input_results_wrapper_ptr->object_ptr;
         picture_control_set_ptr = (PictureParentControlSet *)
@@ -1561,7 +1608,10 @@ void *eb_vp9_picture_decision_kernel(void *input_ptr) {
                 context_ptr->last_solid_color_frame_poc = 0xFFFFFFFF;
 
             if (window_avail == EB_TRUE) {
-                picture_control_set_ptr->scene_change_flag = EB_FALSE;
+                picture_control_set_ptr->scene_change_flag = (sequence_control_set_ptr->scd_mode != SCD_MODE_0)
+                    ? eb_vp9_SceneTransitionDetector(
+                          context_ptr, sequence_control_set_ptr, parent_pcs_window, FUTURE_WINDOW_WIDTH)
+                    : EB_FALSE;
             }
 
             if (window_avail == EB_TRUE || frame_passe_thru == EB_TRUE) {
@@ -1613,7 +1663,8 @@ void *eb_vp9_picture_decision_kernel(void *input_ptr) {
                 encode_context_ptr->pre_assignment_buffer_idr_count += picture_control_set_ptr->idr_flag;
                 encode_context_ptr->pre_assignment_buffer_count += 1;
 
-                if (sequence_control_set_ptr->static_config.rate_control_mode) {
+                if (sequence_control_set_ptr->static_config.rate_control_mode == 1 ||
+                    sequence_control_set_ptr->static_config.rate_control_mode == 2) {
                     // Increment the Intra Period Position
                     encode_context_ptr->intra_period_position = (encode_context_ptr->intra_period_position ==
                                                                  (uint32_t)sequence_control_set_ptr->intra_period)
@@ -2220,6 +2271,13 @@ void *eb_vp9_picture_decision_kernel(void *input_ptr) {
                                 }
                             }
 
+                            temporal_filter_setup(sequence_control_set_ptr,
+                                                  encode_context_ptr,
+                                                  context_ptr,
+                                                  picture_control_set_ptr,
+                                                  mini_gop_index,
+                                                  picture_index);
+
                             // Initialize Segments
                             picture_control_set_ptr->me_segments_column_count =
                                 (uint8_t)(sequence_control_set_ptr->me_segment_column_count_array
@@ -2242,6 +2300,8 @@ void *eb_vp9_picture_decision_kernel(void *input_ptr) {
                                     // Get Empty Results Object
                                     eb_vp9_get_empty_object(context_ptr->picture_decision_results_output_fifo_ptr,
                                                             &output_results_wrapper_ptr);
+                                    if (output_results_wrapper_ptr == EB_NULL)
+                                        return EB_NULL;
 
                                     output_results_ptr = (PictureDecisionResults *)
                                                              output_results_wrapper_ptr->object_ptr;
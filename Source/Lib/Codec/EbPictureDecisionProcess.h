@@ -47,6 +47,8 @@ extern EbErrorType eb_vp9_picture_decision_context_ctor(PictureDecisionContext *
                                                         EbFifo *picture_analysis_results_input_fifo_ptr,
                                                         EbFifo *picture_decision_results_output_fifo_ptr);
 
+extern void eb_vp9_picture_decision_context_reset(PictureDecisionContext *context_ptr);
+
 extern void *eb_vp9_picture_decision_kernel(void *input_ptr);
 
 #endif // EbPictureDecision_h
@@ -3,6 +3,7 @@
 * SPDX - License - Identifier: BSD - 2 - Clause - Patent
 */
 
+#include <assert.h>
 #include <stdlib.h>
 #include <string.h>
 
@@ -44,6 +45,229 @@ EbErrorType eb_vp9_picture_manager_context_ctor(PictureManagerContext **context_
     return EB_ErrorNone;
 }
 
+/************************************************
+ * Reference Queue Entry Index
+ *   The reference queue holds one entry per picture in picture number order,
+ *   so the entry of a picture is at its distance from the head entry
+ ************************************************/
+static uint32_t reference_queue_entry_index(EncodeContext *encode_context_ptr, uint64_t picture_number) {
+    ReferenceQueueEntry *head_entry_ptr =
+        encode_context_ptr->reference_picture_queue[encode_context_ptr->reference_picture_queue_head_index];
+
+    return (uint32_t)((encode_context_ptr->reference_picture_queue_head_index +
+                       (picture_number - head_entry_ptr->picture_number)) %
+                      REFERENCE_QUEUE_MAX_DEPTH);
+}
+
+/************************************************
+ * Reference Release Queue Insert
+ *   Queues a reference entry whose dependent count or
+ *   availability changed, in reference queue order
+ ************************************************/
+static void reference_release_queue_insert(EncodeContext *encode_context_ptr, uint32_t reference_queue_index) {
+    uint32_t *release_queue = encode_context_ptr->reference_release_queue;
+    uint32_t  head_index    = encode_context_ptr->reference_picture_queue_head_index;
+    uint32_t  distance      = (reference_queue_index + REFERENCE_QUEUE_MAX_DEPTH - head_index) %
+        REFERENCE_QUEUE_MAX_DEPTH;
+    uint32_t  release_index;
+
+    if (encode_context_ptr->reference_picture_queue[reference_queue_index]->release_pending) {
+        return;
+    }
+    encode_context_ptr->reference_picture_queue[reference_queue_index]->release_pending = EB_TRUE;
+
+    release_index = encode_context_ptr->reference_release_count++;
+    while (release_index > 0 &&
+           (release_queue[release_index - 1] + REFERENCE_QUEUE_MAX_DEPTH - head_index) % REFERENCE_QUEUE_MAX_DEPTH >
+               distance) {
+        release_queue[release_index] = release_queue[release_index - 1];
+        --release_index;
+    }
+    release_queue[release_index] = reference_queue_index;
+}
+
+/************************************************
+ * Input Ready Queue Insert
+ *   Queues an input entry whose references are all
+ *   completed, in input queue order
+ ************************************************/
+static void input_ready_queue_insert(EncodeContext *encode_context_ptr, uint32_t input_queue_index) {
+    uint32_t *ready_queue = encode_context_ptr->input_ready_queue;
+    uint32_t  head_index  = encode_context_ptr->input_picture_queue_head_index;
+    uint32_t  distance    = (input_queue_index + INPUT_QUEUE_MAX_DEPTH - head_index) % INPUT_QUEUE_MAX_DEPTH;
+    uint32_t  ready_index = encode_context_ptr->input_ready_count++;
+
+    while (ready_index > 0 &&
+           (ready_queue[ready_index - 1] + INPUT_QUEUE_MAX_DEPTH - head_index) % INPUT_QUEUE_MAX_DEPTH > distance) {
+        ready_queue[ready_index] = ready_queue[ready_index - 1];
+        --ready_index;
+    }
+    ready_queue[ready_index] = input_queue_index;
+}
+
+/************************************************
+ * Input Queue Entry Reference
+ *   Returns the reference queue entry of the list0 / list1
+ *   reference of the input entry, EB_NULL when the list is
+ *   not used
+ ************************************************/
+static ReferenceQueueEntry *input_queue_entry_reference(EncodeContext           *encode_context_ptr,
+                                                        PictureParentControlSet *picture_control_set_ptr,
+                                                        InputQueueEntry *input_entry_ptr, uint32_t list_index) {
+    ReferenceList *list_ptr = (list_index == REF_LIST_0) ? input_entry_ptr->list0_ptr : input_entry_ptr->list1_ptr;
+
+    // Same references as the availability check of the Picture Manager
+    EB_BOOL list_used = (list_index == REF_LIST_0)
+        ? (picture_control_set_ptr->ref_list0_count != 0)
+        : (picture_control_set_ptr->slice_type == B_SLICE && picture_control_set_ptr->ref_list1_count &&
+           list_ptr->reference_list != (int32_t)INVALID_POC);
+
+    if (!list_used) {
+        return (ReferenceQueueEntry *)EB_NULL;
+    }
+
+    return encode_context_ptr->reference_picture_queue[CIRCULAR_ADD(
+        ((int32_t)input_entry_ptr->reference_entry_index) - list_ptr->reference_list, REFERENCE_QUEUE_MAX_DEPTH)];
+}
+
+/************************************************
+ * Input Queue Entry Wait
+ *   Adds the input entry to the waiters of its references
+ *   which are not completed yet, or queues it as ready
+ *   when all of them are
+ ************************************************/
+static void input_queue_entry_wait(EncodeContext *encode_context_ptr, PictureParentControlSet *picture_control_set_ptr,
+                                   uint32_t input_queue_index) {
+    InputQueueEntry     *input_entry_ptr = encode_context_ptr->input_picture_queue[input_queue_index];
+    ReferenceQueueEntry *reference_entry_ptr;
+    uint32_t             list_index;
+
+    input_entry_ptr->unavailable_reference_count = 0;
+
+    for (list_index = REF_LIST_0; list_index <= REF_LIST_1; ++list_index) {
+        input_entry_ptr->next_waiter[list_index] = WAITER_NULL;
+
+        reference_entry_ptr = input_queue_entry_reference(
+            encode_context_ptr, picture_control_set_ptr, input_entry_ptr, list_index);
+
+        if (reference_entry_ptr && !reference_entry_ptr->reference_available) {
+            input_entry_ptr->next_waiter[list_index] = reference_entry_ptr->waiter_head;
+            reference_entry_ptr->waiter_head         = (input_queue_index << 1) | list_index;
+            ++input_entry_ptr->unavailable_reference_count;
+        }
+    }
+
+    if (input_entry_ptr->unavailable_reference_count == 0) {
+        input_ready_queue_insert(encode_context_ptr, input_queue_index);
+    }
+}
+
+/************************************************
+ * Reference Queue Entry Signal
+ *   Wakes up the input entries waiting for the
+ *   reference once it is completed
+ ************************************************/
+static void reference_queue_entry_signal(EncodeContext *encode_context_ptr, ReferenceQueueEntry *reference_entry_ptr) {
+    InputQueueEntry *input_entry_ptr;
+    uint32_t         waiter = reference_entry_ptr->waiter_head;
+
+    reference_entry_ptr->waiter_head = WAITER_NULL;
+
+    while (waiter != WAITER_NULL) {
+        input_entry_ptr = encode_context_ptr->input_picture_queue[waiter >> 1];
+
+        if (--input_entry_ptr->unavailable_reference_count == 0) {
+            input_ready_queue_insert(encode_context_ptr, waiter >> 1);
+        }
+        waiter = input_entry_ptr->next_waiter[waiter & 1];
+    }
+}
+
+#ifndef NDEBUG
+/************************************************
+ * Picture Manager Queues Check (debug builds)
+ *   Runs the full queue scans that the indexed queues
+ *   replaced and checks that they agree: the ready queue
+ *   holds the waiting pictures whose references are all
+ *   completed, in input queue order, the waiters of each
+ *   reference are the pictures for which it is not
+ *   completed yet, and a full scan would release no
+ *   reference
+ ************************************************/
+static void picture_manager_queues_check(EncodeContext *encode_context_ptr) {
+    PictureParentControlSet *picture_control_set_ptr;
+    InputQueueEntry         *input_entry_ptr;
+    ReferenceQueueEntry     *reference_entry_ptr;
+    uint32_t                 input_queue_index;
+    uint32_t                 reference_queue_index;
+    uint32_t                 list_index;
+    uint32_t                 ready_index       = 0;
+    uint32_t                 unavailable_count = 0;
+    uint32_t                 waiter_count      = 0;
+    uint32_t                 waiter;
+
+    // Input queue scan
+    for (input_queue_index = encode_context_ptr->input_picture_queue_head_index;
+         input_queue_index != encode_context_ptr->input_picture_queue_tail_index;
+         input_queue_index = (input_queue_index == INPUT_QUEUE_MAX_DEPTH - 1) ? 0 : input_queue_index + 1) {
+        uint32_t entry_unavailable_count = 0;
+
+        input_entry_ptr = encode_context_ptr->input_picture_queue[input_queue_index];
+        if (input_entry_ptr->input_object_ptr == EB_NULL) {
+            continue;
+        }
+        picture_control_set_ptr = (PictureParentControlSet *)input_entry_ptr->input_object_ptr->object_ptr;
+
+        for (list_index = REF_LIST_0; list_index <= REF_LIST_1; ++list_index) {
+            reference_entry_ptr = input_queue_entry_reference(
+                encode_context_ptr, picture_control_set_ptr, input_entry_ptr, list_index);
+            if (reference_entry_ptr && !reference_entry_ptr->reference_available) {
+                ++entry_unavailable_count;
+            }
+        }
+        assert(input_entry_ptr->unavailable_reference_count == entry_unavailable_count);
+        unavailable_count += entry_unavailable_count;
+
+        if (entry_unavailable_count == 0) {
+            assert(ready_index < encode_context_ptr->input_ready_count);
+            assert(encode_context_ptr->input_ready_queue[ready_index] == input_queue_index);
+            ++ready_index;
+        }
+    }
+    assert(ready_index == encode_context_ptr->input_ready_count);
+
+    // Reference queue scan
+    for (reference_queue_index = encode_context_ptr->reference_picture_queue_head_index;
+         reference_queue_index != encode_context_ptr->reference_picture_queue_tail_index;
+         reference_queue_index = (reference_queue_index == REFERENCE_QUEUE_MAX_DEPTH - 1)
+             ? 0
+             : reference_queue_index + 1) {
+        reference_entry_ptr = encode_context_ptr->reference_picture_queue[reference_queue_index];
+
+        assert(reference_entry_ptr->release_pending == EB_FALSE);
+        assert(!((reference_entry_ptr->dependent_count == 0) && (reference_entry_ptr->reference_available) &&
+                 (reference_entry_ptr->release_enable) && (reference_entry_ptr->reference_object_ptr)));
+    }
+
+    // Waiter lists, a reference that is not received yet can be past the tail
+    for (reference_queue_index = 0; reference_queue_index < REFERENCE_QUEUE_MAX_DEPTH; ++reference_queue_index) {
+        reference_entry_ptr = encode_context_ptr->reference_picture_queue[reference_queue_index];
+
+        for (waiter = reference_entry_ptr->waiter_head; waiter != WAITER_NULL;
+             waiter = input_entry_ptr->next_waiter[waiter & 1]) {
+            input_entry_ptr = encode_context_ptr->input_picture_queue[waiter >> 1];
+            assert(input_entry_ptr->input_object_ptr != EB_NULL);
+            picture_control_set_ptr = (PictureParentControlSet *)input_entry_ptr->input_object_ptr->object_ptr;
+            assert(!reference_entry_ptr->reference_available);
+            assert(input_queue_entry_reference(
+                       encode_context_ptr, picture_control_set_ptr, input_entry_ptr, waiter & 1) == reference_entry_ptr);
+            ++waiter_count;
+        }
+    }
+    assert(waiter_count == unavailable_count);
+}
+#endif
+
 /***************************************************************************************************
  * Picture Manager Kernel
  *
@@ -94,6 +318,9 @@ void *eb_vp9_PictureManagerKernel(void *input_ptr) {
     InputQueueEntry *input_entry_ptr;
     uint32_t         input_queue_index;
     uint64_t         current_input_poc;
+    uint32_t         ready_index;
+    uint32_t         ready_count;
+    uint32_t         release_index;
 
     ReferenceQueueEntry *reference_entry_ptr;
     uint32_t             reference_queue_index;
@@ -119,6 +346,8 @@ void *eb_vp9_PictureManagerKernel(void *input_ptr) {
     for (;;) {
         // Get Input Full Object
         eb_vp9_get_full_object(context_ptr->picture_input_fifo_ptr, &input_picture_demux_wrapper_ptr);
+        if (input_picture_demux_wrapper_ptr == EB_NULL)
+            return EB_NULL;
 
         input_picture_demux_ptr = (PictureDemuxResults *)input_picture_demux_wrapper_ptr->object_ptr;
 
@@ -236,6 +465,7 @@ void *eb_vp9_PictureManagerKernel(void *input_ptr) {
                             reference_entry_ptr->dep_list1_count = reference_entry_ptr->list1.list_count;
                             reference_entry_ptr->dependent_count = reference_entry_ptr->dep_list0_count +
                                 reference_entry_ptr->dep_list1_count - dependantListRemovedEntries;
+                            reference_release_queue_insert(encode_context_ptr, reference_queue_index);
 
                         } else {
                             // Modify Dependent List0
@@ -256,6 +486,7 @@ void *eb_vp9_PictureManagerKernel(void *input_ptr) {
 
                                     // Decrement the Reference's referenceCount
                                     --reference_entry_ptr->dependent_count;
+                                    reference_release_queue_insert(encode_context_ptr, reference_queue_index);
 
                                     CHECK_REPORT_ERROR(reference_entry_ptr->dependent_count != ~0u,
                                                        encode_context_ptr->app_callback_ptr,
@@ -281,6 +512,7 @@ void *eb_vp9_PictureManagerKernel(void *input_ptr) {
 
                                     // Decrement the Reference's referenceCount
                                     --reference_entry_ptr->dependent_count;
+                                    reference_release_queue_insert(encode_context_ptr, reference_queue_index);
 
                                     CHECK_REPORT_ERROR(reference_entry_ptr->dependent_count != ~0u,
                                                        encode_context_ptr->app_callback_ptr,
@@ -361,6 +593,7 @@ void *eb_vp9_PictureManagerKernel(void *input_ptr) {
                             reference_entry_ptr->dep_list1_count = reference_entry_ptr->list1.list_count;
                             reference_entry_ptr->dependent_count = reference_entry_ptr->dep_list0_count +
                                 reference_entry_ptr->dep_list1_count - dependantListRemovedEntries;
+                            reference_release_queue_insert(encode_context_ptr, reference_queue_index);
 
                         } else {
                             // Modify Dependent List0
@@ -381,6 +614,7 @@ void *eb_vp9_PictureManagerKernel(void *input_ptr) {
 
                                     // Decrement the Reference's referenceCount
                                     --reference_entry_ptr->dependent_count;
+                                    reference_release_queue_insert(encode_context_ptr, reference_queue_index);
 
                                     CHECK_REPORT_ERROR(reference_entry_ptr->dependent_count != ~0u,
                                                        encode_context_ptr->app_callback_ptr,
@@ -406,6 +640,7 @@ void *eb_vp9_PictureManagerKernel(void *input_ptr) {
 
                                     // Decrement the Reference's referenceCount
                                     --reference_entry_ptr->dependent_count;
+                                    reference_release_queue_insert(encode_context_ptr, reference_queue_index);
 
                                     CHECK_REPORT_ERROR(reference_entry_ptr->dependent_count != ~0u,
                                                        encode_context_ptr->app_callback_ptr,
@@ -446,6 +681,7 @@ void *eb_vp9_PictureManagerKernel(void *input_ptr) {
 
                                 // Decrement the Reference's referenceCount
                                 --reference_entry_ptr->dependent_count;
+                                reference_release_queue_insert(encode_context_ptr, reference_queue_index);
                                 CHECK_REPORT_ERROR(reference_entry_ptr->dependent_count != ~0u,
                                                    encode_context_ptr->app_callback_ptr,
                                                    EB_ENC_PM_ERROR1);
@@ -477,6 +713,7 @@ void *eb_vp9_PictureManagerKernel(void *input_ptr) {
 
                                 // Decrement the Reference's referenceCount
                                 --reference_entry_ptr->dependent_count;
+                                reference_release_queue_insert(encode_context_ptr, reference_queue_index);
                                 CHECK_REPORT_ERROR(reference_entry_ptr->dependent_count != ~0u,
                                                    encode_context_ptr->app_callback_ptr,
                                                    EB_ENC_PM_ERROR1);
@@ -506,8 +743,8 @@ void *eb_vp9_PictureManagerKernel(void *input_ptr) {
                     EB_ENC_PM_ERROR2);
 
                 // Place Picture in input queue
-                input_entry_ptr =
-                    encode_context_ptr->input_picture_queue[encode_context_ptr->input_picture_queue_tail_index];
+                input_queue_index = encode_context_ptr->input_picture_queue_tail_index;
+                input_entry_ptr   = encode_context_ptr->input_picture_queue[input_queue_index];
                 input_entry_ptr->input_object_ptr      = queue_entry_ptr->parent_pcs_wrapper_ptr;
                 input_entry_ptr->reference_entry_index = encode_context_ptr->reference_picture_queue_tail_index;
                 encode_context_ptr->input_picture_queue_tail_index =
@@ -526,6 +763,9 @@ void *eb_vp9_PictureManagerKernel(void *input_ptr) {
                 input_entry_ptr->list0_ptr               = &pred_position_ptr->ref_list0;
                 input_entry_ptr->list1_ptr               = &pred_position_ptr->ref_list1;
 
+                // Wait for the references which are not completed yet
+                input_queue_entry_wait(encode_context_ptr, picture_control_set_ptr, input_queue_index);
+
                 // Check if the reference_picture_queue is full.
                 CHECK_REPORT_ERROR(
                     (encode_context_ptr->reference_picture_queue_head_index !=
@@ -611,27 +851,22 @@ void *eb_vp9_PictureManagerKernel(void *input_ptr) {
                                encode_context_ptr->app_callback_ptr,
                                EB_ENC_PM_ERROR5);
 
-            reference_queue_index = encode_context_ptr->reference_picture_queue_head_index;
-
             // Find the Reference in the Reference Queue
-            do {
-                reference_entry_ptr = encode_context_ptr->reference_picture_queue[reference_queue_index];
+            reference_queue_index = reference_queue_entry_index(encode_context_ptr,
+                                                                input_picture_demux_ptr->picture_number);
+            reference_entry_ptr   = encode_context_ptr->reference_picture_queue[reference_queue_index];
 
-                if (reference_entry_ptr->picture_number == input_picture_demux_ptr->picture_number) {
-                    // Assign the reference object if there is a match
-                    reference_entry_ptr->reference_object_ptr = input_picture_demux_ptr->reference_picture_wrapper_ptr;
+            if (reference_entry_ptr->picture_number == input_picture_demux_ptr->picture_number) {
+                // Assign the reference object if there is a match
+                reference_entry_ptr->reference_object_ptr = input_picture_demux_ptr->reference_picture_wrapper_ptr;
 
-                    // Set the reference availability
-                    reference_entry_ptr->reference_available = EB_TRUE;
-                }
-
-                // Increment the reference_queue_index Iterator
-                reference_queue_index = (reference_queue_index == REFERENCE_QUEUE_MAX_DEPTH - 1)
-                    ? 0
-                    : reference_queue_index + 1;
+                // Set the reference availability
+                reference_entry_ptr->reference_available = EB_TRUE;
 
-            } while ((reference_queue_index != encode_context_ptr->reference_picture_queue_tail_index) &&
-                     (reference_entry_ptr->picture_number != input_picture_demux_ptr->picture_number));
+                // Wake up the input pictures waiting for the reference
+                reference_queue_entry_signal(encode_context_ptr, reference_entry_ptr);
+                reference_release_queue_insert(encode_context_ptr, reference_queue_index);
+            }
 
             CHECK_REPORT_ERROR(reference_entry_ptr->picture_number == input_picture_demux_ptr->picture_number,
                                encode_context_ptr->app_callback_ptr,
@@ -661,293 +896,305 @@ void *eb_vp9_PictureManagerKernel(void *input_ptr) {
         //  Common Code
         // *************************************
 
-        // Walk the input queue and start all ready pictures.  Mark entry as null after started.  Increment the head as you go.
+        // Check the input pictures whose references are all completed, in input queue order, and start the
+        // ready ones.  The others stay in the ready queue until their feedback or input condition is met.
         if (encode_context_ptr != (EncodeContext *)EB_NULL) {
-            input_queue_index = encode_context_ptr->input_picture_queue_head_index;
-            while (input_queue_index != encode_context_ptr->input_picture_queue_tail_index) {
-                input_entry_ptr = encode_context_ptr->input_picture_queue[input_queue_index];
-
-                if (input_entry_ptr->input_object_ptr != EB_NULL) {
-                    entry_picture_control_set_ptr = (PictureParentControlSet *)
-                                                        input_entry_ptr->input_object_ptr->object_ptr;
-                    entrysequence_control_set_ptr = (SequenceControlSet *)entry_picture_control_set_ptr
-                                                        ->sequence_control_set_wrapper_ptr->object_ptr;
-
-                    availability_flag = EB_TRUE;
-
-                    // Check ref_list0 Availability
-                    if (entry_picture_control_set_ptr->ref_list0_count) {
-                        reference_queue_index = (uint32_t)CIRCULAR_ADD(
-                            ((int32_t)input_entry_ptr->reference_entry_index) - // Base
-                                input_entry_ptr->list0_ptr->reference_list, // Offset
-                            REFERENCE_QUEUE_MAX_DEPTH); // Max
-
-                        reference_entry_ptr = encode_context_ptr->reference_picture_queue[reference_queue_index];
-
-                        CHECK_REPORT_ERROR(reference_entry_ptr, encode_context_ptr->app_callback_ptr, EB_ENC_PM_ERROR8);
-
-                        ref_poc = POC_CIRCULAR_ADD(
-                        entry_picture_control_set_ptr->picture_number,
-                        -input_entry_ptr->list0_ptr->reference_list/*,
-                        entrysequence_control_set_ptr->bitsForPictureOrderCount*/);
-
-                        // Increment the current_input_poc is the case of POC rollover
-                        current_input_poc = encode_context_ptr->current_input_poc;
-                        //current_input_poc += ((current_input_poc < ref_poc) && (input_entry_ptr->list0_ptr->reference_list[ref_idx] > 0)) ?
-                        //    (1 << entrysequence_control_set_ptr->bitsForPictureOrderCount) :
-                        //    0;
-
-                        availability_flag = (availability_flag == EB_FALSE) ? EB_FALSE
-                                                                            : // Don't update if already False
-                            (ref_poc > current_input_poc)
-                            ? EB_FALSE
-                            : // The Reference has not been received as an Input Picture yet, then its availability is false
-                            (!encode_context_ptr->terminating_sequence_flag_received &&
-                             (sequence_control_set_ptr->static_config.rate_control_mode &&
-                              entry_picture_control_set_ptr->slice_type != I_SLICE &&
-                              entry_picture_control_set_ptr->temporal_layer_index == 0 &&
-                              !reference_entry_ptr->feedback_arrived))
-                            ? EB_FALSE
-                            : (reference_entry_ptr->reference_available) ? EB_TRUE
-                                                                         : // The Reference has been completed
-                            EB_FALSE; // The Reference has not been completed
-                    }
+            ready_count = 0;
+            for (ready_index = 0; ready_index < encode_context_ptr->input_ready_count; ++ready_index) {
+                input_queue_index = encode_context_ptr->input_ready_queue[ready_index];
+                input_entry_ptr   = encode_context_ptr->input_picture_queue[input_queue_index];
+
+                entry_picture_control_set_ptr = (PictureParentControlSet *)
+                                                    input_entry_ptr->input_object_ptr->object_ptr;
+                entrysequence_control_set_ptr = (SequenceControlSet *)entry_picture_control_set_ptr
+                                                    ->sequence_control_set_wrapper_ptr->object_ptr;
+
+                availability_flag = EB_TRUE;
+
+                // Check ref_list0 Availability
+                if (entry_picture_control_set_ptr->ref_list0_count) {
+                    reference_queue_index = (uint32_t)CIRCULAR_ADD(
+                        ((int32_t)input_entry_ptr->reference_entry_index) - // Base
+                            input_entry_ptr->list0_ptr->reference_list, // Offset
+                        REFERENCE_QUEUE_MAX_DEPTH); // Max
+
+                    reference_entry_ptr = encode_context_ptr->reference_picture_queue[reference_queue_index];
+
+                    CHECK_REPORT_ERROR(reference_entry_ptr, encode_context_ptr->app_callback_ptr, EB_ENC_PM_ERROR8);
+
+                    ref_poc = POC_CIRCULAR_ADD(
+                    entry_picture_control_set_ptr->picture_number,
+                    -input_entry_ptr->list0_ptr->reference_list/*,
+                    entrysequence_control_set_ptr->bitsForPictureOrderCount*/);
+
+                    // Increment the current_input_poc is the case of POC rollover
+                    current_input_poc = encode_context_ptr->current_input_poc;
+                    //current_input_poc += ((current_input_poc < ref_poc) && (input_entry_ptr->list0_ptr->reference_list[ref_idx] > 0)) ?
+                    //    (1 << entrysequence_control_set_ptr->bitsForPictureOrderCount) :
+                    //    0;
+
+                    availability_flag = (availability_flag == EB_FALSE) ? EB_FALSE
+                                                                        : // Don't update if already False
+                        (ref_poc > current_input_poc)
+                        ? EB_FALSE
+                        : // The Reference has not been received as an Input Picture yet, then its availability is false
+                        (!encode_context_ptr->terminating_sequence_flag_received &&
+                         ((sequence_control_set_ptr->static_config.rate_control_mode == 1 ||
+                           sequence_control_set_ptr->static_config.rate_control_mode == 2) &&
+                          entry_picture_control_set_ptr->slice_type != I_SLICE &&
+                          entry_picture_control_set_ptr->temporal_layer_index == 0 &&
+                          !reference_entry_ptr->feedback_arrived))
+                        ? EB_FALSE
+                        : (reference_entry_ptr->reference_available) ? EB_TRUE
+                                                                     : // The Reference has been completed
+                        EB_FALSE; // The Reference has not been completed
+                }
 
-                    // Check ref_list1 Availability
-                    if (entry_picture_control_set_ptr->slice_type == B_SLICE) {
-                        if (entry_picture_control_set_ptr->ref_list1_count) {
-                            // If Reference is valid (non-zero), update the availability
-                            if (input_entry_ptr->list1_ptr->reference_list != (int32_t)INVALID_POC) {
-                                reference_queue_index = (uint32_t)CIRCULAR_ADD(
-                                    ((int32_t)input_entry_ptr->reference_entry_index) - // Base
-                                        input_entry_ptr->list1_ptr->reference_list, // Offset
-                                    REFERENCE_QUEUE_MAX_DEPTH); // Max
-
-                                reference_entry_ptr =
-                                    encode_context_ptr->reference_picture_queue[reference_queue_index];
-
-                                CHECK_REPORT_ERROR(
-                                    reference_entry_ptr, encode_context_ptr->app_callback_ptr, EB_ENC_PM_ERROR8);
-
-                                ref_poc = POC_CIRCULAR_ADD(
-                                entry_picture_control_set_ptr->picture_number,
-                                -input_entry_ptr->list1_ptr->reference_list/*,
-                                entrysequence_control_set_ptr->bitsForPictureOrderCount*/);
-
-                                // Increment the current_input_poc is the case of POC rollover
-                                current_input_poc = encode_context_ptr->current_input_poc;
-                                //current_input_poc += ((current_input_poc < ref_poc && input_entry_ptr->list1_ptr->reference_list[ref_idx] > 0)) ?
-                                //    (1 << entrysequence_control_set_ptr->bitsForPictureOrderCount) :
-                                //    0;
-
-                                availability_flag = (availability_flag == EB_FALSE) ? EB_FALSE
-                                                                                    : // Don't update if already False
-                                    (ref_poc > current_input_poc)
-                                    ? EB_FALSE
-                                    : // The Reference has not been received as an Input Picture yet, then its availability is false
-                                    (!encode_context_ptr->terminating_sequence_flag_received &&
-                                     (sequence_control_set_ptr->static_config.rate_control_mode &&
-                                      entry_picture_control_set_ptr->slice_type != I_SLICE &&
-                                      entry_picture_control_set_ptr->temporal_layer_index == 0 &&
-                                      !reference_entry_ptr->feedback_arrived))
-                                    ? EB_FALSE
-                                    : (reference_entry_ptr->reference_available) ? EB_TRUE
-                                                                                 : // The Reference has been completed
-                                    EB_FALSE; // The Reference has not been completed
-                            }
+                // Check ref_list1 Availability
+                if (entry_picture_control_set_ptr->slice_type == B_SLICE) {
+                    if (entry_picture_control_set_ptr->ref_list1_count) {
+                        // If Reference is valid (non-zero), update the availability
+                        if (input_entry_ptr->list1_ptr->reference_list != (int32_t)INVALID_POC) {
+                            reference_queue_index = (uint32_t)CIRCULAR_ADD(
+                                ((int32_t)input_entry_ptr->reference_entry_index) - // Base
+                                    input_entry_ptr->list1_ptr->reference_list, // Offset
+                                REFERENCE_QUEUE_MAX_DEPTH); // Max
+
+                            reference_entry_ptr =
+                                encode_context_ptr->reference_picture_queue[reference_queue_index];
+
+                            CHECK_REPORT_ERROR(
+                                reference_entry_ptr, encode_context_ptr->app_callback_ptr, EB_ENC_PM_ERROR8);
+
+                            ref_poc = POC_CIRCULAR_ADD(
+                            entry_picture_control_set_ptr->picture_number,
+                            -input_entry_ptr->list1_ptr->reference_list/*,
+                            entrysequence_control_set_ptr->bitsForPictureOrderCount*/);
+
+                            // Increment the current_input_poc is the case of POC rollover
+                            current_input_poc = encode_context_ptr->current_input_poc;
+                            //current_input_poc += ((current_input_poc < ref_poc && input_entry_ptr->list1_ptr->reference_list[ref_idx] > 0)) ?
+                            //    (1 << entrysequence_control_set_ptr->bitsForPictureOrderCount) :
+                            //    0;
+
+                            availability_flag = (availability_flag == EB_FALSE) ? EB_FALSE
+                                                                                : // Don't update if already False
+                                (ref_poc > current_input_poc)
+                                ? EB_FALSE
+                                : // The Reference has not been received as an Input Picture yet, then its availability is false
+                                (!encode_context_ptr->terminating_sequence_flag_received &&
+                                 ((sequence_control_set_ptr->static_config.rate_control_mode == 1 ||
+                                   sequence_control_set_ptr->static_config.rate_control_mode == 2) &&
+                                  entry_picture_control_set_ptr->slice_type != I_SLICE &&
+                                  entry_picture_control_set_ptr->temporal_layer_index == 0 &&
+                                  !reference_entry_ptr->feedback_arrived))
+                                ? EB_FALSE
+                                : (reference_entry_ptr->reference_available) ? EB_TRUE
+                                                                             : // The Reference has been completed
+                                EB_FALSE; // The Reference has not been completed
                         }
                     }
+                }
 
-                    if (availability_flag == EB_TRUE) {
-                        // Get New  Empty Child PCS from PCS Pool
-                        eb_vp9_get_empty_object(context_ptr->picture_control_set_fifo_ptr_array[0],
-                                                &child_picture_control_set_wrapper_ptr);
-
-                        // Child PCS is released by Packetization
-                        eb_vp9_object_inc_live_count(child_picture_control_set_wrapper_ptr, 1);
-
-                        child_picture_control_set_ptr = (PictureControlSet *)
-                                                            child_picture_control_set_wrapper_ptr->object_ptr;
-
-                        //1.Link The Child PCS to its Parent
-                        child_picture_control_set_ptr->picture_parent_control_set_wrapper_ptr =
-                            input_entry_ptr->input_object_ptr;
-                        child_picture_control_set_ptr->parent_pcs_ptr = entry_picture_control_set_ptr;
-
-                        //2. Have some common information between  ChildPCS and ParentPCS.
-                        child_picture_control_set_ptr->sequence_control_set_wrapper_ptr =
-                            entry_picture_control_set_ptr->sequence_control_set_wrapper_ptr;
-                        child_picture_control_set_ptr->picture_qp     = entry_picture_control_set_ptr->picture_qp;
-                        child_picture_control_set_ptr->picture_number = entry_picture_control_set_ptr->picture_number;
-                        child_picture_control_set_ptr->slice_type     = entry_picture_control_set_ptr->slice_type;
-                        child_picture_control_set_ptr->temporal_layer_index =
-                            entry_picture_control_set_ptr->temporal_layer_index;
-
-                        child_picture_control_set_ptr->parent_pcs_ptr->total_num_bits = 0;
-                        child_picture_control_set_ptr->parent_pcs_ptr->picture_qp =
-                            entry_picture_control_set_ptr->picture_qp;
-                        child_picture_control_set_ptr->parent_pcs_ptr->sad_me                   = 0;
-                        child_picture_control_set_ptr->parent_pcs_ptr->quantized_coeff_num_bits = 0;
-                        child_picture_control_set_ptr->enc_mode = entry_picture_control_set_ptr->enc_mode;
-
-                        //3.make all  init for ChildPCS
-                        picture_width_in_sb =
-                            (uint8_t)((entrysequence_control_set_ptr->luma_width + MAX_SB_SIZE_MINUS_1) / MAX_SB_SIZE);
-                        picture_height_in_sb =
-                            (uint8_t)((entrysequence_control_set_ptr->luma_height + MAX_SB_SIZE_MINUS_1) / MAX_SB_SIZE);
-
-                        // EncDec Segments
-                        eb_vp9_enc_dec_segments_init(
-                            child_picture_control_set_ptr->enc_dec_segment_ctrl,
-                            entrysequence_control_set_ptr
-                                ->enc_dec_segment_col_count_array[entry_picture_control_set_ptr->temporal_layer_index],
-                            entrysequence_control_set_ptr
-                                ->enc_dec_segment_row_count_array[entry_picture_control_set_ptr->temporal_layer_index],
-                            picture_width_in_sb,
-                            picture_height_in_sb);
-
-                        // Entropy Coding Rows
-                        {
-                            unsigned row_index;
-
-                            child_picture_control_set_ptr->entropy_coding_current_row           = 0;
-                            child_picture_control_set_ptr->entropy_coding_current_available_row = 0;
-                            child_picture_control_set_ptr->entropy_coding_row_count             = picture_height_in_sb;
-                            child_picture_control_set_ptr->entropy_coding_in_progress           = EB_FALSE;
-
-                            for (row_index = 0; row_index < MAX_SB_ROWS; ++row_index) {
-                                child_picture_control_set_ptr->entropy_coding_row_array[row_index] = EB_FALSE;
-                            }
+                if (availability_flag == EB_TRUE) {
+                    // Get New  Empty Child PCS from PCS Pool
+                    eb_vp9_get_empty_object(context_ptr->picture_control_set_fifo_ptr_array[0],
+                                            &child_picture_control_set_wrapper_ptr);
+                    if (child_picture_control_set_wrapper_ptr == EB_NULL)
+                        return EB_NULL;
+
+                    // Child PCS is released by Packetization
+                    eb_vp9_object_inc_live_count(child_picture_control_set_wrapper_ptr, 1);
+
+                    child_picture_control_set_ptr = (PictureControlSet *)
+                                                        child_picture_control_set_wrapper_ptr->object_ptr;
+
+                    //1.Link The Child PCS to its Parent
+                    child_picture_control_set_ptr->picture_parent_control_set_wrapper_ptr =
+                        input_entry_ptr->input_object_ptr;
+                    child_picture_control_set_ptr->parent_pcs_ptr = entry_picture_control_set_ptr;
+
+                    //2. Have some common information between  ChildPCS and ParentPCS.
+                    child_picture_control_set_ptr->sequence_control_set_wrapper_ptr =
+                        entry_picture_control_set_ptr->sequence_control_set_wrapper_ptr;
+                    child_picture_control_set_ptr->picture_qp     = entry_picture_control_set_ptr->picture_qp;
+                    child_picture_control_set_ptr->picture_number = entry_picture_control_set_ptr->picture_number;
+                    child_picture_control_set_ptr->slice_type     = entry_picture_control_set_ptr->slice_type;
+                    child_picture_control_set_ptr->temporal_layer_index =
+                        entry_picture_control_set_ptr->temporal_layer_index;
+
+                    child_picture_control_set_ptr->parent_pcs_ptr->total_num_bits = 0;
+                    child_picture_control_set_ptr->parent_pcs_ptr->picture_qp =
+                        entry_picture_control_set_ptr->picture_qp;
+                    child_picture_control_set_ptr->parent_pcs_ptr->sad_me                   = 0;
+                    child_picture_control_set_ptr->parent_pcs_ptr->quantized_coeff_num_bits = 0;
+                    child_picture_control_set_ptr->enc_mode = entry_picture_control_set_ptr->enc_mode;
+
+                    //3.make all  init for ChildPCS
+                    picture_width_in_sb =
+                        (uint8_t)((entrysequence_control_set_ptr->luma_width + MAX_SB_SIZE_MINUS_1) / MAX_SB_SIZE);
+                    picture_height_in_sb =
+                        (uint8_t)((entrysequence_control_set_ptr->luma_height + MAX_SB_SIZE_MINUS_1) / MAX_SB_SIZE);
+
+                    // EncDec Segments
+                    eb_vp9_enc_dec_segments_init(
+                        child_picture_control_set_ptr->enc_dec_segment_ctrl,
+                        entrysequence_control_set_ptr
+                            ->enc_dec_segment_col_count_array[entry_picture_control_set_ptr->temporal_layer_index],
+                        entrysequence_control_set_ptr
+                            ->enc_dec_segment_row_count_array[entry_picture_control_set_ptr->temporal_layer_index],
+                        picture_width_in_sb,
+                        picture_height_in_sb);
+
+                    // Entropy Coding Rows
+                    {
+                        unsigned row_index;
+
+                        child_picture_control_set_ptr->entropy_coding_current_row           = 0;
+                        child_picture_control_set_ptr->entropy_coding_current_available_row = 0;
+                        child_picture_control_set_ptr->entropy_coding_row_count             = picture_height_in_sb;
+                        child_picture_control_set_ptr->entropy_coding_in_progress           = EB_FALSE;
+                        child_picture_control_set_ptr->entropy_coding_released_size         = 0;
+
+                        for (row_index = 0; row_index < MAX_SB_ROWS; ++row_index) {
+                            child_picture_control_set_ptr->entropy_coding_row_array[row_index] = EB_FALSE;
                         }
+                    }
 
 #if SEG_SUPPORT
-                        EB_MEMSET(&child_picture_control_set_ptr->segment_counts[0], 0, MAX_SEGMENTS * sizeof(int));
+                    EB_MEMSET(&child_picture_control_set_ptr->segment_counts[0], 0, MAX_SEGMENTS * sizeof(int));
 #endif
-                        // is_low_delay
-                        child_picture_control_set_ptr->is_low_delay =
-                            (EB_BOOL)(child_picture_control_set_ptr->parent_pcs_ptr->pred_struct_ptr
-                                          ->pred_struct_entry_ptr_array[child_picture_control_set_ptr->parent_pcs_ptr
-                                                                            ->pred_struct_index]
-                                          ->positive_ref_pics_total_count == 0);
-
-                        // Reset the Reference Lists
-                        EB_MEMSET(child_picture_control_set_ptr->ref_pic_ptr_array, 0, 2 * sizeof(EbObjectWrapper *));
-
-                        EB_MEMSET(child_picture_control_set_ptr->ref_pic_qp_array, 0, 2 * sizeof(uint8_t));
-
-                        EB_MEMSET(child_picture_control_set_ptr->ref_slice_type_array, 0, 2 * sizeof(EB_SLICE));
-
-                        // Configure List0
-                        if ((entry_picture_control_set_ptr->slice_type == P_SLICE) ||
-                            (entry_picture_control_set_ptr->slice_type == B_SLICE)) {
-                            if (entry_picture_control_set_ptr->ref_list0_count) {
-                                reference_queue_index = (uint32_t)CIRCULAR_ADD(
-                                    ((int32_t)input_entry_ptr->reference_entry_index) -
-                                        input_entry_ptr->list0_ptr->reference_list,
-                                    REFERENCE_QUEUE_MAX_DEPTH); // Max
-
-                                reference_entry_ptr =
-                                    encode_context_ptr->reference_picture_queue[reference_queue_index];
-
-                                // Set the Reference Object
-                                child_picture_control_set_ptr->ref_pic_ptr_array[REF_LIST_0] =
-                                    reference_entry_ptr->reference_object_ptr;
-
-                                child_picture_control_set_ptr->ref_pic_qp_array[REF_LIST_0] =
-                                    ((EbReferenceObject *)reference_entry_ptr->reference_object_ptr->object_ptr)->qp;
-                                child_picture_control_set_ptr->ref_slice_type_array[REF_LIST_0] =
-                                    ((EbReferenceObject *)reference_entry_ptr->reference_object_ptr->object_ptr)
-                                        ->slice_type;
-
-                                // Increment the Reference's live_count by the number of tiles in the input picture
-                                eb_vp9_object_inc_live_count(reference_entry_ptr->reference_object_ptr, 1);
-
-                                // Decrement the Reference's dependent_count Count
-                                --reference_entry_ptr->dependent_count;
-
-                                CHECK_REPORT_ERROR(reference_entry_ptr->dependent_count != ~0u,
-                                                   encode_context_ptr->app_callback_ptr,
-                                                   EB_ENC_PM_ERROR0);
-                            }
+                    // is_low_delay
+                    child_picture_control_set_ptr->is_low_delay =
+                        (EB_BOOL)(child_picture_control_set_ptr->parent_pcs_ptr->pred_struct_ptr
+                                      ->pred_struct_entry_ptr_array[child_picture_control_set_ptr->parent_pcs_ptr
+                                                                        ->pred_struct_index]
+                                      ->positive_ref_pics_total_count == 0);
+
+                    // Reset the Reference Lists
+                    EB_MEMSET(child_picture_control_set_ptr->ref_pic_ptr_array, 0, 2 * sizeof(EbObjectWrapper *));
+
+                    EB_MEMSET(child_picture_control_set_ptr->ref_pic_qp_array, 0, 2 * sizeof(uint8_t));
+
+                    EB_MEMSET(child_picture_control_set_ptr->ref_slice_type_array, 0, 2 * sizeof(EB_SLICE));
+
+                    // Configure List0
+                    if ((entry_picture_control_set_ptr->slice_type == P_SLICE) ||
+                        (entry_picture_control_set_ptr->slice_type == B_SLICE)) {
+                        if (entry_picture_control_set_ptr->ref_list0_count) {
+                            reference_queue_index = (uint32_t)CIRCULAR_ADD(
+                                ((int32_t)input_entry_ptr->reference_entry_index) -
+                                    input_entry_ptr->list0_ptr->reference_list,
+                                REFERENCE_QUEUE_MAX_DEPTH); // Max
+
+                            reference_entry_ptr =
+                                encode_context_ptr->reference_picture_queue[reference_queue_index];
+
+                            // Set the Reference Object
+                            child_picture_control_set_ptr->ref_pic_ptr_array[REF_LIST_0] =
+                                reference_entry_ptr->reference_object_ptr;
+
+                            child_picture_control_set_ptr->ref_pic_qp_array[REF_LIST_0] =
+                                ((EbReferenceObject *)reference_entry_ptr->reference_object_ptr->object_ptr)->qp;
+                            child_picture_control_set_ptr->ref_slice_type_array[REF_LIST_0] =
+                                ((EbReferenceObject *)reference_entry_ptr->reference_object_ptr->object_ptr)
+                                    ->slice_type;
+
+                            // Increment the Reference's live_count by the number of tiles in the input picture
+                            eb_vp9_object_inc_live_count(reference_entry_ptr->reference_object_ptr, 1);
+
+                            // Decrement the Reference's dependent_count Count
+                            --reference_entry_ptr->dependent_count;
+                            reference_release_queue_insert(encode_context_ptr, reference_queue_index);
+
+                            CHECK_REPORT_ERROR(reference_entry_ptr->dependent_count != ~0u,
+                                               encode_context_ptr->app_callback_ptr,
+                                               EB_ENC_PM_ERROR0);
                         }
+                    }
 
-                        // Configure List1
-                        if (entry_picture_control_set_ptr->slice_type == B_SLICE) {
-                            if (entry_picture_control_set_ptr->ref_list1_count) {
-                                reference_queue_index = (uint32_t)CIRCULAR_ADD(
-                                    ((int32_t)input_entry_ptr->reference_entry_index) -
-                                        input_entry_ptr->list1_ptr->reference_list,
-                                    REFERENCE_QUEUE_MAX_DEPTH); // Max
-
-                                reference_entry_ptr =
-                                    encode_context_ptr->reference_picture_queue[reference_queue_index];
-
-                                // Set the Reference Object
-                                child_picture_control_set_ptr->ref_pic_ptr_array[REF_LIST_1] =
-                                    reference_entry_ptr->reference_object_ptr;
-
-                                child_picture_control_set_ptr->ref_pic_qp_array[REF_LIST_1] =
-                                    ((EbReferenceObject *)reference_entry_ptr->reference_object_ptr->object_ptr)->qp;
-                                child_picture_control_set_ptr->ref_slice_type_array[REF_LIST_1] =
-                                    ((EbReferenceObject *)reference_entry_ptr->reference_object_ptr->object_ptr)
-                                        ->slice_type;
-
-                                // Increment the Reference's live_count by the number of tiles in the input picture
-                                eb_vp9_object_inc_live_count(reference_entry_ptr->reference_object_ptr, 1);
-
-                                // Decrement the Reference's dependent_count Count
-                                --reference_entry_ptr->dependent_count;
-
-                                CHECK_REPORT_ERROR(reference_entry_ptr->dependent_count != ~0u,
-                                                   encode_context_ptr->app_callback_ptr,
-                                                   EB_ENC_PM_ERROR0);
-                            }
+                    // Configure List1
+                    if (entry_picture_control_set_ptr->slice_type == B_SLICE) {
+                        if (entry_picture_control_set_ptr->ref_list1_count) {
+                            reference_queue_index = (uint32_t)CIRCULAR_ADD(
+                                ((int32_t)input_entry_ptr->reference_entry_index) -
+                                    input_entry_ptr->list1_ptr->reference_list,
+                                REFERENCE_QUEUE_MAX_DEPTH); // Max
+
+                            reference_entry_ptr =
+                                encode_context_ptr->reference_picture_queue[reference_queue_index];
+
+                            // Set the Reference Object
+                            child_picture_control_set_ptr->ref_pic_ptr_array[REF_LIST_1] =
+                                reference_entry_ptr->reference_object_ptr;
+
+                            child_picture_control_set_ptr->ref_pic_qp_array[REF_LIST_1] =
+                                ((EbReferenceObject *)reference_entry_ptr->reference_object_ptr->object_ptr)->qp;
+                            child_picture_control_set_ptr->ref_slice_type_array[REF_LIST_1] =
+                                ((EbReferenceObject *)reference_entry_ptr->reference_object_ptr->object_ptr)
+                                    ->slice_type;
+
+                            // Increment the Reference's live_count by the number of tiles in the input picture
+                            eb_vp9_object_inc_live_count(reference_entry_ptr->reference_object_ptr, 1);
+
+                            // Decrement the Reference's dependent_count Count
+                            --reference_entry_ptr->dependent_count;
+                            reference_release_queue_insert(encode_context_ptr, reference_queue_index);
+
+                            CHECK_REPORT_ERROR(reference_entry_ptr->dependent_count != ~0u,
+                                               encode_context_ptr->app_callback_ptr,
+                                               EB_ENC_PM_ERROR0);
                         }
+                    }
 
-                        // Adjust the Slice-type if the Lists are Empty, but don't reset the Prediction Structure
-                        entry_picture_control_set_ptr->slice_type = (entry_picture_control_set_ptr->ref_list1_count > 0)
-                            ? B_SLICE
-                            : (entry_picture_control_set_ptr->ref_list0_count > 0) ? P_SLICE
-                                                                                   : I_SLICE;
+                    // Adjust the Slice-type if the Lists are Empty, but don't reset the Prediction Structure
+                    entry_picture_control_set_ptr->slice_type = (entry_picture_control_set_ptr->ref_list1_count > 0)
+                        ? B_SLICE
+                        : (entry_picture_control_set_ptr->ref_list0_count > 0) ? P_SLICE
+                                                                               : I_SLICE;
 
-                        // Increment the sequenceControlSet Wrapper's live count by 1 for only the pictures which are used as reference
-                        if (child_picture_control_set_ptr->parent_pcs_ptr->is_used_as_reference_flag) {
-                            eb_vp9_object_inc_live_count(
-                                child_picture_control_set_ptr->parent_pcs_ptr->sequence_control_set_wrapper_ptr, 1);
-                        }
+                    // Increment the sequenceControlSet Wrapper's live count by 1 for only the pictures which are used as reference
+                    if (child_picture_control_set_ptr->parent_pcs_ptr->is_used_as_reference_flag) {
+                        eb_vp9_object_inc_live_count(
+                            child_picture_control_set_ptr->parent_pcs_ptr->sequence_control_set_wrapper_ptr, 1);
+                    }
 
-                        // Get Empty Results Object
-                        eb_vp9_get_empty_object(context_ptr->picture_manager_output_fifo_ptr, &output_wrapper_ptr);
+                    // Get Empty Results Object
+                    eb_vp9_get_empty_object(context_ptr->picture_manager_output_fifo_ptr, &output_wrapper_ptr);
+                    if (output_wrapper_ptr == EB_NULL)
+                        return EB_NULL;
 
-                        rate_control_tasks_ptr = (RateControlTasks *)output_wrapper_ptr->object_ptr;
-                        rate_control_tasks_ptr->picture_control_set_wrapper_ptr = child_picture_control_set_wrapper_ptr;
-                        rate_control_tasks_ptr->task_type                       = RC_PICTURE_MANAGER_RESULT;
+                    rate_control_tasks_ptr = (RateControlTasks *)output_wrapper_ptr->object_ptr;
+                    rate_control_tasks_ptr->picture_control_set_wrapper_ptr = child_picture_control_set_wrapper_ptr;
+                    rate_control_tasks_ptr->task_type                       = RC_PICTURE_MANAGER_RESULT;
 
-                        // Post the Full Results Object
-                        eb_vp9_post_full_object(output_wrapper_ptr);
+                    // Post the Full Results Object
+                    eb_vp9_post_full_object(output_wrapper_ptr);
 
-                        // Remove the Input Entry from the Input Queue
-                        input_entry_ptr->input_object_ptr = (EbObjectWrapper *)EB_NULL;
-                    }
+                    // Remove the Input Entry from the Input Queue
+                    input_entry_ptr->input_object_ptr = (EbObjectWrapper *)EB_NULL;
+                } else {
+                    encode_context_ptr->input_ready_queue[ready_count++] = input_queue_index;
                 }
+            }
+            encode_context_ptr->input_ready_count = ready_count;
 
-                // Increment the head_index if the head is null
+            // Increment the head_index past the started pictures
+            while ((encode_context_ptr->input_picture_queue_head_index !=
+                    encode_context_ptr->input_picture_queue_tail_index) &&
+                   (encode_context_ptr->input_picture_queue[encode_context_ptr->input_picture_queue_head_index]
+                        ->input_object_ptr == EB_NULL)) {
                 encode_context_ptr->input_picture_queue_head_index =
-                    (encode_context_ptr->input_picture_queue[encode_context_ptr->input_picture_queue_head_index]
-                         ->input_object_ptr)
-                    ? encode_context_ptr->input_picture_queue_head_index
-                    : (encode_context_ptr->input_picture_queue_head_index == INPUT_QUEUE_MAX_DEPTH - 1)
+                    (encode_context_ptr->input_picture_queue_head_index == INPUT_QUEUE_MAX_DEPTH - 1)
                     ? 0
                     : encode_context_ptr->input_picture_queue_head_index + 1;
-
-                // Increment the input_queue_index Iterator
-                input_queue_index = (input_queue_index == INPUT_QUEUE_MAX_DEPTH - 1) ? 0 : input_queue_index + 1;
             }
 
-            // Walk the reference queue and remove entries that have been completely referenced.
-            reference_queue_index = encode_context_ptr->reference_picture_queue_head_index;
-            while (reference_queue_index != encode_context_ptr->reference_picture_queue_tail_index) {
-                reference_entry_ptr = encode_context_ptr->reference_picture_queue[reference_queue_index];
+            // Remove the entries, whose dependent count or availability changed, that have been completely referenced.
+            for (release_index = 0; release_index < encode_context_ptr->reference_release_count; ++release_index) {
+                reference_queue_index = encode_context_ptr->reference_release_queue[release_index];
+                reference_entry_ptr   = encode_context_ptr->reference_picture_queue[reference_queue_index];
+                reference_entry_ptr->release_pending = EB_FALSE;
 
                 // Remove the entry & release the reference if there are no remaining references
                 if ((reference_entry_ptr->dependent_count == 0) && (reference_entry_ptr->reference_available) &&
@@ -959,30 +1206,30 @@ void *eb_vp9_PictureManagerKernel(void *input_ptr) {
                     reference_entry_ptr->reference_available       = EB_FALSE;
                     reference_entry_ptr->is_used_as_reference_flag = EB_FALSE;
                 }
+            }
+            encode_context_ptr->reference_release_count = 0;
+
+#ifndef NDEBUG
+            // Before the head moves past the entries with no dependent, released or not
+            picture_manager_queues_check(encode_context_ptr);
+#endif
 
-                // Increment the head_index if the head is empty
+            // Increment the head_index past the empty entries
+            while (encode_context_ptr->reference_picture_queue_head_index !=
+                   encode_context_ptr->reference_picture_queue_tail_index) {
+                reference_entry_ptr =
+                    encode_context_ptr->reference_picture_queue[encode_context_ptr->reference_picture_queue_head_index];
+
+                if ((reference_entry_ptr->release_enable == EB_FALSE) ||
+                    (reference_entry_ptr->reference_available == EB_FALSE &&
+                     reference_entry_ptr->is_used_as_reference_flag == EB_TRUE) ||
+                    (reference_entry_ptr->dependent_count > 0)) {
+                    break;
+                }
                 encode_context_ptr->reference_picture_queue_head_index =
-                    (encode_context_ptr->reference_picture_queue[encode_context_ptr->reference_picture_queue_head_index]
-                         ->release_enable == EB_FALSE)
-                    ? encode_context_ptr->reference_picture_queue_head_index
-                    : (encode_context_ptr
-                               ->reference_picture_queue[encode_context_ptr->reference_picture_queue_head_index]
-                               ->reference_available == EB_FALSE &&
-                       encode_context_ptr
-                               ->reference_picture_queue[encode_context_ptr->reference_picture_queue_head_index]
-                               ->is_used_as_reference_flag == EB_TRUE)
-                    ? encode_context_ptr->reference_picture_queue_head_index
-                    : (encode_context_ptr
-                           ->reference_picture_queue[encode_context_ptr->reference_picture_queue_head_index]
-                           ->dependent_count > 0)
-                    ? encode_context_ptr->reference_picture_queue_head_index
-                    : (encode_context_ptr->reference_picture_queue_head_index == REFERENCE_QUEUE_MAX_DEPTH - 1)
+                    (encode_context_ptr->reference_picture_queue_head_index == REFERENCE_QUEUE_MAX_DEPTH - 1)
                     ? 0
                     : encode_context_ptr->reference_picture_queue_head_index + 1;
-                // Increment the reference_queue_index Iterator
-                reference_queue_index = (reference_queue_index == REFERENCE_QUEUE_MAX_DEPTH - 1)
-                    ? 0
-                    : reference_queue_index + 1;
             }
         }
 
@@ -18,6 +18,10 @@ EbErrorType eb_vp9_input_queue_entry_ctor(InputQueueEntry **entry_dbl_ptr) {
     entry_ptr->list0_ptr = (ReferenceList *)EB_NULL;
     entry_ptr->list1_ptr = (ReferenceList *)EB_NULL;
 
+    entry_ptr->unavailable_reference_count = 0;
+    entry_ptr->next_waiter[0]              = WAITER_NULL;
+    entry_ptr->next_waiter[1]              = WAITER_NULL;
+
     return EB_ErrorNone;
 }
 
@@ -30,6 +34,8 @@ EbErrorType eb_vp9_reference_queue_entry_ctor(ReferenceQueueEntry **entry_dbl_pt
     entry_ptr->picture_number       = ~0u;
     entry_ptr->dependent_count      = 0;
     entry_ptr->reference_available  = EB_FALSE;
+    entry_ptr->waiter_head          = WAITER_NULL;
+    entry_ptr->release_pending      = EB_FALSE;
 
     EB_MALLOC(int32_t *, entry_ptr->list0.list, sizeof(int32_t) * (1 << MAX_TEMPORAL_LAYERS), EB_N_PTR);
 
@@ -16,6 +16,9 @@
 #ifdef __cplusplus
 extern "C" {
 #endif
+// Waiter list link: (input queue index << 1) | reference list, WAITER_NULL ends the list
+#define WAITER_NULL (~0u)
+
 /************************************************
  * Input Queue Entry
  ************************************************/
@@ -27,6 +30,8 @@ typedef struct InputQueueEntry {
     uint32_t         reference_entry_index;
     ReferenceList   *list0_ptr;
     ReferenceList   *list1_ptr;
+    uint32_t         unavailable_reference_count; // references of the picture which are not completed yet
+    uint32_t         next_waiter[2]; // next waiter of the list0 / list1 reference
 
 } InputQueueEntry;
 
@@ -46,6 +51,8 @@ typedef struct ReferenceQueueEntry {
     DependentList    list1;
     EB_BOOL          is_used_as_reference_flag;
     EB_BOOL          feedback_arrived;
+    uint32_t         waiter_head; // input pictures waiting for the reference to be completed
+    EB_BOOL          release_pending; // queued for the release check of the current event
 } ReferenceQueueEntry;
 
 /************************************************
@@ -4,6 +4,7 @@
 */
 
 #include <stdlib.h>
+#include <math.h>
 
 #include "EbDefinitions.h"
 #include "EbRateControlProcess.h"
@@ -275,43 +276,35 @@ EbErrorType eb_vp9_high_level_eb_vp9_rate_control_context_ctor(HighLevelRateCont
     return EB_ErrorNone;
 }
 
+static void rate_control_layer_context_reset(RateControlLayerContext *entry_ptr) {
+    entry_ptr->first_frame           = 1;
+    entry_ptr->first_non_intra_frame = 1;
+    entry_ptr->feedback_arrived      = EB_FALSE;
+}
+
 EbErrorType eb_vp9_rate_control_layer_context_ctor(RateControlLayerContext **entry_dbl_ptr) {
     RateControlLayerContext *entry_ptr;
     EB_MALLOC(RateControlLayerContext *, entry_ptr, sizeof(RateControlLayerContext), EB_N_PTR);
 
     *entry_dbl_ptr = entry_ptr;
 
-    entry_ptr->first_frame           = 1;
-    entry_ptr->first_non_intra_frame = 1;
-    entry_ptr->feedback_arrived      = EB_FALSE;
+    rate_control_layer_context_reset(entry_ptr);
 
     return EB_ErrorNone;
 }
 
-EbErrorType eb_vp9_rate_control_interval_param_context_ctor(RateControlIntervalParamContext **entry_dbl_ptr) {
-    uint32_t                         temporal_index;
-    EbErrorType                      return_error = EB_ErrorNone;
-    RateControlIntervalParamContext *entry_ptr;
-    EB_MALLOC(RateControlIntervalParamContext *, entry_ptr, sizeof(RateControlIntervalParamContext), EB_N_PTR);
-
-    *entry_dbl_ptr = entry_ptr;
+static void rate_control_interval_param_context_reset(RateControlIntervalParamContext *entry_ptr) {
+    uint32_t temporal_index;
 
     entry_ptr->in_use                  = EB_FALSE;
     entry_ptr->was_used                = EB_FALSE;
     entry_ptr->last_gop                = EB_FALSE;
     entry_ptr->processed_frames_number = 0;
-    EB_MALLOC(RateControlLayerContext **,
-              entry_ptr->rate_control_layer_array,
-              sizeof(RateControlLayerContext *) * EB_MAX_TEMPORAL_LAYERS,
-              EB_N_PTR);
 
     for (temporal_index = 0; temporal_index < EB_MAX_TEMPORAL_LAYERS; temporal_index++) {
-        return_error = eb_vp9_rate_control_layer_context_ctor(&entry_ptr->rate_control_layer_array[temporal_index]);
+        rate_control_layer_context_reset(entry_ptr->rate_control_layer_array[temporal_index]);
         entry_ptr->rate_control_layer_array[temporal_index]->temporal_index = temporal_index;
         entry_ptr->rate_control_layer_array[temporal_index]->frame_rate     = 1 << RC_PRECISION;
-        if (return_error == EB_ErrorInsufficientResources) {
-            return EB_ErrorInsufficientResources;
-        }
     }
 
     entry_ptr->min_target_rate_assigned = EB_FALSE;
@@ -326,6 +319,29 @@ EbErrorType eb_vp9_rate_control_interval_param_context_ctor(RateControlIntervalP
     entry_ptr->first_pic_actual_qp_assigned = EB_FALSE;
     entry_ptr->scene_change_in_gop          = EB_FALSE;
     entry_ptr->extra_ap_bit_ratio_i         = 0;
+}
+
+EbErrorType eb_vp9_rate_control_interval_param_context_ctor(RateControlIntervalParamContext **entry_dbl_ptr) {
+    uint32_t                         temporal_index;
+    EbErrorType                      return_error = EB_ErrorNone;
+    RateControlIntervalParamContext *entry_ptr;
+    EB_MALLOC(RateControlIntervalParamContext *, entry_ptr, sizeof(RateControlIntervalParamContext), EB_N_PTR);
+
+    *entry_dbl_ptr = entry_ptr;
+
+    EB_MALLOC(RateControlLayerContext **,
+              entry_ptr->rate_control_layer_array,
+              sizeof(RateControlLayerContext *) * EB_MAX_TEMPORAL_LAYERS,
+              EB_N_PTR);
+
+    for (temporal_index = 0; temporal_index < EB_MAX_TEMPORAL_LAYERS; temporal_index++) {
+        return_error = eb_vp9_rate_control_layer_context_ctor(&entry_ptr->rate_control_layer_array[temporal_index]);
+        if (return_error == EB_ErrorInsufficientResources) {
+            return EB_ErrorInsufficientResources;
+        }
+    }
+
+    rate_control_interval_param_context_reset(entry_ptr);
 
     return EB_ErrorNone;
 }
@@ -346,7 +362,6 @@ EbErrorType eb_vp9_rate_control_coded_frames_stats_context_ctor(CodedFramesStats
 EbErrorType eb_vp9_rate_control_context_ctor(RateControlContext **context_dbl_ptr,
                                              EbFifo              *rate_control_input_tasks_fifo_ptr,
                                              EbFifo *rate_control_output_results_fifo_ptr, int32_t intra_period) {
-    uint32_t temporal_index;
     uint32_t interval_index;
 
 #if OVERSHOOT_STAT_PRINT
@@ -368,33 +383,14 @@ EbErrorType eb_vp9_rate_control_context_ctor(RateControlContext **context_dbl_pt
         return EB_ErrorInsufficientResources;
     }
 
-    for (temporal_index = 0; temporal_index < EB_MAX_TEMPORAL_LAYERS; temporal_index++) {
-        context_ptr->frames_in_interval[temporal_index] = 0;
-    }
-
-    for (temporal_index = 0; temporal_index < EB_MAX_TEMPORAL_LAYERS; temporal_index++) {
-        for (uint32_t base_qp = 0; base_qp < MAX_REF_QP_NUM; base_qp++) {
-            context_ptr->qp_scaling_map[temporal_index][base_qp] = 0;
-        }
-    }
-    for (uint32_t base_qp = 0; base_qp < MAX_REF_QP_NUM; base_qp++) {
-        context_ptr->qp_scaling_map_I_SLICE[base_qp] = 0;
-    }
-
     EB_MALLOC(RateControlIntervalParamContext **,
               context_ptr->rate_control_param_queue,
               sizeof(RateControlIntervalParamContext *) * PARALLEL_GOP_MAX_NUMBER,
               EB_N_PTR);
 
-    context_ptr->rate_control_param_queue_head_index = 0;
     for (interval_index = 0; interval_index < PARALLEL_GOP_MAX_NUMBER; interval_index++) {
         return_error = eb_vp9_rate_control_interval_param_context_ctor(
             &context_ptr->rate_control_param_queue[interval_index]);
-        context_ptr->rate_control_param_queue[interval_index]->first_poc = (interval_index *
-                                                                            (uint32_t)(intra_period + 1));
-        context_ptr->rate_control_param_queue[interval_index]->last_poc  = ((interval_index + 1) *
-                                                                           (uint32_t)(intra_period + 1)) -
-            1;
         if (return_error == EB_ErrorInsufficientResources) {
             return EB_ErrorInsufficientResources;
         }
@@ -421,6 +417,43 @@ EbErrorType eb_vp9_rate_control_context_ctor(RateControlContext **context_dbl_pt
     context_ptr->avg_bit_actual_per_gop = 0;
 #endif
 
+    eb_vp9_rate_control_context_reset(context_ptr, intra_period);
+
+    return EB_ErrorNone;
+}
+
+/**************************************
+ * eb_vp9_rate_control_context_reset
+ *   Puts the rate control state back to
+ *   the start of a sequence
+ **************************************/
+void eb_vp9_rate_control_context_reset(RateControlContext *context_ptr, int32_t intra_period) {
+    uint32_t temporal_index;
+    uint32_t interval_index;
+
+    for (temporal_index = 0; temporal_index < EB_MAX_TEMPORAL_LAYERS; temporal_index++) {
+        context_ptr->frames_in_interval[temporal_index] = 0;
+    }
+
+    for (temporal_index = 0; temporal_index < EB_MAX_TEMPORAL_LAYERS; temporal_index++) {
+        for (uint32_t base_qp = 0; base_qp < MAX_REF_QP_NUM; base_qp++) {
+            context_ptr->qp_scaling_map[temporal_index][base_qp] = 0;
+        }
+    }
+    for (uint32_t base_qp = 0; base_qp < MAX_REF_QP_NUM; base_qp++) {
+        context_ptr->qp_scaling_map_I_SLICE[base_qp] = 0;
+    }
+
+    context_ptr->rate_control_param_queue_head_index = 0;
+    for (interval_index = 0; interval_index < PARALLEL_GOP_MAX_NUMBER; interval_index++) {
+        rate_control_interval_param_context_reset(context_ptr->rate_control_param_queue[interval_index]);
+        context_ptr->rate_control_param_queue[interval_index]->first_poc = (interval_index *
+                                                                            (uint32_t)(intra_period + 1));
+        context_ptr->rate_control_param_queue[interval_index]->last_poc  = ((interval_index + 1) *
+                                                                           (uint32_t)(intra_period + 1)) -
+            1;
+    }
+
     context_ptr->base_layer_frames_avg_qp       = 0;
     context_ptr->base_layer_intra_frames_avg_qp = 0;
 
@@ -428,8 +461,6 @@ EbErrorType eb_vp9_rate_control_context_ctor(RateControlContext **context_dbl_pt
     context_ptr->extra_bits               = 0;
     context_ptr->extra_bits_gen           = 0;
     context_ptr->max_rate_adjust_delta_qp = 0;
-
-    return EB_ErrorNone;
 }
 void eb_vp9_high_level_rc_input_picture_vbr(PictureParentControlSet *picture_control_set_ptr,
                                             SequenceControlSet      *sequence_control_set_ptr,
@@ -4234,9 +4265,9 @@ void eb_vp9_rate_control_refinement(PictureControlSet               *picture_con
         }
     }
 }
-// initialize the rate control parameter at the beginning
-void eb_vp9_init_rc(RateControlContext *context_ptr, PictureControlSet *picture_control_set_ptr,
-                    SequenceControlSet *sequence_control_set_ptr) {
+// derive the per frame and per sliding window budgets from the target rate
+static void rate_control_set_high_level_targets(RateControlContext *context_ptr,
+                                                SequenceControlSet *sequence_control_set_ptr) {
     context_ptr->high_level_rate_control_ptr->target_bit_rate = sequence_control_set_ptr->static_config.target_bit_rate;
     context_ptr->high_level_rate_control_ptr->frame_rate      = sequence_control_set_ptr->frame_rate;
     context_ptr->high_level_rate_control_ptr->channel_bit_rate_per_frame = (uint64_t)MAX(
@@ -4254,51 +4285,60 @@ void eb_vp9_init_rc(RateControlContext *context_ptr, PictureControlSet *picture_
     context_ptr->high_level_rate_control_ptr->previous_updated_bit_constraint_per_sw =
         context_ptr->high_level_rate_control_ptr->channel_bit_rate_per_sw;
 #endif
+}
 
-    int32_t  total_frame_in_interval = sequence_control_set_ptr->intra_period;
-    uint32_t gopPeriod               = (1 << picture_control_set_ptr->parent_pcs_ptr->hierarchical_levels);
-    context_ptr->frame_rate          = sequence_control_set_ptr->frame_rate;
-    while (total_frame_in_interval >= 0) {
-        if (total_frame_in_interval % (gopPeriod) == 0)
-            context_ptr->frames_in_interval[0]++;
-        else if (total_frame_in_interval % (gopPeriod >> 1) == 0)
-            context_ptr->frames_in_interval[1]++;
-        else if (total_frame_in_interval % (gopPeriod >> 2) == 0)
-            context_ptr->frames_in_interval[2]++;
-        else if (total_frame_in_interval % (gopPeriod >> 3) == 0)
-            context_ptr->frames_in_interval[3]++;
-        else if (total_frame_in_interval % (gopPeriod >> 4) == 0)
-            context_ptr->frames_in_interval[4]++;
-        else if (total_frame_in_interval % (gopPeriod >> 5) == 0)
-            context_ptr->frames_in_interval[5]++;
-        total_frame_in_interval--;
-    }
+// derive the virtual buffer size and its fill thresholds from the target rate
+static void rate_control_set_virtual_buffer(RateControlContext *context_ptr,
+                                            SequenceControlSet *sequence_control_set_ptr) {
+    context_ptr->frame_rate = sequence_control_set_ptr->frame_rate;
     if (sequence_control_set_ptr->static_config.rate_control_mode == 1) { // VBR
         context_ptr->virtual_buffer_size = (((uint64_t)sequence_control_set_ptr->static_config.target_bit_rate * 3)
                                             << RC_PRECISION) /
             (context_ptr->frame_rate);
         context_ptr->rate_average_periodin_frames = (uint64_t)sequence_control_set_ptr->static_config.intra_period + 1;
         context_ptr->virtual_buffer_level_initial_value = context_ptr->virtual_buffer_size >> 1;
-        context_ptr->virtual_buffer_level               = context_ptr->virtual_buffer_size >> 1;
-        context_ptr->previous_virtual_buffer_level      = context_ptr->virtual_buffer_size >> 1;
         context_ptr->vb_fill_threshold1                 = (context_ptr->virtual_buffer_size * 6) >> 3;
         context_ptr->vb_fill_threshold2                 = (context_ptr->virtual_buffer_size << 3) >> 3;
-        context_ptr->base_layer_frames_avg_qp           = sequence_control_set_ptr->qp;
-        context_ptr->base_layer_intra_frames_avg_qp     = sequence_control_set_ptr->qp;
     } else { // CBR
         context_ptr->virtual_buffer_size =
             ((uint64_t)sequence_control_set_ptr->static_config.target_bit_rate); // vbv_buf_size);
         context_ptr->rate_average_periodin_frames = (uint64_t)sequence_control_set_ptr->static_config.intra_period + 1;
         context_ptr->virtual_buffer_level_initial_value = context_ptr->virtual_buffer_size >> 1;
-        context_ptr->virtual_buffer_level               = context_ptr->virtual_buffer_size >> 1;
-        context_ptr->previous_virtual_buffer_level      = context_ptr->virtual_buffer_size >> 1;
         context_ptr->vb_fill_threshold1                 = context_ptr->virtual_buffer_level_initial_value +
             (context_ptr->virtual_buffer_size / 4);
         context_ptr->vb_fill_threshold2 = context_ptr->virtual_buffer_level_initial_value +
             (context_ptr->virtual_buffer_size / 3);
-        context_ptr->base_layer_frames_avg_qp       = sequence_control_set_ptr->qp;
-        context_ptr->base_layer_intra_frames_avg_qp = sequence_control_set_ptr->qp;
     }
+}
+
+// initialize the rate control parameter at the beginning
+void eb_vp9_init_rc(RateControlContext *context_ptr, PictureControlSet *picture_control_set_ptr,
+                    SequenceControlSet *sequence_control_set_ptr) {
+    rate_control_set_high_level_targets(context_ptr, sequence_control_set_ptr);
+
+    int32_t  total_frame_in_interval = sequence_control_set_ptr->intra_period;
+    uint32_t gopPeriod               = (1 << picture_control_set_ptr->parent_pcs_ptr->hierarchical_levels);
+    context_ptr->frame_rate          = sequence_control_set_ptr->frame_rate;
+    while (total_frame_in_interval >= 0) {
+        if (total_frame_in_interval % (gopPeriod) == 0)
+            context_ptr->frames_in_interval[0]++;
+        else if (total_frame_in_interval % (gopPeriod >> 1) == 0)
+            context_ptr->frames_in_interval[1]++;
+        else if (total_frame_in_interval % (gopPeriod >> 2) == 0)
+            context_ptr->frames_in_interval[2]++;
+        else if (total_frame_in_interval % (gopPeriod >> 3) == 0)
+            context_ptr->frames_in_interval[3]++;
+        else if (total_frame_in_interval % (gopPeriod >> 4) == 0)
+            context_ptr->frames_in_interval[4]++;
+        else if (total_frame_in_interval % (gopPeriod >> 5) == 0)
+            context_ptr->frames_in_interval[5]++;
+        total_frame_in_interval--;
+    }
+    rate_control_set_virtual_buffer(context_ptr, sequence_control_set_ptr);
+    context_ptr->virtual_buffer_level           = context_ptr->virtual_buffer_size >> 1;
+    context_ptr->previous_virtual_buffer_level  = context_ptr->virtual_buffer_size >> 1;
+    context_ptr->base_layer_frames_avg_qp       = sequence_control_set_ptr->qp;
+    context_ptr->base_layer_intra_frames_avg_qp = sequence_control_set_ptr->qp;
 
     for (uint32_t base_qp = 0; base_qp < MAX_REF_QP_NUM; base_qp++) {
         if (base_qp < 64) {
@@ -4321,6 +4361,65 @@ void eb_vp9_init_rc(RateControlContext *context_ptr, PictureControlSet *picture_
     }
 }
 
+// follow a runtime update of the target rate, frame rate or VBV: the budgets of the intervals in flight and the
+// virtual buffer levels are rescaled so the feedback state carries over to the new targets
+static void rate_control_update_targets(RateControlContext *context_ptr, SequenceControlSet *sequence_control_set_ptr,
+                                        EncodeContext *encode_context_ptr) {
+    uint64_t previous_target_bit_rate = context_ptr->high_level_rate_control_ptr->target_bit_rate;
+    uint64_t previous_frame_rate      = context_ptr->frame_rate;
+    uint64_t previous_buffer_size     = context_ptr->virtual_buffer_size;
+    double   rate_ratio;
+    double   frame_rate_ratio;
+    double   buffer_ratio;
+    uint32_t interval_index;
+    uint32_t temporal_index;
+
+    rate_control_set_high_level_targets(context_ptr, sequence_control_set_ptr);
+    rate_control_set_virtual_buffer(context_ptr, sequence_control_set_ptr);
+
+    rate_ratio = (double)context_ptr->high_level_rate_control_ptr->target_bit_rate /
+        (double)MAX(previous_target_bit_rate, 1);
+    frame_rate_ratio = (double)context_ptr->frame_rate / (double)MAX(previous_frame_rate, 1);
+    buffer_ratio     = (double)context_ptr->virtual_buffer_size / (double)MAX(previous_buffer_size, 1);
+
+    context_ptr->virtual_buffer_level          = (int64_t)(context_ptr->virtual_buffer_level * buffer_ratio);
+    context_ptr->previous_virtual_buffer_level = (int64_t)(context_ptr->previous_virtual_buffer_level * buffer_ratio);
+
+    for (interval_index = 0; interval_index < PARALLEL_GOP_MAX_NUMBER; interval_index++) {
+        RateControlIntervalParamContext *rate_control_param_ptr = context_ptr->rate_control_param_queue[interval_index];
+        if (!rate_control_param_ptr->in_use)
+            continue;
+        rate_control_param_ptr->virtual_buffer_level = (int64_t)(rate_control_param_ptr->virtual_buffer_level *
+                                                                 buffer_ratio);
+        rate_control_param_ptr->previous_virtual_buffer_level =
+            (int64_t)(rate_control_param_ptr->previous_virtual_buffer_level * buffer_ratio);
+
+        for (temporal_index = 0; temporal_index < EB_MAX_TEMPORAL_LAYERS; temporal_index++) {
+            RateControlLayerContext *rate_control_layer_ptr =
+                rate_control_param_ptr->rate_control_layer_array[temporal_index];
+            // The bits per frame follow the rate over the frame rate
+            double bits_ratio = rate_ratio / frame_rate_ratio;
+
+            rate_control_layer_ptr->target_bit_rate = (uint64_t)(rate_control_layer_ptr->target_bit_rate * rate_ratio);
+            rate_control_layer_ptr->frame_rate      = (uint64_t)MAX(
+                1, (int64_t)(rate_control_layer_ptr->frame_rate * frame_rate_ratio));
+            rate_control_layer_ptr->channel_bit_rate = (uint64_t)MAX(
+                1, (int64_t)(rate_control_layer_ptr->channel_bit_rate * bits_ratio));
+            rate_control_layer_ptr->previous_bit_constraint = (uint64_t)(
+                rate_control_layer_ptr->previous_bit_constraint * bits_ratio);
+            rate_control_layer_ptr->bit_constraint    = (uint64_t)(rate_control_layer_ptr->bit_constraint * bits_ratio);
+            rate_control_layer_ptr->ec_bit_constraint = (uint64_t)MAX(
+                1, (int64_t)(rate_control_layer_ptr->ec_bit_constraint * bits_ratio));
+        }
+    }
+
+    // VBV: keep the fill, bounded by the new size
+    encode_context_ptr->available_target_bitrate = sequence_control_set_ptr->static_config.target_bit_rate;
+    encode_context_ptr->vbv_max_rate             = sequence_control_set_ptr->static_config.vbv_max_rate;
+    encode_context_ptr->vbv_buf_size             = sequence_control_set_ptr->static_config.vbv_buf_size;
+    encode_context_ptr->buffer_fill              = MIN(encode_context_ptr->buffer_fill, encode_context_ptr->vbv_buf_size);
+}
+
 uint64_t predictBits(SequenceControlSet *sequence_control_set_ptr, EncodeContext *encode_context_ptr,
                      HlRateControlHistogramEntry *hlRateControl_histogram_ptr_temp, uint32_t qp) {
     uint64_t total_bits = 0;
@@ -4470,6 +4569,46 @@ uint8_t Vbv_Buf_Calc(PictureControlSet *picture_control_set_ptr, SequenceControl
     return (uint8_t)q;
 }
 
+/****************************************************************************************
+* crf_picture_qindex
+* Constant Rate Factor: adapts the fixed QP qindex of the picture to its complexity, the
+* spatial variance from the picture analysis, restricted to the moving area for the
+* inter pictures, then caps it with the VBV buffer fill when a max rate is set. No
+* feedback is waited for, the buffer fill is the one of the pictures already packetized
+****************************************************************************************/
+static int crf_picture_qindex(PictureControlSet *picture_control_set_ptr, SequenceControlSet *sequence_control_set_ptr,
+                              EncodeContext *encode_context_ptr, int qindex) {
+    PictureParentControlSet *parent_pcs_ptr = picture_control_set_ptr->parent_pcs_ptr;
+    const vpx_bit_depth_t    bit_depth = (vpx_bit_depth_t)sequence_control_set_ptr->static_config.encoder_bit_depth;
+    const double             q         = eb_vp9_convert_qindex_to_q(qindex, bit_depth);
+    double                   complexity = parent_pcs_ptr->pic_avg_variance;
+    double                   q_ratio;
+    RATE_CONTROL             rc;
+    rc.worst_quality = MAXQ;
+    rc.best_quality  = MINQ;
+
+    if (picture_control_set_ptr->slice_type != I_SLICE &&
+        parent_pcs_ptr->non_moving_average_score != INVALID_NON_MOVING_SCORE) {
+        complexity = complexity * MAX(parent_pcs_ptr->non_moving_average_score, 1) / NON_MOVING_SCORE_3;
+    }
+    q_ratio = pow(MAX(complexity, 1) / CRF_REFERENCE_COMPLEXITY, CRF_COMPLEXITY_EXPONENT);
+    q_ratio = CLIP3(CRF_MIN_Q_RATIO, CRF_MAX_Q_RATIO, q_ratio);
+
+    if (encode_context_ptr->vbv_max_rate && encode_context_ptr->vbv_buf_size) {
+        double fill;
+        eb_vp9_block_on_mutex(encode_context_ptr->sc_buffer_mutex);
+        fill = (double)encode_context_ptr->buffer_fill / encode_context_ptr->vbv_buf_size;
+        eb_vp9_release_mutex(encode_context_ptr->sc_buffer_mutex);
+        if (fill < CRF_VBV_FILL_THRESHOLD)
+            q_ratio *= MIN(sqrt(CRF_VBV_FILL_THRESHOLD / MAX(fill, 0.01)), CRF_VBV_MAX_Q_RATIO);
+    }
+
+    qindex += eb_vp9_compute_qdelta(&rc, q, q * q_ratio, bit_depth);
+    return CLIP3(eb_vp9_quantizer_to_qindex(sequence_control_set_ptr->static_config.min_qp_allowed),
+                 eb_vp9_quantizer_to_qindex(sequence_control_set_ptr->static_config.max_qp_allowed),
+                 qindex);
+}
+
 void *eb_vp9_rate_control_kernel(void *input_ptr) {
     // Context
     RateControlContext *context_ptr = (RateControlContext *)input_ptr;
@@ -4503,6 +4642,8 @@ void *eb_vp9_rate_control_kernel(void *input_ptr) {
     for (;;) {
         // Get RateControl Task
         eb_vp9_get_full_object(context_ptr->rate_control_input_tasks_fifo_ptr, &rate_control_tasks_wrapper_ptr);
+        if (rate_control_tasks_wrapper_ptr == EB_NULL)
+            return EB_NULL;
 
         rate_control_tasks_ptr = (RateControlTasks *)rate_control_tasks_wrapper_ptr->object_ptr;
         task_type              = rate_control_tasks_ptr->task_type;
@@ -4516,7 +4657,8 @@ void *eb_vp9_rate_control_kernel(void *input_ptr) {
             sequence_control_set_ptr = (SequenceControlSet *)
                                            picture_control_set_ptr->sequence_control_set_wrapper_ptr->object_ptr;
             encode_context_ptr = (EncodeContext *)sequence_control_set_ptr->encode_context_ptr;
-            if (sequence_control_set_ptr->static_config.rate_control_mode) {
+            if (sequence_control_set_ptr->static_config.rate_control_mode == 1 ||
+                sequence_control_set_ptr->static_config.rate_control_mode == 2) {
                 if (picture_control_set_ptr->picture_number == 0) {
                     //init rate control parameters
                     eb_vp9_init_rc(context_ptr, picture_control_set_ptr, sequence_control_set_ptr);
@@ -4524,6 +4666,13 @@ void *eb_vp9_rate_control_kernel(void *input_ptr) {
                                                                  0.9);
                     encode_context_ptr->vbv_max_rate = sequence_control_set_ptr->static_config.vbv_max_rate;
                     encode_context_ptr->vbv_buf_size = sequence_control_set_ptr->static_config.vbv_buf_size;
+                } else if (sequence_control_set_ptr->static_config.target_bit_rate !=
+                               context_ptr->high_level_rate_control_ptr->target_bit_rate ||
+                           sequence_control_set_ptr->frame_rate != context_ptr->frame_rate ||
+                           sequence_control_set_ptr->static_config.vbv_max_rate != encode_context_ptr->vbv_max_rate ||
+                           sequence_control_set_ptr->static_config.vbv_buf_size != encode_context_ptr->vbv_buf_size) {
+                    // The targets were updated at runtime
+                    rate_control_update_targets(context_ptr, sequence_control_set_ptr, encode_context_ptr);
                 }
 
                 picture_control_set_ptr->parent_pcs_ptr->intra_selected_org_qp = 0;
@@ -4540,11 +4689,22 @@ void *eb_vp9_rate_control_kernel(void *input_ptr) {
                                                     sequence_control_set_ptr->encode_context_ptr,
                                                     context_ptr,
                                                     context_ptr->high_level_rate_control_ptr);
+            } else if (sequence_control_set_ptr->static_config.rate_control_mode == 3) {
+                // CRF has no bitrate target, the VBV only caps the rate when set
+                if (picture_control_set_ptr->picture_number == 0 ||
+                    sequence_control_set_ptr->static_config.vbv_max_rate != encode_context_ptr->vbv_max_rate ||
+                    sequence_control_set_ptr->static_config.vbv_buf_size != encode_context_ptr->vbv_buf_size) {
+                    encode_context_ptr->buffer_fill  = (uint64_t)(sequence_control_set_ptr->static_config.vbv_buf_size *
+                                                                 0.9);
+                    encode_context_ptr->vbv_max_rate = sequence_control_set_ptr->static_config.vbv_max_rate;
+                    encode_context_ptr->vbv_buf_size = sequence_control_set_ptr->static_config.vbv_buf_size;
+                }
             }
 
             // Frame level RC. Find the ParamPtr for the current GOP
             if (sequence_control_set_ptr->intra_period == -1 ||
-                sequence_control_set_ptr->static_config.rate_control_mode == 0) {
+                sequence_control_set_ptr->static_config.rate_control_mode == 0 ||
+                sequence_control_set_ptr->static_config.rate_control_mode == 3) {
                 rate_control_param_ptr          = context_ptr->rate_control_param_queue[0];
                 prev_gop_rate_control_param_ptr = context_ptr->rate_control_param_queue[0];
                 next_gop_rate_control_param_ptr = context_ptr->rate_control_param_queue[0];
@@ -4578,9 +4738,11 @@ void *eb_vp9_rate_control_kernel(void *input_ptr) {
             rate_control_layer_ptr =
                 rate_control_param_ptr->rate_control_layer_array[picture_control_set_ptr->temporal_layer_index];
 
-            if (sequence_control_set_ptr->static_config.rate_control_mode == 0) {
+            if (sequence_control_set_ptr->static_config.rate_control_mode == 0 ||
+                sequence_control_set_ptr->static_config.rate_control_mode == 3) {
                 // if RC mode is 0,  fixed QP is used
                 // QP scaling based on POC number for Flat IPPP structure
+                // CRF (RC mode 3) starts from the same QP, then adapts it to the picture complexity
 
                 if (sequence_control_set_ptr->enable_qp_scaling_flag &&
                     picture_control_set_ptr->parent_pcs_ptr->qp_on_the_fly == EB_FALSE) {
@@ -4735,6 +4897,17 @@ void *eb_vp9_rate_control_kernel(void *input_ptr) {
                             picture_control_set_ptr->picture_qp);
                 }
 
+                if (sequence_control_set_ptr->static_config.rate_control_mode == 3 &&
+                    picture_control_set_ptr->parent_pcs_ptr->qp_on_the_fly == EB_FALSE) {
+                    picture_control_set_ptr->parent_pcs_ptr->cpi->common.base_qindex =
+                        picture_control_set_ptr->base_qindex = crf_picture_qindex(
+                            picture_control_set_ptr,
+                            sequence_control_set_ptr,
+                            encode_context_ptr,
+                            picture_control_set_ptr->base_qindex);
+                    picture_control_set_ptr->picture_qp = (uint8_t)eb_vp9_qindex_to_quantizer(
+                        picture_control_set_ptr->base_qindex);
+                }
             } else {
                 // ***Rate Control***
                 if (sequence_control_set_ptr->static_config.rate_control_mode == 1) {
@@ -4766,7 +4939,8 @@ void *eb_vp9_rate_control_kernel(void *input_ptr) {
                     picture_control_set_ptr->base_qindex = eb_vp9_quantizer_to_qindex(
                         picture_control_set_ptr->picture_qp);
             }
-            if (encode_context_ptr->vbv_buf_size && encode_context_ptr->vbv_max_rate) {
+            if (sequence_control_set_ptr->static_config.rate_control_mode != 3 && encode_context_ptr->vbv_buf_size &&
+                encode_context_ptr->vbv_max_rate) {
                 eb_vp9_block_on_mutex(encode_context_ptr->sc_buffer_mutex);
                 picture_control_set_ptr->picture_qp = (uint8_t)Vbv_Buf_Calc(
                     picture_control_set_ptr, sequence_control_set_ptr, encode_context_ptr);
@@ -4820,6 +4994,8 @@ void *eb_vp9_rate_control_kernel(void *input_ptr) {
             // Get Empty Rate Control Results Buffer
             eb_vp9_get_empty_object(context_ptr->rate_control_output_results_fifo_ptr,
                                     &rate_control_results_wrapper_ptr);
+            if (rate_control_results_wrapper_ptr == EB_NULL)
+                return EB_NULL;
             rate_control_results_ptr = (RateControlResults *)rate_control_results_wrapper_ptr->object_ptr;
             rate_control_results_ptr->picture_control_set_wrapper_ptr =
                 rate_control_tasks_ptr->picture_control_set_wrapper_ptr;
@@ -4843,7 +5019,8 @@ void *eb_vp9_rate_control_kernel(void *input_ptr) {
 
             // Update feedback arrived in referencepictureQueue
             //  SVT_LOG("RC FEEDBACK ARRIVED %d\n", (int)parentpicture_control_set_ptr->picture_number);
-            if (sequence_control_set_ptr->static_config.rate_control_mode) {
+            if (sequence_control_set_ptr->static_config.rate_control_mode == 1 ||
+                sequence_control_set_ptr->static_config.rate_control_mode == 2) {
                 ReferenceQueueEntry *reference_entry_ptr;
                 uint32_t             reference_queue_index;
                 EncodeContext       *encode_context_ptr = sequence_control_set_ptr->encode_context_ptr;
@@ -4867,7 +5044,8 @@ void *eb_vp9_rate_control_kernel(void *input_ptr) {
             }
             // Frame level RC
             if (sequence_control_set_ptr->intra_period == -1 ||
-                sequence_control_set_ptr->static_config.rate_control_mode == 0) {
+                sequence_control_set_ptr->static_config.rate_control_mode == 0 ||
+                sequence_control_set_ptr->static_config.rate_control_mode == 3) {
                 rate_control_param_ptr          = context_ptr->rate_control_param_queue[0];
                 prev_gop_rate_control_param_ptr = context_ptr->rate_control_param_queue[0];
                 if (parentpicture_control_set_ptr->slice_type == I_SLICE) {
@@ -4903,7 +5081,8 @@ void *eb_vp9_rate_control_kernel(void *input_ptr) {
                     ? context_ptr->rate_control_param_queue[PARALLEL_GOP_MAX_NUMBER - 1]
                     : context_ptr->rate_control_param_queue[interval_index_temp - 1];
             }
-            if (sequence_control_set_ptr->static_config.rate_control_mode != 0) {
+            if (sequence_control_set_ptr->static_config.rate_control_mode == 1 ||
+                sequence_control_set_ptr->static_config.rate_control_mode == 2) {
                 context_ptr->previous_virtual_buffer_level = context_ptr->virtual_buffer_level;
 
                 context_ptr->virtual_buffer_level = (int64_t)context_ptr->previous_virtual_buffer_level +
@@ -30,6 +30,16 @@
 #define ADAPTIVE_PERCENTAGE 1
 #define RC_UPDATE_TARGET_RATE 1
 
+// CRF: the quantizer of a picture follows its complexity to the power CRF_COMPLEXITY_EXPONENT (1 - qcomp),
+// relative to the complexity the CRF level is tuned for
+#define CRF_REFERENCE_COMPLEXITY 2000.0
+#define CRF_COMPLEXITY_EXPONENT 0.2
+#define CRF_MIN_Q_RATIO 0.7
+#define CRF_MAX_Q_RATIO 1.4
+// CRF VBV cap: below this buffer fill the quantizer grows with the lacking fill, up to CRF_VBV_MAX_Q_RATIO
+#define CRF_VBV_FILL_THRESHOLD 0.5
+#define CRF_VBV_MAX_Q_RATIO 3.0
+
 static const uint32_t rate_percentage_layer_array[EB_MAX_TEMPORAL_LAYERS][EB_MAX_TEMPORAL_LAYERS] = {
     {100, 0, 0, 0, 0, 0},
     {70, 30, 0, 0, 0, 0},
@@ -235,6 +245,8 @@ extern EbErrorType eb_vp9_rate_control_context_ctor(RateControlContext **context
                                                     EbFifo              *rate_control_input_tasks_fifo_ptr,
                                                     EbFifo *rate_control_output_results_fifo_ptr, int32_t intra_period);
 
+extern void eb_vp9_rate_control_context_reset(RateControlContext *context_ptr, int32_t intra_period);
+
 extern void *eb_vp9_rate_control_kernel(void *input_ptr);
 
 #endif // EbRateControl_h
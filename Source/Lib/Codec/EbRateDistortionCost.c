@@ -127,15 +127,35 @@ int coeff_rate_estimate( //cost_coeffs
             if (band_left)
                 cost += (*token_costs)[0][!prev_t][EOB_TOKEN];
 
+        } else if (eob == 1) { // !use_fast_coef_costing, dc only
+            int16_t tok;
+
+            // dc token
+            cost = vp9_get_token_cost(qcoeff[0], &tok, cat6_high_cost);
+            cost += (*token_costs)[0][pt][tok];
+
+            token_cache[0] = eb_vp9_pt_energy_class[tok];
+            ++token_costs;
+
+            // eob token (band 1 holds more than one coeff)
+            pt = get_coef_context(nb, token_cache, 1);
+            cost += (*token_costs)[0][pt][EOB_TOKEN];
+
         } else { // !use_fast_coef_costing
             int band_left = *band_count++;
             int c;
 
-            // dc token
-            int     v = qcoeff[0];
-            int16_t tok;
+            // Tokens and value costs in bulk, the context dependent costs are accumulated below
+            uint8_t tokens[32 * 32];
+            int     tok;
             unsigned int (*tok_cost_ptr)[COEFF_CONTEXTS][ENTROPY_TOKENS];
-            cost = vp9_get_token_cost(v, &tok, cat6_high_cost);
+            cost = (eob <= COEFF_TOKENIZE_LOW_EOB)
+                ? eb_vp9_coeff_tokenize(qcoeff, scan, eob, cat6_high_cost, tokens)
+                : coeff_tokenize_func_ptr_array[(eb_vp9_ASM_TYPES & AVX2_MASK) && 1](
+                      qcoeff, scan, eob, cat6_high_cost, tokens);
+
+            // dc token
+            tok = tokens[0];
             cost += (*token_costs)[0][pt][tok];
 
             token_cache[0] = eb_vp9_pt_energy_class[tok];
@@ -147,9 +167,8 @@ int coeff_rate_estimate( //cost_coeffs
             for (c = 1; c < eob; c++) {
                 const int rc = scan[c];
 
-                v = qcoeff[rc];
-                cost += vp9_get_token_cost(v, &tok, cat6_high_cost);
-                pt = get_coef_context(nb, token_cache, c);
+                tok = tokens[c];
+                pt  = get_coef_context(nb, token_cache, c);
                 cost += (*tok_cost_ptr)[pt][tok];
                 token_cache[rc] = eb_vp9_pt_energy_class[tok];
                 if (!--band_left) {
@@ -12,11 +12,25 @@
 #include "EbIntraPrediction.h"
 
 #include "EbEncDecProcess.h"
+#include "EbRateDistortionCost_C.h"
+#include "EbRateDistortionCost_AVX2.h"
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+// Up to this eob the coeffs are tokenized in C (not worth the SIMD setup)
+#define COEFF_TOKENIZE_LOW_EOB 16
+
+typedef int (*EbCoeffTokenizeFunc)(const int16_t *qcoeff, const int16_t *scan, int eob,
+                                   const uint16_t *cat6_high_cost, uint8_t *tokens);
+
+static const EbCoeffTokenizeFunc coeff_tokenize_func_ptr_array[ASM_TYPE_TOTAL] = {
+    // C_DEFAULT
+    eb_vp9_coeff_tokenize,
+    // AVX2
+    eb_vp9_coeff_tokenize_avx2_intrin};
+
 #if VP9_RD
 extern void estimate_ref_frame_costs(const VP9_COMMON *cm, const MACROBLOCKD *xd, int segment_id,
                                      uint32_t *ref_costs_single, uint32_t *ref_costs_comp, vpx_prob *comp_mode_p);
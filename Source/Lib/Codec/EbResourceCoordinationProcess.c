@@ -26,6 +26,9 @@
 #include "vp9_entropy.h"
 #include "vp9_encodemv.h"
 #include "vp9_ratectrl.h"
+#if SEG_SUPPORT
+#include "vp9_segmentation.h"
+#endif
 
 /************************************************
  * Resource Coordination Context Constructor
@@ -36,8 +39,6 @@ EbErrorType eb_vp9_resource_coordination_context_ctor(
     EbSequenceControlSetInstance **sequence_control_set_instance_array, EbFifo *sequence_control_set_empty_fifo_ptr,
     EbCallback **app_callback_ptr_array, uint32_t *compute_segments_total_count_array,
     uint32_t encode_instances_total_count) {
-    uint32_t instance_index;
-
     ResourceCoordinationContext *context_ptr;
     EB_MALLOC(ResourceCoordinationContext *, context_ptr, sizeof(ResourceCoordinationContext), EB_N_PTR);
 
@@ -58,229 +59,165 @@ EbErrorType eb_vp9_resource_coordination_context_ctor(
               sizeof(EbObjectWrapper *) * context_ptr->encode_instances_total_count,
               EB_N_PTR);
 
-    for (instance_index = 0; instance_index < context_ptr->encode_instances_total_count; ++instance_index) {
-        context_ptr->sequence_control_set_active_array[instance_index] = 0;
-    }
-
     // Picture Stats
     EB_MALLOC(uint64_t *,
               context_ptr->picture_number_array,
               sizeof(uint64_t) * context_ptr->encode_instances_total_count,
               EB_N_PTR);
 
+    eb_vp9_resource_coordination_context_reset(context_ptr);
+
+    return EB_ErrorNone;
+}
+
+/************************************************
+ * Resource Coordination Context Reset
+ *   Restarts the picture numbering and the speed
+ *   control, the active SequenceControlSet is
+ *   picked again with the next input picture
+ ************************************************/
+void eb_vp9_resource_coordination_context_reset(ResourceCoordinationContext *context_ptr) {
+    uint32_t instance_index;
+
     for (instance_index = 0; instance_index < context_ptr->encode_instances_total_count; ++instance_index) {
-        context_ptr->picture_number_array[instance_index] = 0;
+        context_ptr->sequence_control_set_active_array[instance_index] = 0;
+        context_ptr->picture_number_array[instance_index]              = 0;
     }
 
-    context_ptr->average_enc_mod                    = 0;
-    context_ptr->prev_enc_mod                       = 0;
-    context_ptr->prev_enc_mode_delta                = 0;
-    context_ptr->cur_speed                          = 0; // speed x 1000
-    context_ptr->previous_mode_change_buffer        = 0;
     context_ptr->first_in_pic_arrived_time_seconds  = 0;
     context_ptr->first_in_pic_arrived_timeu_seconds = 0;
-    context_ptr->previous_frame_in_check1           = 0;
-    context_ptr->previous_frame_in_check2           = 0;
-    context_ptr->previous_frame_in_check3           = 0;
-    context_ptr->previous_mode_change_frame_in      = 0;
-    context_ptr->prevs_time_seconds                 = 0;
-    context_ptr->prevs_timeu_seconds                = 0;
+    context_ptr->prev_frame_in                      = 0;
     context_ptr->prev_frame_out                     = 0;
-    context_ptr->start_flag                         = EB_FALSE;
-    context_ptr->previous_buffer_check1             = 0;
-    context_ptr->prev_change_cond                   = 0;
-
-    return EB_ErrorNone;
+    context_ptr->prev_buffer                        = 0;
+    context_ptr->prev_me_busy_time                  = 0;
+    context_ptr->prev_enc_dec_busy_time             = 0;
+    context_ptr->prev_change_frame_in               = 0;
 }
 
 //******************************************************************************//
-// Modify the Enc mode based on the buffer Status
-// Inputs: TargetSpeed, Status of the sc_buffer
-// Output: EncMod
+// Modify the Enc mode and the speed control knobs based on the measured throughput
+// Inputs: frame deadline (injector_frame_rate), output rate, status of the sc_buffer,
+//         time spent by the ME and the EncDec stages
+// Output: EncMod, knobs stepped on top of it
+// Each step moves a single tool (ME search area, MD NFL, MDC depth mode) to the
+// settings of the next faster mode, starting with the tool of the slowest stage,
+// the Enc mode itself only changes once all the knobs are stepped (or cleared)
 //******************************************************************************//
-void eb_vp9_SpeedBufferControl(ResourceCoordinationContext *context_ptr,
-                               PictureParentControlSet     *picture_control_set_ptr,
-                               SequenceControlSet          *sequence_control_set_ptr) {
-    uint64_t curs_time_seconds  = 0;
-    uint64_t curs_timeu_seconds = 0;
-    double   overall_duration   = 0.0;
-    double   inst_duration      = 0.0;
-    int8_t   encoder_mode_delta = 0;
-    int64_t  input_frames_count = 0;
-    int8_t   change_cond        = 0;
-    int64_t  target_fps         = (sequence_control_set_ptr->static_config.injector_frame_rate >> 16);
-
-    int64_t buffer_trshold1 = SC_FRAMES_INTERVAL_T1;
-    int64_t buffer_trshold2 = SC_FRAMES_INTERVAL_T2;
-    int64_t buffer_trshold3 = SC_FRAMES_INTERVAL_T3;
-    int64_t buffer_trshold4 = MAX(SC_FRAMES_INTERVAL_T1, target_fps);
-    eb_vp9_block_on_mutex(sequence_control_set_ptr->encode_context_ptr->sc_buffer_mutex);
-
-    if (sequence_control_set_ptr->encode_context_ptr->sc_frame_in == 0) {
-        svt_vp9_get_time(&context_ptr->first_in_pic_arrived_time_seconds,
-                         &context_ptr->first_in_pic_arrived_timeu_seconds);
-    } else if (sequence_control_set_ptr->encode_context_ptr->sc_frame_in == SC_FRAMES_TO_IGNORE) {
-        context_ptr->start_flag = EB_TRUE;
-    }
+void eb_vp9_speed_control(ResourceCoordinationContext *context_ptr, PictureParentControlSet *picture_control_set_ptr,
+                          SequenceControlSet *sequence_control_set_ptr) {
+    EncodeContext *encode_context_ptr  = sequence_control_set_ptr->encode_context_ptr;
+    uint32_t       injector_frame_rate = sequence_control_set_ptr->static_config.injector_frame_rate;
+    uint64_t       curs_time_seconds   = 0;
+    uint64_t       curs_timeu_seconds  = 0;
+    double         overall_duration    = 0.0;
+    // Frame deadline in ms, injector_frame_rate is in Q16 when above 1000
+    double deadline = (injector_frame_rate > 1000) ? 65536000.0 / injector_frame_rate : 1000.0 / injector_frame_rate;
+
+    eb_vp9_block_on_mutex(encode_context_ptr->sc_buffer_mutex);
 
-    // Compute duration since the start of the encode and since the previous checkpoint
     svt_vp9_get_time(&curs_time_seconds, &curs_timeu_seconds);
+    if (encode_context_ptr->sc_frame_in == 0) {
+        context_ptr->first_in_pic_arrived_time_seconds  = curs_time_seconds;
+        context_ptr->first_in_pic_arrived_timeu_seconds = curs_timeu_seconds;
+    }
 
+    // Number of frames the input is late compared to the injector frame rate
     overall_duration = svt_vp9_compute_overall_elapsed_time_ms(context_ptr->first_in_pic_arrived_time_seconds,
                                                                context_ptr->first_in_pic_arrived_timeu_seconds,
                                                                curs_time_seconds,
                                                                curs_timeu_seconds);
-
-    inst_duration = svt_vp9_compute_overall_elapsed_time_ms(
-        context_ptr->prevs_time_seconds, context_ptr->prevs_timeu_seconds, curs_time_seconds, curs_timeu_seconds);
-
-    input_frames_count = (int64_t)overall_duration *
-        (sequence_control_set_ptr->static_config.injector_frame_rate >> 16) / 1000;
-    sequence_control_set_ptr->encode_context_ptr->sc_buffer = input_frames_count -
-        sequence_control_set_ptr->encode_context_ptr->sc_frame_in;
-
-    encoder_mode_delta = 0;
-
-    // Check every bufferTsshold1 for the changes (previous_frame_in_check1 variable)
-    if (sequence_control_set_ptr->encode_context_ptr->sc_frame_in >
-            context_ptr->previous_frame_in_check1 + buffer_trshold1 &&
-        sequence_control_set_ptr->encode_context_ptr->sc_frame_in >= SC_FRAMES_TO_IGNORE) {
-        // Go to a slower mode based on the fullness and changes of the buffer
-        if (sequence_control_set_ptr->encode_context_ptr->sc_buffer < buffer_trshold4 &&
-            (context_ptr->prev_enc_mode_delta > -1 ||
-             (context_ptr->prev_enc_mode_delta < 0 &&
-              sequence_control_set_ptr->encode_context_ptr->sc_frame_in >
-                  context_ptr->previous_mode_change_frame_in + buffer_trshold4 * 2))) {
-            if (context_ptr->previous_buffer_check1 >
-                sequence_control_set_ptr->encode_context_ptr->sc_buffer + buffer_trshold1) {
-                encoder_mode_delta += -1;
-                change_cond = 2;
-            } else if (context_ptr->previous_mode_change_buffer >
-                           buffer_trshold1 + sequence_control_set_ptr->encode_context_ptr->sc_buffer &&
-                       sequence_control_set_ptr->encode_context_ptr->sc_buffer < buffer_trshold1) {
-                encoder_mode_delta += -1;
-                change_cond = 4;
+    encode_context_ptr->sc_buffer = (int64_t)(overall_duration / deadline) - encode_context_ptr->sc_frame_in;
+
+    if (encode_context_ptr->sc_frame_in == SC_FRAMES_TO_IGNORE ||
+        (encode_context_ptr->sc_frame_in > SC_FRAMES_TO_IGNORE &&
+         encode_context_ptr->sc_frame_in >= context_ptr->prev_frame_in + SC_FRAMES_INTERVAL)) {
+        if (encode_context_ptr->sc_frame_in > SC_FRAMES_TO_IGNORE) {
+            int64_t frames_in     = encode_context_ptr->sc_frame_in - context_ptr->prev_frame_in;
+            int64_t frames_out    = encode_context_ptr->sc_frame_out - context_ptr->prev_frame_out;
+            int64_t mini_gop_size = (int64_t)1 << sequence_control_set_ptr->hierarchical_levels;
+            double  me_load;
+            double  enc_dec_load;
+            uint8_t knob_order[3];
+            uint8_t knob_index;
+            EB_BOOL speed_up;
+
+            // Load of each stage: wall time per frame of one of its threads, in % of the frame deadline
+            me_load = (encode_context_ptr->sc_me_busy_time - context_ptr->prev_me_busy_time) * 100 /
+                (frames_in * sequence_control_set_ptr->motion_estimation_process_init_count * deadline);
+            enc_dec_load = (encode_context_ptr->sc_enc_dec_busy_time - context_ptr->prev_enc_dec_busy_time) * 100 /
+                (frames_in * sequence_control_set_ptr->enc_dec_process_init_count * deadline);
+
+            // Step the tools of the slowest stage first
+            if (me_load > enc_dec_load) {
+                knob_order[0] = SC_KNOB_SEARCH_AREA;
+                knob_order[1] = SC_KNOB_NFL;
+                knob_order[2] = SC_KNOB_DEPTH_MODE;
+            } else {
+                knob_order[0] = SC_KNOB_NFL;
+                knob_order[1] = SC_KNOB_DEPTH_MODE;
+                knob_order[2] = SC_KNOB_SEARCH_AREA;
             }
-        }
-
-        // Go to a faster mode based on the fullness and changes of the buffer
-        if (sequence_control_set_ptr->encode_context_ptr->sc_buffer >
-            buffer_trshold1 + context_ptr->previous_buffer_check1) {
-            encoder_mode_delta += +1;
-            change_cond = 1;
-        } else if (sequence_control_set_ptr->encode_context_ptr->sc_buffer >
-                   buffer_trshold1 + context_ptr->previous_mode_change_buffer) {
-            encoder_mode_delta += +1;
-            change_cond = 3;
-        }
-
-        // Update the encode mode based on the fullness of the buffer
-        // If previous change_cond was the same, double the threshold2
-        if (sequence_control_set_ptr->encode_context_ptr->sc_buffer > buffer_trshold3 &&
-            (context_ptr->prev_change_cond != 7 ||
-             sequence_control_set_ptr->encode_context_ptr->sc_frame_in >
-                 context_ptr->previous_mode_change_frame_in + buffer_trshold2 * 2) &&
-            sequence_control_set_ptr->encode_context_ptr->sc_buffer > context_ptr->previous_mode_change_buffer) {
-            encoder_mode_delta += 1;
-            change_cond = 7;
-        }
-        encoder_mode_delta                                     = CLIP3(-1, 1, encoder_mode_delta);
-        sequence_control_set_ptr->encode_context_ptr->enc_mode = (EB_ENC_MODE)CLIP3(
-            ENC_MODE_0,
-            sequence_control_set_ptr->max_enc_mode,
-            (int8_t)sequence_control_set_ptr->encode_context_ptr->enc_mode + encoder_mode_delta);
-
-        // Update previous stats
-        context_ptr->previous_frame_in_check1 = sequence_control_set_ptr->encode_context_ptr->sc_frame_in;
-        context_ptr->previous_buffer_check1   = sequence_control_set_ptr->encode_context_ptr->sc_buffer;
-
-        if (encoder_mode_delta) {
-            context_ptr->previous_mode_change_buffer   = sequence_control_set_ptr->encode_context_ptr->sc_buffer;
-            context_ptr->previous_mode_change_frame_in = sequence_control_set_ptr->encode_context_ptr->sc_frame_in;
-            context_ptr->prev_enc_mode_delta           = encoder_mode_delta;
-        }
-    }
-
-    // Check every buffer_trshold2 for the changes (previous_frame_in_check2 variable)
-    if (sequence_control_set_ptr->encode_context_ptr->sc_frame_in >
-            context_ptr->previous_frame_in_check2 + buffer_trshold2 &&
-        sequence_control_set_ptr->encode_context_ptr->sc_frame_in >= SC_FRAMES_TO_IGNORE) {
-        encoder_mode_delta = 0;
-
-        // if no change in the encoder mode and buffer is low enough and level is not increasing, switch to a slower encoder mode
-        // If previous change_cond was the same, double the threshold2
-        if (encoder_mode_delta == 0 &&
-            sequence_control_set_ptr->encode_context_ptr->sc_frame_in >
-                context_ptr->previous_mode_change_frame_in + buffer_trshold2 &&
-            (context_ptr->prev_change_cond != 8 ||
-             sequence_control_set_ptr->encode_context_ptr->sc_frame_in >
-                 context_ptr->previous_mode_change_frame_in + buffer_trshold2 * 2) &&
-            ((sequence_control_set_ptr->encode_context_ptr->sc_buffer - context_ptr->previous_mode_change_buffer <
-              (buffer_trshold4 / 3)) ||
-             context_ptr->previous_mode_change_buffer == 0) &&
-            sequence_control_set_ptr->encode_context_ptr->sc_buffer < buffer_trshold3) {
-            encoder_mode_delta = -1;
-            change_cond        = 8;
-        }
 
-        encoder_mode_delta                                     = CLIP3(-1, 1, encoder_mode_delta);
-        sequence_control_set_ptr->encode_context_ptr->enc_mode = (EB_ENC_MODE)CLIP3(
-            ENC_MODE_0,
-            sequence_control_set_ptr->max_enc_mode,
-            (int8_t)sequence_control_set_ptr->encode_context_ptr->enc_mode + encoder_mode_delta);
-        // Update previous stats
-        context_ptr->previous_frame_in_check2 = sequence_control_set_ptr->encode_context_ptr->sc_frame_in;
+            // Go faster when the deadline is missed (the output falling behind the input, or the input falling
+            // behind the frame rate, by more than a mini GOP), or when the slowest stage is about to miss it
+            speed_up = frames_in - frames_out > mini_gop_size ||
+                encode_context_ptr->sc_buffer > context_ptr->prev_buffer + mini_gop_size ||
+                MAX(me_load, enc_dec_load) > SC_LOAD_HIGH;
 
-        if (encoder_mode_delta) {
-            context_ptr->previous_mode_change_buffer   = sequence_control_set_ptr->encode_context_ptr->sc_buffer;
-            context_ptr->previous_mode_change_frame_in = sequence_control_set_ptr->encode_context_ptr->sc_frame_in;
-            context_ptr->prev_enc_mode_delta           = encoder_mode_delta;
-        }
-    }
-    // Check every SC_FRAMES_INTERVAL_SPEED frames for the speed calculation (previous_frame_in_check3 variable)
-    if (context_ptr->start_flag ||
-        (sequence_control_set_ptr->encode_context_ptr->sc_frame_in >
-             context_ptr->previous_frame_in_check3 + SC_FRAMES_INTERVAL_SPEED &&
-         sequence_control_set_ptr->encode_context_ptr->sc_frame_in >= SC_FRAMES_TO_IGNORE)) {
-        if (context_ptr->start_flag) {
-            context_ptr->cur_speed = (uint64_t)(sequence_control_set_ptr->encode_context_ptr->sc_frame_out - 0) * 1000 /
-                (uint64_t)(overall_duration);
-        } else {
-            if (inst_duration != 0)
-                context_ptr->cur_speed = (uint64_t)(sequence_control_set_ptr->encode_context_ptr->sc_frame_out -
-                                                    context_ptr->prev_frame_out) *
-                    1000 / (uint64_t)(inst_duration);
+            if (speed_up) {
+                for (knob_index = 0; knob_index < 3; ++knob_index) {
+                    if (!(encode_context_ptr->sc_knobs & knob_order[knob_index]))
+                        break;
+                }
+                if (knob_index < 3) {
+                    encode_context_ptr->sc_knobs |= knob_order[knob_index];
+                    context_ptr->prev_change_frame_in = encode_context_ptr->sc_frame_in;
+                } else if (encode_context_ptr->enc_mode < sequence_control_set_ptr->max_enc_mode) {
+                    encode_context_ptr->enc_mode      = (EB_ENC_MODE)(encode_context_ptr->enc_mode + 1);
+                    encode_context_ptr->sc_knobs      = 0;
+                    context_ptr->prev_change_frame_in = encode_context_ptr->sc_frame_in;
+                }
+            } else if (MAX(me_load, enc_dec_load) < SC_LOAD_LOW &&
+                       encode_context_ptr->sc_frame_in >= context_ptr->prev_change_frame_in + 2 * SC_FRAMES_INTERVAL) {
+                // Go slower only once the previous change had the time to go through the pipeline
+                for (knob_index = 3; knob_index > 0; --knob_index) {
+                    if (encode_context_ptr->sc_knobs & knob_order[knob_index - 1])
+                        break;
+                }
+                if (knob_index > 0) {
+                    encode_context_ptr->sc_knobs &= ~knob_order[knob_index - 1];
+                    context_ptr->prev_change_frame_in = encode_context_ptr->sc_frame_in;
+                } else if (encode_context_ptr->enc_mode > ENC_MODE_0) {
+                    encode_context_ptr->enc_mode      = (EB_ENC_MODE)(encode_context_ptr->enc_mode - 1);
+                    encode_context_ptr->sc_knobs      = SC_KNOB_ALL;
+                    context_ptr->prev_change_frame_in = encode_context_ptr->sc_frame_in;
+                }
+            }
         }
-        context_ptr->start_flag = EB_FALSE;
 
         // Update previous stats
-        context_ptr->previous_frame_in_check3 = sequence_control_set_ptr->encode_context_ptr->sc_frame_in;
-        context_ptr->prevs_time_seconds       = curs_time_seconds;
-        context_ptr->prevs_timeu_seconds      = curs_timeu_seconds;
-        context_ptr->prev_frame_out           = sequence_control_set_ptr->encode_context_ptr->sc_frame_out;
-
-    } else if (sequence_control_set_ptr->encode_context_ptr->sc_frame_in < SC_FRAMES_TO_IGNORE &&
-               (overall_duration != 0)) {
-        context_ptr->cur_speed = (uint64_t)(sequence_control_set_ptr->encode_context_ptr->sc_frame_out - 0) * 1000 /
-            (uint64_t)(overall_duration);
-    }
-
-    if (change_cond) {
-        context_ptr->prev_change_cond = change_cond;
-    }
-    sequence_control_set_ptr->encode_context_ptr->sc_frame_in++;
-    if (sequence_control_set_ptr->encode_context_ptr->sc_frame_in >= SC_FRAMES_TO_IGNORE) {
-        context_ptr->average_enc_mod += sequence_control_set_ptr->encode_context_ptr->enc_mode;
-    } else {
-        context_ptr->average_enc_mod = 0;
+        context_ptr->prev_frame_in          = encode_context_ptr->sc_frame_in;
+        context_ptr->prev_frame_out         = encode_context_ptr->sc_frame_out;
+        context_ptr->prev_buffer            = encode_context_ptr->sc_buffer;
+        context_ptr->prev_me_busy_time      = encode_context_ptr->sc_me_busy_time;
+        context_ptr->prev_enc_dec_busy_time = encode_context_ptr->sc_enc_dec_busy_time;
     }
 
-    // Set the encoder level
-    picture_control_set_ptr->enc_mode = sequence_control_set_ptr->encode_context_ptr->enc_mode;
-
-    eb_vp9_release_mutex(sequence_control_set_ptr->encode_context_ptr->sc_buffer_mutex);
-
-    context_ptr->prev_enc_mod = sequence_control_set_ptr->encode_context_ptr->enc_mode;
+    encode_context_ptr->sc_frame_in++;
+
+    // Set the encoder level and the level of each knob
+    picture_control_set_ptr->enc_mode             = encode_context_ptr->enc_mode;
+    picture_control_set_ptr->search_area_enc_mode = (EB_ENC_MODE)MIN(
+        encode_context_ptr->enc_mode + !!(encode_context_ptr->sc_knobs & SC_KNOB_SEARCH_AREA),
+        sequence_control_set_ptr->max_enc_mode);
+    picture_control_set_ptr->nfl_enc_mode = (EB_ENC_MODE)MIN(
+        encode_context_ptr->enc_mode + !!(encode_context_ptr->sc_knobs & SC_KNOB_NFL),
+        sequence_control_set_ptr->max_enc_mode);
+    picture_control_set_ptr->depth_mode_enc_mode = (EB_ENC_MODE)MIN(
+        encode_context_ptr->enc_mode + !!(encode_context_ptr->sc_knobs & SC_KNOB_DEPTH_MODE),
+        sequence_control_set_ptr->max_enc_mode);
+
+    eb_vp9_release_mutex(encode_context_ptr->sc_buffer_mutex);
 }
 
 /******************************************************
@@ -463,6 +400,25 @@ EbErrorType eb_vp9_signal_derivation_pre_analysis_vmaf(SequenceControlSet      *
     return return_error;
 }
 
+/***************************************
+ * Mini-GOP boundary
+ *   Picture Decision groups the pictures that follow an intra picture
+ *   into mini-GOPs of 2^hierarchical_levels pictures, the intra picture
+ *   closes the mini-GOP it falls in
+ ***************************************/
+static EB_BOOL is_mini_gop_start(SequenceControlSet *sequence_control_set_ptr, uint64_t picture_number) {
+    uint64_t mini_gop_size = (uint64_t)1 << sequence_control_set_ptr->hierarchical_levels;
+    uint64_t period_position;
+
+    if (sequence_control_set_ptr->intra_period < 0)
+        return (EB_BOOL)((picture_number - 1) % mini_gop_size == 0);
+
+    period_position = picture_number % (uint64_t)(sequence_control_set_ptr->intra_period + 1);
+    if (period_position == 0)
+        return (EB_BOOL)(sequence_control_set_ptr->intra_period % mini_gop_size == 0);
+    return (EB_BOOL)((period_position - 1) % mini_gop_size == 0);
+}
+
 /***************************************
  * ResourceCoordination Kernel
  ***************************************/
@@ -486,8 +442,9 @@ void *eb_vp9_resource_coordination_kernel(void *input_ptr) {
     EbObjectWrapper *prev_picture_control_set_wrapper_ptr = NULL;
     uint32_t         instance_index;
 
-    EB_BOOL  end_of_sequence_flag = EB_FALSE;
-    uint32_t input_size           = 0;
+    EB_BOOL  end_of_sequence_flag         = EB_FALSE;
+    EB_BOOL  sequence_control_set_updated = EB_FALSE;
+    uint32_t input_size                   = 0;
 
     for (;;) {
         // Tie instance_index to zero for now...
@@ -495,6 +452,8 @@ void *eb_vp9_resource_coordination_kernel(void *input_ptr) {
 
         // Get the Next Input Buffer [BLOCKING]
         eb_vp9_get_full_object(context_ptr->input_buffer_fifo_ptr, &ebInputWrapperPtr);
+        if (ebInputWrapperPtr == EB_NULL)
+            return EB_NULL;
         eb_input_ptr = (EbBufferHeaderType *)ebInputWrapperPtr->object_ptr;
 
         sequence_control_set_ptr =
@@ -502,9 +461,15 @@ void *eb_vp9_resource_coordination_kernel(void *input_ptr) {
 
         // If config changes occured since the last picture began encoding, then
         //   prepare a new sequence_control_set_ptr containing the new changes and update the state
-        //   of the previous Active SequenceControlSet
+        //   of the previous Active SequenceControlSet. Runtime updates wait for a mini-GOP boundary
+        //   or a forced IDR so that a mini-GOP is coded with a single set of rate control targets
         eb_vp9_block_on_mutex(context_ptr->sequence_control_set_instance_array[instance_index]->config_mutex);
-        if (context_ptr->sequence_control_set_instance_array[instance_index]->encode_context_ptr->initial_picture) {
+        if (context_ptr->sequence_control_set_instance_array[instance_index]->encode_context_ptr->initial_picture ||
+            (context_ptr->sequence_control_set_instance_array[instance_index]->config_update_pending &&
+             (eb_input_ptr->pic_type == EB_IDR_PICTURE ||
+              is_mini_gop_start(sequence_control_set_ptr, context_ptr->picture_number_array[instance_index])))) {
+            context_ptr->sequence_control_set_instance_array[instance_index]->config_update_pending = EB_FALSE;
+
             // Update picture width, picture height, cropping right offset, cropping bottom offset, and conformance windows
             if (context_ptr->sequence_control_set_instance_array[instance_index]->encode_context_ptr->initial_picture)
 
@@ -541,12 +506,11 @@ void *eb_vp9_resource_coordination_kernel(void *input_ptr) {
                     ->sequence_control_set_ptr->cropping_bottom_offset =
                     context_ptr->sequence_control_set_instance_array[instance_index]
                         ->sequence_control_set_ptr->pad_bottom;
-
-                input_size = context_ptr->sequence_control_set_instance_array[instance_index]
-                                 ->sequence_control_set_ptr->luma_width *
-                    context_ptr->sequence_control_set_instance_array[instance_index]
-                        ->sequence_control_set_ptr->luma_height;
             }
+            input_size = context_ptr->sequence_control_set_instance_array[instance_index]
+                             ->sequence_control_set_ptr->luma_width *
+                context_ptr->sequence_control_set_instance_array[instance_index]->sequence_control_set_ptr->luma_height;
+            sequence_control_set_updated = EB_TRUE;
 
             // Copy previous Active sequence_control_set_ptr to a place holder
             previoussequence_control_set_wrapper_ptr = context_ptr->sequence_control_set_active_array[instance_index];
@@ -554,6 +518,12 @@ void *eb_vp9_resource_coordination_kernel(void *input_ptr) {
             // Get empty SequenceControlSet [BLOCKING]
             eb_vp9_get_empty_object(context_ptr->sequence_control_set_empty_fifo_ptr,
                                     &context_ptr->sequence_control_set_active_array[instance_index]);
+            if (context_ptr->sequence_control_set_active_array[instance_index] == EB_NULL) {
+                context_ptr->sequence_control_set_active_array[instance_index] =
+                    previoussequence_control_set_wrapper_ptr;
+                eb_vp9_release_mutex(context_ptr->sequence_control_set_instance_array[instance_index]->config_mutex);
+                return EB_NULL;
+            }
 
             // Copy the contents of the active SequenceControlSet into the new empty SequenceControlSet
             eb_vp9_copy_sequence_control_set(
@@ -584,7 +554,8 @@ void *eb_vp9_resource_coordination_kernel(void *input_ptr) {
             (SequenceControlSet *)context_ptr->sequence_control_set_active_array[instance_index]->object_ptr;
 
         // Init LCU Params
-        if (context_ptr->sequence_control_set_instance_array[instance_index]->encode_context_ptr->initial_picture) {
+        if (sequence_control_set_updated) {
+            sequence_control_set_updated = EB_FALSE;
             eb_vp9_derive_input_resolution(sequence_control_set_ptr, input_size);
 
             eb_vp9_sb_params_init(sequence_control_set_ptr);
@@ -593,6 +564,8 @@ void *eb_vp9_resource_coordination_kernel(void *input_ptr) {
         //Get a New ParentPCS where we will hold the new inputPicture
         eb_vp9_get_empty_object(context_ptr->picture_control_set_fifo_ptr_array[instance_index],
                                 &picture_control_set_wrapper_ptr);
+        if (picture_control_set_wrapper_ptr == EB_NULL)
+            return EB_NULL;
 
         // Parent PCS is released by the Rate Control after passing through MDC->MD->ENCDEC->Packetization
         eb_vp9_object_inc_live_count(picture_control_set_wrapper_ptr, 1);
@@ -705,23 +678,35 @@ void *eb_vp9_resource_coordination_kernel(void *input_ptr) {
         picture_control_set_ptr->input_picture_wrapper_ptr = input_picture_wrapper_ptr;
         picture_control_set_ptr->end_of_sequence_flag      = end_of_sequence_flag;
 
+        // Give the Input Picture a nominal live_count of 1, the temporal filter of a later picture may also hold it
+        eb_vp9_object_inc_live_count(input_picture_wrapper_ptr, 1);
+
         // Set Picture Control Flags
         picture_control_set_ptr->idr_flag = sequence_control_set_ptr->encode_context_ptr->initial_picture ||
             (picture_control_set_ptr->eb_input_ptr->pic_type == EB_IDR_PICTURE);
         picture_control_set_ptr->scene_change_flag = EB_FALSE;
 
+        // Drop the histograms signal left by the last picture of a sequence, it had no next picture to consume it
+        while (eb_vp9_try_semaphore(picture_control_set_ptr->picture_histogram_done_semaphore) == EB_ErrorNone) {}
+
         picture_control_set_ptr->qp_on_the_fly = EB_FALSE;
 
         picture_control_set_ptr->sb_total_count = sequence_control_set_ptr->sb_total_count;
 
         if (sequence_control_set_ptr->static_config.speed_control_flag) {
-            eb_vp9_SpeedBufferControl(context_ptr, picture_control_set_ptr, sequence_control_set_ptr);
+            eb_vp9_speed_control(context_ptr, picture_control_set_ptr, sequence_control_set_ptr);
         } else {
             picture_control_set_ptr->enc_mode = (EB_ENC_MODE)sequence_control_set_ptr->static_config.enc_mode;
+
+            picture_control_set_ptr->search_area_enc_mode = picture_control_set_ptr->enc_mode;
+            picture_control_set_ptr->nfl_enc_mode         = picture_control_set_ptr->enc_mode;
+            picture_control_set_ptr->depth_mode_enc_mode  = picture_control_set_ptr->enc_mode;
         }
 
         // Set the SCD Mode
-        sequence_control_set_ptr->scd_mode = SCD_MODE_0;
+        sequence_control_set_ptr->scd_mode = sequence_control_set_ptr->static_config.scene_change_detection
+            ? SCD_MODE_1
+            : SCD_MODE_0;
 
         // Pre-Analysis Signal(s) derivation
         if (sequence_control_set_ptr->static_config.tune == TUNE_SQ) {
@@ -734,7 +719,8 @@ void *eb_vp9_resource_coordination_kernel(void *input_ptr) {
 
         // Rate Control
         // Set the ME Distortion and OIS Historgrams to zero
-        if (sequence_control_set_ptr->static_config.rate_control_mode) {
+        if (sequence_control_set_ptr->static_config.rate_control_mode == 1 ||
+            sequence_control_set_ptr->static_config.rate_control_mode == 2) {
             EB_MEMSET(picture_control_set_ptr->me_distortion_histogram, 0, NUMBER_OF_SAD_INTERVALS * sizeof(uint16_t));
             EB_MEMSET(
                 picture_control_set_ptr->ois_distortion_histogram, 0, NUMBER_OF_INTRA_SAD_INTERVALS * sizeof(uint16_t));
@@ -765,6 +751,8 @@ void *eb_vp9_resource_coordination_kernel(void *input_ptr) {
         // Get Empty Reference Picture Object
         eb_vp9_get_empty_object(sequence_control_set_ptr->encode_context_ptr->pa_reference_picture_pool_fifo_ptr,
                                 &reference_picture_wrapper_ptr);
+        if (reference_picture_wrapper_ptr == EB_NULL)
+            return EB_NULL;
 
         picture_control_set_ptr->pareference_picture_wrapper_ptr = reference_picture_wrapper_ptr;
 
@@ -780,6 +768,8 @@ void *eb_vp9_resource_coordination_kernel(void *input_ptr) {
             ((PictureParentControlSet *)prev_picture_control_set_wrapper_ptr->object_ptr)->end_of_sequence_flag =
                 end_of_sequence_flag;
             eb_vp9_get_empty_object(context_ptr->resource_coordination_results_output_fifo_ptr, &output_wrapper_ptr);
+            if (output_wrapper_ptr == EB_NULL)
+                return EB_NULL;
             output_results_ptr = (ResourceCoordinationResults *)output_wrapper_ptr->object_ptr;
             output_results_ptr->picture_control_set_wrapper_ptr = prev_picture_control_set_wrapper_ptr;
 
@@ -9,6 +9,8 @@
 #include "EbDefinitions.h"
 #include "EbSystemResourceManager.h"
 #include "EbDefinitions.h"
+#include "EbPictureControlSet.h"
+#include "EbSequenceControlSet.h"
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -31,26 +33,17 @@ typedef struct ResourceCoordinationContext {
     // Picture Number Array
     uint64_t *picture_number_array;
 
-    uint64_t average_enc_mod;
-    uint8_t  prev_enc_mod;
-    int8_t   prev_enc_mode_delta;
-    uint8_t  prev_change_cond;
-
-    int64_t previous_mode_change_buffer;
-    int64_t previous_mode_change_frame_in;
-    int64_t previous_buffer_check1;
-    int64_t previous_frame_in_check1;
-    int64_t previous_frame_in_check2;
-    int64_t previous_frame_in_check3;
-
-    uint64_t cur_speed; // speed x 1000
-    uint64_t prevs_time_seconds;
-    uint64_t prevs_timeu_seconds;
-    int64_t  prev_frame_out;
-
+    // Speed Control
     uint64_t first_in_pic_arrived_time_seconds;
     uint64_t first_in_pic_arrived_timeu_seconds;
-    EB_BOOL  start_flag;
+
+    // Speed control stats at the previous check
+    int64_t  prev_frame_in;
+    int64_t  prev_frame_out;
+    int64_t  prev_buffer;
+    double   prev_me_busy_time;
+    double   prev_enc_dec_busy_time;
+    int64_t  prev_change_frame_in;
 
 } ResourceCoordinationContext;
 
@@ -64,6 +57,11 @@ extern EbErrorType eb_vp9_resource_coordination_context_ctor(
     EbCallback **app_callback_ptr_array, uint32_t *compute_segments_total_count_array,
     uint32_t encode_instances_total_count);
 
+extern void eb_vp9_resource_coordination_context_reset(ResourceCoordinationContext *context_ptr);
+
+extern void eb_vp9_speed_control(ResourceCoordinationContext *context_ptr, PictureParentControlSet *picture_control_set_ptr,
+                                 SequenceControlSet *sequence_control_set_ptr);
+
 extern void *eb_vp9_resource_coordination_kernel(void *input_ptr);
 
 #ifdef __cplusplus
@@ -213,6 +213,10 @@ EbErrorType eb_vp9_copy_sequence_control_set(SequenceControlSet *dst, SequenceCo
     write_count += sizeof(EB_BOOL);
     dst->max_enc_mode = src->max_enc_mode;
     write_count += sizeof(uint8_t);
+    dst->motion_estimation_process_init_count = src->motion_estimation_process_init_count;
+    write_count += sizeof(uint32_t);
+    dst->enc_dec_process_init_count = src->enc_dec_process_init_count;
+    write_count += sizeof(uint32_t);
 
     // Segments
     for (segment_index = 0; segment_index < MAX_TEMPORAL_LAYERS; ++segment_index) {
@@ -263,6 +267,7 @@ EbErrorType eb_vp9_sequence_control_set_instance_ctor(EbSequenceControlSetInstan
     }
 
     EB_CREATEMUTEX(EbHandle *, (*object_dbl_ptr)->config_mutex, sizeof(EbHandle), EB_MUTEX);
+    (*object_dbl_ptr)->config_update_pending = EB_FALSE;
 
     return EB_ErrorNone;
 }
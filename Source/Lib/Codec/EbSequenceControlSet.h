@@ -153,6 +153,8 @@ typedef struct EbSequenceControlSetInstance {
     EncodeContext      *encode_context_ptr;
     SequenceControlSet *sequence_control_set_ptr;
     EbHandle            config_mutex;
+    // Rate control targets were updated, copied to a new active SequenceControlSet at the next boundary
+    EB_BOOL             config_update_pending;
 
 } EbSequenceControlSetInstance;
 
@@ -977,6 +977,8 @@ void *eb_vp9_source_based_operations_kernel(void *input_ptr) {
     for (;;) {
         // Get Input Full Object
         eb_vp9_get_full_object(context_ptr->initial_rate_control_results_input_fifo_ptr, &input_results_wrapper_ptr);
+        if (input_results_wrapper_ptr == EB_NULL)
+            return EB_NULL;
 
         input_results_ptr       = (InitialRateControlResults *)input_results_wrapper_ptr->object_ptr;
         picture_control_set_ptr = (PictureParentControlSet *)
@@ -1068,6 +1070,8 @@ void *eb_vp9_source_based_operations_kernel(void *input_ptr) {
 
         // Get Empty Results Object
         eb_vp9_get_empty_object(context_ptr->picture_demux_results_output_fifo_ptr, &output_results_wrapper_ptr);
+        if (output_results_wrapper_ptr == EB_NULL)
+            return EB_NULL;
 
         output_results_ptr = (PictureDemuxResults *)output_results_wrapper_ptr->object_ptr;
         output_results_ptr->picture_control_set_wrapper_ptr = input_results_ptr->picture_control_set_wrapper_ptr;
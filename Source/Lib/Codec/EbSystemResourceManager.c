@@ -27,6 +27,9 @@ static EbErrorType eb_fifo_ctor(EbFifo *fifo_ptr, uint32_t initial_count, uint32
     // Copy the Muxing Queue ptr this Fifo belongs to
     fifo_ptr->queue_ptr = queue_ptr;
 
+    fifo_ptr->quit_signal = EB_FALSE;
+    fifo_ptr->node_index  = 0;
+
     return EB_ErrorNone;
 }
 
@@ -95,6 +98,22 @@ static EbErrorType eb_circular_buffer_ctor(EbCircularBuffer **buffer_dbl_ptr, ui
     return EB_ErrorNone;
 }
 
+/**************************************
+ * eb_circular_buffer_reset
+ **************************************/
+static void eb_circular_buffer_reset(EbCircularBuffer *buffer_ptr) {
+    uint32_t buffer_index;
+
+    for (buffer_index = 0; buffer_index < buffer_ptr->buffer_total_count; ++buffer_index) {
+        buffer_ptr->array_ptr[buffer_index] = EB_NULL;
+    }
+
+    buffer_ptr->head_index = 0;
+    buffer_ptr->tail_index = 0;
+
+    buffer_ptr->current_count = 0;
+}
+
 /**************************************
  * eb_circular_buffer_empty_check
  **************************************/
@@ -165,6 +184,39 @@ static EbErrorType eb_circular_buffer_push_front(EbCircularBuffer *buffer_ptr, E
     return return_error;
 }
 
+/**************************************
+ * eb_circular_buffer_peek
+ **************************************/
+static EbPtr eb_circular_buffer_peek(EbCircularBuffer *buffer_ptr, uint32_t offset) {
+    return buffer_ptr->array_ptr[(buffer_ptr->head_index + offset) % buffer_ptr->buffer_total_count];
+}
+
+/**************************************
+ * eb_circular_buffer_remove
+ *   removes the entry offset entries after the
+ *   head, the entries before it move one step
+ *   towards the tail
+ **************************************/
+static EbPtr eb_circular_buffer_remove(EbCircularBuffer *buffer_ptr, uint32_t offset) {
+    uint32_t entry_index = (buffer_ptr->head_index + offset) % buffer_ptr->buffer_total_count;
+    EbPtr    object_ptr  = buffer_ptr->array_ptr[entry_index];
+
+    while (entry_index != buffer_ptr->head_index) {
+        const uint32_t previous_index = (entry_index == 0) ? buffer_ptr->buffer_total_count - 1 : entry_index - 1;
+
+        buffer_ptr->array_ptr[entry_index] = buffer_ptr->array_ptr[previous_index];
+        entry_index                        = previous_index;
+    }
+
+    buffer_ptr->array_ptr[buffer_ptr->head_index] = EB_NULL;
+    buffer_ptr->head_index = (buffer_ptr->head_index == buffer_ptr->buffer_total_count - 1)
+        ? 0
+        : buffer_ptr->head_index + 1;
+    --buffer_ptr->current_count;
+
+    return object_ptr;
+}
+
 /**************************************
  * eb_muxing_queue_ctor
  **************************************/
@@ -217,6 +269,93 @@ static EbErrorType eb_muxing_queue_ctor(EbMuxingQueue **queue_dbl_ptr, uint32_t
     return return_error;
 }
 
+/**************************************
+ * eb_muxing_queue_shutdown
+ **************************************/
+static void eb_muxing_queue_shutdown(EbMuxingQueue *queue_ptr) {
+    EbFifo  *process_fifo_ptr;
+    uint32_t process_index;
+
+    for (process_index = 0; process_index < queue_ptr->process_total_count; ++process_index) {
+        process_fifo_ptr = queue_ptr->process_fifo_ptr_array[process_index];
+
+        eb_vp9_block_on_mutex(process_fifo_ptr->lockout_mutex);
+        process_fifo_ptr->quit_signal = EB_TRUE;
+        eb_vp9_release_mutex(process_fifo_ptr->lockout_mutex);
+
+        // Wake up the process if it is blocked on the Fifo
+        eb_vp9_post_semaphore(process_fifo_ptr->counting_semaphore);
+    }
+}
+
+/**************************************
+ * eb_muxing_queue_reset
+ **************************************/
+static void eb_muxing_queue_reset(EbMuxingQueue *queue_ptr) {
+    EbFifo  *process_fifo_ptr;
+    uint32_t process_index;
+
+    eb_circular_buffer_reset(queue_ptr->object_queue);
+    eb_circular_buffer_reset(queue_ptr->process_queue);
+
+    for (process_index = 0; process_index < queue_ptr->process_total_count; ++process_index) {
+        process_fifo_ptr = queue_ptr->process_fifo_ptr_array[process_index];
+
+        process_fifo_ptr->first_ptr   = (EbObjectWrapper *)EB_NULL;
+        process_fifo_ptr->last_ptr    = (EbObjectWrapper *)EB_NULL;
+        process_fifo_ptr->quit_signal = EB_FALSE;
+
+        // Drain the posts that were never consumed
+        while (eb_vp9_try_semaphore(process_fifo_ptr->counting_semaphore) == EB_ErrorNone) {}
+    }
+}
+
+/**************************************
+ * eb_muxing_queue_node_pair
+ *   pairs a waiting process with a full object
+ *   of its node when there is one: a single
+ *   waiting process takes the first object of
+ *   its node, otherwise the first object goes
+ *   to the first process of its node. Either
+ *   side falls back to the head of its queue
+ **************************************/
+static void eb_muxing_queue_node_pair(EbMuxingQueue *queue_ptr, EbSystemResource *resource_ptr,
+                                      EbFifo **process_fifo_dbl_ptr, EbObjectWrapper **wrapper_dbl_ptr) {
+    EbCircularBuffer *object_queue   = queue_ptr->object_queue;
+    EbCircularBuffer *process_queue  = queue_ptr->process_queue;
+    uint32_t          object_offset  = 0;
+    uint32_t          process_offset = 0;
+    uint32_t          offset;
+
+    if (process_queue->current_count == 1) {
+        const uint32_t node_index = ((EbFifo *)eb_circular_buffer_peek(process_queue, 0))->node_index;
+
+        for (offset = 0; offset < object_queue->current_count; ++offset) {
+            if (resource_ptr->object_node_callback(eb_circular_buffer_peek(object_queue, offset)) == node_index) {
+                object_offset = offset;
+                break;
+            }
+        }
+    } else {
+        const uint32_t node_index = resource_ptr->object_node_callback(eb_circular_buffer_peek(object_queue, 0));
+
+        for (offset = 0; offset < process_queue->current_count; ++offset) {
+            if (((EbFifo *)eb_circular_buffer_peek(process_queue, offset))->node_index == node_index) {
+                process_offset = offset;
+                break;
+            }
+        }
+    }
+
+    *process_fifo_dbl_ptr = (EbFifo *)eb_circular_buffer_remove(process_queue, process_offset);
+    *wrapper_dbl_ptr      = (EbObjectWrapper *)eb_circular_buffer_remove(object_queue, object_offset);
+
+    if (resource_ptr->object_node_callback(*wrapper_dbl_ptr) == (*process_fifo_dbl_ptr)->node_index)
+        ++resource_ptr->local_assignment_count;
+    else
+        ++resource_ptr->remote_assignment_count;
+}
+
 /**************************************
  * eb_muxing_queue_assignation
  **************************************/
@@ -228,11 +367,18 @@ static EbErrorType eb_muxing_queue_assignation(EbMuxingQueue *queue_ptr) {
     // while loop
     while ((eb_circular_buffer_empty_check(queue_ptr->object_queue) == EB_FALSE) &&
            (eb_circular_buffer_empty_check(queue_ptr->process_queue) == EB_FALSE)) {
-        // Get the next process
-        eb_circular_buffer_pop_front(queue_ptr->process_queue, (void **)&process_fifo_ptr);
+        EbSystemResource *resource_ptr = ((EbObjectWrapper *)eb_circular_buffer_peek(queue_ptr->object_queue, 0))
+                                             ->system_resource_ptr;
+
+        if (resource_ptr->object_node_callback && queue_ptr == resource_ptr->full_queue)
+            eb_muxing_queue_node_pair(queue_ptr, resource_ptr, &process_fifo_ptr, &wrapper_ptr);
+        else {
+            // Get the next process
+            eb_circular_buffer_pop_front(queue_ptr->process_queue, (void **)&process_fifo_ptr);
 
-        // Get the next object
-        eb_circular_buffer_pop_front(queue_ptr->object_queue, (void **)&wrapper_ptr);
+            // Get the next object
+            eb_circular_buffer_pop_front(queue_ptr->object_queue, (void **)&wrapper_ptr);
+        }
 
         // Block on the Process Fifo's Mutex
         eb_vp9_block_on_mutex(process_fifo_ptr->lockout_mutex);
@@ -394,7 +540,12 @@ EbErrorType eb_vp9_system_resource_ctor(EbSystemResource **resource_dbl_ptr, uin
     EB_MALLOC(EbSystemResource *, resource_ptr, sizeof(EbSystemResource), EB_N_PTR);
     *resource_dbl_ptr = resource_ptr;
 
-    resource_ptr->object_total_count = object_total_count;
+    resource_ptr->object_total_count       = object_total_count;
+    resource_ptr->release_callback         = NULL;
+    resource_ptr->release_callback_context = NULL;
+    resource_ptr->object_node_callback     = NULL;
+    resource_ptr->local_assignment_count   = 0;
+    resource_ptr->remote_assignment_count  = 0;
 
     // Allocate array for wrapper pointers
     EB_MALLOC(EbObjectWrapper **,
@@ -408,6 +559,7 @@ EbErrorType eb_vp9_system_resource_ctor(EbSystemResource **resource_dbl_ptr, uin
         resource_ptr->wrapper_ptr_pool[wrapperIndex]->live_count          = 0;
         resource_ptr->wrapper_ptr_pool[wrapperIndex]->release_enable      = EB_TRUE;
         resource_ptr->wrapper_ptr_pool[wrapperIndex]->system_resource_ptr = resource_ptr;
+        resource_ptr->wrapper_ptr_pool[wrapperIndex]->node_index          = 0;
 
         // Call the Constructor for each element
         if (object_ctor) {
@@ -448,6 +600,47 @@ EbErrorType eb_vp9_system_resource_ctor(EbSystemResource **resource_dbl_ptr, uin
     return return_error;
 }
 
+/*********************************************************************
+ * eb_vp9_system_resource_set_object_nodes
+ *********************************************************************/
+void eb_vp9_system_resource_set_object_nodes(EbSystemResource *resource_ptr, uint32_t node_count) {
+    uint32_t wrapper_index;
+
+    for (wrapper_index = 0; wrapper_index < resource_ptr->object_total_count; ++wrapper_index)
+        resource_ptr->wrapper_ptr_pool[wrapper_index]->node_index = wrapper_index % node_count;
+}
+
+/*********************************************************************
+ * eb_vp9_shutdown_process
+ *********************************************************************/
+void eb_vp9_shutdown_process(EbSystemResource *resource_ptr) {
+    eb_muxing_queue_shutdown(resource_ptr->empty_queue);
+
+    if (resource_ptr->full_queue) {
+        eb_muxing_queue_shutdown(resource_ptr->full_queue);
+    }
+}
+
+/*********************************************************************
+ * eb_vp9_system_resource_reset
+ *********************************************************************/
+void eb_vp9_system_resource_reset(EbSystemResource *resource_ptr) {
+    uint32_t wrapper_index;
+
+    eb_muxing_queue_reset(resource_ptr->empty_queue);
+
+    if (resource_ptr->full_queue) {
+        eb_muxing_queue_reset(resource_ptr->full_queue);
+    }
+
+    // Fill the Empty Fifo with every ObjectWrapper, as done at construction
+    for (wrapper_index = 0; wrapper_index < resource_ptr->object_total_count; ++wrapper_index) {
+        resource_ptr->wrapper_ptr_pool[wrapper_index]->live_count     = 0;
+        resource_ptr->wrapper_ptr_pool[wrapper_index]->release_enable = EB_TRUE;
+        eb_muxing_queue_object_push_back(resource_ptr->empty_queue, resource_ptr->wrapper_ptr_pool[wrapper_index]);
+    }
+}
+
 /*********************************************************************
  * EbSystemResourceReleaseProcess
  *********************************************************************/
@@ -502,7 +695,9 @@ EbErrorType eb_vp9_post_full_object(EbObjectWrapper *object_ptr) {
  *      pointer to EbObjectWrapper to be released.
  *********************************************************************/
 EbErrorType eb_vp9_release_object(EbObjectWrapper *object_ptr) {
-    EbErrorType return_error = EB_ErrorNone;
+    EbErrorType       return_error = EB_ErrorNone;
+    EbSystemResource *resource_ptr = object_ptr->system_resource_ptr;
+    EB_BOOL           released     = EB_FALSE;
 
     eb_vp9_block_on_mutex(object_ptr->system_resource_ptr->empty_queue->lockout_mutex);
 
@@ -514,13 +709,52 @@ EbErrorType eb_vp9_release_object(EbObjectWrapper *object_ptr) {
         object_ptr->live_count = EB_ObjectWrapperReleasedValue;
 
         eb_muxing_queue_object_push_front(object_ptr->system_resource_ptr->empty_queue, object_ptr);
+        released = EB_TRUE;
     }
 
     eb_vp9_release_mutex(object_ptr->system_resource_ptr->empty_queue->lockout_mutex);
 
+    // object_ptr may already be reused by another process at this point
+    if (released && resource_ptr->release_callback)
+        resource_ptr->release_callback(resource_ptr->release_callback_context);
+
     return return_error;
 }
 
+/**************************************
+ * eb_fifo_take_empty_object
+ *   Waits for the object assigned to the
+ *   requesting fifo and prepares it for use
+ **************************************/
+static void eb_fifo_take_empty_object(EbFifo *empty_fifo_ptr, EbObjectWrapper **wrapper_dbl_ptr) {
+    // Block on the counting Semaphore until an empty buffer is available
+    eb_vp9_block_on_semaphore(empty_fifo_ptr->counting_semaphore);
+
+    // Acquire lockout Mutex
+    eb_vp9_block_on_mutex(empty_fifo_ptr->lockout_mutex);
+
+    // The encoder is shutting down, hand a NULL object to the producer and keep
+    //   the Fifo signaled for the calls it makes on its way out
+    if (empty_fifo_ptr->quit_signal) {
+        *wrapper_dbl_ptr = (EbObjectWrapper *)EB_NULL;
+        eb_vp9_post_semaphore(empty_fifo_ptr->counting_semaphore);
+        eb_vp9_release_mutex(empty_fifo_ptr->lockout_mutex);
+        return;
+    }
+
+    // Get the empty object
+    eb_fifo_pop_front(empty_fifo_ptr, wrapper_dbl_ptr);
+
+    // Reset the wrapper's live_count
+    (*wrapper_dbl_ptr)->live_count = 0;
+
+    // Object release enable
+    (*wrapper_dbl_ptr)->release_enable = EB_TRUE;
+
+    // Release Mutex
+    eb_vp9_release_mutex(empty_fifo_ptr->lockout_mutex);
+}
+
 /*********************************************************************
  * EbSystemResourceGetEmptyObject
  *   Dequeues an empty EbObjectWrapper from the SystemResource.  This
@@ -542,25 +776,46 @@ EbErrorType eb_vp9_get_empty_object(EbFifo *empty_fifo_ptr, EbObjectWrapper **wr
     // Queue the Fifo requesting the empty fifo
     eb_release_process(empty_fifo_ptr);
 
-    // Block on the counting Semaphore until an empty buffer is available
-    eb_vp9_block_on_semaphore(empty_fifo_ptr->counting_semaphore);
+    eb_fifo_take_empty_object(empty_fifo_ptr, wrapper_dbl_ptr);
 
-    // Acquire lockout Mutex
-    eb_vp9_block_on_mutex(empty_fifo_ptr->lockout_mutex);
+    return return_error;
+}
 
-    // Get the empty object
-    eb_fifo_pop_front(empty_fifo_ptr, wrapper_dbl_ptr);
+EbErrorType eb_vp9_get_empty_object_non_blocking(EbFifo *empty_fifo_ptr, EbObjectWrapper **wrapper_dbl_ptr) {
+    EbMuxingQueue *queue_ptr = empty_fifo_ptr->queue_ptr;
+    EB_BOOL        object_available;
 
-    // Reset the wrapper's live_count
-    (*wrapper_dbl_ptr)->live_count = 0;
+    eb_vp9_block_on_mutex(queue_ptr->lockout_mutex);
 
-    // Object release enable
-    (*wrapper_dbl_ptr)->release_enable = EB_TRUE;
+    // Objects left in the queue are never promised to a waiting process, queuing
+    // the request only when one is left guarantees the semaphore is posted
+    object_available = !eb_circular_buffer_empty_check(queue_ptr->object_queue);
+    if (object_available) {
+        eb_circular_buffer_push_front(queue_ptr->process_queue, empty_fifo_ptr);
+        eb_muxing_queue_assignation(queue_ptr);
+    }
 
-    // Release Mutex
-    eb_vp9_release_mutex(empty_fifo_ptr->lockout_mutex);
+    eb_vp9_release_mutex(queue_ptr->lockout_mutex);
 
-    return return_error;
+    if (object_available == EB_FALSE) {
+        *wrapper_dbl_ptr = (EbObjectWrapper *)EB_NULL;
+        return EB_NoErrorFullQueue;
+    }
+
+    eb_fifo_take_empty_object(empty_fifo_ptr, wrapper_dbl_ptr);
+
+    return (*wrapper_dbl_ptr == EB_NULL) ? EB_NoErrorFullQueue : EB_ErrorNone;
+}
+
+uint32_t eb_vp9_get_empty_object_count(EbFifo *empty_fifo_ptr) {
+    EbMuxingQueue *queue_ptr = empty_fifo_ptr->queue_ptr;
+    uint32_t       object_count;
+
+    eb_vp9_block_on_mutex(queue_ptr->lockout_mutex);
+    object_count = queue_ptr->object_queue->current_count;
+    eb_vp9_release_mutex(queue_ptr->lockout_mutex);
+
+    return object_count;
 }
 
 /*********************************************************************
@@ -590,7 +845,13 @@ EbErrorType eb_vp9_get_full_object(EbFifo *full_fifo_ptr, EbObjectWrapper **wrap
     // Acquire lockout Mutex
     eb_vp9_block_on_mutex(full_fifo_ptr->lockout_mutex);
 
-    eb_fifo_pop_front(full_fifo_ptr, wrapper_dbl_ptr);
+    // The encoder is shutting down, hand a NULL object to the consumer and keep
+    //   the Fifo signaled for the calls it makes on its way out
+    if (full_fifo_ptr->quit_signal) {
+        *wrapper_dbl_ptr = (EbObjectWrapper *)EB_NULL;
+        eb_vp9_post_semaphore(full_fifo_ptr->counting_semaphore);
+    } else
+        eb_fifo_pop_front(full_fifo_ptr, wrapper_dbl_ptr);
 
     // Release Mutex
     eb_vp9_release_mutex(full_fifo_ptr->lockout_mutex);
@@ -46,6 +46,10 @@ typedef struct EbObjectWrapper {
     //   only in the implemenation of a single-linked Fifo.
     struct EbObjectWrapper *next_ptr;
 
+    // node_index - the memory node the object was constructed on, 0
+    //   unless the SystemResource is split in per-node sub-pools.
+    uint32_t node_index;
+
 } EbObjectWrapper;
 
 /*********************************************************************
@@ -76,6 +80,14 @@ typedef struct EbFifo {
     //   associated with.
     struct EbMuxingQueue *queue_ptr;
 
+    // quit_signal - set by eb_vp9_shutdown_process to wake up the
+    //   process blocked on the EbFifo and make it leave its loop.
+    EB_BOOL quit_signal;
+
+    // node_index - the memory node the process runs on, used to hand
+    //   it the objects of its node first (see object_node_callback).
+    uint32_t node_index;
+
 } EbFifo;
 
 /*********************************************************************
@@ -126,6 +138,23 @@ typedef struct EbSystemResource {
     // The full FIFO contains a queue of completed buffers
     EbMuxingQueue *full_queue;
 
+    // release_callback - optional notification that an object went back
+    //   to the empty queue. Called from the releasing thread, outside of
+    //   any SystemResource lock.
+    void (*release_callback)(void *context);
+    void *release_callback_context;
+
+    // object_node_callback - optional memory node of a full object. When
+    //   set, a full object goes to a waiting process of its node first and
+    //   a process takes the first full object of its node first, any
+    //   process or object otherwise. Called under the full queue lock.
+    uint32_t (*object_node_callback)(EbObjectWrapper *wrapper_ptr);
+
+    // local/remote_assignment_count - the full objects handed to a process
+    //   of their node and of another node, with object_node_callback only.
+    uint64_t local_assignment_count;
+    uint64_t remote_assignment_count;
+
 } EbSystemResource;
 
 /*********************************************************************
@@ -213,6 +242,19 @@ extern EbErrorType eb_vp9_system_resource_ctor(EbSystemResource **resource_dbl_p
                                                EbFifo ***consumer_fifo_ptr_array_ptr, EB_BOOL full_fifo_enabled,
                                                EB_CTOR object_ctor, EbPtr object_init_data_ptr);
 
+/*********************************************************************
+ * eb_vp9_system_resource_set_object_nodes
+ *   Tags the objects of a SystemResource split in per-node sub-pools:
+ *   object n was constructed on node n % node_count.
+ *
+ *   resource_ptr
+ *     pointer to the SystemResource whose objects are tagged.
+ *
+ *   node_count
+ *     Number of memory nodes the objects are spread on.
+ *********************************************************************/
+extern void eb_vp9_system_resource_set_object_nodes(EbSystemResource *resource_ptr, uint32_t node_count);
+
 /*********************************************************************
  * eb_system_resource_dtor
  *   Destructor for EbSystemResource.  Fully destructs all members
@@ -236,6 +278,8 @@ extern void eb_system_resource_dtor(EbSystemResource *resource_ptr, EbDtor objec
  *   wrapperCopyPtr if wrapperCopyPtr is not NULL. This function blocks
  *   on the SystemResource emptyFifo counting_semaphore. This function
  *   is write protected by the SystemResource emptyFifo lockout_mutex.
+ *   A NULL EbObjectWrapper is returned once the emptyFifo was
+ *   signaled to quit (see eb_vp9_shutdown_process).
  *
  *   resource_ptr
  *      pointer to the SystemResource that provides the empty
@@ -247,6 +291,21 @@ extern void eb_system_resource_dtor(EbSystemResource *resource_ptr, EbDtor objec
  *********************************************************************/
 extern EbErrorType eb_vp9_get_empty_object(EbFifo *empty_fifo_ptr, EbObjectWrapper **wrapper_dbl_ptr);
 
+/*********************************************************************
+ * EbSystemResourceGetEmptyObjectNonBlocking
+ *   Same as eb_vp9_get_empty_object, but returns EB_NoErrorFullQueue
+ *   with a NULL wrapper instead of blocking when no empty
+ *   EbObjectWrapper is available.
+ *********************************************************************/
+extern EbErrorType eb_vp9_get_empty_object_non_blocking(EbFifo *empty_fifo_ptr, EbObjectWrapper **wrapper_dbl_ptr);
+
+/*********************************************************************
+ * EbSystemResourceGetEmptyObjectCount
+ *   Returns the number of empty EbObjectWrappers that are not yet
+ *   promised to a waiting process.
+ *********************************************************************/
+extern uint32_t eb_vp9_get_empty_object_count(EbFifo *empty_fifo_ptr);
+
 /*********************************************************************
  * EbSystemResourcePostObject
  *   Queues a full EbObjectWrapper to the SystemResource. This
@@ -269,6 +328,8 @@ extern EbErrorType eb_vp9_post_full_object(EbObjectWrapper *object_ptr);
  *   function blocks on the SystemResource fullFifo counting_semaphore.
  *   This function is write protected by the SystemResource fullFifo
  *   lockout_mutex.
+ *   A NULL EbObjectWrapper is returned once the fullFifo was
+ *   signaled to quit (see eb_vp9_shutdown_process).
  *
  *   resource_ptr
  *      pointer to the SystemResource that provides the full
@@ -293,6 +354,32 @@ extern EbErrorType eb_vp9_get_full_object_non_blocking(EbFifo *full_fifo_ptr, Eb
  *      pointer to EbObjectWrapper to be released.
  *********************************************************************/
 extern EbErrorType eb_vp9_release_object(EbObjectWrapper *object_ptr);
+
+/*********************************************************************
+ * EbSystemResourceShutdownProcess
+ *   Signals every process Fifo of the SystemResource to quit and
+ *   wakes up the processes blocked on them. A process blocked in
+ *   eb_vp9_get_full_object or eb_vp9_get_empty_object gets a NULL
+ *   EbObjectWrapper back, as does every later call on these Fifos.
+ *   The process is expected to release the locks it holds and to
+ *   return from its kernel.
+ *
+ *   resource_ptr
+ *      pointer to the SystemResource to be shut down.
+ *********************************************************************/
+extern void eb_vp9_shutdown_process(EbSystemResource *resource_ptr);
+
+/*********************************************************************
+ * EbSystemResourceReset
+ *   Returns every EbObjectWrapper of the SystemResource to the empty
+ *   queue and clears the process Fifos and their quit signals. Only
+ *   valid once no process uses the SystemResource anymore (i.e. after
+ *   eb_vp9_shutdown_process and the processes joined).
+ *
+ *   resource_ptr
+ *      pointer to the SystemResource to be reset.
+ *********************************************************************/
+extern void eb_vp9_system_resource_reset(EbSystemResource *resource_ptr);
 #ifdef __cplusplus
 }
 #endif
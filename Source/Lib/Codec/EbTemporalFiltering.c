@@ -0,0 +1,248 @@
+/*
+* Copyright(c) 2019 Intel Corporation
+* SPDX - License - Identifier: BSD - 2 - Clause - Patent
+*/
+
+#include "EbUtility.h"
+#include "EbComputeSAD.h"
+#include "EbPictureOperators.h"
+#include "EbTemporalFiltering.h"
+
+// me_results index of the first 16x16 block, the 16 blocks follow in raster scan order
+#define ME_RESULTS_16x16_OFFSET 5
+
+/*******************************************
+* Scales the quarter-pel List0 ME vector of the
+* source picture to a picture at the given
+* distance, returns it in full-pel
+*******************************************/
+static int32_t scale_mv(int16_t mv, int32_t distance, int32_t ref_distance) {
+    const int32_t scaled = mv * distance;
+    const int32_t scale  = ref_distance << 2;
+
+    return scaled >= 0 ? (scaled + (scale >> 1)) / scale : -((-scaled + (scale >> 1)) / scale);
+}
+
+/*******************************************
+* Full-pel refinement of the scaled vector,
+* the (0,0) vector is always checked. Vectors
+* are kept within the picture.
+*******************************************/
+static void temporal_filter_search(uint8_t *src, uint32_t src_stride, EbPictureBufferDesc *ref_picture_ptr,
+                                   int32_t block_x, int32_t block_y, uint32_t block_width, uint32_t block_height,
+                                   int32_t *mv_x, int32_t *mv_y, EbAsm asm_type) {
+    const int32_t min_x    = -block_x;
+    const int32_t min_y    = -block_y;
+    const int32_t max_x    = (int32_t)(ref_picture_ptr->width - block_width) - block_x;
+    const int32_t max_y    = (int32_t)(ref_picture_ptr->height - block_height) - block_y;
+    const int32_t center_x = CLIP3(min_x, max_x, *mv_x);
+    const int32_t center_y = CLIP3(min_y, max_y, *mv_y);
+    uint8_t      *ref_ptr  = ref_picture_ptr->buffer_y +
+        (ref_picture_ptr->origin_y + block_y) * ref_picture_ptr->stride_y + ref_picture_ptr->origin_x + block_x;
+    uint32_t best_sad;
+    int32_t  x, y;
+
+    *mv_x    = 0;
+    *mv_y    = 0;
+    best_sad = n_x_m_sad_kernel_func_ptr_array[asm_type][block_width >> 3](
+        src, src_stride, ref_ptr, ref_picture_ptr->stride_y, block_height, block_width);
+
+    for (y = MAX(center_y - TEMPORAL_FILTER_SEARCH_RANGE, min_y);
+         y <= MIN(center_y + TEMPORAL_FILTER_SEARCH_RANGE, max_y);
+         y++) {
+        for (x = MAX(center_x - TEMPORAL_FILTER_SEARCH_RANGE, min_x);
+             x <= MIN(center_x + TEMPORAL_FILTER_SEARCH_RANGE, max_x);
+             x++) {
+            const uint32_t sad = n_x_m_sad_kernel_func_ptr_array[asm_type][block_width >> 3](
+                src,
+                src_stride,
+                ref_ptr + y * (int32_t)ref_picture_ptr->stride_y + x,
+                ref_picture_ptr->stride_y,
+                block_height,
+                block_width);
+            if (sad < best_sad) {
+                best_sad = sad;
+                *mv_x    = x;
+                *mv_y    = y;
+            }
+        }
+    }
+}
+
+static void temporal_filter_apply(const uint8_t *src, uint32_t src_stride, const uint8_t *pred,
+                                  uint32_t pred_stride, uint32_t block_width, uint32_t block_height,
+                                  int32_t strength, int32_t filter_weight, uint32_t *accumulator, uint16_t *count,
+                                  EbAsm asm_type) {
+    if (block_width & 7) {
+        eb_vp9_temporal_filter_apply_kernel(
+            src, src_stride, pred, pred_stride, block_width, block_height, strength, filter_weight, accumulator, count);
+    } else {
+        temporal_filter_apply_func_ptr_array[asm_type][block_width >> 4](
+            src, src_stride, pred, pred_stride, block_width, block_height, strength, filter_weight, accumulator, count);
+    }
+}
+
+/*******************************************
+* Filters one block of the 3 planes: each past
+* picture is motion compensated (full-pel) and
+* weighted per block on its SSE, then per
+* sample on its distance to the source.
+*******************************************/
+static void temporal_filter_block(PictureParentControlSet *picture_control_set_ptr, MeCuResults *me_results,
+                                  int32_t ref_distance, int32_t block_x, int32_t block_y, uint32_t block_width,
+                                  uint32_t block_height, EbAsm asm_type) {
+    EbPictureBufferDesc *input_picture_ptr = picture_control_set_ptr->enhanced_picture_ptr;
+    const int32_t        strength          = picture_control_set_ptr->temporal_filter_strength;
+    uint32_t accumulator[MAX_MB_PLANE][TEMPORAL_FILTER_BLOCK_SIZE * TEMPORAL_FILTER_BLOCK_SIZE];
+    uint16_t count[MAX_MB_PLANE][TEMPORAL_FILTER_BLOCK_SIZE * TEMPORAL_FILTER_BLOCK_SIZE];
+    uint8_t *src[MAX_MB_PLANE];
+    uint32_t src_stride[MAX_MB_PLANE];
+    uint32_t width[MAX_MB_PLANE];
+    uint32_t height[MAX_MB_PLANE];
+    uint32_t plane, i, j;
+    uint8_t  frame_index;
+
+    src[0] = input_picture_ptr->buffer_y + (input_picture_ptr->origin_y + block_y) * input_picture_ptr->stride_y +
+        input_picture_ptr->origin_x + block_x;
+    src[1] = input_picture_ptr->buffer_cb +
+        ((input_picture_ptr->origin_y + block_y) >> 1) * input_picture_ptr->stride_cb +
+        ((input_picture_ptr->origin_x + block_x) >> 1);
+    src[2] = input_picture_ptr->buffer_cr +
+        ((input_picture_ptr->origin_y + block_y) >> 1) * input_picture_ptr->stride_cr +
+        ((input_picture_ptr->origin_x + block_x) >> 1);
+    src_stride[0] = input_picture_ptr->stride_y;
+    src_stride[1] = input_picture_ptr->stride_cb;
+    src_stride[2] = input_picture_ptr->stride_cr;
+    width[0]      = block_width;
+    height[0]     = block_height;
+    width[1] = width[2] = block_width >> 1;
+    height[1] = height[2] = block_height >> 1;
+
+    // The source samples take part with the highest weight
+    for (plane = 0; plane < MAX_MB_PLANE; plane++) {
+        for (i = 0; i < height[plane]; i++) {
+            for (j = 0; j < width[plane]; j++) {
+                count[plane][i * width[plane] + j]       = TEMPORAL_FILTER_SELF_WEIGHT;
+                accumulator[plane][i * width[plane] + j] = TEMPORAL_FILTER_SELF_WEIGHT *
+                    src[plane][i * src_stride[plane] + j];
+            }
+        }
+    }
+
+    for (frame_index = 0; frame_index < picture_control_set_ptr->temporal_filter_count; frame_index++) {
+        EbPictureBufferDesc *ref_picture_ptr = picture_control_set_ptr->temporal_filter_picture_ptr_array[frame_index];
+        const int32_t        distance        = frame_index + 1;
+        int32_t              mv_x            = scale_mv(me_results->x_mv_l0, distance, ref_distance);
+        int32_t              mv_y            = scale_mv(me_results->y_mv_l0, distance, ref_distance);
+        int32_t              chroma_x, chroma_y;
+        uint8_t             *pred;
+        uint64_t             error;
+        int32_t              filter_weight;
+
+        temporal_filter_search(
+            src[0], src_stride[0], ref_picture_ptr, block_x, block_y, block_width, block_height, &mv_x, &mv_y, asm_type);
+
+        pred = ref_picture_ptr->buffer_y +
+            (ref_picture_ptr->origin_y + block_y + mv_y) * ref_picture_ptr->stride_y + ref_picture_ptr->origin_x +
+            block_x + mv_x;
+
+        error = (block_width == TEMPORAL_FILTER_BLOCK_SIZE)
+            ? spatialfull_distortion_kernel_func_ptr_array[asm_type][2](
+                  src[0], src_stride[0], pred, ref_picture_ptr->stride_y, block_width, block_height)
+            : eb_vp9_spatial_full_distortion_kernel(
+                  src[0], src_stride[0], pred, ref_picture_ptr->stride_y, block_width, block_height);
+
+        // Thresholds are given for a 16x16 block
+        error = (error * TEMPORAL_FILTER_BLOCK_SIZE * TEMPORAL_FILTER_BLOCK_SIZE) / (block_width * block_height);
+        filter_weight = error < TEMPORAL_FILTER_ERROR_LOW ? 2 : error < TEMPORAL_FILTER_ERROR_HIGH ? 1 : 0;
+        if (filter_weight == 0)
+            continue;
+
+        temporal_filter_apply(src[0],
+                              src_stride[0],
+                              pred,
+                              ref_picture_ptr->stride_y,
+                              width[0],
+                              height[0],
+                              strength,
+                              filter_weight,
+                              accumulator[0],
+                              count[0],
+                              asm_type);
+
+        // Chroma uses the luma vector at full-pel chroma precision
+        chroma_x = CLIP3(
+            -(block_x >> 1), (int32_t)((ref_picture_ptr->width - block_width) >> 1) - (block_x >> 1), mv_x / 2);
+        chroma_y = CLIP3(
+            -(block_y >> 1), (int32_t)((ref_picture_ptr->height - block_height) >> 1) - (block_y >> 1), mv_y / 2);
+
+        pred = ref_picture_ptr->buffer_cb +
+            (((ref_picture_ptr->origin_y + block_y) >> 1) + chroma_y) * ref_picture_ptr->stride_cb +
+            ((ref_picture_ptr->origin_x + block_x) >> 1) + chroma_x;
+        temporal_filter_apply(src[1],
+                              src_stride[1],
+                              pred,
+                              ref_picture_ptr->stride_cb,
+                              width[1],
+                              height[1],
+                              strength,
+                              filter_weight,
+                              accumulator[1],
+                              count[1],
+                              asm_type);
+
+        pred = ref_picture_ptr->buffer_cr +
+            (((ref_picture_ptr->origin_y + block_y) >> 1) + chroma_y) * ref_picture_ptr->stride_cr +
+            ((ref_picture_ptr->origin_x + block_x) >> 1) + chroma_x;
+        temporal_filter_apply(src[2],
+                              src_stride[2],
+                              pred,
+                              ref_picture_ptr->stride_cr,
+                              width[2],
+                              height[2],
+                              strength,
+                              filter_weight,
+                              accumulator[2],
+                              count[2],
+                              asm_type);
+    }
+
+    // Normalize back into the source
+    for (plane = 0; plane < MAX_MB_PLANE; plane++) {
+        for (i = 0; i < height[plane]; i++) {
+            for (j = 0; j < width[plane]; j++) {
+                const uint32_t k = i * width[plane] + j;
+                src[plane][i * src_stride[plane] + j] = (uint8_t)((accumulator[plane][k] + (count[plane][k] >> 1)) /
+                                                                  count[plane][k]);
+            }
+        }
+    }
+}
+
+void eb_vp9_temporal_filter_sb(PictureParentControlSet *picture_control_set_ptr, uint32_t sb_index,
+                               uint32_t sb_origin_x, uint32_t sb_origin_y) {
+    EbPictureBufferDesc *input_picture_ptr = picture_control_set_ptr->enhanced_picture_ptr;
+    const EbAsm          asm_type          = (EbAsm)((eb_vp9_ASM_TYPES & AVX2_MASK) && 1);
+    const int32_t        ref_distance      = (int32_t)(picture_control_set_ptr->picture_number -
+                                           picture_control_set_ptr->ref_pic_poc_array[REF_LIST_0]);
+    uint32_t             block_index;
+
+    for (block_index = 0; block_index < (MAX_SB_SIZE / TEMPORAL_FILTER_BLOCK_SIZE) *
+             (MAX_SB_SIZE / TEMPORAL_FILTER_BLOCK_SIZE);
+         block_index++) {
+        const uint32_t block_x = sb_origin_x + (block_index & 3) * TEMPORAL_FILTER_BLOCK_SIZE;
+        const uint32_t block_y = sb_origin_y + (block_index >> 2) * TEMPORAL_FILTER_BLOCK_SIZE;
+
+        if (block_x >= input_picture_ptr->width || block_y >= input_picture_ptr->height)
+            continue;
+
+        temporal_filter_block(picture_control_set_ptr,
+                              &picture_control_set_ptr->me_results[sb_index][ME_RESULTS_16x16_OFFSET + block_index],
+                              ref_distance,
+                              (int32_t)block_x,
+                              (int32_t)block_y,
+                              MIN(TEMPORAL_FILTER_BLOCK_SIZE, input_picture_ptr->width - block_x),
+                              MIN(TEMPORAL_FILTER_BLOCK_SIZE, input_picture_ptr->height - block_y),
+                              asm_type);
+    }
+}
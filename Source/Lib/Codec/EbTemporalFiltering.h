@@ -0,0 +1,61 @@
+/*
+* Copyright(c) 2019 Intel Corporation
+* SPDX - License - Identifier: BSD - 2 - Clause - Patent
+*/
+
+#ifndef EbTemporalFiltering_h
+#define EbTemporalFiltering_h
+
+#include "EbDefinitions.h"
+#include "EbPictureControlSet.h"
+
+#include "EbTemporalFiltering_C.h"
+#include "EbTemporalFiltering_SSE2.h"
+#include "EbTemporalFiltering_AVX2.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**************************************
+ * Defines
+ **************************************/
+#define TEMPORAL_FILTER_BLOCK_SIZE 16
+#define TEMPORAL_FILTER_SEARCH_RANGE 2 // full-pel refinement around the scaled ME vector
+#define TEMPORAL_FILTER_STRENGTH 2 // below the libvpx ARF default of 5 as the filtered picture is also displayed
+#define TEMPORAL_FILTER_SELF_WEIGHT 32 // weight of the source samples, i.e. 16 * the highest block weight
+#define TEMPORAL_FILTER_ERROR_LOW 10000 // per 16x16 block SSE below which the past block has the highest weight
+#define TEMPORAL_FILTER_ERROR_HIGH 20000 // per 16x16 block SSE above which the past block is not used
+
+/***************************************
+ * Function Ptr Types
+ ***************************************/
+typedef void (*EbTemporalFilterApplyType)(const uint8_t *src, uint32_t src_stride, const uint8_t *pred,
+                                          uint32_t pred_stride, uint32_t block_width, uint32_t block_height,
+                                          int32_t strength, int32_t filter_weight, uint32_t *accumulator,
+                                          uint16_t *count);
+
+/***************************************
+ * Function Tables
+ ***************************************/
+static EbTemporalFilterApplyType FUNC_TABLE temporal_filter_apply_func_ptr_array[ASM_TYPE_TOTAL][2] = {
+    // C_DEFAULT
+    {/*0 8xM  */ eb_vp9_temporal_filter_apply_kernel,
+     /*1 16xM */ eb_vp9_temporal_filter_apply_kernel},
+    // AVX2
+    {/*0 8xM  */ eb_vp9_temporal_filter_apply_sse2_intrin,
+     /*1 16xM */ eb_vp9_temporal_filter_apply_avx2_intrin},
+};
+
+/***************************************
+ * Extern Function Declaration
+ ***************************************/
+// Filters the source samples of the SB in place with the past pictures selected @ PictureDecisionProcess(),
+// must be called once the ME of the SB is done
+extern void eb_vp9_temporal_filter_sb(PictureParentControlSet *picture_control_set_ptr, uint32_t sb_index,
+                                      uint32_t sb_origin_x, uint32_t sb_origin_y);
+
+#ifdef __cplusplus
+}
+#endif
+#endif // EbTemporalFiltering_h
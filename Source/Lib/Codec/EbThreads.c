@@ -159,15 +159,20 @@ EbErrorType eb_stop_thread(EbHandle thread_handle) {
 
 /****************************************
  * eb_vp9_destroy_thread
+ *   Waits for the thread to return and
+ *   releases its handle. The thread must
+ *   have been asked to quit beforehand
+ *   (see eb_vp9_shutdown_process).
  ****************************************/
 EbErrorType eb_vp9_destroy_thread(EbHandle thread_handle) {
     EbErrorType error_return = EB_ErrorNone;
 
 #ifdef _WIN32
-    error_return = TerminateThread((HANDLE)thread_handle, 0) ? EB_ErrorDestroyThreadFailed : EB_ErrorNone;
+    error_return = WaitForSingleObject((HANDLE)thread_handle, INFINITE) == WAIT_OBJECT_0 ? EB_ErrorNone
+                                                                                         : EB_ErrorDestroyThreadFailed;
+    CloseHandle((HANDLE)thread_handle);
 #elif __linux__
-    error_return = pthread_cancel(*((pthread_t *)thread_handle)) ? EB_ErrorDestroyThreadFailed : EB_ErrorNone;
-    pthread_join(*((pthread_t *)thread_handle), NULL);
+    error_return = pthread_join(*((pthread_t *)thread_handle), NULL) ? EB_ErrorDestroyThreadFailed : EB_ErrorNone;
     free(thread_handle);
 #endif // _WIN32
 
@@ -231,6 +236,25 @@ EbErrorType eb_vp9_block_on_semaphore(EbHandle semaphore_handle) {
     return return_error;
 }
 
+/***************************************
+ * eb_vp9_try_semaphore
+ *   Decrements the semaphore without blocking,
+ *   returns EB_NoErrorEmptyQueue when its
+ *   count is already zero
+ ***************************************/
+EbErrorType eb_vp9_try_semaphore(EbHandle semaphore_handle) {
+    EbErrorType return_error = EB_ErrorNone;
+
+#ifdef _WIN32
+    return_error = WaitForSingleObject((HANDLE)semaphore_handle, 0) == WAIT_OBJECT_0 ? EB_ErrorNone
+                                                                                     : EB_NoErrorEmptyQueue;
+#elif __linux__
+    return_error = sem_trywait((sem_t *)semaphore_handle) ? EB_NoErrorEmptyQueue : EB_ErrorNone;
+#endif // _WIN32
+
+    return return_error;
+}
+
 /***************************************
  * eb_vp9_destroy_semaphore
  ***************************************/
@@ -34,6 +34,7 @@ extern EbErrorType eb_vp9_destroy_thread(EbHandle thread_handle);
 extern EbHandle    eb_vp9_create_semaphore(uint32_t initial_count, uint32_t max_count);
 extern EbErrorType eb_vp9_post_semaphore(EbHandle semaphore_handle);
 extern EbErrorType eb_vp9_block_on_semaphore(EbHandle semaphore_handle);
+extern EbErrorType eb_vp9_try_semaphore(EbHandle semaphore_handle);
 extern EbErrorType eb_vp9_destroy_semaphore(EbHandle semaphore_handle);
 /**************************************
  * Mutex
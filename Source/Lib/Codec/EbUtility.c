@@ -13,9 +13,11 @@
 #include <stdio.h>
 
 //#endif
+#include <windows.h>
 #elif __linux__
 #include <stdio.h>
 #include <stdlib.h>
+#include <sys/mman.h>
 #include "EbDefinitions.h"
 //#if   (LINUX_ENCODER_TIMING || LINUX_DECODER_TIMING)
 #include <sys/time.h>
@@ -609,3 +611,72 @@ void build_ep_block_stats() {
 }
 
 const EpBlockStats *ep_get_block_stats(uint32_t bidx_mds) { return &ep_block_stats_ptr_mds[bidx_mds]; }
+
+/****************************************
+ * eb_vp9_huge_page_malloc
+ *  Allocates a buffer of huge pages: explicit huge pages from the
+ *  reserved pool with HUGE_PAGES_EXPLICIT when available, huge page
+ *  aligned and advised as transparent huge pages otherwise.
+ *  Fills the memory map entry used to release it.
+ ****************************************/
+EbPtr eb_vp9_huge_page_malloc(size_t size, EbMemoryMapEntry *memory_entry) {
+    EbPtr ptr = NULL;
+#ifdef _WIN32
+    const size_t large_page_size = GetLargePageMinimum();
+    // Large pages need the SeLockMemoryPrivilege, there is no transparent equivalent
+    if (eb_vp9_huge_pages == HUGE_PAGES_EXPLICIT && large_page_size) {
+        const size_t mapped_size = (size + large_page_size - 1) & ~(large_page_size - 1);
+        ptr = VirtualAlloc(NULL, mapped_size, MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES, PAGE_READWRITE);
+        if (ptr) {
+            memory_entry->ptr_type = EB_H_PTR;
+            size                   = mapped_size;
+            *total_lib_huge_page_memory += mapped_size;
+        }
+    }
+    if (ptr == NULL) {
+        ptr = _aligned_malloc(size, ALVALUE);
+        if (ptr == NULL)
+            return NULL;
+        memory_entry->ptr_type = EB_A_PTR;
+    }
+#else
+#ifdef MAP_HUGETLB
+    if (eb_vp9_huge_pages == HUGE_PAGES_EXPLICIT) {
+        const size_t mapped_size = (size + HUGE_PAGE_SIZE - 1) & ~((size_t)HUGE_PAGE_SIZE - 1);
+        // The pages are reserved by mmap, an exhausted pool fails here rather than at first touch
+        ptr = mmap(NULL, mapped_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if (ptr == MAP_FAILED)
+            ptr = NULL;
+        else {
+            memory_entry->ptr_type = EB_H_PTR;
+            size                   = mapped_size;
+            *total_lib_huge_page_memory += mapped_size;
+        }
+    }
+#endif
+    if (ptr == NULL) {
+        if (posix_memalign(&ptr, HUGE_PAGE_SIZE, size) != 0)
+            return NULL;
+        memory_entry->ptr_type = EB_A_PTR;
+#ifdef MADV_HUGEPAGE
+        // Only the whole huge pages can be backed, the tail of the buffer stays on regular pages
+        if (madvise(ptr, size, MADV_HUGEPAGE) == 0)
+            *total_lib_huge_page_memory += size & ~((size_t)HUGE_PAGE_SIZE - 1);
+#endif
+    }
+#endif
+    memory_entry->ptr  = ptr;
+    memory_entry->size = size;
+    return ptr;
+}
+
+/****************************************
+ * eb_vp9_huge_page_free
+ ****************************************/
+void eb_vp9_huge_page_free(EbMemoryMapEntry *memory_entry) {
+#ifdef _WIN32
+    VirtualFree(memory_entry->ptr, 0, MEM_RELEASE);
+#else
+    munmap(memory_entry->ptr, memory_entry->size);
+#endif
+}
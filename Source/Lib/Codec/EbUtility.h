@@ -17,6 +17,9 @@ extern "C" {
  ****************************/
 void build_ep_block_stats();
 
+extern EbPtr eb_vp9_huge_page_malloc(size_t size, EbMemoryMapEntry *memory_entry);
+extern void  eb_vp9_huge_page_free(EbMemoryMapEntry *memory_entry);
+
 typedef struct EpBlockStats {
     uint8_t depth; // depth of the block
     Part    shape; // P_N..P_V4 . P_S is not used.
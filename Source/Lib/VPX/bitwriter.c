@@ -10,21 +10,77 @@
 
 #include "./bitwriter.h"
 
-void eb_vp9_start_encode(VpxWriter *br, uint8_t *source) {
+void eb_vp9_start_encode(VpxWriter *br, uint8_t *source, unsigned int size) {
     br->lowvalue = 0;
     br->range    = 255;
-    br->count    = -24;
+    br->count    = 0;
     br->buffer   = source;
     br->pos      = 0;
+    br->size     = size;
+    br->error    = 0;
     vpx_write_bit(br, 0);
 }
 
+/*********************************************************************
+ * flush_bytes
+ *   Resolves the pending carry of the window into the bytes already
+ *   written, then moves the byte_count most significant bytes of the
+ *   window to the buffer. Bytes that do not fit in the buffer are
+ *   dropped and the error flag is raised.
+ *********************************************************************/
+static void flush_bytes(VpxWriter *br, int byte_count) {
+    const int window_bits = br->count + 8;
+    uint64_t  lowvalue    = br->lowvalue;
+    int       i;
+
+    if (lowvalue >> window_bits) {
+        int x = br->pos - 1;
+
+        while (x >= 0 && br->buffer[x] == 0xff) {
+            br->buffer[x] = 0;
+            x--;
+        }
+
+        br->buffer[x] += 1;
+        lowvalue &= ((uint64_t)1 << window_bits) - 1;
+    }
+
+    for (i = 1; i <= byte_count; i++) {
+        if (br->pos < br->size)
+            br->buffer[br->pos++] = (uint8_t)(lowvalue >> (window_bits - (i << 3)));
+        else
+            br->error = 1;
+    }
+
+    br->count -= byte_count << 3;
+    br->lowvalue = lowvalue & (((uint64_t)1 << (br->count + 8)) - 1);
+}
+
+void eb_vp9_flush_encode(VpxWriter *br) { flush_bytes(br, br->count >> 3); }
+
 void eb_vp9_stop_encode(VpxWriter *br) {
-    int i;
+    unsigned int stream_size;
+    int          i;
 
+    // The bytes flushed before the padding all belong to the stream, the padding
+    // then stays in the window so that its tail is never written to the buffer
+    eb_vp9_flush_encode(br);
     for (i = 0; i < 32; i++) vpx_write_bit(br, 0);
+    if (br->error)
+        return;
+
+    // The padding makes every pending bit final. The last 24 to 31 bits are
+    // not part of the stream.
+    stream_size = vpx_writer_tell(br);
+    flush_bytes(br, stream_size - br->pos);
+    br->count    = 16; // vpx_writer_tell() now returns pos
+    br->lowvalue = 0;
 
     // Ensure there's no ambigous collision with any index marker bytes
-    if ((br->buffer[br->pos - 1] & 0xe0) == 0xc0)
-        br->buffer[br->pos++] = 0;
+    if ((br->buffer[br->pos - 1] & 0xe0) == 0xc0) {
+        if (br->pos < br->size)
+            br->buffer[br->pos++] = 0;
+        else
+            br->error = 1;
+    }
 }
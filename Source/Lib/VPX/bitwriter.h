@@ -20,27 +20,33 @@
 extern "C" {
 #endif
 
+// The writer accumulates the coded bits in a 64-bit window and only moves
+// whole bytes to the output once VPX_WRITER_FLUSH_COUNT bits are pending, so
+// the carry out of the window is resolved once per flush instead of per byte.
+#define VPX_WRITER_FLUSH_COUNT 48
+// Largest count for which a write of up to 7 bits plus its carry still fits in
+// the 64-bit window (count + 8 range bits + carry bit <= 64)
+#define VPX_WRITER_MAX_COUNT 55
+
 typedef struct VpxWriter {
-    unsigned int lowvalue;
+    uint64_t     lowvalue; // low end of the interval, count + 8 bits plus a pending carry bit
     unsigned int range;
-    int          count;
+    int          count; // number of bits in lowvalue above the 8 bits of range precision
     unsigned int pos;
+    unsigned int size; // capacity of buffer in bytes
+    int          error; // set when the coded data did not fit in buffer
     uint8_t     *buffer;
 } VpxWriter;
 
-void eb_vp9_start_encode(VpxWriter *bc, uint8_t *buffer);
+void eb_vp9_start_encode(VpxWriter *bc, uint8_t *buffer, unsigned int size);
 void eb_vp9_stop_encode(VpxWriter *bc);
+void eb_vp9_flush_encode(VpxWriter *bc);
 
 static INLINE void vpx_write(VpxWriter *br, int bit, int probability) {
-    unsigned int split;
-    int          count    = br->count;
-    unsigned int range    = br->range;
-    unsigned int lowvalue = br->lowvalue;
-    int          shift;
-
-    split = 1 + (((range - 1) * probability) >> 8);
-
-    range = split;
+    const unsigned int split    = 1 + (((br->range - 1) * probability) >> 8);
+    unsigned int       range    = split;
+    uint64_t           lowvalue = br->lowvalue;
+    int                shift;
 
     if (bit) {
         lowvalue += split;
@@ -49,44 +55,64 @@ static INLINE void vpx_write(VpxWriter *br, int bit, int probability) {
 
     shift = eb_vp9_norm[range];
 
-    range <<= shift;
-    count += shift;
+    br->range    = range << shift;
+    br->lowvalue = lowvalue << shift;
+    br->count += shift;
+
+    if (br->count >= VPX_WRITER_FLUSH_COUNT)
+        eb_vp9_flush_encode(br);
+}
+
+// Writes bits with probability one half: the split is (range + 1) >> 1, and
+// since range stays in [64, 128] after the split the renormalization is at
+// most one bit, so no table lookup nor flush is needed inside the loop.
+static INLINE void vpx_write_literal(VpxWriter *w, int data, int bits) {
+    uint64_t     lowvalue;
+    unsigned int range;
+    int          count;
+    int          bit;
 
-    if (count >= 0) {
-        int offset = shift - count;
+    if (w->count + bits > VPX_WRITER_MAX_COUNT)
+        eb_vp9_flush_encode(w);
 
-        if ((lowvalue << (offset - 1)) & 0x80000000) {
-            int x = br->pos - 1;
+    lowvalue = w->lowvalue;
+    range    = w->range;
+    count    = w->count;
 
-            while (x >= 0 && br->buffer[x] == 0xff) {
-                br->buffer[x] = 0;
-                x--;
-            }
+    for (bit = bits - 1; bit >= 0; bit--) {
+        const unsigned int split = (range + 1) >> 1;
+        int                shift;
 
-            br->buffer[x] += 1;
-        }
+        if ((data >> bit) & 1) {
+            lowvalue += split;
+            range -= split;
+        } else
+            range = split;
 
-        br->buffer[br->pos++] = (uint8_t)(lowvalue >> (24 - offset));
-        lowvalue <<= offset;
-        shift = count;
-        lowvalue &= 0xffffff;
-        count -= 8;
+        shift = range < 128;
+        range <<= shift;
+        lowvalue <<= shift;
+        count += shift;
     }
 
-    lowvalue <<= shift;
-    br->count    = count;
-    br->lowvalue = lowvalue;
-    br->range    = range;
+    w->lowvalue = lowvalue;
+    w->range    = range;
+    w->count    = count;
+
+    if (count >= VPX_WRITER_FLUSH_COUNT)
+        eb_vp9_flush_encode(w);
 }
 
 static INLINE void vpx_write_bit(VpxWriter *w, int bit) {
-    vpx_write(w, bit, 128); // vpx_prob_half
+    vpx_write_literal(w, bit, 1); // vpx_prob_half
 }
 
-static INLINE void vpx_write_literal(VpxWriter *w, int data, int bits) {
-    int bit;
+// Number of bytes the stream holds so far, including the whole bytes still in
+// the window minus the tail that eb_vp9_stop_encode() does not emit
+static INLINE unsigned int vpx_writer_tell(const VpxWriter *w) {
+    const unsigned int total_bits = (w->pos << 3) + w->count;
 
-    for (bit = bits - 1; bit >= 0; bit--) vpx_write_bit(w, 1 & (data >> bit));
+    return total_bits >= 16 ? (total_bits - 16) >> 3 : 0;
 }
 
 #define vpx_write_prob(w, v) vpx_write_literal((w), (v), 8)
@@ -1289,7 +1289,7 @@ static void write_uncompressed_header(PictureControlSet *picture_control_set_ptr
     write_tile_info(cm, wb);
 }
 
-size_t write_compressed_header(VP9_COMP *cpi, uint8_t *data) {
+size_t write_compressed_header(VP9_COMP *cpi, uint8_t *data, size_t size) {
     VP9_COMMON *const cm = &cpi->common;
 #if 0 // xd
   MACROBLOCKD *const xd = &cpi->td.mb.e_mbd;
@@ -1300,7 +1300,7 @@ size_t write_compressed_header(VP9_COMP *cpi, uint8_t *data) {
 
     VpxWriter header_bc;
 
-    eb_vp9_start_encode(&header_bc, data);
+    eb_vp9_start_encode(&header_bc, data, (unsigned int)size);
 #if 1 // xd
     encode_txfm_probs(cm, &header_bc, counts);
 #else
@@ -1361,13 +1361,15 @@ size_t write_compressed_header(VP9_COMP *cpi, uint8_t *data) {
     }
 
     eb_vp9_stop_encode(&header_bc);
+    if (header_bc.error)
+        return 0;
     assert(header_bc.pos <= 0xffff);
 
     return header_bc.pos;
 }
 
-void eb_vp9_pack_bitstream(PictureControlSet *picture_control_set_ptr, VP9_COMP *cpi, uint8_t *dest, size_t *size,
-                           int show_existing_frame, int show_existing_frame_index) {
+EbErrorType eb_vp9_pack_bitstream(PictureControlSet *picture_control_set_ptr, VP9_COMP *cpi, uint8_t *dest,
+                                  size_t *size, int show_existing_frame, int show_existing_frame_index) {
     uint8_t                    *data = dest;
     size_t                      first_part_size, uncompressed_hdr_size;
     struct vpx_write_bit_buffer wb = {data, 0};
@@ -1378,7 +1380,7 @@ void eb_vp9_pack_bitstream(PictureControlSet *picture_control_set_ptr, VP9_COMP
     // Skip the rest coding process if use show existing frame.
     if (show_existing_frame) {
         *size = eb_vp9_wb_bytes_written(&wb);
-        return;
+        return EB_ErrorNone;
     }
 
     saved_wb = wb;
@@ -1389,24 +1391,42 @@ void eb_vp9_pack_bitstream(PictureControlSet *picture_control_set_ptr, VP9_COMP
 #if 0 // Hsan
   vpx_clear_system_state();
 #endif
-    first_part_size = write_compressed_header(cpi, data);
+    OutputBitstreamUnit *output_bitstream_ptr =
+        (OutputBitstreamUnit *)picture_control_set_ptr->bitstream_ptr->output_bitstream_ptr;
+    size_t capacity = output_bitstream_ptr->size - (size_t)(data - output_bitstream_ptr->buffer_begin);
+
+    first_part_size = write_compressed_header(cpi, data, capacity);
+    if (first_part_size == 0) {
+        *size = uncompressed_hdr_size;
+        return EB_ErrorInsufficientResources;
+    }
+    capacity -= first_part_size;
     data += first_part_size;
     // TODO(jbb): Figure out what to do if first_part_size > 16 bits.
     eb_vp9_wb_write_literal(&saved_wb, (int)first_part_size, 16);
 
 #if 1 // Hsan ------------------------------------
-    // Link data from EC stream to final stream.
-    unsigned int ecOutputBitstreamSize = picture_control_set_ptr->entropy_coder_ptr->residual_bc.pos;
+    // Link data from EC stream to final stream, except the part already output in partial packets.
+    unsigned int ecOutputBitstreamSize = picture_control_set_ptr->entropy_coder_ptr->residual_bc.pos -
+        picture_control_set_ptr->entropy_coding_released_size;
 
     OutputBitstreamUnit *ec_output_bitstream_ptr =
         (OutputBitstreamUnit *)picture_control_set_ptr->entropy_coder_ptr->ec_output_bitstream_ptr;
 
     // Copy from EC stream to frame stream
-    EB_MEMCPY(data, ec_output_bitstream_ptr->buffer_begin, ecOutputBitstreamSize);
+    if (ecOutputBitstreamSize > capacity) {
+        *size = data - dest;
+        return EB_ErrorInsufficientResources;
+    }
+    EB_MEMCPY(data,
+              ec_output_bitstream_ptr->buffer_begin + picture_control_set_ptr->entropy_coding_released_size,
+              ecOutputBitstreamSize);
     data += ecOutputBitstreamSize;
 #else
     data += encode_tiles(cpi, data);
 #endif
 
     *size = data - dest;
+
+    return EB_ErrorNone;
 }
@@ -42,8 +42,9 @@ int vp9_get_refresh_mask(VP9_COMP *cpi);
 #endif
 void vp9_bitstream_encode_tiles_buffer_dealloc(VP9_COMP *const cpi);
 
-void eb_vp9_pack_bitstream(PictureControlSet *picture_control_set_ptr, VP9_COMP *cpi, uint8_t *dest, size_t *size,
-                           int show_existing_frame, int show_existing_frame_index);
+// Returns EB_ErrorInsufficientResources when the frame does not fit in the packetization buffer
+EbErrorType eb_vp9_pack_bitstream(PictureControlSet *picture_control_set_ptr, VP9_COMP *cpi, uint8_t *dest,
+                                  size_t *size, int show_existing_frame, int show_existing_frame_index);
 
 #if 0
 static INLINE int vp9_preserve_existing_gf(VP9_COMP *cpi) {
@@ -60,7 +61,8 @@ void eb_vp9_write_modes_b(EntropyCodingContext *context_ptr, VP9_COMP *cpi, MACR
                           int mi_row, int mi_col, unsigned int *const max_mv_magnitude,
                           int interp_filter_selected[MAX_REF_FRAMES][SWITCHABLE]);
 
-size_t write_compressed_header(VP9_COMP *cpi, uint8_t *data);
+// Returns 0 when the header does not fit in size bytes
+size_t write_compressed_header(VP9_COMP *cpi, uint8_t *data, size_t size);
 
 #ifdef __cplusplus
 } // extern "C"
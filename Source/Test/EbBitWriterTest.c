@@ -0,0 +1,283 @@
+/*
+* Copyright(c) 2019 Intel Corporation
+* SPDX - License - Identifier: BSD - 2 - Clause - Patent
+*/
+
+/**************************************
+ * Bit Writer Test
+ *   The boolean encoder with the 64-bit window must give the bytes of the
+ *   libvpx writer it replaced, kept below with its 24-bit window, on random
+ *   streams of token like symbols, literals and carry runs. A writer that
+ *   runs out of buffer must raise its error flag without writing past its
+ *   size. Both writers are then timed on the same symbols.
+ **************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "bitwriter.h"
+
+#define TEST_CHECK(cond)                                                   \
+    do {                                                                   \
+        if (!(cond)) {                                                     \
+            printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+            return 1;                                                      \
+        }                                                                  \
+    } while (0)
+
+#define TEST_STREAM_COUNT 2000
+#define TEST_MAX_SYMBOL_COUNT 20000
+#define TEST_BUFFER_SIZE (TEST_MAX_SYMBOL_COUNT * 2 + 64)
+#define TEST_GUARD_SIZE 16
+#define TEST_GUARD_BYTE 0xa5
+#define BENCH_SYMBOL_COUNT 1000000
+#define BENCH_REPEAT_COUNT 20
+
+typedef enum SymbolType { SYMBOL_BOOL, SYMBOL_LITERAL } SymbolType;
+
+typedef struct Symbol {
+    uint8_t type;
+    uint8_t probability; // SYMBOL_BOOL
+    uint8_t bits; // SYMBOL_LITERAL
+    int     data;
+} Symbol;
+
+/**************************************
+ * Reference writer, the libvpx one with a 24-bit window
+ **************************************/
+typedef struct RefWriter {
+    unsigned int lowvalue;
+    unsigned int range;
+    int          count;
+    unsigned int pos;
+    uint8_t     *buffer;
+} RefWriter;
+
+static INLINE void ref_write(RefWriter *br, int bit, int probability) {
+    unsigned int split;
+    int          count    = br->count;
+    unsigned int range    = br->range;
+    unsigned int lowvalue = br->lowvalue;
+    int          shift;
+
+    split = 1 + (((range - 1) * probability) >> 8);
+
+    range = split;
+
+    if (bit) {
+        lowvalue += split;
+        range = br->range - split;
+    }
+
+    shift = eb_vp9_norm[range];
+
+    range <<= shift;
+    count += shift;
+
+    if (count >= 0) {
+        int offset = shift - count;
+
+        if ((lowvalue << (offset - 1)) & 0x80000000) {
+            int x = br->pos - 1;
+
+            while (x >= 0 && br->buffer[x] == 0xff) {
+                br->buffer[x] = 0;
+                x--;
+            }
+
+            br->buffer[x] += 1;
+        }
+
+        br->buffer[br->pos++] = (uint8_t)(lowvalue >> (24 - offset));
+        lowvalue <<= offset;
+        shift = count;
+        lowvalue &= 0xffffff;
+        count -= 8;
+    }
+
+    lowvalue <<= shift;
+    br->count    = count;
+    br->lowvalue = lowvalue;
+    br->range    = range;
+}
+
+static INLINE void ref_write_literal(RefWriter *w, int data, int bits) {
+    int bit;
+
+    for (bit = bits - 1; bit >= 0; bit--) ref_write(w, 1 & (data >> bit), 128);
+}
+
+static void ref_start_encode(RefWriter *br, uint8_t *source) {
+    br->lowvalue = 0;
+    br->range    = 255;
+    br->count    = -24;
+    br->buffer   = source;
+    br->pos      = 0;
+    ref_write(br, 0, 128);
+}
+
+static void ref_stop_encode(RefWriter *br) {
+    int i;
+
+    for (i = 0; i < 32; i++) ref_write(br, 0, 128);
+
+    if ((br->buffer[br->pos - 1] & 0xe0) == 0xc0)
+        br->buffer[br->pos++] = 0;
+}
+
+/**************************************
+ * Symbol streams
+ **************************************/
+static uint32_t random_state = 1;
+
+static uint32_t random_next(void) {
+    random_state = random_state * 1664525u + 1013904223u;
+    return random_state >> 8;
+}
+
+// Coefficient tokens are mostly coded with skewed probabilities and the likely
+// branch, carry runs come from long sequences of unlikely ones
+static void generate_stream(Symbol *symbols, uint32_t symbol_count, int carry_runs) {
+    uint32_t index;
+
+    for (index = 0; index < symbol_count; ++index) {
+        Symbol *symbol = &symbols[index];
+
+        if (random_next() % 8 == 0) {
+            symbol->type = SYMBOL_LITERAL;
+            symbol->bits = (uint8_t)(1 + random_next() % 16);
+            symbol->data = (int)(random_next() & ((1u << symbol->bits) - 1));
+        } else {
+            symbol->type        = SYMBOL_BOOL;
+            symbol->probability = (uint8_t)(1 + random_next() % 255);
+            if (carry_runs && (index / 64) % 2) {
+                symbol->probability = 255;
+                symbol->data        = 1;
+            } else
+                symbol->data = (int)(random_next() % 256) >= symbol->probability;
+        }
+    }
+}
+
+static void write_stream(VpxWriter *writer, const Symbol *symbols, uint32_t symbol_count) {
+    uint32_t index;
+
+    for (index = 0; index < symbol_count; ++index) {
+        if (symbols[index].type == SYMBOL_LITERAL)
+            vpx_write_literal(writer, symbols[index].data, symbols[index].bits);
+        else
+            vpx_write(writer, symbols[index].data, symbols[index].probability);
+    }
+}
+
+static void ref_write_stream(RefWriter *writer, const Symbol *symbols, uint32_t symbol_count) {
+    uint32_t index;
+
+    for (index = 0; index < symbol_count; ++index) {
+        if (symbols[index].type == SYMBOL_LITERAL)
+            ref_write_literal(writer, symbols[index].data, symbols[index].bits);
+        else
+            ref_write(writer, symbols[index].data, symbols[index].probability);
+    }
+}
+
+/**************************************
+ * Conformance
+ **************************************/
+static int run_conformance_test(Symbol *symbols, uint8_t *buffer, uint8_t *ref_buffer) {
+    uint32_t stream_index;
+
+    for (stream_index = 0; stream_index < TEST_STREAM_COUNT; ++stream_index) {
+        const uint32_t symbol_count = stream_index < 64 ? stream_index : 1 + random_next() % TEST_MAX_SYMBOL_COUNT;
+        VpxWriter      writer;
+        RefWriter      ref_writer;
+        unsigned int   byte_index;
+
+        generate_stream(symbols, symbol_count, stream_index % 4 == 3);
+
+        memset(ref_buffer, 0, TEST_BUFFER_SIZE);
+        ref_start_encode(&ref_writer, ref_buffer);
+        ref_write_stream(&ref_writer, symbols, symbol_count);
+        ref_stop_encode(&ref_writer);
+
+        // Exact fit
+        memset(buffer, TEST_GUARD_BYTE, TEST_BUFFER_SIZE + TEST_GUARD_SIZE);
+        eb_vp9_start_encode(&writer, buffer, ref_writer.pos);
+        write_stream(&writer, symbols, symbol_count);
+        eb_vp9_stop_encode(&writer);
+        TEST_CHECK(writer.error == 0);
+        TEST_CHECK(writer.pos == ref_writer.pos);
+        TEST_CHECK(memcmp(buffer, ref_buffer, ref_writer.pos) == 0);
+        TEST_CHECK(buffer[ref_writer.pos] == TEST_GUARD_BYTE);
+
+        // One byte short, the error is raised and nothing is written past the size
+        memset(buffer, TEST_GUARD_BYTE, TEST_BUFFER_SIZE + TEST_GUARD_SIZE);
+        eb_vp9_start_encode(&writer, buffer, ref_writer.pos - 1);
+        write_stream(&writer, symbols, symbol_count);
+        eb_vp9_stop_encode(&writer);
+        TEST_CHECK(writer.error == 1);
+        for (byte_index = ref_writer.pos - 1; byte_index < TEST_BUFFER_SIZE + TEST_GUARD_SIZE; ++byte_index)
+            TEST_CHECK(buffer[byte_index] == TEST_GUARD_BYTE);
+    }
+
+    return 0;
+}
+
+/**************************************
+ * Throughput
+ **************************************/
+static double elapsed_seconds(clock_t start) { return (double)(clock() - start) / CLOCKS_PER_SEC; }
+
+static void run_benchmark(Symbol *symbols, uint8_t *buffer, uint8_t *ref_buffer) {
+    double       seconds, ref_seconds;
+    unsigned int bits = 0;
+    clock_t      start;
+    int          repeat;
+
+    generate_stream(symbols, BENCH_SYMBOL_COUNT, 0);
+
+    start = clock();
+    for (repeat = 0; repeat < BENCH_REPEAT_COUNT; ++repeat) {
+        RefWriter ref_writer;
+
+        ref_start_encode(&ref_writer, ref_buffer);
+        ref_write_stream(&ref_writer, symbols, BENCH_SYMBOL_COUNT);
+        ref_stop_encode(&ref_writer);
+        bits = ref_writer.pos << 3;
+    }
+    ref_seconds = elapsed_seconds(start);
+
+    start = clock();
+    for (repeat = 0; repeat < BENCH_REPEAT_COUNT; ++repeat) {
+        VpxWriter writer;
+
+        eb_vp9_start_encode(&writer, buffer, BENCH_SYMBOL_COUNT * 8);
+        write_stream(&writer, symbols, BENCH_SYMBOL_COUNT);
+        eb_vp9_stop_encode(&writer);
+    }
+    seconds = elapsed_seconds(start);
+
+    printf("24-bit writer: %.1f Mbit/s\n", ref_seconds > 0 ? bits * (double)BENCH_REPEAT_COUNT / ref_seconds / 1e6 : 0);
+    printf("64-bit writer: %.1f Mbit/s\n", seconds > 0 ? bits * (double)BENCH_REPEAT_COUNT / seconds / 1e6 : 0);
+}
+
+int main(void) {
+    Symbol  *symbols    = (Symbol *)malloc(sizeof(Symbol) * BENCH_SYMBOL_COUNT);
+    uint8_t *buffer     = (uint8_t *)malloc(BENCH_SYMBOL_COUNT * 8);
+    uint8_t *ref_buffer = (uint8_t *)malloc(BENCH_SYMBOL_COUNT * 8);
+    int      result     = 1;
+
+    if (symbols && buffer && ref_buffer) {
+        result = run_conformance_test(symbols, buffer, ref_buffer);
+        if (result == 0)
+            run_benchmark(symbols, buffer, ref_buffer);
+    }
+
+    free(symbols);
+    free(buffer);
+    free(ref_buffer);
+
+    printf("%s\n", result ? "FAIL" : "PASS");
+    return result;
+}
@@ -0,0 +1,210 @@
+/*
+* Copyright(c) 2019 Intel Corporation
+* SPDX - License - Identifier: BSD - 2 - Clause - Patent
+*/
+
+/**************************************
+ * Coefficient Rate Test
+ *   coeff_rate_estimate tokenizes the coeffs in bulk (C up to
+ *   COEFF_TOKENIZE_LOW_EOB, AVX2 above) and has a closed form for the DC
+ *   only blocks. On random blocks, random token costs and every eob from 0
+ *   to the block size, it must give the cost of the serial libvpx loop, with
+ *   the C kernels and, when the CPU has them, the AVX2 ones.
+ **************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "EbEncHandle.h"
+#include "EbRateDistortionCost.h"
+#include "vp9_scan.h"
+#include "vp9_tokenize.h"
+
+#define TEST_CHECK(cond)                                                   \
+    do {                                                                   \
+        if (!(cond)) {                                                     \
+            printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+            return 1;                                                      \
+        }                                                                  \
+    } while (0)
+
+#define TEST_BLOCK_COUNT 40
+#define TEST_MAX_TOKEN_COST 4096
+
+static const int16_t band_counts[TX_SIZES][8] = {
+    {1, 2, 3, 4, 3, 16 - 13, 0},
+    {1, 2, 3, 4, 11, 64 - 21, 0},
+    {1, 2, 3, 4, 11, 256 - 21, 0},
+    {1, 2, 3, 4, 11, 1024 - 21, 0},
+};
+
+static uint32_t random_state = 1;
+
+static uint32_t random_next(void) {
+    random_state = random_state * 1664525u + 1013904223u;
+    return random_state >> 8;
+}
+
+/**************************************
+ * Reference, the serial libvpx loop (cost_coeffs, !use_fast_coef_costing)
+ **************************************/
+static int ref_coeff_cost(const int16_t *qcoeff, const scan_order *so, TX_SIZE tx_size,
+                          unsigned int (*token_costs)[2][COEFF_CONTEXTS][ENTROPY_TOKENS], int pt, int eob) {
+    const int16_t  *band_count     = &band_counts[tx_size][1];
+    const uint16_t *cat6_high_cost = vp9_get_high_cost_table(8);
+    uint8_t         token_cache[32 * 32];
+    int             band_left = *band_count++;
+    int             cost;
+    int             c;
+    int16_t         tok;
+    unsigned int (*tok_cost_ptr)[COEFF_CONTEXTS][ENTROPY_TOKENS];
+
+    if (eob == 0)
+        return token_costs[0][0][pt][EOB_TOKEN];
+
+    // dc token
+    cost = vp9_get_token_cost(qcoeff[0], &tok, cat6_high_cost);
+    cost += (*token_costs)[0][pt][tok];
+
+    token_cache[0] = eb_vp9_pt_energy_class[tok];
+    ++token_costs;
+
+    tok_cost_ptr = &((*token_costs)[!tok]);
+
+    // ac tokens
+    for (c = 1; c < eob; c++) {
+        const int rc = so->scan[c];
+
+        cost += vp9_get_token_cost(qcoeff[rc], &tok, cat6_high_cost);
+        pt = get_coef_context(so->neighbors, token_cache, c);
+        cost += (*tok_cost_ptr)[pt][tok];
+        token_cache[rc] = eb_vp9_pt_energy_class[tok];
+        if (!--band_left) {
+            band_left = *band_count++;
+            ++token_costs;
+        }
+        tok_cost_ptr = &((*token_costs)[!tok]);
+    }
+
+    // eob token
+    if (band_left) {
+        pt = get_coef_context(so->neighbors, token_cache, c);
+        cost += (*token_costs)[0][pt][EOB_TOKEN];
+    }
+
+    return cost;
+}
+
+/**************************************
+ * Random blocks
+ **************************************/
+// Mostly small values, with the CATEGORY1 .. CATEGORY6 ranges (up to the 8-bit DCT_MAX_VALUE) and the
+// CATEGORY6 bound on both signs
+static int16_t random_coeff(void) {
+    const uint32_t range = random_next() % 100;
+    int            v;
+
+    if (range < 40)
+        v = 0;
+    else if (range < 75)
+        v = 1 + random_next() % 4;
+    else if (range < 90)
+        v = 5 + random_next() % (CAT6_MIN_VAL - 5);
+    else if (range < 95)
+        v = CAT6_MIN_VAL - 1 + random_next() % 3;
+    else
+        v = CAT6_MIN_VAL + random_next() % (DCT_MAX_VALUE - CAT6_MIN_VAL);
+
+    return (int16_t)((random_next() & 1) ? -v : v);
+}
+
+static void fill_token_costs(vp9_coeff_cost *token_costs) {
+    unsigned int *cost  = &token_costs[0][0][0][0][0][0][0];
+    size_t        count = sizeof(vp9_coeff_cost) * TX_SIZES / sizeof(unsigned int);
+    size_t        index;
+
+    for (index = 0; index < count; ++index) cost[index] = random_next() % TEST_MAX_TOKEN_COST;
+}
+
+/**************************************
+ * Conformance
+ **************************************/
+static int run_block_test(EncDecContext *context_ptr, MACROBLOCK *x, uint32_t cpu_asm_type, TX_SIZE tx_size,
+                          int plane, int16_t *qcoeff) {
+    MACROBLOCKD *const xd          = context_ptr->e_mbd;
+    const int          max_eob     = 16 << (tx_size << 1);
+    const TX_TYPE      tx_type     = get_tx_type(get_plane_type(plane), xd);
+    const scan_order  *so          = tx_size == TX_32X32 ? &eb_vp9_default_scan_orders[TX_32X32]
+                                                         : &eb_vp9_scan_orders[tx_size][tx_type];
+    unsigned int(*token_costs)[2][COEFF_CONTEXTS][ENTROPY_TOKENS] =
+        x->token_costs[tx_size][get_plane_type(plane)][is_inter_block(xd->mi[0])];
+    int eob;
+
+    for (eob = 0; eob <= max_eob; ++eob) {
+        const int pt       = random_next() % COEFF_CONTEXTS;
+        const int ref_cost = ref_coeff_cost(qcoeff, so, tx_size, token_costs, pt, eob);
+
+        eb_vp9_ASM_TYPES = 0;
+        TEST_CHECK(coeff_rate_estimate(context_ptr, x, qcoeff, (uint16_t)eob, plane, 0, tx_size, pt, 0) == ref_cost);
+
+        if (cpu_asm_type & AVX2_MASK) {
+            eb_vp9_ASM_TYPES = cpu_asm_type;
+            TEST_CHECK(coeff_rate_estimate(context_ptr, x, qcoeff, (uint16_t)eob, plane, 0, tx_size, pt, 0) ==
+                       ref_cost);
+        }
+    }
+
+    return 0;
+}
+
+static int run_conformance_test(EncDecContext *context_ptr, MACROBLOCK *x, uint32_t cpu_asm_type) {
+    MACROBLOCKD *const xd = context_ptr->e_mbd;
+    ModeInfo *const    mi = xd->mi[0];
+    int16_t            qcoeff[32 * 32];
+    int                block_index;
+
+    for (block_index = 0; block_index < TEST_BLOCK_COUNT; ++block_index) {
+        TX_SIZE tx_size;
+        int     coeff_index;
+
+        fill_token_costs(x->token_costs);
+        for (coeff_index = 0; coeff_index < 32 * 32; ++coeff_index) qcoeff[coeff_index] = random_coeff();
+
+        // Intra blocks cover the ADST scans, the inter ones the DCT one
+        mi->ref_frame[0] = (block_index & 1) ? LAST_FRAME : INTRA_FRAME;
+        mi->mode         = (PREDICTION_MODE)(random_next() % INTRA_MODES);
+        mi->sb_type      = BLOCK_64X64;
+
+        for (tx_size = TX_4X4; tx_size < TX_SIZES; ++tx_size) {
+            TEST_CHECK(run_block_test(context_ptr, x, cpu_asm_type, tx_size, 0, qcoeff) == 0);
+            TEST_CHECK(run_block_test(context_ptr, x, cpu_asm_type, tx_size, 1, qcoeff) == 0);
+        }
+    }
+
+    return 0;
+}
+
+int main(void) {
+    const uint32_t cpu_asm_type = get_cpu_asm_type();
+    EncDecContext *context_ptr  = (EncDecContext *)calloc(1, sizeof(EncDecContext));
+    MACROBLOCK    *x            = (MACROBLOCK *)calloc(1, sizeof(MACROBLOCK));
+    MACROBLOCKD   *xd           = (MACROBLOCKD *)calloc(1, sizeof(MACROBLOCKD));
+    ModeInfo      *mi           = (ModeInfo *)calloc(1, sizeof(ModeInfo));
+    int            result       = 1;
+
+    if (context_ptr && x && xd && mi) {
+        xd->mi             = &mi;
+        context_ptr->e_mbd = xd;
+        if (!(cpu_asm_type & AVX2_MASK))
+            printf("no AVX2, the C kernels only are tested\n");
+        result = run_conformance_test(context_ptr, x, cpu_asm_type);
+    }
+
+    free(context_ptr);
+    free(x);
+    free(xd);
+    free(mi);
+
+    printf("%s\n", result ? "FAIL" : "PASS");
+    return result;
+}
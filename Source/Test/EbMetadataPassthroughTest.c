@@ -0,0 +1,159 @@
+/*
+* Copyright(c) 2019 Intel Corporation
+* SPDX - License - Identifier: BSD - 2 - Clause - Patent
+*/
+
+/**************************************
+ * Metadata Passthrough Test
+ *   Every picture is sent with p_app_private pointing to its own tag and a
+ *   user_metadata blob derived from its number. Every tag must come back
+ *   in exactly one packet, the packet of the picture (same pts), with the
+ *   blob of the picture, hidden pictures and show existing frames
+ *   included. With partial packet output the final packet of each picture
+ *   carries them. With an input header of the previous size, which does not
+ *   cover user_metadata, the packets carry p_app_private and a zero blob.
+ **************************************/
+
+#include <stddef.h>
+#include <string.h>
+#include "EbTestEncoder.h"
+
+#define TEST_WIDTH 176
+#define TEST_HEIGHT 144
+#define TEST_PICTURE_COUNT 64
+
+typedef struct PassthroughConfig {
+    uint8_t  enc_mode;
+    int32_t  intra_period;
+    uint32_t partial_packet_output;
+    EbBool   legacy_header;
+} PassthroughConfig;
+
+static const PassthroughConfig passthrough_configs[] = {
+    {9, -1, 0, EB_FALSE},
+    {6, 31, 0, EB_FALSE},
+    {9, 15, 1, EB_FALSE},
+    {9, -1, 0, EB_TRUE},
+};
+
+typedef struct PictureTag {
+    uint64_t picture_number;
+    uint32_t packet_count;
+} PictureTag;
+
+typedef struct PassthroughCheck {
+    PictureTag tags[TEST_PICTURE_COUNT];
+    EbBool     legacy_header;
+    uint32_t   show_existing_count;
+} PassthroughCheck;
+
+static void fill_metadata(uint8_t *user_metadata, uint64_t picture_number) {
+    uint32_t byte_index;
+
+    for (byte_index = 0; byte_index < EB_USER_METADATA_SIZE; ++byte_index)
+        user_metadata[byte_index] = (uint8_t)(picture_number * 7 + byte_index * 13 + 1);
+}
+
+static int check_packet(void *context, const EbBufferHeaderType *packet) {
+    PassthroughCheck *passthrough_check = (PassthroughCheck *)context;
+    PictureTag       *tag               = (PictureTag *)packet->p_app_private;
+    uint8_t           user_metadata[EB_USER_METADATA_SIZE];
+
+    if (tag < passthrough_check->tags || tag >= passthrough_check->tags + TEST_PICTURE_COUNT) {
+        printf("pts %lld: unknown p_app_private %p\n", (long long)packet->pts, packet->p_app_private);
+        return 1;
+    }
+    if (tag->packet_count++) {
+        printf("picture %llu: returned in more than one packet\n", (unsigned long long)tag->picture_number);
+        return 1;
+    }
+    if ((int64_t)tag->picture_number != packet->pts) {
+        printf("picture %llu: returned with the packet of pts %lld\n",
+               (unsigned long long)tag->picture_number,
+               (long long)packet->pts);
+        return 1;
+    }
+
+    if (passthrough_check->legacy_header)
+        memset(user_metadata, 0, sizeof(user_metadata));
+    else
+        fill_metadata(user_metadata, tag->picture_number);
+    if (memcmp(packet->user_metadata, user_metadata, sizeof(user_metadata))) {
+        printf("picture %llu: wrong user_metadata\n", (unsigned long long)tag->picture_number);
+        return 1;
+    }
+    if (packet->flags & EB_BUFFERFLAG_SHOW_EXT)
+        ++passthrough_check->show_existing_count;
+
+    return 0;
+}
+
+static int encode_sequence(TestEncoder *test_encoder, PassthroughCheck *passthrough_check) {
+    uint64_t picture_number;
+    uint32_t tag_index;
+
+    for (picture_number = 0; picture_number < TEST_PICTURE_COUNT; ++picture_number) {
+        PictureTag *tag = &passthrough_check->tags[picture_number];
+
+        tag->picture_number = picture_number;
+        test_encoder_fill(test_encoder, picture_number);
+        test_encoder->input_header.p_app_private = tag;
+        fill_metadata(test_encoder->input_header.user_metadata, picture_number);
+        TEST_CHECK(eb_vp9_svt_enc_send_picture(test_encoder->handle, &test_encoder->input_header) == EB_ErrorNone);
+    }
+    TEST_CHECK(test_encoder_send_eos(test_encoder) == EB_ErrorNone);
+    TEST_CHECK(test_encoder_drain(test_encoder, check_packet, passthrough_check) == TEST_PICTURE_COUNT);
+
+    for (tag_index = 0; tag_index < TEST_PICTURE_COUNT; ++tag_index)
+        TEST_CHECK(passthrough_check->tags[tag_index].packet_count == 1);
+    // The hierarchical structure hides pictures, the packets showing them must not carry tags of their own
+    TEST_CHECK(passthrough_check->show_existing_count > 0);
+
+    return 0;
+}
+
+static int run_passthrough_test(const PassthroughConfig *passthrough_config) {
+    TestEncoder      test_encoder;
+    PassthroughCheck passthrough_check;
+    int              result = 1;
+
+    if (test_encoder_open(&test_encoder, TEST_WIDTH, TEST_HEIGHT) != EB_ErrorNone) {
+        printf("cannot open the encoder\n");
+        test_encoder_close(&test_encoder);
+        return 1;
+    }
+
+    memset(&passthrough_check, 0, sizeof(passthrough_check));
+    passthrough_check.legacy_header = passthrough_config->legacy_header;
+    if (passthrough_config->legacy_header)
+        test_encoder.input_header.size = offsetof(EbBufferHeaderType, user_metadata);
+
+    test_encoder.config.enc_mode              = passthrough_config->enc_mode;
+    test_encoder.config.intra_period          = passthrough_config->intra_period;
+    test_encoder.config.partial_packet_output = passthrough_config->partial_packet_output;
+    if (test_encoder_start(&test_encoder) == EB_ErrorNone)
+        result = encode_sequence(&test_encoder, &passthrough_check);
+    else
+        printf("cannot start the encoder\n");
+    test_encoder_close(&test_encoder);
+
+    if (result)
+        printf("enc mode %u, intra period %d, partial packets %u, legacy header %d failed\n",
+               passthrough_config->enc_mode,
+               passthrough_config->intra_period,
+               passthrough_config->partial_packet_output,
+               passthrough_config->legacy_header);
+
+    return result;
+}
+
+int main(void) {
+    uint32_t config_index;
+    int      result = 0;
+
+    for (config_index = 0; config_index < sizeof(passthrough_configs) / sizeof(passthrough_configs[0]); ++config_index)
+        result |= run_passthrough_test(&passthrough_configs[config_index]);
+
+    printf("%s\n", result ? "FAIL" : "PASS");
+    return result;
+}
@@ -0,0 +1,162 @@
+/*
+* Copyright(c) 2019 Intel Corporation
+* SPDX - License - Identifier: BSD - 2 - Clause - Patent
+*/
+
+/**************************************
+ * NUMA Placement Benchmark
+ *   A 1080p sequence is encoded on all the sockets, without the per-node
+ *   placement (every pool interleaved across the encoder nodes) and then
+ *   with it (the child picture control sets and the process contexts on
+ *   one node each, the EncDec tasks routed to the processes of the node of
+ *   their picture). For each run it reports the frame rate, the remote
+ *   allocations counted by the kernel (other_node and numa_miss of
+ *   /sys/devices/system/node/node<N>/numastat) and the EncDec tasks taken
+ *   on the node of their picture. The packets of both runs must match.
+ *   Not a ctest test: on a single node there is nothing to compare.
+ *
+ *   EbNumaPlacementBenchmark [picture count]
+ **************************************/
+
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "EbTestEncoder.h"
+#include "EbEncHandle.h"
+
+#define TEST_WIDTH 1920
+#define TEST_HEIGHT 1080
+#define TEST_PICTURE_COUNT 120
+#define TEST_MAX_NODES 64
+
+typedef struct NodeStats {
+    uint64_t other_node;
+    uint64_t numa_miss;
+} NodeStats;
+
+typedef struct RunStats {
+    double    fps;
+    NodeStats node_stats;
+    uint64_t  local_assignment_count;
+    uint64_t  remote_assignment_count;
+    uint64_t  digest;
+} RunStats;
+
+static double time_seconds(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec + now.tv_nsec * 1e-9;
+}
+
+// Sums the counters of all the nodes, the counters stay 0 where numastat does not exist
+static void read_node_stats(NodeStats *node_stats) {
+    uint32_t node;
+
+    memset(node_stats, 0, sizeof(NodeStats));
+    for (node = 0; node < TEST_MAX_NODES; ++node) {
+        char               path[64];
+        char               name[32];
+        unsigned long long value;
+        FILE              *file;
+
+        snprintf(path, sizeof(path), "/sys/devices/system/node/node%u/numastat", node);
+        file = fopen(path, "r");
+        if (!file)
+            continue;
+        while (fscanf(file, "%31s %llu", name, &value) == 2) {
+            if (!strcmp(name, "other_node"))
+                node_stats->other_node += value;
+            else if (!strcmp(name, "numa_miss"))
+                node_stats->numa_miss += value;
+        }
+        fclose(file);
+    }
+}
+
+static int digest_packet(void *context, const EbBufferHeaderType *packet) {
+    uint64_t *digest = (uint64_t *)context;
+    uint32_t  byte_index;
+
+    for (byte_index = 0; byte_index < packet->n_filled_len; ++byte_index)
+        *digest = (*digest ^ packet->p_buffer[byte_index]) * 0x100000001b3ull;
+
+    return 0;
+}
+
+static int run_benchmark(EbBool numa_placement, uint32_t picture_count, RunStats *run_stats) {
+    TestEncoder  test_encoder;
+    EbEncHandle *enc_handle_ptr;
+    NodeStats    start_stats;
+    uint64_t     picture_number;
+    double       start_time;
+
+    memset(run_stats, 0, sizeof(RunStats));
+    run_stats->digest = 0xcbf29ce484222325ull;
+
+    eb_vp9_numa_placement = numa_placement;
+    TEST_CHECK(test_encoder_open(&test_encoder, TEST_WIDTH, TEST_HEIGHT) == EB_ErrorNone);
+    test_encoder.config.enc_mode      = 9;
+    test_encoder.config.target_socket = -1;
+
+    read_node_stats(&start_stats);
+    start_time = time_seconds();
+    if (test_encoder_start(&test_encoder) != EB_ErrorNone) {
+        test_encoder_close(&test_encoder);
+        printf("cannot start the encoder\n");
+        return 1;
+    }
+    for (picture_number = 0; picture_number < picture_count; ++picture_number)
+        TEST_CHECK(test_encoder_send(&test_encoder, picture_number) == EB_ErrorNone);
+    TEST_CHECK(test_encoder_send_eos(&test_encoder) == EB_ErrorNone);
+    TEST_CHECK(test_encoder_drain(&test_encoder, digest_packet, &run_stats->digest) == picture_count);
+
+    run_stats->fps = picture_count / (time_seconds() - start_time);
+    read_node_stats(&run_stats->node_stats);
+    run_stats->node_stats.other_node -= start_stats.other_node;
+    run_stats->node_stats.numa_miss -= start_stats.numa_miss;
+
+    enc_handle_ptr                      = (EbEncHandle *)test_encoder.handle->p_component_private;
+    run_stats->local_assignment_count  = enc_handle_ptr->enc_dec_tasks_resource_ptr->local_assignment_count;
+    run_stats->remote_assignment_count = enc_handle_ptr->enc_dec_tasks_resource_ptr->remote_assignment_count;
+    test_encoder_close(&test_encoder);
+
+    return 0;
+}
+
+static void print_stats(const char *name, const RunStats *run_stats) {
+    printf("%-12s %8.2f fps   other_node %10llu   numa_miss %10llu   EncDec tasks local %8llu remote %8llu\n",
+           name,
+           run_stats->fps,
+           (unsigned long long)run_stats->node_stats.other_node,
+           (unsigned long long)run_stats->node_stats.numa_miss,
+           (unsigned long long)run_stats->local_assignment_count,
+           (unsigned long long)run_stats->remote_assignment_count);
+}
+
+int main(int argc, char **argv) {
+    const uint32_t picture_count = argc > 1 ? (uint32_t)atoi(argv[1]) : TEST_PICTURE_COUNT;
+    RunStats       interleaved, per_node;
+    uint32_t       node_count;
+
+    if (run_benchmark(EB_FALSE, picture_count, &interleaved))
+        return 1;
+    if (run_benchmark(EB_TRUE, picture_count, &per_node))
+        return 1;
+    // Derived by the last initialization, from the processors of the encoder threads
+    node_count = eb_vp9_numa_node_count;
+
+    printf("%u pictures %ux%u, %u memory node(s)\n", picture_count, TEST_WIDTH, TEST_HEIGHT, node_count);
+    print_stats("interleaved", &interleaved);
+    print_stats("per node", &per_node);
+    if (node_count <= 1)
+        printf("the encoder threads run on a single memory node, both runs place the memory the same way\n");
+    else
+        printf("per node: %+.1f%% fps\n", 100.0 * (per_node.fps / interleaved.fps - 1.0));
+
+    if (interleaved.digest != per_node.digest) {
+        printf("the packets of the two runs differ\n");
+        return 1;
+    }
+
+    return 0;
+}
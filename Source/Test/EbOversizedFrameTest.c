@@ -0,0 +1,105 @@
+/*
+* Copyright(c) 2019 Intel Corporation
+* SPDX - License - Identifier: BSD - 2 - Clause - Patent
+*/
+
+/**************************************
+ * Oversized Frame Test
+ *   Noise pictures coded at QP 0 give frames larger than the raw
+ *   pictures, so larger than the entropy coding, packetization and output
+ *   stream buffers they start with. The buffers have to grow: no error may
+ *   be reported, every frame must be larger than the raw picture and start
+ *   with a valid frame header.
+ **************************************/
+
+#include <string.h>
+#include "EbTestEncoder.h"
+
+#define TEST_WIDTH 320
+#define TEST_HEIGHT 240
+#define TEST_PICTURE_COUNT 6
+#define TEST_RAW_PICTURE_SIZE (TEST_WIDTH * TEST_HEIGHT * 3 / 2)
+
+typedef struct FrameCheck {
+    uint32_t packet_count;
+} FrameCheck;
+
+static int check_packet(void *context, const EbBufferHeaderType *packet) {
+    FrameCheck *frame_check = (FrameCheck *)context;
+
+    if (packet->n_filled_len <= TEST_RAW_PICTURE_SIZE) {
+        printf("packet %u: %u bytes, not larger than the raw picture\n", frame_check->packet_count, packet->n_filled_len);
+        return 1;
+    }
+    if (packet->n_filled_len > packet->n_alloc_len) {
+        printf("packet %u: %u bytes in a %u bytes buffer\n",
+               frame_check->packet_count,
+               packet->n_filled_len,
+               packet->n_alloc_len);
+        return 1;
+    }
+    // frame_marker
+    if ((packet->p_buffer[0] >> 6) != 2) {
+        printf("packet %u: invalid frame marker\n", frame_check->packet_count);
+        return 1;
+    }
+    // Key frame sync code, profile 0
+    if (frame_check->packet_count == 0 &&
+        (packet->p_buffer[1] != 0x49 || packet->p_buffer[2] != 0x83 || packet->p_buffer[3] != 0x42)) {
+        printf("packet 0: invalid key frame sync code\n");
+        return 1;
+    }
+    ++frame_check->packet_count;
+
+    return 0;
+}
+
+static void fill_noise(TestEncoder *test_encoder, uint32_t *random_state) {
+    uint8_t *sample = test_encoder->frame_buffer;
+    uint32_t sample_index;
+
+    for (sample_index = 0; sample_index < TEST_RAW_PICTURE_SIZE; ++sample_index) {
+        *random_state        = *random_state * 1664525u + 1013904223u;
+        sample[sample_index] = (uint8_t)(*random_state >> 24);
+    }
+}
+
+static int run_oversized_frame_test(TestEncoder *test_encoder) {
+    FrameCheck frame_check;
+    uint32_t   random_state = 1;
+    uint64_t   picture_number;
+
+    test_encoder->config.rate_control_mode = 0;
+    test_encoder->config.qp                = 0;
+    test_encoder->config.enc_mode          = 9;
+    TEST_CHECK(test_encoder_start(test_encoder) == EB_ErrorNone);
+
+    for (picture_number = 0; picture_number < TEST_PICTURE_COUNT; ++picture_number) {
+        test_encoder_fill(test_encoder, picture_number);
+        fill_noise(test_encoder, &random_state);
+        TEST_CHECK(eb_vp9_svt_enc_send_picture(test_encoder->handle, &test_encoder->input_header) == EB_ErrorNone);
+    }
+    TEST_CHECK(test_encoder_send_eos(test_encoder) == EB_ErrorNone);
+
+    memset(&frame_check, 0, sizeof(frame_check));
+    TEST_CHECK(test_encoder_drain(test_encoder, check_packet, &frame_check) == TEST_PICTURE_COUNT);
+
+    return 0;
+}
+
+int main(void) {
+    TestEncoder test_encoder;
+    int         result;
+
+    if (test_encoder_open(&test_encoder, TEST_WIDTH, TEST_HEIGHT) != EB_ErrorNone) {
+        printf("cannot open the encoder\n");
+        test_encoder_close(&test_encoder);
+        return 1;
+    }
+
+    result = run_oversized_frame_test(&test_encoder);
+    test_encoder_close(&test_encoder);
+
+    printf("%s\n", result ? "FAIL" : "PASS");
+    return result;
+}
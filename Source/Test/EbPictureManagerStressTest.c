@@ -0,0 +1,165 @@
+/*
+* Copyright(c) 2019 Intel Corporation
+* SPDX - License - Identifier: BSD - 2 - Clause - Patent
+*/
+
+/**************************************
+ * Picture Manager Stress Test
+ *   Long sequences are encoded with long intra periods, scene changes and
+ *   every rate control mode. The pictures are sent as long as the encoder
+ *   takes them, ahead of the packets received, so the picture manager
+ *   queues hold many pictures waiting for their references. Every picture must come out
+ *   once, the sequence starting with an IDR picture. In debug builds the
+ *   picture manager checks its indexed queues against the full queue scans
+ *   on every event, i.e. that pictures start and references are released
+ *   as the scans would do it.
+ **************************************/
+
+#include <string.h>
+#include "EbTestEncoder.h"
+
+#define TEST_WIDTH 176
+#define TEST_HEIGHT 144
+#define TEST_PICTURE_COUNT 200
+#define TEST_SCENE_LENGTH 45
+
+typedef struct StressConfig {
+    int32_t  intra_period;
+    uint32_t scene_change_detection;
+    uint32_t rate_control_mode;
+} StressConfig;
+
+static const StressConfig stress_configs[] = {
+    {-1, 0, 0},
+    {255, 0, 1},
+    {31, 0, 2},
+    {23, 0, 0},
+    {7, 1, 0},
+};
+
+typedef struct SequenceCheck {
+    uint8_t  received[TEST_PICTURE_COUNT];
+    uint32_t packet_count;
+} SequenceCheck;
+
+static int check_packet(void *context, const EbBufferHeaderType *packet) {
+    SequenceCheck *sequence_check = (SequenceCheck *)context;
+
+    if (packet->pts < 0 || packet->pts >= TEST_PICTURE_COUNT || sequence_check->received[packet->pts]) {
+        printf("packet %u: unexpected pts %lld\n", sequence_check->packet_count, (long long)packet->pts);
+        return 1;
+    }
+    if (sequence_check->packet_count == 0 && packet->pic_type != EB_IDR_PICTURE) {
+        printf("the sequence does not start with an IDR picture (pic_type %u)\n", packet->pic_type);
+        return 1;
+    }
+    sequence_check->received[packet->pts] = 1;
+    ++sequence_check->packet_count;
+
+    return 0;
+}
+
+// Receives one packet if there is one, returns 1 when a frame packet was received, 0 when none was, -1 on an error
+static int receive_packet(TestEncoder *test_encoder, SequenceCheck *sequence_check) {
+    EbBufferHeaderType *packet;
+    EbErrorType         return_error = eb_vp9_svt_get_packet(test_encoder->handle, &packet, 0);
+    int                 result       = 0;
+
+    if (return_error == EB_NoErrorEmptyQueue)
+        return 0;
+    if (return_error == EB_ErrorMax) {
+        printf("encode error, packet flags 0x%x\n", packet->flags);
+        result = -1;
+    } else if ((packet->flags & EB_BUFFERFLAG_PARTIAL) == 0)
+        result = check_packet(sequence_check, packet) ? -1 : 1;
+    eb_vp9_svt_release_out_buffer(&packet);
+
+    return result;
+}
+
+// The synthetic picture, with a cut every TEST_SCENE_LENGTH pictures
+static void fill_picture(TestEncoder *test_encoder, uint64_t picture_number) {
+    const uint32_t luma_size = TEST_WIDTH * TEST_HEIGHT;
+    uint32_t       sample_index;
+
+    test_encoder_fill(test_encoder, picture_number);
+    if ((picture_number / TEST_SCENE_LENGTH) & 1) {
+        for (sample_index = 0; sample_index < luma_size; ++sample_index)
+            test_encoder->input_planes.luma[sample_index] ^= 0xff;
+    }
+}
+
+static int encode_sequence(TestEncoder *test_encoder) {
+    SequenceCheck sequence_check;
+    uint64_t      picture_number = 0;
+    uint32_t      frame_count    = 0;
+    int64_t       drain_count;
+    int           received;
+
+    memset(&sequence_check, 0, sizeof(sequence_check));
+    fill_picture(test_encoder, picture_number);
+    while (picture_number < TEST_PICTURE_COUNT) {
+        // The queue is full when the encoder holds as many pictures as it can, the packets are received then
+        if (eb_vp9_svt_enc_send_picture_non_blocking(test_encoder->handle, &test_encoder->input_header) ==
+            EB_ErrorNone) {
+            if (++picture_number < TEST_PICTURE_COUNT)
+                fill_picture(test_encoder, picture_number);
+            continue;
+        }
+        received = receive_packet(test_encoder, &sequence_check);
+        TEST_CHECK(received >= 0);
+        if (received)
+            ++frame_count;
+        else
+            test_sleep_ms(1);
+    }
+    TEST_CHECK(test_encoder_send_eos(test_encoder) == EB_ErrorNone);
+
+    drain_count = test_encoder_drain(test_encoder, check_packet, &sequence_check);
+    TEST_CHECK(drain_count >= 0);
+    TEST_CHECK(frame_count + drain_count == TEST_PICTURE_COUNT);
+    TEST_CHECK(sequence_check.packet_count == TEST_PICTURE_COUNT);
+
+    return 0;
+}
+
+static int run_stress_test(const StressConfig *stress_config) {
+    TestEncoder test_encoder;
+    int         result = 1;
+
+    if (test_encoder_open(&test_encoder, TEST_WIDTH, TEST_HEIGHT) != EB_ErrorNone) {
+        printf("cannot open the encoder\n");
+        test_encoder_close(&test_encoder);
+        return 1;
+    }
+
+    test_encoder.config.enc_mode               = 9;
+    test_encoder.config.intra_period           = stress_config->intra_period;
+    test_encoder.config.scene_change_detection = stress_config->scene_change_detection;
+    test_encoder.config.rate_control_mode      = stress_config->rate_control_mode;
+    test_encoder.config.target_bit_rate        = 200000;
+    if (test_encoder_start(&test_encoder) == EB_ErrorNone)
+        result = encode_sequence(&test_encoder);
+    else
+        printf("cannot start the encoder\n");
+    test_encoder_close(&test_encoder);
+
+    if (result)
+        printf("intra period %d, scene change detection %u, rate control mode %u failed\n",
+               stress_config->intra_period,
+               stress_config->scene_change_detection,
+               stress_config->rate_control_mode);
+
+    return result;
+}
+
+int main(void) {
+    uint32_t config_index;
+    int      result = 0;
+
+    for (config_index = 0; config_index < sizeof(stress_configs) / sizeof(stress_configs[0]); ++config_index)
+        result |= run_stress_test(&stress_configs[config_index]);
+
+    printf("%s\n", result ? "FAIL" : "PASS");
+    return result;
+}
@@ -0,0 +1,115 @@
+/*
+* Copyright(c) 2019 Intel Corporation
+* SPDX - License - Identifier: BSD - 2 - Clause - Patent
+*/
+
+/**************************************
+ * Reset Test
+ *   A sequence is encoded, the encoder is reset and the same sequence is
+ *   encoded again, it must give the same packets. The encoder is reset
+ *   once more, then again with pictures in flight and neither the packets
+ *   nor the recon taken: the kernels blocked on their pools, e.g. the
+ *   EncDec one waiting for a recon buffer under the recon frame count
+ *   lock, have to leave without holding a lock. The sequence is encoded a
+ *   third time after a runtime update that takes the configuration lock.
+ **************************************/
+
+#include <string.h>
+#include "EbTestEncoder.h"
+
+#define TEST_WIDTH 320
+#define TEST_HEIGHT 240
+#define TEST_PICTURE_COUNT 24
+#define TEST_IN_FLIGHT_COUNT 40
+
+typedef struct SequenceDigest {
+    uint64_t hash[TEST_PICTURE_COUNT];
+    uint32_t size[TEST_PICTURE_COUNT];
+    uint32_t packet_count;
+} SequenceDigest;
+
+static int digest_packet(void *context, const EbBufferHeaderType *packet) {
+    SequenceDigest *digest = (SequenceDigest *)context;
+    uint64_t        hash   = 0xcbf29ce484222325ull;
+    uint32_t        byte_index;
+
+    if (digest->packet_count >= TEST_PICTURE_COUNT) {
+        printf("more packets than pictures\n");
+        return 1;
+    }
+    if (digest->packet_count == 0 && packet->pic_type != EB_IDR_PICTURE) {
+        printf("the sequence does not start with an IDR picture (pic_type %u)\n", packet->pic_type);
+        return 1;
+    }
+
+    for (byte_index = 0; byte_index < packet->n_filled_len; ++byte_index)
+        hash = (hash ^ packet->p_buffer[byte_index]) * 0x100000001b3ull;
+    digest->hash[digest->packet_count] = hash;
+    digest->size[digest->packet_count] = packet->n_filled_len;
+    ++digest->packet_count;
+
+    return 0;
+}
+
+static int encode_sequence(TestEncoder *test_encoder, SequenceDigest *digest) {
+    uint64_t picture_number;
+
+    memset(digest, 0, sizeof(SequenceDigest));
+    for (picture_number = 0; picture_number < TEST_PICTURE_COUNT; ++picture_number)
+        TEST_CHECK(test_encoder_send(test_encoder, picture_number) == EB_ErrorNone);
+    TEST_CHECK(test_encoder_send_eos(test_encoder) == EB_ErrorNone);
+    TEST_CHECK(test_encoder_drain(test_encoder, digest_packet, digest) == TEST_PICTURE_COUNT);
+    TEST_CHECK(test_encoder->recon_count == TEST_PICTURE_COUNT);
+
+    return 0;
+}
+
+static int run_reset_test(TestEncoder *test_encoder) {
+    SequenceDigest first, second;
+    uint64_t       picture_number;
+
+    test_encoder->config.recon_file = 1;
+    TEST_CHECK(test_encoder_start(test_encoder) == EB_ErrorNone);
+
+    // Reset after a complete sequence
+    TEST_CHECK(encode_sequence(test_encoder, &first) == 0);
+    TEST_CHECK(eb_vp9_svt_enc_reset(test_encoder->handle) == EB_ErrorNone);
+    TEST_CHECK(encode_sequence(test_encoder, &second) == 0);
+    TEST_CHECK(memcmp(&first, &second, sizeof(SequenceDigest)) == 0);
+
+    // Reset with pictures in flight and no packet taken, the pipeline stalls on the output pools. The sequence
+    // is ended, the encoder is reset before the pictures are sent
+    TEST_CHECK(eb_vp9_svt_enc_reset(test_encoder->handle) == EB_ErrorNone);
+    for (picture_number = 0; picture_number < TEST_IN_FLIGHT_COUNT; ++picture_number) {
+        test_encoder_fill(test_encoder, picture_number);
+        if (eb_vp9_svt_enc_send_picture_non_blocking(test_encoder->handle, &test_encoder->input_header) ==
+            EB_NoErrorFullQueue)
+            break;
+    }
+    test_sleep_ms(500);
+    TEST_CHECK(eb_vp9_svt_enc_reset(test_encoder->handle) == EB_ErrorNone);
+
+    // The configuration lock is free again
+    TEST_CHECK(eb_vp9_svt_enc_update_parameter(test_encoder->handle, &test_encoder->config) == EB_ErrorNone);
+    TEST_CHECK(encode_sequence(test_encoder, &second) == 0);
+    TEST_CHECK(memcmp(&first, &second, sizeof(SequenceDigest)) == 0);
+
+    return 0;
+}
+
+int main(void) {
+    TestEncoder test_encoder;
+    int         result;
+
+    if (test_encoder_open(&test_encoder, TEST_WIDTH, TEST_HEIGHT) != EB_ErrorNone) {
+        printf("cannot open the encoder\n");
+        test_encoder_close(&test_encoder);
+        return 1;
+    }
+
+    result = run_reset_test(&test_encoder);
+    test_encoder_close(&test_encoder);
+
+    printf("%s\n", result ? "FAIL" : "PASS");
+    return result;
+}
@@ -0,0 +1,282 @@
+/*
+* Copyright(c) 2019 Intel Corporation
+* SPDX - License - Identifier: BSD - 2 - Clause - Patent
+*/
+
+/**************************************
+ * Speed Control Test
+ *   eb_vp9_speed_control is driven by a synthetic pipeline: the ME and
+ *   EncDec stage loads follow the per tool modes it sets (ME search area,
+ *   MD NFL, MDC depth mode) and a throttle factor standing for slower
+ *   processors, the output rate follows the slowest stage. It must:
+ *   - step the tools of the slowest stage first, one tool per check
+ *   - hold the frame deadline (every stage load at most SC_LOAD_HIGH, the
+ *     output keeping up with the input) once settled
+ *   - go faster when the processors are throttled and slower again when
+ *     the throttle is lifted, holding the deadline in both cases
+ *   - go faster when the output falls behind or the input arrives late,
+ *     even with the stage loads within the target range
+ **************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "EbDefinitions.h"
+#include "EbEncodeContext.h"
+#include "EbPictureControlSet.h"
+#include "EbSequenceControlSet.h"
+#include "EbResourceCoordinationProcess.h"
+#include "EbThreads.h"
+#include "EbTime.h"
+
+#define TEST_CHECK(cond)                                                   \
+    do {                                                                   \
+        if (!(cond)) {                                                     \
+            printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+            return 1;                                                      \
+        }                                                                  \
+    } while (0)
+
+#define TEST_FRAME_RATE 30
+#define TEST_DEADLINE (1000.0 / TEST_FRAME_RATE)
+#define TEST_ME_THREADS 2
+#define TEST_ENC_DEC_THREADS 4
+#define TEST_SETTLE_FRAMES 3000
+#define TEST_HOLD_FRAMES 1200
+
+/**************************************
+ * Synthetic pipeline
+ **************************************/
+typedef struct Pipeline {
+    ResourceCoordinationContext context;
+    PictureParentControlSet    *picture_control_set_ptr;
+    SequenceControlSet         *sequence_control_set_ptr;
+    EncodeContext              *encode_context_ptr;
+
+    // Stage loads at ENC_MODE_0, in % of the frame deadline per thread
+    double me_base_load;
+    double enc_dec_base_load;
+    // Processing time factor, 1 when the processors are not throttled
+    double throttle;
+    // Share of the frames the output takes, 1 when nothing but the stages holds it
+    double output_rate;
+    double output_credit;
+    // Delay (ms) of the input on the frame rate
+    double input_delay;
+
+    // Of the last frame
+    double me_load;
+    double enc_dec_load;
+} Pipeline;
+
+static double mode_scale(double step, EB_ENC_MODE enc_mode) {
+    double scale = 1.0;
+    int    mode;
+
+    for (mode = 0; mode < enc_mode; ++mode) scale *= step;
+
+    return scale;
+}
+
+// Sum of the per tool modes, the speed of the three tools
+static uint32_t tool_level(const Pipeline *pipeline) {
+    return pipeline->picture_control_set_ptr->search_area_enc_mode + pipeline->picture_control_set_ptr->nfl_enc_mode +
+        pipeline->picture_control_set_ptr->depth_mode_enc_mode;
+}
+
+static double max_load(const Pipeline *pipeline) {
+    return MAX(pipeline->me_load, pipeline->enc_dec_load);
+}
+
+// The frames arrive at the frame rate, input_delay late: the arrival time of the first frame is moved back by the
+// time the frames already sent should have taken
+static void pipeline_set_arrival(Pipeline *pipeline) {
+    const double   elapsed_ms = pipeline->encode_context_ptr->sc_frame_in * TEST_DEADLINE + pipeline->input_delay + 0.5;
+    const uint64_t elapsed_us = (uint64_t)(elapsed_ms * 1000);
+    uint64_t       seconds;
+    uint64_t       useconds;
+
+    svt_vp9_get_time(&seconds, &useconds);
+    useconds += seconds * 1000000 - elapsed_us;
+    pipeline->context.first_in_pic_arrived_time_seconds  = useconds / 1000000;
+    pipeline->context.first_in_pic_arrived_timeu_seconds = useconds % 1000000;
+}
+
+static int pipeline_init(Pipeline *pipeline, double me_base_load, double enc_dec_base_load) {
+    memset(pipeline, 0, sizeof(Pipeline));
+    pipeline->picture_control_set_ptr  = (PictureParentControlSet *)calloc(1, sizeof(PictureParentControlSet));
+    pipeline->sequence_control_set_ptr = (SequenceControlSet *)calloc(1, sizeof(SequenceControlSet));
+    pipeline->encode_context_ptr       = (EncodeContext *)calloc(1, sizeof(EncodeContext));
+    TEST_CHECK(pipeline->picture_control_set_ptr && pipeline->sequence_control_set_ptr &&
+               pipeline->encode_context_ptr);
+
+    pipeline->encode_context_ptr->sc_buffer_mutex = eb_vp9_create_mutex();
+    pipeline->encode_context_ptr->enc_mode        = SPEED_CONTROL_INIT_MOD;
+
+    pipeline->sequence_control_set_ptr->encode_context_ptr                   = pipeline->encode_context_ptr;
+    pipeline->sequence_control_set_ptr->static_config.injector_frame_rate    = TEST_FRAME_RATE << 16;
+    pipeline->sequence_control_set_ptr->hierarchical_levels                  = 3;
+    pipeline->sequence_control_set_ptr->max_enc_mode                         = MAX_SUPPORTED_MODES_SUB1080P - 1;
+    pipeline->sequence_control_set_ptr->motion_estimation_process_init_count = TEST_ME_THREADS;
+    pipeline->sequence_control_set_ptr->enc_dec_process_init_count           = TEST_ENC_DEC_THREADS;
+
+    pipeline->me_base_load      = me_base_load;
+    pipeline->enc_dec_base_load = enc_dec_base_load;
+    pipeline->throttle          = 1.0;
+    pipeline->output_rate       = 1.0;
+
+    return 0;
+}
+
+static void pipeline_free(Pipeline *pipeline) {
+    if (pipeline->encode_context_ptr)
+        eb_vp9_destroy_mutex(pipeline->encode_context_ptr->sc_buffer_mutex);
+    free(pipeline->picture_control_set_ptr);
+    free(pipeline->sequence_control_set_ptr);
+    free(pipeline->encode_context_ptr);
+}
+
+// Sends frame_count frames, each one is processed with the tool modes the speed control set for it. The tool
+// level changes by one step at most from a frame to the next
+static int pipeline_run(Pipeline *pipeline, uint32_t frame_count) {
+    EncodeContext *encode_context_ptr = pipeline->encode_context_ptr;
+    uint32_t       frame_index;
+
+    for (frame_index = 0; frame_index < frame_count; ++frame_index) {
+        const uint32_t previous_level = tool_level(pipeline);
+
+        if (encode_context_ptr->sc_frame_in)
+            pipeline_set_arrival(pipeline);
+        eb_vp9_speed_control(&pipeline->context, pipeline->picture_control_set_ptr, pipeline->sequence_control_set_ptr);
+        if (encode_context_ptr->sc_frame_in > 1)
+            TEST_CHECK(abs((int)tool_level(pipeline) - (int)previous_level) <= 1);
+
+        pipeline->me_load = pipeline->me_base_load * pipeline->throttle *
+            mode_scale(0.85, pipeline->picture_control_set_ptr->search_area_enc_mode);
+        pipeline->enc_dec_load = pipeline->enc_dec_base_load * pipeline->throttle *
+            mode_scale(0.9, pipeline->picture_control_set_ptr->nfl_enc_mode) *
+            mode_scale(0.9, pipeline->picture_control_set_ptr->depth_mode_enc_mode);
+
+        // The stages report their processing time, the output goes at the pace of the slowest one
+        eb_vp9_block_on_mutex(encode_context_ptr->sc_buffer_mutex);
+        encode_context_ptr->sc_me_busy_time += pipeline->me_load / 100 * TEST_DEADLINE * TEST_ME_THREADS;
+        encode_context_ptr->sc_enc_dec_busy_time += pipeline->enc_dec_load / 100 * TEST_DEADLINE *
+            TEST_ENC_DEC_THREADS;
+        pipeline->output_credit += MIN(1.0, 100 / max_load(pipeline)) * pipeline->output_rate;
+        encode_context_ptr->sc_frame_out = (int64_t)pipeline->output_credit;
+        eb_vp9_release_mutex(encode_context_ptr->sc_buffer_mutex);
+    }
+
+    return 0;
+}
+
+// Runs frame_count frames checking that the deadline is held on each one
+static int pipeline_hold(Pipeline *pipeline, uint32_t frame_count) {
+    const int64_t lag = pipeline->encode_context_ptr->sc_frame_in - pipeline->encode_context_ptr->sc_frame_out;
+    uint32_t      frame_index;
+
+    for (frame_index = 0; frame_index < frame_count; ++frame_index) {
+        TEST_CHECK(pipeline_run(pipeline, 1) == 0);
+        TEST_CHECK(max_load(pipeline) <= SC_LOAD_HIGH);
+    }
+    TEST_CHECK(pipeline->encode_context_ptr->sc_frame_in - pipeline->encode_context_ptr->sc_frame_out <= lag + 1);
+
+    return 0;
+}
+
+/**************************************
+ * Tests
+ **************************************/
+// The first knob stepped is a tool of the slowest stage, enc_mode is kept
+static int run_stage_load_test(double me_base_load, double enc_dec_base_load, uint8_t first_knob) {
+    Pipeline pipeline;
+    int      result = 1;
+
+    if (pipeline_init(&pipeline, me_base_load, enc_dec_base_load) == 0 &&
+        pipeline_run(&pipeline, SC_FRAMES_TO_IGNORE + 2 * SC_FRAMES_INTERVAL) == 0) {
+        result = !(pipeline.encode_context_ptr->sc_knobs == first_knob &&
+                   pipeline.encode_context_ptr->enc_mode == SPEED_CONTROL_INIT_MOD);
+        if (result)
+            printf("knobs 0x%x enc_mode %d, expected knobs 0x%x\n",
+                   pipeline.encode_context_ptr->sc_knobs,
+                   pipeline.encode_context_ptr->enc_mode,
+                   first_knob);
+    }
+    pipeline_free(&pipeline);
+
+    return result;
+}
+
+// The deadline is held, the processors are throttled, then no longer
+static int run_throttle_test(Pipeline *pipeline) {
+    uint32_t settled_level;
+    uint32_t throttled_level;
+
+    TEST_CHECK(pipeline_init(pipeline, 140, 380) == 0);
+    TEST_CHECK(pipeline_run(pipeline, TEST_SETTLE_FRAMES) == 0);
+    TEST_CHECK(pipeline_hold(pipeline, TEST_HOLD_FRAMES) == 0);
+    settled_level = tool_level(pipeline);
+    TEST_CHECK(settled_level > 3 * SPEED_CONTROL_INIT_MOD);
+
+    pipeline->throttle = 1.5;
+    TEST_CHECK(pipeline_run(pipeline, TEST_SETTLE_FRAMES) == 0);
+    TEST_CHECK(pipeline_hold(pipeline, TEST_HOLD_FRAMES) == 0);
+    throttled_level = tool_level(pipeline);
+    TEST_CHECK(throttled_level > settled_level);
+
+    pipeline->throttle = 1.0;
+    TEST_CHECK(pipeline_run(pipeline, TEST_SETTLE_FRAMES) == 0);
+    TEST_CHECK(pipeline_hold(pipeline, TEST_HOLD_FRAMES) == 0);
+    TEST_CHECK(tool_level(pipeline) < throttled_level);
+    // Back within a step of the unthrottled settings, the loads below SC_LOAD_LOW would go slower
+    TEST_CHECK(abs((int)tool_level(pipeline) - (int)settled_level) <= 1);
+
+    return 0;
+}
+
+// With the stage loads between SC_LOAD_LOW and SC_LOAD_HIGH, the tools are kept unless the output falls behind
+// or the input arrives late
+static int run_output_rate_test(Pipeline *pipeline, EbBool output_late, EbBool input_late) {
+    uint32_t level;
+
+    // 90% for both stages at ENC_MODE_5 with no knob, still above SC_LOAD_LOW after one step
+    TEST_CHECK(pipeline_init(pipeline, 90 / mode_scale(0.85, ENC_MODE_5), 90 / mode_scale(0.81, ENC_MODE_5)) == 0);
+    TEST_CHECK(pipeline_run(pipeline, SC_FRAMES_TO_IGNORE + SC_FRAMES_INTERVAL) == 0);
+    level = tool_level(pipeline);
+
+    if (output_late)
+        pipeline->output_rate = 0.8;
+    if (input_late)
+        pipeline->input_delay = 1000;
+    TEST_CHECK(pipeline_run(pipeline, 4 * SC_FRAMES_INTERVAL) == 0);
+
+    if (output_late)
+        TEST_CHECK(tool_level(pipeline) >= level + 3);
+    else if (input_late)
+        TEST_CHECK(tool_level(pipeline) == level + 1);
+    else
+        TEST_CHECK(tool_level(pipeline) == level);
+
+    return 0;
+}
+
+int main(void) {
+    Pipeline pipeline;
+    int      result = 0;
+
+    result |= run_stage_load_test(140, 380, SC_KNOB_NFL);
+    result |= run_stage_load_test(300, 200, SC_KNOB_SEARCH_AREA);
+
+    result |= run_throttle_test(&pipeline);
+    pipeline_free(&pipeline);
+
+    result |= run_output_rate_test(&pipeline, EB_FALSE, EB_FALSE);
+    pipeline_free(&pipeline);
+    result |= run_output_rate_test(&pipeline, EB_TRUE, EB_FALSE);
+    pipeline_free(&pipeline);
+    result |= run_output_rate_test(&pipeline, EB_FALSE, EB_TRUE);
+    pipeline_free(&pipeline);
+
+    printf("%s\n", result ? "FAIL" : "PASS");
+    return result;
+}
@@ -0,0 +1,203 @@
+/*
+* Copyright(c) 2019 Intel Corporation
+* SPDX - License - Identifier: BSD - 2 - Clause - Patent
+*/
+
+#include <stdlib.h>
+#include <string.h>
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+#include "EbTestEncoder.h"
+
+/**************************************
+ * Sleep
+ **************************************/
+void test_sleep_ms(uint32_t milliseconds) {
+#ifdef _WIN32
+    Sleep(milliseconds);
+#else
+    usleep(milliseconds * 1000);
+#endif
+}
+
+/**************************************
+ * Open the test encoder
+ **************************************/
+EbErrorType test_encoder_open(TestEncoder *test_encoder, uint32_t width, uint32_t height) {
+    const size_t luma_size = (size_t)width * height;
+    EbErrorType  return_error;
+
+    memset(test_encoder, 0, sizeof(TestEncoder));
+
+    return_error = eb_vp9_svt_init_handle(&test_encoder->handle, test_encoder, &test_encoder->config);
+    if (return_error != EB_ErrorNone)
+        return return_error;
+
+    test_encoder->config.source_width  = width;
+    test_encoder->config.source_height = height;
+
+    test_encoder->frame_buffer = (uint8_t *)malloc(luma_size + (luma_size >> 1));
+    if (test_encoder->frame_buffer == NULL)
+        return EB_ErrorInsufficientResources;
+
+    test_encoder->input_planes.luma      = test_encoder->frame_buffer;
+    test_encoder->input_planes.cb        = test_encoder->frame_buffer + luma_size;
+    test_encoder->input_planes.cr        = test_encoder->frame_buffer + luma_size + (luma_size >> 2);
+    test_encoder->input_planes.y_stride  = width;
+    test_encoder->input_planes.cb_stride = width >> 1;
+    test_encoder->input_planes.cr_stride = width >> 1;
+
+    test_encoder->input_header.size     = sizeof(EbBufferHeaderType);
+    test_encoder->input_header.p_buffer = (uint8_t *)&test_encoder->input_planes;
+    test_encoder->input_header.pic_type = EB_INVALID_PICTURE;
+
+    return EB_ErrorNone;
+}
+
+/**************************************
+ * Start the test encoder
+ **************************************/
+EbErrorType test_encoder_start(TestEncoder *test_encoder) {
+    const size_t luma_size    = (size_t)test_encoder->config.source_width * test_encoder->config.source_height;
+    EbErrorType  return_error = eb_vp9_svt_enc_set_parameter(test_encoder->handle, &test_encoder->config);
+
+    if (return_error != EB_ErrorNone)
+        return return_error;
+
+    if (test_encoder->config.recon_file) {
+        test_encoder->recon_header.size        = sizeof(EbBufferHeaderType);
+        test_encoder->recon_header.n_alloc_len = (uint32_t)((luma_size + (luma_size >> 1))
+                                                            << (test_encoder->config.encoder_bit_depth > 8));
+        test_encoder->recon_header.p_buffer    = (uint8_t *)malloc(test_encoder->recon_header.n_alloc_len);
+        if (test_encoder->recon_header.p_buffer == NULL)
+            return EB_ErrorInsufficientResources;
+    }
+
+    return eb_vp9_init_encoder(test_encoder->handle);
+}
+
+/**************************************
+ * Fill a synthetic picture
+ **************************************/
+void test_encoder_fill(TestEncoder *test_encoder, uint64_t picture_number) {
+    const uint32_t width        = test_encoder->config.source_width;
+    const uint32_t height       = test_encoder->config.source_height;
+    const uint32_t chroma_width = width >> 1;
+    uint32_t       x, y;
+
+    for (y = 0; y < height; ++y)
+        for (x = 0; x < width; ++x)
+            test_encoder->input_planes.luma[y * width + x] = (uint8_t)(((x * y >> 4) + 2 * picture_number) & 0xff);
+    for (y = 0; y < height >> 1; ++y)
+        for (x = 0; x < chroma_width; ++x) {
+            test_encoder->input_planes.cb[y * chroma_width + x] = (uint8_t)(128 + ((x + picture_number) & 0xf));
+            test_encoder->input_planes.cr[y * chroma_width + x] = (uint8_t)(128 - ((y + picture_number) & 0xf));
+        }
+
+    test_encoder->input_header.n_filled_len = width * height + (width * height >> 1);
+    test_encoder->input_header.flags        = 0;
+    test_encoder->input_header.pts          = (int64_t)picture_number;
+    test_encoder->input_header.pic_type     = EB_INVALID_PICTURE;
+}
+
+/**************************************
+ * Send a synthetic picture
+ **************************************/
+EbErrorType test_encoder_send(TestEncoder *test_encoder, uint64_t picture_number) {
+    test_encoder_fill(test_encoder, picture_number);
+
+    return eb_vp9_svt_enc_send_picture(test_encoder->handle, &test_encoder->input_header);
+}
+
+/**************************************
+ * Send the end of sequence
+ **************************************/
+EbErrorType test_encoder_send_eos(TestEncoder *test_encoder) {
+    EbBufferHeaderType eos_header;
+
+    memset(&eos_header, 0, sizeof(eos_header));
+    eos_header.size     = sizeof(EbBufferHeaderType);
+    eos_header.flags    = EB_BUFFERFLAG_EOS;
+    eos_header.pic_type = EB_INVALID_PICTURE;
+
+    return eb_vp9_svt_enc_send_picture(test_encoder->handle, &eos_header);
+}
+
+/**************************************
+ * Receive the packets of the sequence
+ *   The packets are waited for, unless the
+ *   reconstructed pictures are output too:
+ *   the encoder then waits for the recon to
+ *   be taken and both are polled
+ **************************************/
+int64_t test_encoder_drain(TestEncoder *test_encoder, TestPacketCheck check, void *context) {
+    const EbBool        poll        = test_encoder->config.recon_file ? EB_TRUE : EB_FALSE;
+    EbBool              eos         = EB_FALSE;
+    EbBool              recon_eos   = poll ? EB_FALSE : EB_TRUE;
+    int64_t             frame_count = 0;
+    EbBufferHeaderType *packet;
+
+    test_encoder->recon_count = 0;
+    while (eos == EB_FALSE || recon_eos == EB_FALSE) {
+        EbBool idle = EB_TRUE;
+
+        if (recon_eos == EB_FALSE) {
+            EbErrorType return_error = eb_vp9_svt_get_recon(test_encoder->handle, &test_encoder->recon_header);
+
+            if (return_error == EB_ErrorMax) {
+                printf("recon error, flags 0x%x\n", test_encoder->recon_header.flags);
+                return -1;
+            }
+            if (return_error != EB_NoErrorEmptyQueue) {
+                ++test_encoder->recon_count;
+                recon_eos = (test_encoder->recon_header.flags & EB_BUFFERFLAG_EOS) ? EB_TRUE : EB_FALSE;
+                idle      = EB_FALSE;
+            }
+        }
+
+        if (eos == EB_FALSE) {
+            EbErrorType return_error = eb_vp9_svt_get_packet(test_encoder->handle, &packet, poll ? 0 : 1);
+
+            if (return_error == EB_ErrorMax) {
+                printf("encode error, packet flags 0x%x\n", packet->flags);
+                eb_vp9_svt_release_out_buffer(&packet);
+                return -1;
+            }
+            if (return_error != EB_NoErrorEmptyQueue) {
+                if ((packet->flags & EB_BUFFERFLAG_PARTIAL) == 0) {
+                    if (check && check(context, packet)) {
+                        eb_vp9_svt_release_out_buffer(&packet);
+                        return -1;
+                    }
+                    ++frame_count;
+                }
+                eos  = (packet->flags & EB_BUFFERFLAG_EOS) ? EB_TRUE : EB_FALSE;
+                idle = EB_FALSE;
+                eb_vp9_svt_release_out_buffer(&packet);
+            }
+        }
+
+        if (idle && poll)
+            test_sleep_ms(1);
+    }
+
+    return frame_count;
+}
+
+/**************************************
+ * Close the test encoder
+ **************************************/
+void test_encoder_close(TestEncoder *test_encoder) {
+    if (test_encoder->handle) {
+        eb_vp9_deinit_encoder(test_encoder->handle);
+        eb_vp9_deinit_handle(test_encoder->handle);
+        test_encoder->handle = NULL;
+    }
+    free(test_encoder->frame_buffer);
+    free(test_encoder->recon_header.p_buffer);
+    test_encoder->frame_buffer          = NULL;
+    test_encoder->recon_header.p_buffer = NULL;
+}
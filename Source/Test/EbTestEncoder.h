@@ -0,0 +1,71 @@
+/*
+* Copyright(c) 2019 Intel Corporation
+* SPDX - License - Identifier: BSD - 2 - Clause - Patent
+*/
+
+#ifndef EbTestEncoder_h
+#define EbTestEncoder_h
+
+#include <stdint.h>
+#include <stdio.h>
+#include "EbSvtVp9Enc.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define TEST_CHECK(cond)                                                   \
+    do {                                                                   \
+        if (!(cond)) {                                                     \
+            printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+            return 1;                                                      \
+        }                                                                  \
+    } while (0)
+
+/**************************************
+ * Test Encoder
+ *   Drives one encoder instance through the public API with synthetic
+ *   8-bit pictures, a moving gradient that every picture number shifts
+ **************************************/
+typedef struct TestEncoder {
+    EbComponentType         *handle;
+    EbSvtVp9EncConfiguration config;
+    EbBufferHeaderType       input_header;
+    EbSvtEncInput            input_planes;
+    uint8_t                 *frame_buffer;
+    EbBufferHeaderType       recon_header; // recon_file only, the reconstructed pictures are received and dropped
+    uint64_t                 recon_count;
+} TestEncoder;
+
+// Packet inspection, called for every packet that is not a partial chunk, a non zero return fails the drain
+typedef int (*TestPacketCheck)(void *context, const EbBufferHeaderType *packet);
+
+// Constructs the handle and loads the default configuration, the caller can then edit test_encoder->config
+extern EbErrorType test_encoder_open(TestEncoder *test_encoder, uint32_t width, uint32_t height);
+
+// Sets the configuration and initializes the encoder, with recon_file the reconstructed pictures are drained as well
+extern EbErrorType test_encoder_start(TestEncoder *test_encoder);
+
+// Fills the input header with the synthetic picture picture_number
+extern void test_encoder_fill(TestEncoder *test_encoder, uint64_t picture_number);
+
+// Fills the synthetic picture picture_number and sends it, blocking
+extern EbErrorType test_encoder_send(TestEncoder *test_encoder, uint64_t picture_number);
+
+// Signals the end of the sequence
+extern EbErrorType test_encoder_send_eos(TestEncoder *test_encoder);
+
+// Receives the packets up to the EOS one, returns the number of frame packets or -1 on an error.
+// With recon_file, the reconstructed pictures are received up to the EOS one as well and counted in recon_count
+extern int64_t test_encoder_drain(TestEncoder *test_encoder, TestPacketCheck check, void *context);
+
+// Portable sleep
+extern void test_sleep_ms(uint32_t milliseconds);
+
+// Deinitializes the encoder and releases the handle
+extern void test_encoder_close(TestEncoder *test_encoder);
+
+#ifdef __cplusplus
+}
+#endif
+#endif // EbTestEncoder_h
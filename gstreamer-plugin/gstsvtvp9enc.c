@@ -34,6 +34,8 @@ static void gst_svtvp9enc_get_property (GObject * object,
     guint property_id, GValue * value, GParamSpec * pspec);
 static void gst_svtvp9enc_dispose (GObject * object);
 static void gst_svtvp9enc_finalize (GObject * object);
+static GstStateChangeReturn gst_svtvp9enc_change_state (GstElement * element,
+    GstStateChange transition);
 
 gboolean gst_svtvp9enc_allocate_svt_buffers (GstSvtVp9Enc * svtvp9enc);
 void gst_svthevenc_deallocate_svt_buffers (GstSvtVp9Enc * svtvp9enc);
@@ -41,8 +43,15 @@ static gboolean gst_svtvp9enc_configure_svt (GstSvtVp9Enc * svtvp9enc);
 static GstFlowReturn gst_svtvp9enc_encode (GstSvtVp9Enc * svtvp9enc,
     GstVideoCodecFrame * frame);
 static gboolean gst_svtvp9enc_send_eos (GstSvtVp9Enc * svtvp9enc);
-static GstFlowReturn gst_svtvp9enc_dequeue_encoded_frames (GstSvtVp9Enc *
-    svtvp9enc, gboolean closing_encoder, gboolean output_frames);
+static gboolean gst_svtvp9enc_start_output_task (GstSvtVp9Enc * svtvp9enc);
+static void gst_svtvp9enc_output_loop (GstSvtVp9Enc * svtvp9enc);
+static GstFlowReturn gst_svtvp9enc_finish_output_frame (GstSvtVp9Enc *
+    svtvp9enc, GstVideoCodecFrame * frame, EbBufferHeaderType * output_buf);
+static void gst_svtvp9enc_release_output_buffer (gpointer data);
+static void gst_svtvp9enc_wait_output_buffers (GstSvtVp9Enc * svtvp9enc);
+static GstFlowReturn gst_svtvp9enc_drain (GstSvtVp9Enc * svtvp9enc,
+    gboolean output_frames);
+static gboolean gst_svtvp9enc_restart (GstSvtVp9Enc * svtvp9enc);
 
 static gboolean gst_svtvp9enc_open (GstVideoEncoder * encoder);
 static gboolean gst_svtvp9enc_close (GstVideoEncoder * encoder);
@@ -70,8 +79,14 @@ static gboolean gst_svtvp9enc_flush (GstVideoEncoder * encoder);
 
 /* helpers */
 void set_default_svt_configuration (EbSvtVp9EncConfiguration * svt_config);
-gint compare_video_code_frame_and_pts (const void *video_codec_frame_ptr,
-    const void *pts_ptr);
+
+/* an SVT-VP9 output buffer lent to downstream, given back to the library
+ * when the GstBuffer wrapping it is freed */
+typedef struct _GstSvtVp9EncOutputBuffer
+{
+  GstSvtVp9Enc *svtvp9enc;
+  EbBufferHeaderType *output_buf;
+} GstSvtVp9EncOutputBuffer;
 
 enum
 {
@@ -170,6 +185,8 @@ gst_svtvp9enc_class_init (GstSvtVp9EncClass * klass)
   gobject_class->get_property = gst_svtvp9enc_get_property;
   gobject_class->dispose = gst_svtvp9enc_dispose;
   gobject_class->finalize = gst_svtvp9enc_finalize;
+  GST_ELEMENT_CLASS (klass)->change_state =
+      GST_DEBUG_FUNCPTR (gst_svtvp9enc_change_state);
   video_encoder_class->open = GST_DEBUG_FUNCPTR (gst_svtvp9enc_open);
   video_encoder_class->close = GST_DEBUG_FUNCPTR (gst_svtvp9enc_close);
   video_encoder_class->start = GST_DEBUG_FUNCPTR (gst_svtvp9enc_start);
@@ -317,6 +334,10 @@ gst_svtvp9enc_init (GstSvtVp9Enc * svtvp9enc)
   memset (&svtvp9enc->svt_encoder, 0, sizeof (svtvp9enc->svt_encoder));
   svtvp9enc->frame_count = 0;
   svtvp9enc->dts_offset = 0;
+  g_mutex_init (&svtvp9enc->input_lock);
+  g_mutex_init (&svtvp9enc->output_lock);
+  g_cond_init (&svtvp9enc->output_cond);
+  svtvp9enc->output_flow = GST_FLOW_OK;
 
   EbErrorType res =
       eb_vp9_svt_init_handle(&svtvp9enc->svt_encoder, NULL, svtvp9enc->svt_config);
@@ -518,9 +539,34 @@ gst_svtvp9enc_finalize (GObject * object)
   g_free (svtvp9enc->svt_config);
   GST_OBJECT_UNLOCK (svtvp9enc);
 
+  g_mutex_clear (&svtvp9enc->input_lock);
+  g_mutex_clear (&svtvp9enc->output_lock);
+  g_cond_clear (&svtvp9enc->output_cond);
+
   G_OBJECT_CLASS (gst_svtvp9enc_parent_class)->finalize (object);
 }
 
+GstStateChangeReturn
+gst_svtvp9enc_change_state (GstElement * element, GstStateChange transition)
+{
+  GstSvtVp9Enc *svtvp9enc = GST_SVTVP9ENC (element);
+
+  if (transition == GST_STATE_CHANGE_READY_TO_PAUSED)
+    svtvp9enc->stopping = FALSE;
+
+  /* the output task waits on SVT-VP9 with the source pad stream lock held,
+   * it has to be done before the pads are deactivated */
+  if (transition == GST_STATE_CHANGE_PAUSED_TO_READY) {
+    GST_VIDEO_ENCODER_STREAM_LOCK (svtvp9enc);
+    svtvp9enc->stopping = TRUE;
+    gst_svtvp9enc_drain (svtvp9enc, FALSE);
+    GST_VIDEO_ENCODER_STREAM_UNLOCK (svtvp9enc);
+  }
+
+  return GST_ELEMENT_CLASS (gst_svtvp9enc_parent_class)->change_state (element,
+      transition);
+}
+
 gboolean
 gst_svtvp9enc_allocate_svt_buffers (GstSvtVp9Enc * svtvp9enc)
 {
@@ -614,7 +660,7 @@ gst_svtvp9enc_start_svt (GstSvtVp9Enc * svtvp9enc)
     GST_ERROR_OBJECT (svtvp9enc, "eb_vp9_init_encoder failed with error %d", res);
     return FALSE;
   }
-  return TRUE;
+  return gst_svtvp9enc_start_output_task (svtvp9enc);
 }
 
 void
@@ -714,6 +760,7 @@ gst_svtvp9enc_encode (GstSvtVp9Enc * svtvp9enc, GstVideoCodecFrame * frame)
   if (!gst_video_frame_map (&video_frame, &svtvp9enc->state->info,
           frame->input_buffer, GST_MAP_READ)) {
     GST_ERROR_OBJECT (svtvp9enc, "couldn't map input frame");
+    gst_video_codec_frame_unref (frame);
     return GST_FLOW_ERROR;
   }
 
@@ -733,7 +780,8 @@ gst_svtvp9enc_encode (GstSvtVp9Enc * svtvp9enc, GstVideoCodecFrame * frame)
 
   input_buffer->n_filled_len = GST_VIDEO_FRAME_SIZE (&video_frame);
 
-  /* Fill in Buffers Header control data */
+  /* Fill in Buffers Header control data,
+   * the reference to the frame is handed to the output task through p_app_private */
   input_buffer->flags = 0;
   input_buffer->p_app_private = (void *) frame;
   input_buffer->pts = frame->pts;
@@ -743,12 +791,19 @@ gst_svtvp9enc_encode (GstSvtVp9Enc * svtvp9enc, GstVideoCodecFrame * frame)
     input_buffer->pic_type = EB_IDR_PICTURE;
   }
 
+  /* the call blocks until an input slot is free, which needs the output task
+   * to make progress: don't hold the stream lock meanwhile */
+  GST_VIDEO_ENCODER_STREAM_UNLOCK (svtvp9enc);
+  g_mutex_lock (&svtvp9enc->input_lock);
   res = eb_vp9_svt_enc_send_picture(svtvp9enc->svt_encoder, input_buffer);
+  g_mutex_unlock (&svtvp9enc->input_lock);
+  GST_VIDEO_ENCODER_STREAM_LOCK (svtvp9enc);
+  gst_video_frame_unmap (&video_frame);
   if (res != EB_ErrorNone) {
     GST_ERROR_OBJECT (svtvp9enc, "Issue %d sending picture to SVT-VP9.", res);
+    gst_video_codec_frame_unref (frame);
     ret = GST_FLOW_ERROR;
   }
-  gst_video_frame_unmap (&video_frame);
 
   return ret;
 }
@@ -766,7 +821,10 @@ gst_svtvp9enc_send_eos (GstSvtVp9Enc * svtvp9enc)
   input_buffer.flags = EB_BUFFERFLAG_EOS;
   input_buffer.p_buffer = NULL;
 
+  g_mutex_lock (&svtvp9enc->input_lock);
   ret = eb_vp9_svt_enc_send_picture(svtvp9enc->svt_encoder, &input_buffer);
+  g_mutex_unlock (&svtvp9enc->input_lock);
+  svtvp9enc->eos_sent = (ret == EB_ErrorNone);
 
   if (ret != EB_ErrorNone) {
     GST_ERROR_OBJECT (svtvp9enc, "couldn't send EOS frame.");
@@ -779,112 +837,229 @@ gst_svtvp9enc_send_eos (GstSvtVp9Enc * svtvp9enc)
 gboolean
 gst_svtvp9enc_flush (GstVideoEncoder * encoder)
 {
-  GstFlowReturn ret =
-      gst_svtvp9enc_dequeue_encoded_frames (GST_SVTVP9ENC (encoder), TRUE,
-      FALSE);
+  GstSvtVp9Enc *svtvp9enc = GST_SVTVP9ENC (encoder);
+
+  if (!svtvp9enc->output_task_started)
+    return TRUE;
+
+  /* SVT-VP9 has no flush: finish the current sequence discarding its packets
+   * and start a new one */
+  gst_svtvp9enc_drain (svtvp9enc, FALSE);
+
+  return gst_svtvp9enc_restart (svtvp9enc);
+}
+
+/* starts a new SVT-VP9 sequence once the previous one was drained */
+gboolean
+gst_svtvp9enc_restart (GstSvtVp9Enc * svtvp9enc)
+{
+  EbErrorType res;
+
+  /* the pools are refilled by the reset, no buffer may still be lent */
+  gst_svtvp9enc_wait_output_buffers (svtvp9enc);
 
-  return (ret != GST_FLOW_ERROR);
+  res = eb_vp9_svt_enc_reset (svtvp9enc->svt_encoder);
+  if (res != EB_ErrorNone) {
+    GST_ERROR_OBJECT (svtvp9enc, "eb_vp9_svt_enc_reset failed with error %d", res);
+    return FALSE;
+  }
+  svtvp9enc->dts_offset = 0;
+
+  return gst_svtvp9enc_start_output_task (svtvp9enc);
 }
 
-gint
-compare_video_code_frame_and_pts (const void *video_codec_frame_ptr,
-    const void *pts_ptr)
+void
+gst_svtvp9enc_wait_output_buffers (GstSvtVp9Enc * svtvp9enc)
+{
+  g_mutex_lock (&svtvp9enc->output_lock);
+  if (svtvp9enc->output_buffers_in_use)
+    GST_DEBUG_OBJECT (svtvp9enc, "waiting for downstream to release %u buffers",
+        svtvp9enc->output_buffers_in_use);
+  while (svtvp9enc->output_buffers_in_use)
+    g_cond_wait (&svtvp9enc->output_cond, &svtvp9enc->output_lock);
+  g_mutex_unlock (&svtvp9enc->output_lock);
+}
+
+void
+gst_svtvp9enc_release_output_buffer (gpointer data)
 {
-  return ((GstVideoCodecFrame *) video_codec_frame_ptr)->pts -
-      *((GstClockTime *) pts_ptr);
+  GstSvtVp9EncOutputBuffer *output_buffer = (GstSvtVp9EncOutputBuffer *) data;
+  GstSvtVp9Enc *svtvp9enc = output_buffer->svtvp9enc;
+
+  eb_vp9_svt_release_out_buffer (&output_buffer->output_buf);
+
+  g_mutex_lock (&svtvp9enc->output_lock);
+  svtvp9enc->output_buffers_in_use--;
+  g_cond_broadcast (&svtvp9enc->output_cond);
+  g_mutex_unlock (&svtvp9enc->output_lock);
+
+  gst_object_unref (svtvp9enc);
+  g_slice_free (GstSvtVp9EncOutputBuffer, output_buffer);
 }
 
 GstFlowReturn
-gst_svtvp9enc_dequeue_encoded_frames (GstSvtVp9Enc * svtvp9enc,
-    gboolean done_sending_pics, gboolean output_frames)
+gst_svtvp9enc_finish_output_frame (GstSvtVp9Enc * svtvp9enc,
+    GstVideoCodecFrame * frame, EbBufferHeaderType * output_buf)
 {
-  GstFlowReturn ret = GST_FLOW_OK;
-  EbErrorType res = EB_ErrorNone;
-  gboolean encode_at_eos = FALSE;
+  GstSvtVp9EncOutputBuffer *output_buffer =
+      g_slice_new (GstSvtVp9EncOutputBuffer);
+
+  if (output_buf->pic_type == EB_IDR_PICTURE
+      || output_buf->pic_type == EB_I_PICTURE) {
+    GST_VIDEO_CODEC_FRAME_SET_SYNC_POINT (frame);
+  }
+
+  /* lend the packet to downstream instead of copying it, the SVT-VP9 buffer
+   * goes back to the library once the GstBuffer is freed */
+  output_buffer->svtvp9enc = gst_object_ref (svtvp9enc);
+  output_buffer->output_buf = output_buf;
+  g_mutex_lock (&svtvp9enc->output_lock);
+  svtvp9enc->output_buffers_in_use++;
+  g_mutex_unlock (&svtvp9enc->output_lock);
+
+  frame->output_buffer =
+      gst_buffer_new_wrapped_full (GST_MEMORY_FLAG_READONLY,
+      output_buf->p_buffer, output_buf->n_alloc_len, 0,
+      output_buf->n_filled_len, output_buffer,
+      gst_svtvp9enc_release_output_buffer);
+  GST_BUFFER_FLAG_SET(frame->output_buffer, GST_BUFFER_FLAG_LIVE);
+
+  /* SVT-VP9 may return first frames with a negative DTS,
+   * offsetting it to start at 0 since GStreamer 1.x doesn't support it */
+  if (output_buf->dts + svtvp9enc->dts_offset < 0) {
+    svtvp9enc->dts_offset = -output_buf->dts;
+  }
+  /* Gstreamer doesn't support negative DTS so we return
+   * very small increasing ones for the first frames. */
+  if (output_buf->dts < 1) {
+    frame->dts = frame->output_buffer->dts =
+        output_buf->dts + svtvp9enc->dts_offset;
+  } else {
+    frame->dts = frame->output_buffer->dts =
+        (output_buf->dts *
+        svtvp9enc->svt_config->frame_rate_denominator * GST_SECOND) /
+        svtvp9enc->svt_config->frame_rate_numerator;
+  }
 
-  do {
-    GList *pending_frames = NULL;
-    GList *frame_list_element = NULL;
-    GstVideoCodecFrame *frame = NULL;
-    EbBufferHeaderType *output_buf = NULL;
+  frame->pts = frame->output_buffer->pts = output_buf->pts;
 
-    res =
-        eb_vp9_svt_get_packet(svtvp9enc->svt_encoder, &output_buf,
-        done_sending_pics);
+  GST_LOG_OBJECT (svtvp9enc, "#frame:%lld dts:%" G_GINT64_FORMAT " pts:%"
+      G_GINT64_FORMAT " SliceType:%d\n", svtvp9enc->frame_count,
+       (frame->dts), (frame->pts), output_buf->pic_type);
 
-    if (output_buf != NULL)
-      encode_at_eos =
-          ((output_buf->flags & EB_BUFFERFLAG_EOS) == EB_BUFFERFLAG_EOS);
+  svtvp9enc->frame_count++;
+
+  return gst_video_encoder_finish_frame (GST_VIDEO_ENCODER (svtvp9enc), frame);
+}
+
+/* runs on the source pad task, one packet per iteration, until the EOS packet */
+void
+gst_svtvp9enc_output_loop (GstSvtVp9Enc * svtvp9enc)
+{
+  GstFlowReturn ret = GST_FLOW_OK;
+  EbBufferHeaderType *output_buf = NULL;
+  GstVideoCodecFrame *frame;
+  gboolean output_frames;
+  gboolean encode_at_eos;
+  EbErrorType res;
+
+  res = eb_vp9_svt_get_packet (svtvp9enc->svt_encoder, &output_buf, TRUE);
+  if (output_buf == NULL) {
+    GST_ERROR_OBJECT (svtvp9enc, "no packet returned by SVT-VP9");
+    ret = GST_FLOW_ERROR;
+    encode_at_eos = TRUE;
+  } else {
+    encode_at_eos =
+        ((output_buf->flags & EB_BUFFERFLAG_EOS) == EB_BUFFERFLAG_EOS);
+    /* the frame reference was given to SVT-VP9 with the picture */
+    frame = (GstVideoCodecFrame *) output_buf->p_app_private;
+
+    g_mutex_lock (&svtvp9enc->output_lock);
+    output_frames = svtvp9enc->output_frames
+        && svtvp9enc->output_flow == GST_FLOW_OK;
+    g_mutex_unlock (&svtvp9enc->output_lock);
 
     if (res == EB_ErrorMax) {
       GST_ERROR_OBJECT (svtvp9enc, "Error while encoding, return\n");
-      return GST_FLOW_ERROR;
-    } else if (res != EB_NoErrorEmptyQueue && output_frames && output_buf) {
-      /* if p_app_private is indeed propagated, get the frame through it
-       * it's not currently the case with SVT-VP9
-       * so we fallback on using its PTS to find it back */
-      if (output_buf->p_app_private) {
-        frame = (GstVideoCodecFrame *) output_buf->p_app_private;
-      } else {
-        pending_frames = gst_video_encoder_get_frames (GST_VIDEO_ENCODER
-            (svtvp9enc));
-        frame_list_element = g_list_find_custom (pending_frames,
-            &output_buf->pts, compare_video_code_frame_and_pts);
-
-        if (frame_list_element == NULL)
-          return GST_FLOW_ERROR;
+      ret = GST_FLOW_ERROR;
+    }
 
-        frame = (GstVideoCodecFrame *) frame_list_element->data;
-      }
+    if (frame == NULL) {
+      eb_vp9_svt_release_out_buffer (&output_buf);
+    } else if (ret == GST_FLOW_OK && output_frames) {
+      GST_VIDEO_ENCODER_STREAM_LOCK (svtvp9enc);
+      ret = gst_svtvp9enc_finish_output_frame (svtvp9enc, frame, output_buf);
+      GST_VIDEO_ENCODER_STREAM_UNLOCK (svtvp9enc);
+    } else {
+      eb_vp9_svt_release_out_buffer (&output_buf);
+      gst_video_codec_frame_unref (frame);
+    }
+  }
 
-      if (output_buf->pic_type == EB_IDR_PICTURE
-          || output_buf->pic_type == EB_I_PICTURE) {
-        GST_VIDEO_CODEC_FRAME_SET_SYNC_POINT (frame);
-      }
+  g_mutex_lock (&svtvp9enc->output_lock);
+  if (ret != GST_FLOW_OK && svtvp9enc->output_flow == GST_FLOW_OK)
+    svtvp9enc->output_flow = ret;
+  svtvp9enc->eos_received = encode_at_eos;
+  g_cond_broadcast (&svtvp9enc->output_cond);
+  g_mutex_unlock (&svtvp9enc->output_lock);
 
-      frame->output_buffer =
-          gst_buffer_new_allocate (NULL, output_buf->n_filled_len, NULL);
-      GST_BUFFER_FLAG_SET(frame->output_buffer, GST_BUFFER_FLAG_LIVE);
-      gst_buffer_fill (frame->output_buffer, 0,
-          output_buf->p_buffer, output_buf->n_filled_len);
+  if (ret == GST_FLOW_NOT_LINKED || ret < GST_FLOW_EOS) {
+    GST_ELEMENT_ERROR (svtvp9enc, STREAM, ENCODE, (NULL),
+        ("Failed to output the encoded frames: %s", gst_flow_get_name (ret)));
+  }
 
-      /* SVT-VP9 may return first frames with a negative DTS,
-       * offsetting it to start at 0 since GStreamer 1.x doesn't support it */
-      if (output_buf->dts + svtvp9enc->dts_offset < 0) {
-        svtvp9enc->dts_offset = -output_buf->dts;
-      }
-      /* Gstreamer doesn't support negative DTS so we return
-       * very small increasing ones for the first frames. */
-      if (output_buf->dts < 1) {
-        frame->dts = frame->output_buffer->dts =
-            output_buf->dts + svtvp9enc->dts_offset;
-      } else {
-        frame->dts = frame->output_buffer->dts =
-            (output_buf->dts *
-            svtvp9enc->svt_config->frame_rate_denominator * GST_SECOND) /
-            svtvp9enc->svt_config->frame_rate_numerator;
-      }
+  /* the remaining packets are still dequeued after an error so that
+   * draining always completes */
+  if (encode_at_eos)
+    gst_pad_pause_task (GST_VIDEO_ENCODER_SRC_PAD (svtvp9enc));
+}
 
-      frame->pts = frame->output_buffer->pts = output_buf->pts;
+gboolean
+gst_svtvp9enc_start_output_task (GstSvtVp9Enc * svtvp9enc)
+{
+  g_mutex_lock (&svtvp9enc->output_lock);
+  svtvp9enc->output_frames = TRUE;
+  svtvp9enc->eos_sent = FALSE;
+  svtvp9enc->eos_received = FALSE;
+  svtvp9enc->output_flow = GST_FLOW_OK;
+  g_mutex_unlock (&svtvp9enc->output_lock);
+
+  svtvp9enc->output_task_started =
+      gst_pad_start_task (GST_VIDEO_ENCODER_SRC_PAD (svtvp9enc),
+      (GstTaskFunction) gst_svtvp9enc_output_loop, svtvp9enc, NULL);
+  if (!svtvp9enc->output_task_started)
+    GST_ERROR_OBJECT (svtvp9enc, "couldn't start the output task");
+
+  return svtvp9enc->output_task_started;
+}
 
-      GST_LOG_OBJECT (svtvp9enc, "#frame:%lld dts:%" G_GINT64_FORMAT " pts:%"
-          G_GINT64_FORMAT " SliceType:%d\n", svtvp9enc->frame_count,
-           (frame->dts), (frame->pts), output_buf->pic_type);
+/* sends EOS if needed and waits for the output task to dequeue the last packet,
+ * called with the stream lock held */
+GstFlowReturn
+gst_svtvp9enc_drain (GstSvtVp9Enc * svtvp9enc, gboolean output_frames)
+{
+  GstFlowReturn ret;
 
-      eb_vp9_svt_release_out_buffer(&output_buf);
-      output_buf = NULL;
+  if (!svtvp9enc->output_task_started)
+    return GST_FLOW_OK;
 
-      ret = gst_video_encoder_finish_frame (GST_VIDEO_ENCODER (svtvp9enc), frame);
+  g_mutex_lock (&svtvp9enc->output_lock);
+  svtvp9enc->output_frames = output_frames;
+  g_mutex_unlock (&svtvp9enc->output_lock);
 
-      if (pending_frames != NULL) {
-        g_list_free_full (pending_frames,
-            (GDestroyNotify) gst_video_codec_frame_unref);
-      }
+  if (!svtvp9enc->eos_sent && !gst_svtvp9enc_send_eos (svtvp9enc))
+    return GST_FLOW_ERROR;
 
-      svtvp9enc->frame_count++;
-    }
+  GST_VIDEO_ENCODER_STREAM_UNLOCK (svtvp9enc);
+  g_mutex_lock (&svtvp9enc->output_lock);
+  while (!svtvp9enc->eos_received)
+    g_cond_wait (&svtvp9enc->output_cond, &svtvp9enc->output_lock);
+  ret = svtvp9enc->output_flow;
+  g_mutex_unlock (&svtvp9enc->output_lock);
 
-  } while (res == EB_ErrorNone && !encode_at_eos);
+  gst_pad_stop_task (GST_VIDEO_ENCODER_SRC_PAD (svtvp9enc));
+  svtvp9enc->output_task_started = FALSE;
+  GST_VIDEO_ENCODER_STREAM_LOCK (svtvp9enc);
 
   return ret;
 }
@@ -944,6 +1119,9 @@ gst_svtvp9enc_stop (GstVideoEncoder * encoder)
   svtvp9enc->state = NULL;
   GST_OBJECT_UNLOCK (svtvp9enc);
 
+  /* the output task was stopped when going to READY, downstream may still hold buffers */
+  gst_svtvp9enc_wait_output_buffers (svtvp9enc);
+
   GST_OBJECT_LOCK (svtvp9enc);
   eb_vp9_deinit_encoder(svtvp9enc->svt_encoder);
   /* Destruct the buffer memory pool */
@@ -1003,13 +1181,32 @@ gst_svtvp9enc_handle_frame (GstVideoEncoder * encoder,
 
   GST_DEBUG_OBJECT (svtvp9enc, "handle_frame");
 
+  if (svtvp9enc->stopping) {
+    gst_video_codec_frame_unref (frame);
+    return GST_FLOW_FLUSHING;
+  }
+
+  /* new data after EOS starts a new sequence */
+  if (svtvp9enc->eos_sent && !gst_svtvp9enc_restart (svtvp9enc)) {
+    gst_video_codec_frame_unref (frame);
+    return GST_FLOW_ERROR;
+  }
+
+  g_mutex_lock (&svtvp9enc->output_lock);
+  ret = svtvp9enc->output_flow;
+  g_mutex_unlock (&svtvp9enc->output_lock);
+  if (ret != GST_FLOW_OK) {
+    gst_video_codec_frame_unref (frame);
+    return ret;
+  }
+
+  /* the packets are output by the source pad task */
   ret = gst_svtvp9enc_encode (svtvp9enc, frame);
   if (ret != GST_FLOW_OK) {
     GST_DEBUG_OBJECT (svtvp9enc, "gst_svtvp9enc_encode returned %d", ret);
-    return ret;
   }
 
-  return gst_svtvp9enc_dequeue_encoded_frames (svtvp9enc, FALSE, TRUE);
+  return ret;
 }
 
 static GstFlowReturn
@@ -1019,13 +1216,12 @@ gst_svtvp9enc_finish (GstVideoEncoder * encoder)
 
   GST_DEBUG_OBJECT (svtvp9enc, "finish");
 
-  gst_svtvp9enc_send_eos (svtvp9enc);
-
-  return gst_svtvp9enc_dequeue_encoded_frames (svtvp9enc, TRUE, TRUE);
+  return gst_svtvp9enc_drain (svtvp9enc, TRUE);
 }
 
 static GstFlowReturn
-gst_svtvp9enc_pre_push (GstVideoEncoder * encoder, GstVideoCodecFrame * frame)
+gst_svtvp9enc_pre_push (GstVideoEncoder * encoder,
+    G_GNUC_UNUSED GstVideoCodecFrame * frame)
 {
   GstSvtVp9Enc *svtvp9enc = GST_SVTVP9ENC (encoder);
 
@@ -1087,7 +1283,8 @@ gst_svtvp9enc_negotiate (GstVideoEncoder * encoder)
 }
 
 static gboolean
-gst_svtvp9enc_decide_allocation (GstVideoEncoder * encoder, GstQuery * query)
+gst_svtvp9enc_decide_allocation (GstVideoEncoder * encoder,
+    G_GNUC_UNUSED GstQuery * query)
 {
   GstSvtVp9Enc *svtvp9enc = GST_SVTVP9ENC (encoder);
 
@@ -1097,7 +1294,8 @@ gst_svtvp9enc_decide_allocation (GstVideoEncoder * encoder, GstQuery * query)
 }
 
 static gboolean
-gst_svtvp9enc_propose_allocation (GstVideoEncoder * encoder, GstQuery * query)
+gst_svtvp9enc_propose_allocation (GstVideoEncoder * encoder,
+    G_GNUC_UNUSED GstQuery * query)
 {
   GstSvtVp9Enc *svtvp9enc = GST_SVTVP9ENC (encoder);
 
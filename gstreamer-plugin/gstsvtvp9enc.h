@@ -42,6 +42,22 @@ typedef struct _GstSvtVp9Enc
 
   long long int frame_count;
   int dts_offset;
+
+  /* serializes the pictures and the EOS sent to SVT-VP9 */
+  GMutex input_lock;
+  /* set while going to READY, new frames are refused */
+  gboolean stopping;
+
+  /* output task state, protected by output_lock */
+  GMutex output_lock;
+  GCond output_cond;
+  gboolean output_frames;
+  gboolean output_task_started;
+  gboolean eos_sent;
+  gboolean eos_received;
+  GstFlowReturn output_flow;
+  /* SVT-VP9 output buffers still referenced by downstream GstBuffers */
+  guint output_buffers_in_use;
 } GstSvtVp9Enc;
 
 typedef struct _GstSvtVp9EncClass